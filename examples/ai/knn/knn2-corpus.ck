@@ -0,0 +1,65 @@
+//------------------------------------------------------------------------------
+// name: knn2-corpus.ck
+// desc: k-NN lookups in a large corpus (e.g., for concatenative synthesis,
+//       where each analysis frame looks up its nearest units); training
+//       builds a search index, so lookups don't scan the whole corpus;
+//       .approximate() trades exactness for speed
+//
+// version: need chuck version 1.5.5.8 or higher
+// sorting: part of ChAI (ChucK for AI)
+//
+// uncomment the next line to learn more about the KNN2 object:
+// KNN2.help();
+//------------------------------------------------------------------------------
+
+// corpus size
+50000 => int NUM_UNITS;
+// feature dimensions (e.g., a few spectral features per unit)
+8 => int NUM_DIMS;
+// number of lookups (e.g., one per analysis frame)
+1000 => int NUM_LOOKUPS;
+
+// a made-up corpus: features, and a label per unit (e.g., source file)
+float features[NUM_UNITS][NUM_DIMS];
+int labels[NUM_UNITS];
+for( int i; i < NUM_UNITS; i++ )
+{
+    for( int j; j < NUM_DIMS; j++ ) Math.random2f( 0, 1 ) => features[i][j];
+    i % 16 => labels[i];
+}
+
+// train (and index) the model
+KNN2 knn;
+knn.train( features, labels );
+// weights are part of the index
+knn.weigh( [2.0, 2.0, 1, 1, 1, 1, .5, .5] );
+
+// the same queries, looked up exactly and approximately
+float queries[NUM_LOOKUPS][NUM_DIMS];
+for( int i; i < NUM_LOOKUPS; i++ )
+    for( int j; j < NUM_DIMS; j++ ) Math.random2f( 0, 1 ) => queries[i][j];
+
+// look up the nearest unit for each query
+fun void lookup( int result[] )
+{
+    int found[0], indices[0];
+    for( int i; i < NUM_LOOKUPS; i++ )
+    {
+        knn.search( queries[i], 1, found, indices );
+        indices[0] => result[i];
+    }
+}
+
+// exact (the default)
+int exact[NUM_LOOKUPS];
+lookup( exact );
+
+// approximate: neighbors may be up to 1.5x farther than the true ones
+knn.approximate( .5 );
+int approx[NUM_LOOKUPS];
+lookup( approx );
+
+// how often did the approximate search find the true nearest unit?
+0 => int matches;
+for( int i; i < NUM_LOOKUPS; i++ ) if( exact[i] == approx[i] ) matches++;
+<<< "approximate matches exact:", matches, "of", NUM_LOOKUPS >>>;
@@ -0,0 +1,63 @@
+//---------------------------------------------------------------------
+// name: mlp-async.ck
+// desc: training a multilayer perception (MLP) in the background,
+//       while the sound (and the rest of the VM) keeps going
+//       (also works for SVM, KNN2, and Wekinator: .trainAsync())
+//
+// version: need chuck version 1.5.5.8 or higher
+// sorting: part of ChAI (ChucK for AI)
+//
+// uncomment for MLP API:
+// MLP.help();
+//---------------------------------------------------------------------
+
+// a sound to keep going during training
+SinOsc foo => dac;
+.2 => foo.gain;
+
+// a wobble, in its own shred
+fun void wobble()
+{
+    while( true )
+    {
+        Math.random2f( 300, 600 ) => foo.freq;
+        100::ms => now;
+    }
+}
+spork ~ wobble();
+
+// same data and initial weights every run
+Math.srandom( 1234 );
+
+// instantiate a multilayer perception
+MLP mlp;
+// nodes per layer: input, hidden layers, output
+mlp.init( [8, 64, 64, 2] );
+
+// lots of (made up) observations
+float X[2000][8];
+float Y[2000][2];
+for( int i; i < X.size(); i++ )
+{
+    for( int j; j < 8; j++ ) Math.random2f( -1, 1 ) => X[i][j];
+    Math.sin( X[i][0] + X[i][1] ) => Y[i][0];
+    X[i][2] * X[i][3] => Y[i][1];
+}
+
+// a test input
+[.5, .5, .2, .8, 0, 0, 0, 0] @=> float x[];
+float y[2];
+
+// before training
+mlp.predict( x, y );
+<<< "before:", y[0], y[1] >>>;
+
+// train in the background; wait on the returned event
+now => time start;
+<<< "training model...", "" >>>;
+mlp.trainAsync( X, Y, .01, 50 ) => now;
+<<< "done training after", (now - start) / second, "seconds of audio" >>>;
+
+// after training (prints about .88, .13 with the seed above)
+mlp.predict( x, y );
+<<< "after:", y[0], y[1] >>>;
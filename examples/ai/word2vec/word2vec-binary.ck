@@ -0,0 +1,47 @@
+//------------------------------------------------------------------------------
+// name: word2vec-binary.ck
+// desc: converting a text word2vec model to a binary model, which loads
+//       near-instantly (it is memory-mapped instead of parsed) and whose
+//       memory is shared by every ChucK that loads the same file
+//
+// version: need chuck version 1.5.5.8 or higher
+// sorting: part of ChAI (ChucK for AI)
+//
+// NOTE: download pre-trained word vector model from:
+//       https://chuck.stanford.edu/chai/data/glove/
+//         | (can use any of these)
+//       glove-wiki-gigaword-50.txt (400000 words x 50 dimensions)
+//       glove-wiki-gigaword-50-pca-3.txt (400000 words x 3 dimensions)
+//       glove-wiki-gigaword-50-tsne-2.txt (400000 words x 2 dimensions)
+//------------------------------------------------------------------------------
+
+// the text model (see URLs above for download)
+me.dir() + "glove-wiki-gigaword-50.txt" => string textpath;
+// the binary model to make from it
+me.dir() + "glove-wiki-gigaword-50.bin" => string binpath;
+
+// instantiate
+Word2Vec model;
+// load the binary model; same as loading a text model, only faster
+if( !model.load( binpath ) )
+{
+    // the first time: convert the text model (this parses it, so it could
+    // take a few seconds), then load
+    <<< "converting:", textpath >>>;
+    if( !Word2Vec.convert( textpath, binpath ) || !model.load( binpath ) )
+    {
+        <<< "cannot convert model file...", "" >>>;
+        me.exit();
+    }
+}
+
+// print info
+<<< "dictionary size:", model.size() >>>;
+<<< "embedding dimensions:", model.dim() >>>;
+<<< "using KDTree for search:", model.useKDTree() ? "YES" : "NO" >>>;
+
+// use it as usual
+string words[10];
+model.getSimilar( "cat", words.size(), words );
+<<< "words similar to 'cat':", "" >>>;
+for( int i; i < words.size(); i++ ) <<< "   ", words[i] >>>;
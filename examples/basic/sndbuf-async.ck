@@ -0,0 +1,28 @@
+//------------------------------------------------------------------------------
+// name: sndbuf-async.ck
+// desc: reading a sound file in the background, so that reading a long file
+//       doesn't hold up the shred (or the audio); the SndBuf keeps playing
+//       what it had until the new file is ready
+//
+// version: need chuck version 1.5.5.8 or higher
+//------------------------------------------------------------------------------
+
+// the patch
+SndBuf buf => dac;
+.5 => buf.gain;
+
+// something to play meanwhile
+me.dir() + "../data/kick.wav" => buf.read;
+1 => buf.loop;
+
+// start reading another file; returns an Event, signaled when it's ready
+buf.readAsync( me.dir() + "../data/amen.wav" ) @=> Event loaded;
+// (.ready() is false until then)
+<<< "reading...", buf.ready() >>>;
+
+// wait for it (the kick keeps playing)
+loaded => now;
+<<< "ready:", buf.ready(), buf.samples(), "samples" >>>;
+
+// play the new file for a bit
+4::second => now;
@@ -0,0 +1,43 @@
+//------------------------------------------------------------------------------
+// name: sndbuf-stream.ck
+// desc: streaming a sound file from disk, instead of loading it into memory
+//       (e.g., for long recordings); a background thread reads ahead of the
+//       play position, so playback never waits on the disk
+//
+// version: need chuck version 1.5.5.8 or higher
+//------------------------------------------------------------------------------
+
+// sound file to stream; me.dir() returns location of this file
+me.dir() + "../data/amen.wav" => string filename;
+// if there is argument, use it as the filename
+if( me.args() ) me.arg(0) => filename;
+
+// the patch
+SndBuf buf => dac;
+// stream, staying a second (at 44.1k) ahead of the play position;
+// this must be set before reading the file
+44100 => buf.stream;
+// read (only the beginning of the file is read now)
+filename => buf.read;
+
+// check if file successfully opened
+if( !buf.ready() ) me.exit();
+
+// loop, forwards then backwards
+1 => buf.loop;
+.5 => buf.gain;
+1 => buf.rate;
+4::second => now;
+-1 => buf.rate;
+4::second => now;
+
+// jump around; each jump leaves the stream a moment to catch up
+repeat( 8 )
+{
+    Math.random2( 0, buf.samples()-1 ) => buf.pos;
+    500::ms => now;
+}
+
+// frames played before the stream had read them (should be few, if any,
+// other than right after jumps)
+<<< "underruns:", buf.underruns() >>>;
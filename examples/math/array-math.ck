@@ -0,0 +1,39 @@
+// name: array-math.ck
+// desc: whole-array math on float[], computed natively instead of
+//       element by element in a ChucK loop
+//         reductions: Math.sum(), Math.mean(), Math.min(), Math.max(),
+//                     Math.dot(), Math.cossim(), Math.euclidean()
+//         in place: Math.add(), Math.mul(), Math.scale(),
+//                   Math.axpy(), Math.normalize()
+//
+// NOTE: functions taking two arrays work over the length of the
+//       shorter one; in-place functions modify their first array
+//       (or 'y' for Math.axpy)
+//
+// uncomment this line to print Math library API
+// Math.help();
+
+// e.g., magnitudes from an analysis frame
+[ 0.1, 0.5, 0.9, 0.4, 0.2, 0.05, 0.3, 0.6 ] @=> float mags[];
+// and a running average of previous frames
+float avg[mags.size()];
+
+// reductions
+<<< "sum:", Math.sum(mags), "mean:", Math.mean(mags) >>>;
+<<< "min:", Math.min(mags), "max:", Math.max(mags) >>>;
+<<< "energy:", Math.dot(mags, mags) >>>;
+
+// running average: avg = .9*avg + .1*mags
+Math.scale( avg, 0.9 );
+Math.axpy( 0.1, mags, avg );
+<<< "avg[2]:", avg[2] >>>;
+
+// weighting: mags = mags * weights
+[ 1.0, 1, 1, 1, .5, .5, .5, .5 ] @=> float weights[];
+Math.mul( mags, weights );
+<<< "weighted mags[4]:", mags[4] >>>;
+
+// add avg into mags, then scale mags to unit length
+Math.add( mags, avg );
+<<< "norm before normalize:", Math.normalize(mags) >>>;
+<<< "norm after normalize:", Math.sqrt(Math.dot(mags, mags)) >>>;
@@ -0,0 +1,36 @@
+// associative array microbenchmark: per-note lookup tables keyed by string
+// run with: time chuck --silent assoc-bench.ck
+// (compare wall-clock time across builds; the checksum should not change)
+
+// number of distinct keys in each table
+1024 => int NUM_KEYS;
+// number of passes over all keys
+2000 => int PASSES;
+
+// tables, as a shred might keep per note
+float freqs[0];
+int velocities[0];
+
+// key strings, made once (as literals or stored names would be)
+string keys[NUM_KEYS];
+for( 0 => int i; i < NUM_KEYS; i++ )
+{
+    "note-" + i => keys[i];
+    Std.mtof( i % 128 ) => freqs[keys[i]];
+    i % 128 => velocities[keys[i]];
+}
+
+// read-modify-write every entry, over and over
+0.0 => float checksum;
+for( 0 => int p; p < PASSES; p++ )
+{
+    for( 0 => int i; i < NUM_KEYS; i++ )
+    {
+        keys[i] => string key;
+        freqs[key] * velocities[key] +=> checksum;
+        1 +=> velocities[key];
+    }
+}
+
+<<< "keys:", NUM_KEYS, "lookups:", NUM_KEYS * PASSES * 3,
+    "checksum:", checksum >>>;
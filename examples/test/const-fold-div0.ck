@@ -0,0 +1,6 @@
+// integer division by a constant zero is not folded away; it is still a
+// run-time exception, as without folding (expected: const-fold-div0.txt)
+//   chuck --silent const-fold-div0.ck 2> err.txt; diff err.txt const-fold-div0.txt
+<<< "before" >>>;
+<<< 1 / 0 >>>;
+<<< "never printed" >>>;
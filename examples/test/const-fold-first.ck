@@ -0,0 +1,12 @@
+// constant-folded if/while as the first statement of a file and of a
+// function body, where the emitted branch has no instructions; the output
+// must match const-fold-first.txt:
+//   chuck --silent const-fold-first.ck 2> out.txt; diff out.txt const-fold-first.txt
+if( false ) <<< "never emitted" >>>;
+
+fun void f() { if( false ) <<< "never emitted" >>>; <<< "f" >>>; }
+fun void g() { if( 0.0 ) <<< "never emitted" >>>; <<< "g" >>>; }
+fun void h() { if( 1 ) { <<< "h" >>>; } }
+fun void w() { while( false ) <<< "never emitted" >>>; <<< "w" >>>; }
+
+f(); g(); h(); w();
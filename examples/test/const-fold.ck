@@ -0,0 +1,28 @@
+// compile-time constant folding and dead-branch elimination; the output
+// must match const-fold.txt, made without folding:
+//   chuck --silent const-fold.ck 2> out.txt; diff out.txt const-fold.txt
+// (chuck --dump const-fold.ck shows each folded expression as one push)
+
+// folded to one float push
+2 * pi * 440.0 / 48000.0 => float w;
+<<< w, Math.PI / 4, -(3 + 4) * 2, 7 / 2, 7.5 % 2.0 >>>;
+// int arithmetic, including negative division and modulo, and shifts
+<<< 2147483647 * 4, -7 / 2, -7 % 3, 7 % -3, 1 << 62 >>>;
+// float arithmetic, including infinities and mixed int/float operands
+<<< 1.0 / 3.0, 1 + 0.5, 3 * 0.25, 1.0 / 0.0, -1.0 / 0.0 >>>;
+// comparisons, logic, bitwise, casts, and ?: on constants
+<<< 1 < 2, true && false, ~5, 6 ^ 3, 7.9 $ int, true ? 1 : 2 >>>;
+<<< 2.5 >= 2.5, 3 != 3, false || 1 == 1, !true, 12 & 10, 12 | 3 >>>;
+<<< -2.75 $ int, 5 $ float / 2, (1 < 2) ? 0.5 : 1.5, 0 ? "a" : "b" >>>;
+// folded constants mixed with variables
+3 => int a;
+<<< a * (2 + 3), (4 * 2) - a, a + pi * 0 >>>;
+
+// only the taken branch is emitted
+if( false ) <<< "never emitted" >>>;
+else <<< "emitted" >>>;
+if( 2 > 1 ) <<< "taken" >>>;
+while( false ) <<< "never emitted" >>>;
+0 => int n;
+while( true ) { if( ++n == 3 ) break; }
+<<< "loop:", n >>>;
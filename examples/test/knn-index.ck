@@ -0,0 +1,130 @@
+// k-NN search check: KNN and KNN2 search a k-d tree (unless a weight is
+// negative, then they scan every point); here each search is compared
+// against a brute-force scan in ChucK, with and without weigh(), and with
+// a negative weight; most of the data lies on a grid (multiples of .25),
+// so ties (broken by lower index) are common; the output must match
+// knn-index.txt, made with a full scan:
+//   chuck --silent knn-index.ck 2> out.txt; diff out.txt knn-index.txt
+
+// reproducible
+Math.srandom( 1234 );
+
+// number of points, dimensions, queries
+600 => int N;
+3 => int D;
+200 => int Q;
+
+// the data, with some duplicate points
+float X[N][D];
+for( int i; i < N; i++ )
+{
+    if( i > 10 && i % 17 == 0 )
+    {
+        for( int j; j < D; j++ ) X[i-5][j] => X[i][j];
+        continue;
+    }
+    for( int j; j < D; j++ ) Math.random2( -20, 20 ) * .25 => X[i][j];
+}
+
+// the k nearest rows of X to q, by weighted squared distance, nearest
+// first (ties to the lower index); 0 fills in beyond the number of rows
+fun void brute( float X[][], float w[], float q[], int k, int out[] )
+{
+    float best[k];
+    out.size( k );
+    for( int i; i < k; i++ ) { 1e10 => best[i]; 0 => out[i]; }
+    for( int i; i < X.size(); i++ )
+    {
+        0.0 => float d;
+        for( int j; j < X[i].size(); j++ )
+            (q[j] - X[i][j]) * (q[j] - X[i][j]) * w[j] +=> d;
+        for( int m; m < k; m++ )
+        {
+            if( d < best[m] )
+            {
+                for( k - 1 => int l; l > m; l-- )
+                { best[l-1] => best[l]; out[l-1] => out[l]; }
+                d => best[m]; i => out[m];
+                break;
+            }
+        }
+    }
+}
+
+// search Q random queries for k = 1...10; print a few, count mismatches
+fun void check( string what, KNN knn, float X[][], float w[] )
+{
+    0 => int mismatches;
+    int got[0];
+    int expected[0];
+    float q[D];
+    for( int n; n < Q; n++ )
+    {
+        for( int j; j < D; j++ ) Math.random2( -24, 24 ) * .25 => q[j];
+        1 + n % 10 => int k;
+        knn.search( q, k, got );
+        brute( X, w, q, k, expected );
+        for( int i; i < k; i++ ) if( got[i] != expected[i] ) { mismatches++; break; }
+        if( n < 3 )
+        {
+            what + " k=" + k + ":" => string s;
+            for( int i; i < k; i++ ) s + " " + got[i] => s;
+            <<< s >>>;
+        }
+    }
+    <<< what, "mismatches:", mismatches >>>;
+}
+
+// unweighted
+KNN knn;
+knn.train( X );
+check( "unweighted", knn, X, [1.0, 1.0, 1.0] );
+
+// weighted (including a zero weight)
+[4.0, .25, 0.0] @=> float w1[];
+knn.weigh( w1 );
+check( "weighted", knn, X, w1 );
+
+// a negative weight
+[1.0, -.5, 2.0] @=> float w2[];
+knn.weigh( w2 );
+check( "negative", knn, X, w2 );
+
+// back to non-negative
+[1.0, 9.0, .5] @=> float w3[];
+knn.weigh( w3 );
+check( "reweighted", knn, X, w3 );
+
+// off the grid: random data and weights, in more dimensions
+8 => int E;
+float R[N][E];
+for( int i; i < N; i++ ) for( int j; j < E; j++ ) Math.random2f( -1, 1 ) => R[i][j];
+float w4[E];
+for( int j; j < E; j++ ) Math.random2f( 0, 3 ) => w4[j];
+KNN knnr;
+knnr.train( R );
+knnr.weigh( w4 );
+E => D;
+check( "random", knnr, R, w4 );
+
+// fewer points than k
+KNN small;
+[[1.0, 0.0, 0.0], [0.0, 1.0, 0.0], [1.0, 0.0, 0.0]] @=> float S[][];
+small.train( S );
+int got[0];
+small.search( [.75, 0.0, 0.0], 5, got );
+<<< "small:", got[0], got[1], got[2], got[3], got[4] >>>;
+
+// KNN2 searches the same way
+KNN2 knn2;
+int labels[N];
+for( int i; i < N; i++ ) i % 4 => labels[i];
+knn2.train( X, labels );
+int found[0];
+int indices[0];
+int expected[0];
+knn2.search( [1.0, -.5, 2.25], 7, found, indices );
+brute( X, [1.0, 1.0, 1.0], [1.0, -.5, 2.25], 7, expected );
+0 => int agree;
+for( int i; i < 7; i++ ) if( indices[i] == expected[i] && found[i] == labels[indices[i]] ) agree++;
+<<< "knn2:", agree, "of 7" >>>;
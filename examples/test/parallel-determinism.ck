@@ -0,0 +1,130 @@
+// parallel UGen rendering determinism check: renders serially, runs itself
+// again with --ugen-threads, and fails (crashes) unless the checksums of the
+// two outputs match exactly; run serially, with Std.system() enabled:
+//   chuck --silent --caution-to-the-wind --adaptive:64 parallel-determinism.ck
+// --adaptive:64 is required: the threaded run renders in 64-sample blocks,
+// and a serial run without it ticks per sample, which legitimately gives
+// different output (and checksums)
+// (set CHUCK to the chuck executable to test, if not `chuck` on the path)
+// expected output: "success"
+
+// same noise every run
+Math.srandom( 1234 );
+
+32 => int NUM_VOICES;
+// how long to run, in ChucK time
+4::second => dur LENGTH;
+
+// independent voices, mixed into one bus (rendered on the workers)
+Gain mix => dac;
+0.5 / NUM_VOICES => mix.gain;
+SinOsc sin[NUM_VOICES/2];
+TriOsc tri[NUM_VOICES/2];
+LPF lpf[NUM_VOICES/2];
+BiQuad bq[NUM_VOICES/2];
+ADSR env[NUM_VOICES];
+for( 0 => int i; i < NUM_VOICES/2; i++ )
+{
+    sin[i] => lpf[i] => env[2*i] => mix;
+    tri[i] => bq[i] => env[2*i+1] => mix;
+    110 + 37 * i => sin[i].freq;
+    220 + 53 * i => tri[i].freq;
+    800 + 100 * i => lpf[i].freq;
+    0.99 => bq[i].prad; 1 => bq[i].eqzs;
+    (600 + 75 * i) => bq[i].pfreq;
+    env[2*i].set( 5::ms, 20::ms, 0.5, 50::ms );
+    env[2*i+1].set( 10::ms, 30::ms, 0.3, 80::ms );
+}
+
+// a voice with noise and feedback (rendered on the audio thread)
+Noise n => Delay d => Gain fb => d => dac;
+0.05 => n.gain;
+0.5 => fb.gain;
+7::ms => d.max => d.delay;
+
+// stereo voice, straight into the dac
+SinOsc s => Pan2 p => dac;
+0.1 => s.gain;
+-0.5 => p.pan;
+
+// the output, a block at a time
+64 => int SIZE;
+dac => Flip flip => blackhole;
+SIZE => flip.size;
+
+// checksums
+0.0 => float sum;
+0.0 => float weighted;
+0 => int count;
+
+// retrigger the envelopes
+fun void play()
+{
+    0 => int k;
+    while( true )
+    {
+        env[k % NUM_VOICES].keyOn();
+        env[(k + NUM_VOICES/2) % NUM_VOICES].keyOff();
+        k++;
+        13::ms => now;
+    }
+}
+spork ~ play();
+
+now + LENGTH => time later;
+while( now < later )
+{
+    SIZE::samp => now;
+    flip.upchuck() @=> UAnaBlob blob;
+    for( 0 => int i; i < SIZE; i++ )
+    {
+        blob.fval( i ) => float x;
+        x +=> sum;
+        x * (count % 997 + 1) +=> weighted;
+        count++;
+    }
+}
+
+Std.ftoa( sum, 15 ) + " " + Std.ftoa( weighted, 15 ) => string result;
+
+// the threaded run: report to the file it was given
+if( me.args() > 0 )
+{
+    FileIO fout;
+    fout.open( me.arg(0), FileIO.WRITE );
+    fout <= result <= IO.newline();
+    fout.close();
+    me.exit();
+}
+
+// run again, threaded, reporting to the temp directory
+Std.getenv( "TMPDIR", Std.getenv( "TEMP", "/tmp" ) ) + "/parallel-determinism.out" => string file;
+Std.getenv( "CHUCK", "chuck" ) + " --silent --adaptive:64 --ugen-threads:4 \""
+    + me.path() + ":" + file + "\"" => string cmd;
+// empty the file first, so output left by an earlier run is never compared
+FileIO fclear;
+fclear.open( file, FileIO.WRITE );
+fclear.close();
+// (without --caution-to-the-wind, Std.system() runs nothing and returns 0)
+if( Std.system( cmd ) != 0 )
+{
+    <<< "FAILURE: could not run:", cmd >>>;
+    Machine.crash();
+}
+
+// compare
+FileIO fin;
+fin.open( file, FileIO.READ );
+fin.readLine() => string threaded;
+fin.close();
+if( threaded == "" )
+{
+    <<< "FAILURE: could not run / no output:", cmd >>>;
+    Machine.crash();
+}
+if( threaded != result )
+{
+    <<< "FAILURE: serial", result, "threaded", threaded >>>;
+    Machine.crash();
+}
+<<< "success" >>>;
@@ -0,0 +1,27 @@
+// shreduler microbenchmark: many sporked shreds with random ::samp waits
+// run with: time chuck --silent shreduler-bench.ck
+// (each `=> now` re-shredules a shred among all the others; compare
+// wall-clock time across builds; the wakeup count should not change)
+
+10000 => int NUM_SHREDS;
+// how long to run, in ChucK time
+1::second => dur LENGTH;
+
+// count of shred wake-ups
+0 => int wakeups;
+
+fun void voice()
+{
+    while( true )
+    {
+        Math.random2( 1, 256 )::samp => now;
+        wakeups++;
+    }
+}
+
+Math.srandom( 1234 );
+for( 0 => int i; i < NUM_SHREDS; i++ ) spork ~ voice();
+
+LENGTH => now;
+
+<<< "shreds:", NUM_SHREDS, "wakeups:", wakeups >>>;
@@ -0,0 +1,128 @@
+// compact VM ops check: exercises the instructions the VM lowers to compact
+// ops (pushes, pops, assignment, int/float arithmetic and comparisons, ++,
+// casts, jumps and branches, and the fused pairs), at file scope and inside
+// functions; the output must match vm-ops.txt, made by the original
+// per-instruction execution:
+//   chuck --silent vm-ops.ck 2> out.txt; diff out.txt vm-ops.txt
+
+// file-scope (base) int and float locals
+3 => int a;
+-7 => int b;
+2.5 => float x;
+-0.125 => float y;
+
+// int arithmetic, including overflow wrap-around
+<<< a + b, a - b, a * b, b * b * b >>>;
+<<< 9223372036854775807 + 1, -9223372036854775807 - 2 >>>;
+// float arithmetic
+<<< x + y, x - y, x * y, x / y, 1.0 / 3.0 >>>;
+<<< 1.0 / 0.0, -1.0 / 0.0 >>>;
+
+// int comparisons
+<<< a < b, a > b, a <= 3, a >= 4, a == 3, a != 3 >>>;
+// float comparisons
+<<< x < y, x > y, x <= 2.5, y >= 0.0 >>>;
+
+// casts
+<<< a $ float, x $ int, y $ int, -2.75 $ int, 1e15 $ int >>>;
+// mixed (implicit int to float)
+<<< a + x, b * y >>>;
+
+// assignment, chained and as a value
+0 => int c;
+a + b => c => int d;
+<<< c, d >>>;
+0.0 => float z;
+x * 4 => z => float w;
+<<< z, w >>>;
+
+// ++, as statements and as values
+0 => int i;
+i++; ++i;
+<<< i, i++, ++i, i >>>;
+
+// loops: for / while / until / do, with breaks and continues
+0 => int sum;
+for( 0 => int k; k < 100; k++ )
+{
+    if( k % 7 == 3 ) continue;
+    if( k > 90 ) break;
+    k +=> sum;
+}
+<<< "for:", sum >>>;
+
+0 => int n;
+0.0 => float f;
+while( n != 20 ) { n * 0.5 +=> f; n++; }
+<<< "while:", n, f >>>;
+
+10 => n;
+until( n == 0 ) n--;
+<<< "until:", n >>>;
+
+0 => n;
+do { n + 3 => n; } while( n < 50 );
+<<< "do:", n >>>;
+
+// nested loops and branches on the result of comparisons
+0 => int count;
+for( 0 => int p; p < 10; p++ )
+    for( p => int q; q < 10; q++ )
+        if( (p * q) % 3 == 0 && p != q ) count++;
+<<< "nested:", count >>>;
+
+// function-scope locals, arguments and recursion
+fun int fib( int n )
+{
+    if( n < 2 ) return n;
+    return fib( n - 1 ) + fib( n - 2 );
+}
+<<< "fib:", fib( 20 ) >>>;
+
+fun float poly( float t, int terms )
+{
+    0.0 => float acc;
+    1.0 => float p;
+    for( 0 => int k; k < terms; k++ )
+    {
+        p / (k + 1) +=> acc;
+        t *=> p;
+    }
+    return acc;
+}
+<<< "poly:", poly( 0.5, 12 ), poly( -1.5, 7 ) >>>;
+
+fun int collatz( int n )
+{
+    0 => int steps;
+    while( n != 1 )
+    {
+        if( n % 2 == 0 ) n / 2 => n;
+        else 3 * n + 1 => n;
+        steps++;
+    }
+    return steps;
+}
+<<< "collatz:", collatz( 27 ), collatz( 97 ) >>>;
+
+// expression statements whose values are discarded
+a + b;
+x * y;
+a < b;
+<<< "discarded:", a, b, x, y >>>;
+
+// class members and statics alongside locals
+class Counter
+{
+    0 => int n;
+    0.0 => float total;
+    fun void add( float v ) { n++; v +=> total; }
+}
+Counter counter;
+for( 1 => int k; k <= 10; k++ ) counter.add( k * 0.5 );
+<<< "counter:", counter.n, counter.total >>>;
+
+// time and dur arithmetic (float pushes and adds)
+now + 10::samp => time t1;
+12::samp - 2::samp => dur span;
+<<< "time:", (t1 - now) / samp, span / samp, (now + span < t1) >>>;
@@ -81,6 +81,10 @@
 #define CHUCK_PARAM_OUTPUT_CHANNELS_DEFAULT        "2"
 #define CHUCK_PARAM_VM_ADAPTIVE_DEFAULT            "0"
 #define CHUCK_PARAM_VM_HALT_DEFAULT                "0"
+#define CHUCK_PARAM_VM_BLOCK_SHREDULE_DEFAULT      "0"
+#define CHUCK_PARAM_VM_UGEN_SCHEDULE_DEFAULT       "0"
+#define CHUCK_PARAM_VM_UGEN_THREADS_DEFAULT        "0"
+#define CHUCK_PARAM_VM_OP_PAIRS_DEFAULT            "0"
 #define CHUCK_PARAM_OTF_ENABLE_DEFAULT             "0"
 #define CHUCK_PARAM_OTF_PORT_DEFAULT               "8888"
 #define CHUCK_PARAM_OTF_PRINT_WARNINGS_DEFAULT     "0"
@@ -90,6 +94,7 @@
 #define CHUCK_PARAM_WORKING_DIRECTORY_DEFAULT      ""
 #define CHUCK_PARAM_IS_REALTIME_AUDIO_HINT_DEFAULT "0"
 #define CHUCK_PARAM_COMPILER_HIGHLIGHT_ON_ERROR_DEFAULT "1"
+#define CHUCK_PARAM_COMPILER_CODE_CACHE_DEFAULT    "64"
 #define CHUCK_PARAM_TTY_COLOR_DEFAULT              "0"
 #define CHUCK_PARAM_TTY_WIDTH_HINT_DEFAULT         "80"
 // chugin-relate param defaults
@@ -192,6 +197,10 @@ void ChucK::initDefaultParams()
     initParam( CHUCK_PARAM_OUTPUT_CHANNELS, CHUCK_PARAM_OUTPUT_CHANNELS_DEFAULT, ck_param_int );
     initParam( CHUCK_PARAM_VM_ADAPTIVE, CHUCK_PARAM_VM_ADAPTIVE_DEFAULT, ck_param_int );
     initParam( CHUCK_PARAM_VM_HALT, CHUCK_PARAM_VM_HALT_DEFAULT, ck_param_int );
+    initParam( CHUCK_PARAM_VM_BLOCK_SHREDULE, CHUCK_PARAM_VM_BLOCK_SHREDULE_DEFAULT, ck_param_int );
+    initParam( CHUCK_PARAM_VM_UGEN_SCHEDULE, CHUCK_PARAM_VM_UGEN_SCHEDULE_DEFAULT, ck_param_int );
+    initParam( CHUCK_PARAM_VM_UGEN_THREADS, CHUCK_PARAM_VM_UGEN_THREADS_DEFAULT, ck_param_int );
+    initParam( CHUCK_PARAM_VM_OP_PAIRS, CHUCK_PARAM_VM_OP_PAIRS_DEFAULT, ck_param_int );
     initParam( CHUCK_PARAM_OTF_ENABLE, CHUCK_PARAM_OTF_ENABLE_DEFAULT, ck_param_int );
     initParam( CHUCK_PARAM_OTF_PORT, CHUCK_PARAM_OTF_PORT_DEFAULT, ck_param_int );
     initParam( CHUCK_PARAM_OTF_PRINT_WARNINGS, CHUCK_PARAM_OTF_PRINT_WARNINGS_DEFAULT, ck_param_int );
@@ -202,6 +211,7 @@ void ChucK::initDefaultParams()
     initParam( CHUCK_PARAM_CHUGIN_ENABLE, CHUCK_PARAM_CHUGIN_ENABLE_DEFAULT, ck_param_int );
     initParam( CHUCK_PARAM_IS_REALTIME_AUDIO_HINT, CHUCK_PARAM_IS_REALTIME_AUDIO_HINT_DEFAULT, ck_param_int );
     initParam( CHUCK_PARAM_COMPILER_HIGHLIGHT_ON_ERROR, CHUCK_PARAM_COMPILER_HIGHLIGHT_ON_ERROR_DEFAULT, ck_param_int );
+    initParam( CHUCK_PARAM_COMPILER_CODE_CACHE, CHUCK_PARAM_COMPILER_CODE_CACHE_DEFAULT, ck_param_int );
     initParam( CHUCK_PARAM_TTY_COLOR, CHUCK_PARAM_TTY_COLOR_DEFAULT, ck_param_int );
     initParam( CHUCK_PARAM_TTY_WIDTH_HINT, CHUCK_PARAM_TTY_WIDTH_HINT_DEFAULT, ck_param_int );
 
@@ -285,6 +295,21 @@ void ChucK::enactParam( const std::string & name, t_CKINT value )
         // (NOTE: this could be pre-initialization, so need to check VM pointer)
         if( vm() ) vm()->update_srate( value );
     }
+    else if( matchParam(name,CHUCK_PARAM_VM_BLOCK_SHREDULE) )
+    {
+        // can be toggled while running (NOTE: pre-initialization, see initVM())
+        if( vm() && vm()->shreduler() ) vm()->shreduler()->set_block_shreduling( value != 0 );
+    }
+    else if( matchParam(name,CHUCK_PARAM_VM_UGEN_SCHEDULE) )
+    {
+        // can be toggled while running (NOTE: pre-initialization, see initVM())
+        if( vm() && vm()->shreduler() ) vm()->shreduler()->set_ugen_schedule( value != 0 );
+    }
+    else if( matchParam(name,CHUCK_PARAM_VM_UGEN_THREADS) )
+    {
+        // can be changed while running; the audio thread resizes the pool
+        if( vm() && vm()->shreduler() ) vm()->shreduler()->set_ugen_threads( value > 0 ? value : 0 );
+    }
     if( matchParam(name,CHUCK_PARAM_TTY_COLOR) )
     {
         // set the global override switch
@@ -555,6 +580,10 @@ t_CKBOOL ChucK::initVM()
     t_CKUINT ins = getParamInt( CHUCK_PARAM_INPUT_CHANNELS );
     t_CKUINT adaptiveSize = getParamInt( CHUCK_PARAM_VM_ADAPTIVE );
     t_CKBOOL halt = getParamInt( CHUCK_PARAM_VM_HALT ) != 0;
+    t_CKBOOL blockShredule = getParamInt( CHUCK_PARAM_VM_BLOCK_SHREDULE ) != 0;
+    t_CKBOOL ugenSchedule = getParamInt( CHUCK_PARAM_VM_UGEN_SCHEDULE ) != 0;
+    t_CKINT ugenThreads = getParamInt( CHUCK_PARAM_VM_UGEN_THREADS );
+    t_CKBOOL opPairs = getParamInt( CHUCK_PARAM_VM_OP_PAIRS ) != 0;
 
     // instantiate VM
     m_carrier->vm = new Chuck_VM();
@@ -568,6 +597,14 @@ t_CKBOOL ChucK::initVM()
         EM_error2( 0, "%s", m_carrier->vm->last_error() );
         return false;
     }
+    // block-rate shreduling
+    m_carrier->vm->shreduler()->set_block_shreduling( blockShredule );
+    // flattened UGen graph schedule
+    m_carrier->vm->shreduler()->set_ugen_schedule( ugenSchedule );
+    // worker threads for independent voices
+    m_carrier->vm->shreduler()->set_ugen_threads( ugenThreads > 0 ? ugenThreads : 0 );
+    // instruction pair counts (only before any shred runs)
+    m_carrier->vm->set_op_pairs( opPairs );
 
     return true;
 }
@@ -585,6 +622,7 @@ t_CKBOOL ChucK::initCompiler()
     t_CKBOOL dump = getParamInt( CHUCK_PARAM_DUMP_INSTRUCTIONS ) != 0;
     t_CKBOOL auto_depend = getParamInt( CHUCK_PARAM_AUTO_DEPEND ) != 0;
     t_CKUINT deprecate = getParamInt( CHUCK_PARAM_DEPRECATE_LEVEL );
+    t_CKINT codeCache = getParamInt( CHUCK_PARAM_COMPILER_CODE_CACHE );
     std::string workingDir = getParamString( CHUCK_PARAM_WORKING_DIRECTORY );
 
     // log
@@ -609,6 +647,8 @@ t_CKBOOL ChucK::initCompiler()
     m_carrier->compiler->setAutoDepend( auto_depend );
     // set deprecation level
     m_carrier->env->deprecate_level = deprecate;
+    // set how many compiled programs to keep for reuse (0 to disable)
+    m_carrier->compiler->setCodeCacheSize( codeCache > 0 ? codeCache : 0 );
 
     // pop indent for compiler
     EM_poplog();
@@ -89,6 +89,10 @@
 #define CHUCK_PARAM_OUTPUT_CHANNELS             "OUTPUT_CHANNELS"
 #define CHUCK_PARAM_VM_ADAPTIVE                 "VM_ADAPTIVE"
 #define CHUCK_PARAM_VM_HALT                     "VM_HALT"
+#define CHUCK_PARAM_VM_BLOCK_SHREDULE           "VM_BLOCK_SHREDULE"
+#define CHUCK_PARAM_VM_UGEN_SCHEDULE            "VM_UGEN_SCHEDULE"
+#define CHUCK_PARAM_VM_UGEN_THREADS             "VM_UGEN_THREADS"
+#define CHUCK_PARAM_VM_OP_PAIRS                 "VM_OP_PAIRS"
 #define CHUCK_PARAM_OTF_ENABLE                  "OTF_ENABLE"
 #define CHUCK_PARAM_OTF_PORT                    "OTF_PORT"
 #define CHUCK_PARAM_OTF_PRINT_WARNINGS          "OTF_PRINT_WARNINGS"
@@ -98,6 +102,7 @@
 #define CHUCK_PARAM_WORKING_DIRECTORY           "WORKING_DIRECTORY"
 #define CHUCK_PARAM_IS_REALTIME_AUDIO_HINT      "IS_REALTIME_AUDIO_HINT"
 #define CHUCK_PARAM_COMPILER_HIGHLIGHT_ON_ERROR "COMPILER_HIGHLIGHT_ON_ERROR"
+#define CHUCK_PARAM_COMPILER_CODE_CACHE         "COMPILER_CODE_CACHE"
 #define CHUCK_PARAM_TTY_COLOR                   "TTY_COLOR"
 #define CHUCK_PARAM_TTY_WIDTH_HINT              "TTY_WIDTH_HINT"
 // chugin-relate param names
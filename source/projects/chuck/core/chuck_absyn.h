@@ -404,6 +404,8 @@ typedef enum { ae_exp_binary = 0, ae_exp_unary, ae_exp_cast, ae_exp_postfix,
              } ae_Exp_Type;
 // type meta data
 typedef enum { ae_meta_value = 0, ae_meta_var } ae_Exp_Meta;
+// compile-time constant kind (set by type checker when an exp folds)
+typedef enum { ae_const_none = 0, ae_const_int, ae_const_float } ae_Exp_Const;
 
 struct a_Exp_
 {
@@ -422,6 +424,11 @@ struct a_Exp_
     // #2024-func-call-update
     t_CKBOOL emit_as_funccall;
 
+    // compile-time constant value, if this exp folds to one; the emitter
+    // then pushes the value instead of evaluating the exp
+    ae_Exp_Const cval_kind;
+    union { t_CKINT cval_num; t_CKFLOAT cval_fnum; };
+
     union
     {
         struct a_Exp_Binary_ binary;
@@ -68,6 +68,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <functional>
 #include <set>
 using namespace std;
 
@@ -104,6 +105,8 @@ Chuck_Compiler::Chuck_Compiler()
 
     // origin hint | 1.5.0.0 (ge) added
     m_originHint = ckte_origin_UNKNOWN;
+    // code cache (off until set)
+    m_codeCacheSize = 0;
 }
 
 
@@ -180,6 +183,9 @@ void Chuck_Compiler::shutdown()
     // push indent
     EM_pushlog();
 
+    // release cached code
+    clearCodeCache();
+
     // free emitter (and set emitter to NULL)
     emit_engine_shutdown( emitter );
     // check the pointer is now NULL
@@ -385,6 +391,17 @@ t_CKBOOL Chuck_Compiler::compile( Chuck_CompileTarget * target )
     std::vector<ImportTargetNode *> problems;
     // local import target node
     ImportTargetNode node( target, 0, 0 );
+    // source and its hash, for the code cache
+    string cacheSource; t_CKUINT cacheHash = 0;
+    t_CKBOOL cacheable = code_cache_key( target, cacheSource, cacheHash );
+
+    // same source compiled before; reuse its code
+    if( cacheable && code_cache_lookup( target, cacheSource, cacheHash ) )
+    {
+        // compile() memory-manages target
+        CK_SAFE_DELETE( target );
+        return TRUE;
+    }
 
     // set the chuck
     target->the_chuck = this->carrier()->chuck;
@@ -462,6 +479,9 @@ t_CKBOOL Chuck_Compiler::compile( Chuck_CompileTarget * target )
         }
     }
 
+    // remember the code for next time (AST is still around to be checked)
+    if( cacheable ) code_cache_insert( target, cacheSource, cacheHash );
+
 cleanup:
     // 1.4.1.0 (ge) | added to unset the fileName reference, which determines
     // how messages print to console (e.g., [file.ck]: or [chuck]:)
@@ -478,6 +498,153 @@ cleanup:
 
 
 
+//-----------------------------------------------------------------------------
+// name: setCodeCacheSize()
+// desc: set max number of compiled programs to keep; 0 disables the cache
+//-----------------------------------------------------------------------------
+void Chuck_Compiler::setCodeCacheSize( t_CKUINT size )
+{
+    // set
+    m_codeCacheSize = size;
+    // evict down to size
+    while( m_codeCacheOrder.size() > m_codeCacheSize )
+    {
+        // oldest first
+        std::map<t_CKUINT, Chuck_CodeCacheEntry>::iterator it = m_codeCache.find( m_codeCacheOrder.front() );
+        if( it != m_codeCache.end() )
+        {
+            CK_SAFE_RELEASE( it->second.code );
+            m_codeCache.erase( it );
+        }
+        m_codeCacheOrder.pop_front();
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: clearCodeCache()
+// desc: release all cached code
+//-----------------------------------------------------------------------------
+void Chuck_Compiler::clearCodeCache()
+{
+    // release each
+    std::map<t_CKUINT, Chuck_CodeCacheEntry>::iterator it;
+    for( it = m_codeCache.begin(); it != m_codeCache.end(); it++ )
+        CK_SAFE_RELEASE( it->second.code );
+    // clear
+    m_codeCache.clear();
+    m_codeCacheOrder.clear();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: code_cache_key()
+// desc: get source and hash for a target; FALSE if target cannot be cached
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_Compiler::code_cache_key( Chuck_CompileTarget * target,
+                                         string & source, t_CKUINT & hash )
+{
+    // only whole programs (imports are already kept by the import registry);
+    // not when dumping instructions, which happens during emit
+    if( !m_codeCacheSize || target->howMuch != te_do_all || (emitter && emitter->dump) )
+        return FALSE;
+
+    // code literal
+    if( target->codeLiteral != "" )
+    {
+        source = target->codeLiteral;
+    }
+    // file
+    else if( target->fd2parse )
+    {
+        // size of file
+        fseek( target->fd2parse, 0, SEEK_END );
+        long size = ftell( target->fd2parse );
+        fseek( target->fd2parse, 0, SEEK_SET );
+        if( size < 0 ) return FALSE;
+        // read it; the parser seeks to the beginning again
+        source.resize( size );
+        if( size && fread( &source[0], 1, size, target->fd2parse ) != (size_t)size )
+        { fseek( target->fd2parse, 0, SEEK_SET ); return FALSE; }
+        fseek( target->fd2parse, 0, SEEK_SET );
+    }
+    else return FALSE;
+
+    // hash path and source
+    hash = (t_CKUINT)std::hash<string>()( target->absolutePath + '\0' + source );
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: code_cache_lookup()
+// desc: look up code compiled from the same path and source
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_Compiler::code_cache_lookup( Chuck_CompileTarget * target,
+                                            const string & source, t_CKUINT hash )
+{
+    // look up by hash
+    std::map<t_CKUINT, Chuck_CodeCacheEntry>::iterator it = m_codeCache.find( hash );
+    if( it == m_codeCache.end() ) return FALSE;
+    // guard against hash collisions
+    if( it->second.path != target->absolutePath || it->second.source != source ) return FALSE;
+
+    // log
+    EM_log( CK_LOG_FINE, "reusing compiled code for '%s' (source unchanged)...", target->filename.c_str() );
+    // the code, as output()
+    this->code = it->second.code;
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: code_cache_insert()
+// desc: add code compiled from target; targets with classes or operator
+//       overloads are not cached, since compiling them again has effects
+//       beyond the code (e.g., new public types, fresh static data)
+//-----------------------------------------------------------------------------
+void Chuck_Compiler::code_cache_insert( Chuck_CompileTarget * target,
+                                        const string & source, t_CKUINT hash )
+{
+    // check for code and AST
+    if( !this->code || !target->AST ) return;
+
+    // look for definitions
+    for( a_Program prog = target->AST; prog; prog = prog->next )
+    {
+        if( prog->section->s_type == ae_section_class ) return;
+        if( prog->section->s_type == ae_section_func &&
+            prog->section->func_def->op2overload != ae_op_none ) return;
+    }
+
+    // already cached (e.g., a collision we chose not to replace)
+    if( m_codeCache.find( hash ) != m_codeCache.end() ) return;
+
+    // add, holding a reference
+    Chuck_CodeCacheEntry & entry = m_codeCache[hash];
+    entry.path = target->absolutePath;
+    entry.source = source;
+    entry.code = this->code;
+    CK_SAFE_ADD_REF( entry.code );
+    m_codeCacheOrder.push_back( hash );
+
+    // evict oldest if over size
+    setCodeCacheSize( m_codeCacheSize );
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: generate_compile_sequence()
 // desc: produce a compilation sequences of targets from a import dependency graph
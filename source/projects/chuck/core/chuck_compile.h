@@ -234,6 +234,25 @@ protected:
 
 
 
+//-----------------------------------------------------------------------------
+// name: struct Chuck_CodeCacheEntry
+// desc: compiled code for a source, reused when the same source is compiled
+//-----------------------------------------------------------------------------
+struct Chuck_CodeCacheEntry
+{
+    // absolute path of the compiled target
+    std::string path;
+    // the source that was compiled (checked on hash match)
+    std::string source;
+    // the compiled code (the cache holds a reference)
+    Chuck_VM_Code * code;
+
+    Chuck_CodeCacheEntry() : code( NULL ) { }
+};
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: struct Chuck_Compiler
 // desc: the sum of the components in compilation
@@ -275,6 +294,14 @@ public: // data
     // to denote where new entities originate | 1.5.0.0 (ge) added
     ckte_Origin m_originHint;
 
+protected: // code cache
+    // compiled code by hash of path and source
+    std::map<t_CKUINT, Chuck_CodeCacheEntry> m_codeCache;
+    // hashes in order of insertion, for eviction
+    std::list<t_CKUINT> m_codeCacheOrder;
+    // max number of cached entries; 0 disables the cache
+    t_CKUINT m_codeCacheSize;
+
 public: // to all
     // contructor
     Chuck_Compiler();
@@ -297,6 +324,12 @@ public: // compile from file or code
     // get the code generated from the last compile()
     Chuck_VM_Code * output();
 
+public: // code cache
+    // set max number of compiled programs to keep; 0 disables (and clears) the cache
+    void setCodeCacheSize( t_CKUINT size );
+    // release all cached code (e.g., when the VM is cleared)
+    void clearCodeCache();
+
 public: // import while observing semantics of chuck @import
     // import a .ck module by file path
     t_CKBOOL importFile( const std::string & filename );
@@ -396,6 +429,14 @@ protected: // internal
     // all except import
     t_CKBOOL compile_all_except_import( Chuck_Context * context );
 
+protected: // code cache
+    // get source and hash for a target; FALSE if target cannot be cached
+    t_CKBOOL code_cache_key( Chuck_CompileTarget * target, std::string & source, t_CKUINT & hash );
+    // look up code compiled from the same path and source; sets `code` on hit
+    t_CKBOOL code_cache_lookup( Chuck_CompileTarget * target, const std::string & source, t_CKUINT hash );
+    // add code compiled from target, if the target has no public definitions
+    void code_cache_insert( Chuck_CompileTarget * target, const std::string & source, t_CKUINT hash );
+
 protected: // import
     // scan for @import statements; builds a list of dependencies in the target
     t_CKBOOL scan_imports( Chuck_CompileTarget * target );
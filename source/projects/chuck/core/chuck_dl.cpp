@@ -742,6 +742,45 @@ void CK_DLL_CALL ck_add_ugen_funcf( Chuck_DL_Query * query, f_tickf ugen_tickf,
 
 
 
+//-----------------------------------------------------------------------------
+// name: ck_add_ugen_funcv()
+// desc: (ugen only) add block tick function; the per-sample tick added by
+//       add_ugen_func() is still required, and used when not ticking blocks
+//-----------------------------------------------------------------------------
+void CK_DLL_CALL ck_add_ugen_funcv( Chuck_DL_Query * query, f_tickv ugen_tickv )
+{
+    // make sure there is class
+    if( !query->curr_class )
+    {
+        // error
+        EM_error2( 0, "class import: add_ugen_funcv invoked without begin_class..." );
+        return;
+    }
+
+    // make sure there is a per-sample tick to fall back on
+    if( !query->curr_class->ugen_tick )
+    {
+        // error
+        EM_error2( 0, "class import: add_ugen_funcv invoked without add_ugen_func..." );
+        return;
+    }
+
+    // make sure tickv not defined already
+    if( query->curr_class->ugen_tickv && ugen_tickv )
+    {
+        // error
+        EM_error2( 0, "class import: ugen_tickv already defined..." );
+        return;
+    }
+
+    // set
+    if( ugen_tickv ) query->curr_class->ugen_tickv = ugen_tickv;
+    query->curr_func = NULL;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: ck_add_ugen_funcf_auto_num_channels()
 // desc: (ugen only) add tick and pmsg functions. specify num channels by vm.
@@ -1395,11 +1434,12 @@ t_CKBOOL Chuck_DLL::compatible()
 {
     // probe dll
     if( !this->probe() ) return FALSE;
-    // major AND minor version must match | 1.5.2.0 (ge)
-    //   (was: major version must be same between chugin and host, and
-    //   chugin minor version must less than or equal host minor version)
+    // major version must be the same between chugin and host, and chugin
+    // minor version must be <= host minor version, as in query(); minor
+    // revisions only append to Chuck_DL_Query | DL API 10.3
+    //   (was: major AND minor version must match | 1.5.2.0 (ge))
     if( m_apiVersionMajor == CK_DLL_VERSION_MAJOR &&
-        m_apiVersionMinor == CK_DLL_VERSION_MINOR ) return TRUE;
+        m_apiVersionMinor <= CK_DLL_VERSION_MINOR ) return TRUE;
 
     // error string
     m_last_error = string("incompatible API version: chugin (")
@@ -1451,6 +1491,7 @@ Chuck_DL_Query::Chuck_DL_Query( Chuck_Carrier * carrier, Chuck_DLL * dll )
     unregister_shreds_watcher = ck_unregister_shreds_watcher; // 1.5.1.5 (ge & andrew)
     register_callback_on_shutdown = ck_register_callback_on_shutdown; // 1.5.2.5 (ge)
     register_callback_on_srate_update = ck_register_callback_on_srate_update; // 1.5.4.2 (ge)
+    add_ugen_funcv = ck_add_ugen_funcv; // DL API 10.3
     m_carrier = carrier;
     dll_ref = dll; // 1.5.1.3 (ge) added
 
@@ -375,6 +375,8 @@ Chuck_VM_Code * emit_to_code( Chuck_Code * in,
     // copy
     for( t_CKUINT i = 0; i < code->num_instr; i++ )
         code->instr[i] = in->code[i];
+    // lower for the shred run loop
+    code->lower();
 
     // dump
     if( dump )
@@ -731,7 +733,8 @@ t_CKBOOL emit_engine_emit_stmt( Chuck_Emitter * emit, a_Stmt stmt, t_CKBOOL pop
     }
 
     // see if need to add closing
-    if( codestr_close != "" && nextIndex < emit->next_index()-1 )
+    // (nextIndex+1 so a statement that emitted nothing at index 0 never underflows)
+    if( codestr_close != "" && nextIndex+1 < emit->next_index() )
     {
         // APPPEND closing
         emit->code->code[emit->next_index()-1]->append_codestr( codestr_close );
@@ -755,6 +758,22 @@ t_CKBOOL emit_engine_emit_stmt( Chuck_Emitter * emit, a_Stmt stmt, t_CKBOOL pop
 
 
 
+//-----------------------------------------------------------------------------
+// name: emit_engine_is_const_cond() / emit_engine_const_cond_true()
+// desc: whether a condition was folded to a constant, and its truth value
+//-----------------------------------------------------------------------------
+static t_CKBOOL emit_engine_is_const_cond( a_Exp cond )
+{
+    return cond->cval_kind != ae_const_none && !cond->next && !cond->cast_to;
+}
+static t_CKBOOL emit_engine_const_cond_true( a_Exp cond )
+{
+    return cond->cval_kind == ae_const_int ? cond->cval_num != 0 : cond->cval_fnum != 0;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: emit_engine_emit_if()
 // desc: ...
@@ -767,6 +786,24 @@ t_CKBOOL emit_engine_emit_if( Chuck_Emitter * emit, a_Stmt_If stmt )
     // push the stack, allowing for new local variables
     emit->push_scope();
 
+    // compile-time constant condition; emit only the branch that is taken
+    if( emit_engine_is_const_cond( stmt->cond ) )
+    {
+        // push the stack, allowing for new local variables
+        emit->push_scope();
+        // emit the body
+        ret = emit_engine_emit_stmt( emit, emit_engine_const_cond_true( stmt->cond )
+                                           ? stmt->if_body : stmt->else_body );
+        if( !ret )
+            return FALSE;
+        // pop stack
+        emit->pop_scope();
+        // pop stack
+        emit->pop_scope();
+
+        return ret;
+    }
+
     // emit the condition
     ret = emit_engine_emit_exp( emit, stmt->cond, FALSE, stmt->self );
     if( !ret )
@@ -1234,6 +1271,11 @@ t_CKBOOL emit_engine_emit_while( Chuck_Emitter * emit, a_Stmt_While stmt )
     // codestr prefix for better description | 1.5.0.8
     string codestr_prefix = "/** loop conditional **/";
 
+    // compile-time constant false condition; the body can never run
+    if( emit_engine_is_const_cond( stmt->cond ) &&
+        !emit_engine_const_cond_true( stmt->cond ) )
+        return TRUE;
+
     // push stack
     emit->push_scope();
 
@@ -1927,8 +1969,16 @@ t_CKBOOL emit_engine_emit_exp( Chuck_Emitter * emit, a_Exp exp, t_CKBOOL doAddRe
     // loop over
     while( exp )
     {
+        // compile-time constant (folded by the type checker); push as immediate
+        if( exp->cval_kind != ae_const_none && !exp->emit_var )
+        {
+            if( exp->cval_kind == ae_const_int )
+                emit->append( new Chuck_Instr_Reg_Push_Imm( exp->cval_num ) );
+            else
+                emit->append( new Chuck_Instr_Reg_Push_Imm2( exp->cval_fnum ) );
+        }
         // check expression format
-        switch( exp->s_type )
+        else switch( exp->s_type )
         {
         case ae_exp_binary:
             if( !emit_engine_emit_exp_binary( emit, &exp->binary ) )
@@ -5002,6 +5052,13 @@ t_CKBOOL emit_engine_emit_exp_if( Chuck_Emitter * emit, a_Exp_If exp_if )
     t_CKBOOL ret = TRUE;
     Chuck_Instr_Branch_Op * op = NULL, * op2 = NULL;
 
+    // compile-time constant condition; emit only the exp that is selected
+    if( emit_engine_is_const_cond( exp_if->cond ) )
+    {
+        return emit_engine_emit_exp( emit, emit_engine_const_cond_true( exp_if->cond )
+                                           ? exp_if->if_exp : exp_if->else_exp );
+    }
+
     // push the stack, allowing for new local variables
     emit->push_scope();
 
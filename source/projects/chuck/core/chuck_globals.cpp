@@ -34,6 +34,8 @@
 #include "chuck_globals.h"
 #include "chuck_vm.h"
 #include "chuck_instr.h"
+#include <atomic>
+#include <mutex>
 using namespace std;
 
 
@@ -564,6 +566,75 @@ struct Chuck_Global_Object_Container
 
 
 
+//-----------------------------------------------------------------------------
+// name: struct Chuck_Global_Slot
+// desc: a global int or float, resolved to a handle
+//-----------------------------------------------------------------------------
+struct Chuck_Global_Slot
+{
+    // set before the slot is published, then read-only
+    std::string name;
+    te_GlobalType type;
+    // latest value set by handle
+    std::atomic<t_CKINT> ival;
+    std::atomic<t_CKFLOAT> fval;
+    // audio thread only: the variable's storage, once looked up
+    void * ptr;
+
+    // constructor
+    Chuck_Global_Slot( const std::string & n, te_GlobalType t )
+    : name(n), type(t), ival(0), fval(0), ptr(NULL) { }
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_Global_Slots
+// desc: handle table, plus a two-level bitmap of slots set since the audio
+//       thread last looked; setters only ever set bits (fetch_or), so any
+//       number of threads may set, and the audio thread only ever clears
+//       them (exchange), so nothing is missed and nothing waits
+//-----------------------------------------------------------------------------
+#define CK_GLOBAL_SLOT_WORDS 64
+#define CK_GLOBAL_SLOTS_MAX (CK_GLOBAL_SLOT_WORDS * 64)
+struct Chuck_Global_Slots
+{
+    // the slots; published in order, never moved or freed until the end
+    std::atomic<Chuck_Global_Slot *> slot[CK_GLOBAL_SLOTS_MAX];
+    std::atomic<t_CKINT> count;
+    // bit i of dirty[w]: slot w*64+i was set
+    std::atomic<uint64_t> dirty[CK_GLOBAL_SLOT_WORDS];
+    // bit w: dirty[w] may be non-zero
+    std::atomic<uint64_t> summary;
+    // host side: name to handle, for resolving
+    std::mutex mutex;
+    std::map<std::string, t_CKINT> handles;
+
+    // constructor
+    Chuck_Global_Slots() : count(0), summary(0)
+    {
+        for( t_CKINT i = 0; i < CK_GLOBAL_SLOTS_MAX; i++ ) slot[i] = NULL;
+        for( t_CKINT i = 0; i < CK_GLOBAL_SLOT_WORDS; i++ ) dirty[i] = 0;
+    }
+
+    // destructor
+    ~Chuck_Global_Slots()
+    {
+        for( t_CKINT i = 0; i < count; i++ ) delete slot[i].load();
+    }
+
+    // mark a slot as set
+    void mark( t_CKINT handle )
+    {
+        dirty[handle / 64].fetch_or( (uint64_t)1 << (handle % 64), std::memory_order_release );
+        summary.fetch_or( (uint64_t)1 << (handle / 64), std::memory_order_release );
+    }
+};
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: Chuck_Globals_Manager()
 // desc: constructor: size queues appropriately
@@ -576,6 +647,9 @@ Chuck_Globals_Manager::Chuck_Globals_Manager( Chuck_VM * vm )
     // REFACTOR-2017: TODO might want to dynamically grow queue?
     m_global_request_queue.init( 16384 );
     m_global_request_retry_queue.init( 16384 );
+
+    // handle table
+    m_slots = new Chuck_Global_Slots;
 }
 
 
@@ -588,6 +662,7 @@ Chuck_Globals_Manager::Chuck_Globals_Manager( Chuck_VM * vm )
 Chuck_Globals_Manager::~Chuck_Globals_Manager()
 {
     cleanup_global_variables();
+    CK_SAFE_DELETE( m_slots );
 }
 
 
@@ -718,6 +793,39 @@ t_CKBOOL Chuck_Globals_Manager::setGlobalInt( const char * name, t_CKINT val )
 
 
 
+//-----------------------------------------------------------------------------
+// name: resolveGlobalInt()
+// desc: get a handle for setting a global int
+//-----------------------------------------------------------------------------
+t_CKINT Chuck_Globals_Manager::resolveGlobalInt( const char * name )
+{
+    return resolve_global_slot( name, te_globalInt );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: setGlobalIntHandle()
+// desc: set a global int by handle
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_Globals_Manager::setGlobalIntHandle( t_CKINT handle, t_CKINT val )
+{
+    // check handle
+    if( handle < 0 || handle >= m_slots->count.load( std::memory_order_acquire ) ) return FALSE;
+    Chuck_Global_Slot * slot = m_slots->slot[handle].load( std::memory_order_acquire );
+    if( slot->type != te_globalInt ) return FALSE;
+
+    // store, then flag for the audio thread
+    slot->ival.store( val, std::memory_order_relaxed );
+    m_slots->mark( handle );
+
+    return TRUE;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: init_global_int()
 // desc: tell the vm that a global int is now available
@@ -862,6 +970,103 @@ t_CKBOOL Chuck_Globals_Manager::setGlobalFloat( const char * name,
 
 
 
+//-----------------------------------------------------------------------------
+// name: resolveGlobalFloat()
+// desc: get a handle for setting a global float
+//-----------------------------------------------------------------------------
+t_CKINT Chuck_Globals_Manager::resolveGlobalFloat( const char * name )
+{
+    return resolve_global_slot( name, te_globalFloat );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: setGlobalFloatHandle()
+// desc: set a global float by handle
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_Globals_Manager::setGlobalFloatHandle( t_CKINT handle, t_CKFLOAT val )
+{
+    // check handle
+    if( handle < 0 || handle >= m_slots->count.load( std::memory_order_acquire ) ) return FALSE;
+    Chuck_Global_Slot * slot = m_slots->slot[handle].load( std::memory_order_acquire );
+    if( slot->type != te_globalFloat ) return FALSE;
+
+    // store, then flag for the audio thread
+    slot->fval.store( val, std::memory_order_relaxed );
+    m_slots->mark( handle );
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: resolve_global_slot()
+// desc: find or make the slot for a name and type; outside the audio thread
+//-----------------------------------------------------------------------------
+t_CKINT Chuck_Globals_Manager::resolve_global_slot( const char * name, te_GlobalType type )
+{
+    std::lock_guard<std::mutex> lock( m_slots->mutex );
+
+    // already resolved?
+    std::string key = std::string( type == te_globalInt ? "int " : "float " ) + name;
+    std::map<std::string, t_CKINT>::iterator it = m_slots->handles.find( key );
+    if( it != m_slots->handles.end() ) return it->second;
+
+    // out of slots
+    t_CKINT handle = m_slots->count.load( std::memory_order_relaxed );
+    if( handle >= CK_GLOBAL_SLOTS_MAX ) return -1;
+
+    // publish the slot, then the count
+    m_slots->slot[handle].store( new Chuck_Global_Slot( name, type ), std::memory_order_release );
+    m_slots->count.store( handle + 1, std::memory_order_release );
+    m_slots->handles[key] = handle;
+
+    return handle;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: handle_global_slots()
+// desc: apply values set by handle (audio thread); a slot's variable is
+//       looked up by name only the first time it is set
+//-----------------------------------------------------------------------------
+void Chuck_Globals_Manager::handle_global_slots()
+{
+    // nothing set: one atomic load
+    if( m_slots->summary.load( std::memory_order_relaxed ) == 0 ) return;
+
+    uint64_t words = m_slots->summary.exchange( 0, std::memory_order_acquire );
+    for( t_CKINT w = 0; words; w++, words >>= 1 )
+    {
+        if( !(words & 1) ) continue;
+        uint64_t bits = m_slots->dirty[w].exchange( 0, std::memory_order_acquire );
+        for( t_CKINT b = 0; bits; b++, bits >>= 1 )
+        {
+            if( !(bits & 1) ) continue;
+            Chuck_Global_Slot * slot = m_slots->slot[w*64 + b].load( std::memory_order_acquire );
+            if( slot->type == te_globalInt )
+            {
+                if( !slot->ptr ) { init_global_int( slot->name ); slot->ptr = &m_global_ints[slot->name]->val; }
+                *(t_CKINT *)slot->ptr = slot->ival.load( std::memory_order_relaxed );
+            }
+            else
+            {
+                if( !slot->ptr ) { init_global_float( slot->name ); slot->ptr = &m_global_floats[slot->name]->val; }
+                *(t_CKFLOAT *)slot->ptr = slot->fval.load( std::memory_order_relaxed );
+            }
+        }
+    }
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: init_global_float()
 // desc: tell the vm that a global float is now available
@@ -2779,6 +2984,11 @@ void Chuck_Globals_Manager::global_ctor_was_called( const std::string & name,
 //-----------------------------------------------------------------------------
 void Chuck_Globals_Manager::cleanup_global_variables()
 {
+    // handles: forget their variables' storage (looked up again when set)
+    t_CKINT numSlots = m_slots ? m_slots->count.load( std::memory_order_acquire ) : 0;
+    for( t_CKINT i = 0; i < numSlots; i++ )
+        m_slots->slot[i].load( std::memory_order_acquire )->ptr = NULL;
+
     // ints: delete containers and clear map
     for( std::map< std::string, Chuck_Global_Int_Container * >::iterator it=
         m_global_ints.begin(); it!=m_global_ints.end(); it++ )
@@ -2855,6 +3065,9 @@ void Chuck_Globals_Manager::handle_global_queue_messages()
 {
     bool should_retry_this_request = false;
 
+    // values set by handle first; they don't go through the queue
+    handle_global_slots();
+
     while( m_global_request_queue.more() )
     {
         should_retry_this_request = false;
@@ -87,6 +87,8 @@ struct Chuck_Global_Event_Container;
 struct Chuck_Global_UGen_Container;
 struct Chuck_Global_Array_Container;
 struct Chuck_Global_Object_Container;
+// handle-based access
+struct Chuck_Global_Slots;
 
 
 
@@ -277,6 +279,17 @@ public:
     t_CKBOOL getAllGlobalVariables( void (*callback)( const std::vector<Chuck_Globals_TypeValue> & list, void * data ),
                                     void * data = NULL );
 
+    // handle-based access to global ints and floats, for hosts that set the
+    // same globals often: resolve a name to a handle once (may lock and
+    // allocate), then set by handle (lock-free, allocation-free, no string
+    // lookups on the audio thread); if set again before the audio thread
+    // gets to it, only the latest value is applied. handles stay valid for
+    // the lifetime of the VM; returns -1 when out of handles
+    t_CKINT resolveGlobalInt( const char * name );
+    t_CKINT resolveGlobalFloat( const char * name );
+    t_CKBOOL setGlobalIntHandle( t_CKINT handle, t_CKINT val );
+    t_CKBOOL setGlobalFloatHandle( t_CKINT handle, t_CKFLOAT val );
+
 public:
     // run Chuck_Msg in the globals order
     t_CKBOOL execute_chuck_msg_with_globals( Chuck_Msg* msg );
@@ -345,6 +358,11 @@ public: // these should ever ONLY be called from within the VM
     void handle_global_queue_messages();
 
 private:
+    // resolve a handle for a name and type
+    t_CKINT resolve_global_slot( const char * name, te_GlobalType type );
+    // apply values set by handle since last time
+    void handle_global_slots();
+
     // ptr to my vm
     Chuck_VM * m_vm;
 
@@ -367,6 +385,9 @@ private:
     // this is ok because the external host has no guarantee of sample-level
     // determinism, like we have within the ChucK VM
     FinalRingBuffer< Chuck_Global_Request > m_global_request_retry_queue;
+
+    // handle-based access: slots and their dirty bits
+    Chuck_Global_Slots * m_slots;
 };
 
 
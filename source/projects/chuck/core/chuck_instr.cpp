@@ -4519,6 +4519,9 @@ t_CKBOOL initialize_object( Chuck_Object * object, Chuck_Type * type, Chuck_VM_S
         if( type->ugen_info->tick ) ugen->tick = type->ugen_info->tick;
         // added 1.3.0.0 -- tickf for multi-channel tick
         if( type->ugen_info->tickf ) ugen->tickf = type->ugen_info->tickf;
+        // block tick for mono ugens, alongside tick (DL API 10.3)
+        if( type->ugen_info->tickv ) ugen->tickv = type->ugen_info->tickv;
+        ugen->m_tick_isolated = type->ugen_info->isolated;
         if( type->ugen_info->pmsg ) ugen->pmsg = type->ugen_info->pmsg;
         // TODO: another hack!
         if( type->ugen_info->tock ) ((Chuck_UAna *)ugen)->tock = type->ugen_info->tock;
@@ -7283,14 +7286,14 @@ void Chuck_Instr_Array_Map_Access::execute( Chuck_VM * vm, Chuck_VM_Shred * shre
         // check if writing
         if( m_emit_addr ) {
             // get the addr
-            val = arr->addr( key->str() );
+            val = arr->map_addr( key );
             // exception
             if( !val ) goto error;
             // push the addr
             push_( sp, val );
         } else {
             // get the value
-            arr->get( key->str(), &val );
+            arr->map_get( key, &val );
             // push the value
             push_( sp, val );
         }
@@ -7304,14 +7307,14 @@ void Chuck_Instr_Array_Map_Access::execute( Chuck_VM * vm, Chuck_VM_Shred * shre
         // check if writing
         if( m_emit_addr ) {
             // get the addr
-            val = arr->addr( key->str() );
+            val = arr->map_addr( key );
             // exception
             if( !val ) goto error;
             // push the addr
             push_( sp, val );
         } else {
             // get the value
-            arr->get( key->str(), &fval );
+            arr->map_get( key, &fval );
             // push the value
             push_( ((t_CKFLOAT *&)sp), fval );
         }
@@ -7325,14 +7328,14 @@ void Chuck_Instr_Array_Map_Access::execute( Chuck_VM * vm, Chuck_VM_Shred * shre
         // check if writing
         if( m_emit_addr ) {
             // get the addr
-            val = arr->addr( key->str() );
+            val = arr->map_addr( key );
             // exception
             if( !val ) goto error;
             // push the addr
             push_( sp, val );
         } else {
             // get the value
-            arr->get( key->str(), &v2 );
+            arr->map_get( key, &v2 );
             // push the value
             push_( ((t_CKVEC2 *&)sp), v2 );
         }
@@ -7346,14 +7349,14 @@ void Chuck_Instr_Array_Map_Access::execute( Chuck_VM * vm, Chuck_VM_Shred * shre
         // check if writing
         if( m_emit_addr ) {
             // get the addr
-            val = arr->addr( key->str() );
+            val = arr->map_addr( key );
             // exception
             if( !val ) goto error;
             // push the addr
             push_( sp, val );
         } else {
             // get the value
-            arr->get( key->str(), &v3 );
+            arr->map_get( key, &v3 );
             // push the value
             push_( ((t_CKVEC3 *&)sp), v3 );
         }
@@ -7367,14 +7370,14 @@ void Chuck_Instr_Array_Map_Access::execute( Chuck_VM * vm, Chuck_VM_Shred * shre
         // check if writing
         if( m_emit_addr ) {
             // get the addr
-            val = arr->addr( key->str() );
+            val = arr->map_addr( key );
             // exception
             if( !val ) goto error;
             // push the addr
             push_( sp, val );
         } else {
             // get the value
-            arr->get( key->str(), &v4 );
+            arr->map_get( key, &v4 );
             // push the value
             push_( ((t_CKVEC4 *&)sp), v4 );
         }
@@ -7447,7 +7450,7 @@ void Chuck_Instr_Array_Access_Multi::execute( Chuck_VM * vm, Chuck_VM_Shred * sh
             // get index
             Chuck_String * key = (Chuck_String *)(i);
             // get the array
-            if( !base->get( key->str(), &val ) )
+            if( !base->map_get( key, &val ) )
                 goto array_out_of_bound;
         }
         else
@@ -9909,3 +9912,210 @@ void ck_throw_exception( Chuck_VM_Shred * shred, const char * name, const char *
     shred->is_running = FALSE;
     shred->is_done = TRUE;
 }
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ck_lower_instr()
+// desc: lower an instruction array to compact ops; matches exact classes
+//       only, so subclasses with different behavior stay CK_OP_INSTR
+//-----------------------------------------------------------------------------
+Chuck_VM_Op * ck_lower_instr( Chuck_Instr ** instr, t_CKUINT num_instr )
+{
+#ifdef __CHUNREAL_ENGINE__
+    // no run time type information; execute everything as instructions
+    return NULL;
+#else
+
+    Chuck_VM_Op * ops = new Chuck_VM_Op[num_instr];
+
+    for( t_CKUINT i = 0; i < num_instr; i++ )
+    {
+        Chuck_Instr * in = instr[i];
+        const std::type_info & t = typeid(*in);
+        Chuck_VM_Op & op = ops[i];
+        op.op = CK_OP_INSTR;
+        op.uval = 0;
+        op.uval2 = 0;
+        op.instr = in;
+
+        // operand-carrying instructions
+        if( t == typeid(Chuck_Instr_Reg_Push_Imm) )
+        { op.op = CK_OP_REG_PUSH_IMM; op.uval = ((Chuck_Instr_Reg_Push_Imm *)in)->get(); }
+        else if( t == typeid(Chuck_Instr_Reg_Push_Imm2) )
+        { op.op = CK_OP_REG_PUSH_IMM2; op.fval = ((Chuck_Instr_Reg_Push_Imm2 *)in)->get(); }
+        else if( t == typeid(Chuck_Instr_Reg_Push_Mem) )
+        {
+            Chuck_Instr_Reg_Push_Mem * p = (Chuck_Instr_Reg_Push_Mem *)in;
+            op.op = p->use_base() ? CK_OP_REG_PUSH_MEM_BASE : CK_OP_REG_PUSH_MEM; op.uval = p->get();
+        }
+        else if( t == typeid(Chuck_Instr_Reg_Push_Mem2) )
+        {
+            Chuck_Instr_Reg_Push_Mem2 * p = (Chuck_Instr_Reg_Push_Mem2 *)in;
+            op.op = p->use_base() ? CK_OP_REG_PUSH_MEM2_BASE : CK_OP_REG_PUSH_MEM2; op.uval = p->get();
+        }
+        else if( t == typeid(Chuck_Instr_Reg_Push_Mem_Addr) )
+        {
+            Chuck_Instr_Reg_Push_Mem_Addr * p = (Chuck_Instr_Reg_Push_Mem_Addr *)in;
+            op.op = p->use_base() ? CK_OP_REG_PUSH_MEM_ADDR_BASE : CK_OP_REG_PUSH_MEM_ADDR; op.uval = p->get();
+        }
+        else if( t == typeid(Chuck_Instr_Reg_Pop_WordsMulti) )
+        { op.op = CK_OP_REG_POP_WORDS; op.uval = ((Chuck_Instr_Reg_Pop_WordsMulti *)in)->get(); }
+        else if( t == typeid(Chuck_Instr_Branch_Eq_int) )
+        { op.op = CK_OP_BRANCH_EQ_INT; op.uval = ((Chuck_Instr_Branch_Eq_int *)in)->get(); }
+        else if( t == typeid(Chuck_Instr_Branch_Neq_int) )
+        { op.op = CK_OP_BRANCH_NEQ_INT; op.uval = ((Chuck_Instr_Branch_Neq_int *)in)->get(); }
+        else if( t == typeid(Chuck_Instr_Goto) )
+        { op.op = CK_OP_GOTO; op.uval = ((Chuck_Instr_Goto *)in)->get(); }
+        // operand-less instructions
+        else if( t == typeid(Chuck_Instr_Reg_Pop_Int) ) op.op = CK_OP_REG_POP_INT;
+        else if( t == typeid(Chuck_Instr_Reg_Pop_Float) ) op.op = CK_OP_REG_POP_FLOAT;
+        else if( t == typeid(Chuck_Instr_Assign_Primitive) ) op.op = CK_OP_ASSIGN_PRIMITIVE;
+        else if( t == typeid(Chuck_Instr_Assign_Primitive2) ) op.op = CK_OP_ASSIGN_PRIMITIVE2;
+        else if( t == typeid(Chuck_Instr_Add_int) ) op.op = CK_OP_ADD_INT;
+        else if( t == typeid(Chuck_Instr_Minus_int) ) op.op = CK_OP_MINUS_INT;
+        else if( t == typeid(Chuck_Instr_Times_int) ) op.op = CK_OP_TIMES_INT;
+        else if( t == typeid(Chuck_Instr_Add_double) ) op.op = CK_OP_ADD_DOUBLE;
+        else if( t == typeid(Chuck_Instr_Minus_double) ) op.op = CK_OP_MINUS_DOUBLE;
+        else if( t == typeid(Chuck_Instr_Times_double) ) op.op = CK_OP_TIMES_DOUBLE;
+        else if( t == typeid(Chuck_Instr_Divide_double) ) op.op = CK_OP_DIVIDE_DOUBLE;
+        else if( t == typeid(Chuck_Instr_PreInc_int) ) op.op = CK_OP_PREINC_INT;
+        else if( t == typeid(Chuck_Instr_PostInc_int) ) op.op = CK_OP_POSTINC_INT;
+        else if( t == typeid(Chuck_Instr_Lt_int) ) op.op = CK_OP_LT_INT;
+        else if( t == typeid(Chuck_Instr_Gt_int) ) op.op = CK_OP_GT_INT;
+        else if( t == typeid(Chuck_Instr_Le_int) ) op.op = CK_OP_LE_INT;
+        else if( t == typeid(Chuck_Instr_Ge_int) ) op.op = CK_OP_GE_INT;
+        else if( t == typeid(Chuck_Instr_Eq_int) ) op.op = CK_OP_EQ_INT;
+        else if( t == typeid(Chuck_Instr_Neq_int) ) op.op = CK_OP_NEQ_INT;
+        else if( t == typeid(Chuck_Instr_Lt_double) ) op.op = CK_OP_LT_DOUBLE;
+        else if( t == typeid(Chuck_Instr_Gt_double) ) op.op = CK_OP_GT_DOUBLE;
+        else if( t == typeid(Chuck_Instr_Le_double) ) op.op = CK_OP_LE_DOUBLE;
+        else if( t == typeid(Chuck_Instr_Ge_double) ) op.op = CK_OP_GE_DOUBLE;
+        else if( t == typeid(Chuck_Instr_Cast_int2double) ) op.op = CK_OP_CAST_INT2DOUBLE;
+        else if( t == typeid(Chuck_Instr_Cast_double2int) ) op.op = CK_OP_CAST_DOUBLE2INT;
+        else if( t == typeid(Chuck_Instr_Reg_Dup_Last) ) op.op = CK_OP_REG_DUP_LAST;
+    }
+
+    // superinstructions
+    ck_fuse_ops( ops, num_instr );
+
+    return ops;
+#endif
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ck_fuse_ops()
+// desc: peephole pass over lowered ops; a sequence starting at i is replaced
+//       at ops[i] only, and the superinstruction skips the rest of it, so
+//       ops[i+1...] still work as jump targets and no jumps need fixing.
+//       the sequences were picked from --vm-op-pairs counts (see
+//       chuck_vm.cpp) over the examples; run in order, so patterns only
+//       ever read ops not yet fused
+//-----------------------------------------------------------------------------
+void ck_fuse_ops( Chuck_VM_Op * ops, t_CKUINT num_ops )
+{
+    // ops remaining from i (the code always ends with EOC, never fused)
+    #define at( k ) ( i + (k) < num_ops ? ops[i+(k)].op : (t_CKUINT)CK_OP_INSTR )
+
+    for( t_CKUINT i = 0; i < num_ops; i++ )
+    {
+        Chuck_VM_Op & op = ops[i];
+        t_CKUINT a = at(0), b = at(1), c = at(2);
+
+        // compare; push 0; branch if equal -> branch if compare false
+        if( b == CK_OP_REG_PUSH_IMM && ops[i+1].uval == 0 && c == CK_OP_BRANCH_EQ_INT )
+        {
+            t_CKUINT fused = CK_OP_INSTR;
+            switch( a )
+            {
+            case CK_OP_LT_INT: fused = CK_OP_LT_INT_BRANCH_FALSE; break;
+            case CK_OP_GT_INT: fused = CK_OP_GT_INT_BRANCH_FALSE; break;
+            case CK_OP_LE_INT: fused = CK_OP_LE_INT_BRANCH_FALSE; break;
+            case CK_OP_GE_INT: fused = CK_OP_GE_INT_BRANCH_FALSE; break;
+            case CK_OP_EQ_INT: fused = CK_OP_EQ_INT_BRANCH_FALSE; break;
+            case CK_OP_NEQ_INT: fused = CK_OP_NEQ_INT_BRANCH_FALSE; break;
+            case CK_OP_LT_DOUBLE: fused = CK_OP_LT_DOUBLE_BRANCH_FALSE; break;
+            case CK_OP_GT_DOUBLE: fused = CK_OP_GT_DOUBLE_BRANCH_FALSE; break;
+            case CK_OP_LE_DOUBLE: fused = CK_OP_LE_DOUBLE_BRANCH_FALSE; break;
+            case CK_OP_GE_DOUBLE: fused = CK_OP_GE_DOUBLE_BRANCH_FALSE; break;
+            }
+            if( fused != CK_OP_INSTR ) { op.op = fused; op.uval = ops[i+2].uval; continue; }
+        }
+
+        // push address of local; assign; pop -> store local
+        if( (a == CK_OP_REG_PUSH_MEM_ADDR || a == CK_OP_REG_PUSH_MEM_ADDR_BASE) &&
+            ( (b == CK_OP_ASSIGN_PRIMITIVE && c == CK_OP_REG_POP_INT) ||
+              (b == CK_OP_ASSIGN_PRIMITIVE2 && c == CK_OP_REG_POP_FLOAT) ) )
+        {
+            t_CKBOOL base = a == CK_OP_REG_PUSH_MEM_ADDR_BASE;
+            if( b == CK_OP_ASSIGN_PRIMITIVE ) op.op = base ? CK_OP_STORE_MEM_BASE : CK_OP_STORE_MEM;
+            else op.op = base ? CK_OP_STORE_MEM2_BASE : CK_OP_STORE_MEM2;
+            continue;
+        }
+
+        // push address of int local; ++; pop the int -> increment local
+        if( (a == CK_OP_REG_PUSH_MEM_ADDR || a == CK_OP_REG_PUSH_MEM_ADDR_BASE) &&
+            (b == CK_OP_POSTINC_INT || b == CK_OP_PREINC_INT) &&
+            c == CK_OP_REG_POP_WORDS && ops[i+2].uval * sz_WORD == sz_INT )
+        {
+            op.op = a == CK_OP_REG_PUSH_MEM_ADDR_BASE ? CK_OP_INC_MEM_BASE : CK_OP_INC_MEM;
+            continue;
+        }
+
+        // assign; pop -> assign without pushing back
+        if( a == CK_OP_ASSIGN_PRIMITIVE && b == CK_OP_REG_POP_INT ) { op.op = CK_OP_ASSIGN_POP; continue; }
+        if( a == CK_OP_ASSIGN_PRIMITIVE2 && b == CK_OP_REG_POP_FLOAT ) { op.op = CK_OP_ASSIGN_POP2; continue; }
+
+        // push; pop -> nothing
+        if( ( (a == CK_OP_REG_PUSH_IMM || a == CK_OP_REG_PUSH_MEM || a == CK_OP_REG_PUSH_MEM_BASE ||
+               a == CK_OP_REG_PUSH_MEM_ADDR || a == CK_OP_REG_PUSH_MEM_ADDR_BASE) && b == CK_OP_REG_POP_INT ) ||
+            ( (a == CK_OP_REG_PUSH_IMM2 || a == CK_OP_REG_PUSH_MEM2 || a == CK_OP_REG_PUSH_MEM2_BASE) && b == CK_OP_REG_POP_FLOAT ) )
+        { op.op = CK_OP_SKIP; op.uval = 2; continue; }
+
+        // int literal; cast to float -> float literal
+        if( a == CK_OP_REG_PUSH_IMM && b == CK_OP_CAST_INT2DOUBLE )
+        { op.op = CK_OP_PUSH_IMM_AS_FLOAT; op.fval = (t_CKFLOAT)(t_CKINT)op.uval; continue; }
+
+        // immediate; arithmetic -> arithmetic with immediate
+        if( a == CK_OP_REG_PUSH_IMM && (b == CK_OP_ADD_INT || b == CK_OP_MINUS_INT || b == CK_OP_TIMES_INT) )
+        {
+            op.op = b == CK_OP_ADD_INT ? CK_OP_ADD_INT_IMM : b == CK_OP_MINUS_INT ? CK_OP_MINUS_INT_IMM : CK_OP_TIMES_INT_IMM;
+            continue;
+        }
+        if( a == CK_OP_REG_PUSH_IMM2 && (b == CK_OP_ADD_DOUBLE || b == CK_OP_MINUS_DOUBLE ||
+                                        b == CK_OP_TIMES_DOUBLE || b == CK_OP_DIVIDE_DOUBLE) )
+        {
+            op.op = b == CK_OP_ADD_DOUBLE ? CK_OP_ADD_DOUBLE_IMM : b == CK_OP_MINUS_DOUBLE ? CK_OP_MINUS_DOUBLE_IMM :
+                    b == CK_OP_TIMES_DOUBLE ? CK_OP_TIMES_DOUBLE_IMM : CK_OP_DIVIDE_DOUBLE_IMM;
+            continue;
+        }
+
+        // two pushes -> one
+        if( a == CK_OP_REG_PUSH_MEM && b == CK_OP_REG_PUSH_MEM )
+        { op.op = CK_OP_PUSH_MEM_MEM; op.uval2 = ops[i+1].uval; continue; }
+        if( a == CK_OP_REG_PUSH_MEM_BASE && b == CK_OP_REG_PUSH_MEM_BASE )
+        { op.op = CK_OP_PUSH_MEM_MEM_BASE; op.uval2 = ops[i+1].uval; continue; }
+        if( a == CK_OP_REG_PUSH_MEM && b == CK_OP_REG_PUSH_IMM )
+        { op.op = CK_OP_PUSH_MEM_IMM; op.uval2 = ops[i+1].uval; continue; }
+        if( a == CK_OP_REG_PUSH_MEM_BASE && b == CK_OP_REG_PUSH_IMM )
+        { op.op = CK_OP_PUSH_MEM_IMM_BASE; op.uval2 = ops[i+1].uval; continue; }
+    }
+    #undef at
+
+    // thread jumps: a jump to a Goto goes straight to its target
+    for( t_CKUINT i = 0; i < num_ops; i++ )
+    {
+        Chuck_VM_Op & op = ops[i];
+        t_CKBOOL jumps = op.op == CK_OP_GOTO || op.op == CK_OP_BRANCH_EQ_INT || op.op == CK_OP_BRANCH_NEQ_INT ||
+                         (op.op >= CK_OP_LT_INT_BRANCH_FALSE && op.op <= CK_OP_GE_DOUBLE_BRANCH_FALSE);
+        if( !jumps ) continue;
+        // bounded, in case of Goto cycles
+        for( t_CKUINT hops = 0; hops < 16 && op.uval < num_ops && ops[op.uval].op == CK_OP_GOTO &&
+             ops[op.uval].uval != op.uval; hops++ )
+            op.uval = ops[op.uval].uval;
+    }
+}
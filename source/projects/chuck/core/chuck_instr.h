@@ -98,6 +98,7 @@ struct Chuck_Instr_Branch_Op : public Chuck_Instr
 public:
     Chuck_Instr_Branch_Op() : m_jmp(0) { }
     inline void set( t_CKUINT jmp ) { m_jmp = jmp; }
+    inline t_CKUINT get() { return m_jmp; }
 
 public:
     virtual const char * params() const
@@ -2418,6 +2419,9 @@ public:
       snprintf( buffer, CK_PRINT_BUF_LENGTH, "src=%ld, base=%ld", (long)m_val, (long)base );
       return buffer; }
 
+    // whether global stack base is used
+    inline t_CKBOOL use_base() const { return base; }
+
 protected:
     // use global stack base
     t_CKBOOL base;
@@ -2443,6 +2447,9 @@ public:
       snprintf( buffer, CK_PRINT_BUF_LENGTH, "src=%ld, base=%ld", (long)m_val, (long)base );
       return buffer; }
 
+    // whether global stack base is used
+    inline t_CKBOOL use_base() const { return base; }
+
 protected:
     // use global stack base
     t_CKBOOL base;
@@ -2568,6 +2575,9 @@ public:
       snprintf( buffer, CK_PRINT_BUF_LENGTH, "src=%ld, base=%ld", (long)m_val, (long)base );
       return buffer; }
 
+    // whether global stack base is used
+    inline t_CKBOOL use_base() const { return base; }
+
 protected:
     // use global stack base
     t_CKBOOL base;
@@ -4759,6 +4769,86 @@ protected:
 
 
 
+//-----------------------------------------------------------------------------
+// name: enum te_VM_Opcode
+// desc: compact opcodes, for instructions the shred run loop executes inline;
+//       everything else is CK_OP_INSTR and calls Chuck_Instr::execute()
+//-----------------------------------------------------------------------------
+enum te_VM_Opcode
+{
+    CK_OP_INSTR = 0,
+    // push / pop
+    CK_OP_REG_PUSH_IMM, CK_OP_REG_PUSH_IMM2,
+    CK_OP_REG_PUSH_MEM, CK_OP_REG_PUSH_MEM_BASE,
+    CK_OP_REG_PUSH_MEM2, CK_OP_REG_PUSH_MEM2_BASE,
+    CK_OP_REG_PUSH_MEM_ADDR, CK_OP_REG_PUSH_MEM_ADDR_BASE,
+    CK_OP_REG_POP_INT, CK_OP_REG_POP_FLOAT, CK_OP_REG_POP_WORDS,
+    // assign
+    CK_OP_ASSIGN_PRIMITIVE, CK_OP_ASSIGN_PRIMITIVE2,
+    // arithmetic
+    CK_OP_ADD_INT, CK_OP_MINUS_INT, CK_OP_TIMES_INT,
+    CK_OP_ADD_DOUBLE, CK_OP_MINUS_DOUBLE, CK_OP_TIMES_DOUBLE, CK_OP_DIVIDE_DOUBLE,
+    CK_OP_PREINC_INT, CK_OP_POSTINC_INT,
+    // comparison
+    CK_OP_LT_INT, CK_OP_GT_INT, CK_OP_LE_INT, CK_OP_GE_INT, CK_OP_EQ_INT, CK_OP_NEQ_INT,
+    CK_OP_LT_DOUBLE, CK_OP_GT_DOUBLE, CK_OP_LE_DOUBLE, CK_OP_GE_DOUBLE,
+    // control
+    CK_OP_BRANCH_EQ_INT, CK_OP_BRANCH_NEQ_INT, CK_OP_GOTO,
+    // cast
+    CK_OP_CAST_INT2DOUBLE, CK_OP_CAST_DOUBLE2INT,
+    // stack
+    CK_OP_REG_DUP_LAST,
+
+    // superinstructions, fused from the sequences in ck_fuse_ops(); the
+    // ops they cover keep their own entries, for jumps into the middle
+    // push two locals, or a local and an immediate
+    CK_OP_PUSH_MEM_MEM, CK_OP_PUSH_MEM_MEM_BASE,
+    CK_OP_PUSH_MEM_IMM, CK_OP_PUSH_MEM_IMM_BASE,
+    // int literal pushed as float
+    CK_OP_PUSH_IMM_AS_FLOAT,
+    // arithmetic with an immediate right operand
+    CK_OP_ADD_INT_IMM, CK_OP_MINUS_INT_IMM, CK_OP_TIMES_INT_IMM,
+    CK_OP_ADD_DOUBLE_IMM, CK_OP_MINUS_DOUBLE_IMM, CK_OP_TIMES_DOUBLE_IMM, CK_OP_DIVIDE_DOUBLE_IMM,
+    // compare, then branch if false (conditions of if/while/for)
+    CK_OP_LT_INT_BRANCH_FALSE, CK_OP_GT_INT_BRANCH_FALSE, CK_OP_LE_INT_BRANCH_FALSE,
+    CK_OP_GE_INT_BRANCH_FALSE, CK_OP_EQ_INT_BRANCH_FALSE, CK_OP_NEQ_INT_BRANCH_FALSE,
+    CK_OP_LT_DOUBLE_BRANCH_FALSE, CK_OP_GT_DOUBLE_BRANCH_FALSE,
+    CK_OP_LE_DOUBLE_BRANCH_FALSE, CK_OP_GE_DOUBLE_BRANCH_FALSE,
+    // assignment statements: store, without pushing the value back
+    CK_OP_ASSIGN_POP, CK_OP_ASSIGN_POP2,
+    CK_OP_STORE_MEM, CK_OP_STORE_MEM_BASE, CK_OP_STORE_MEM2, CK_OP_STORE_MEM2_BASE,
+    // ++ statements on a local
+    CK_OP_INC_MEM, CK_OP_INC_MEM_BASE,
+    // push immediately popped: skip uval ops
+    CK_OP_SKIP,
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_VM_Op
+// desc: lowered instruction: opcode, operands, and the original instruction
+//       (executed for CK_OP_INSTR, and used for dumps and error messages)
+//-----------------------------------------------------------------------------
+struct Chuck_VM_Op
+{
+    t_CKUINT op;
+    union { t_CKUINT uval; t_CKFLOAT fval; };
+    // second operand, for superinstructions
+    union { t_CKUINT uval2; t_CKFLOAT fval2; };
+    Chuck_Instr * instr;
+};
+
+// lower an instruction array to ops (caller deletes [] the result;
+// NULL if instructions can't be lowered)
+Chuck_VM_Op * ck_lower_instr( Chuck_Instr ** instr, t_CKUINT num_instr );
+// peephole pass over lowered ops: fuse superinstructions, thread jumps
+void ck_fuse_ops( Chuck_VM_Op * ops, t_CKUINT num_ops );
+
+
+
+
 // runtime functions (REFACTOR-2017: added overloads)
 Chuck_Object * instantiate_and_initialize_object( Chuck_Type * type, Chuck_VM_Shred * shred );
 Chuck_Object * instantiate_and_initialize_object( Chuck_Type * type, Chuck_VM * vm );
@@ -49,6 +49,7 @@ using namespace std;
 
 // dac tick
 CK_DLL_TICK(__ugen_tick) { *out = in; return TRUE; }
+CK_DLL_TICKV(__ugen_tickv) { for( t_CKUINT i = 0; i < nframes; i++ ) out[i] = in[i]; return TRUE; }
 // object string offset
 static t_CKUINT Object_offset_string = 0;
 
@@ -139,6 +140,8 @@ t_CKBOOL init_class_ugen( Chuck_Env * env, Chuck_Type * type )
     type->ugen_info = new Chuck_UGen_Info;
     type->ugen_info->add_ref();
     type->ugen_info->tick = __ugen_tick;
+    type->ugen_info->tickv = __ugen_tickv;
+    type->ugen_info->isolated = TRUE;
     type->ugen_info->num_ins = 1;
     type->ugen_info->num_outs = 1;
     // documentation text
@@ -1303,7 +1306,7 @@ t_CKBOOL init_class_array( Chuck_Env * env, Chuck_Type * type )
     // add getKeys() | (1.4.1.1) nshaheed
     func = make_new_mfun( "void", "getKeys", array_get_keys );
     func->add_arg( "string[]", "keys" );
-    func->doc = "return all keys found in associative array in keys";
+    func->doc = "return all keys found in associative array in keys, in ascending (lexicographic) order";
     if( !type_engine_import_mfun( env, func ) ) goto error;
 
     // note 1.4.1.0: in the future, should deprecate and encourage programmer
@@ -522,6 +522,19 @@ t_CKUINT Chuck_ArrayInt::addr( const string & key )
 
 
 
+//-----------------------------------------------------------------------------
+// name: map_addr()
+// desc: return address of element at key, using the key's cached hash
+//-----------------------------------------------------------------------------
+t_CKUINT Chuck_ArrayInt::map_addr( Chuck_String * key )
+{
+    // get the addr
+    return (t_CKUINT)m_map.insert( key->str(), key->hash() );
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: get()
 // desc: get value of element at position i
@@ -569,11 +582,11 @@ t_CKINT Chuck_ArrayInt::get( const string & key, t_CKUINT * val )
     // set to zero
     *val = 0;
     // find
-    map<string, t_CKUINT>::iterator iter = m_map.find( key );
+    t_CKUINT * found = m_map.find( key );
     // check
-    if( iter == m_map.end() ) return 0;
+    if( !found ) return 0;
     // copy value
-    *val = (*iter).second;
+    *val = *found;
     // return good
     return 1;
 }
@@ -581,6 +594,24 @@ t_CKINT Chuck_ArrayInt::get( const string & key, t_CKUINT * val )
 
 
 
+//-----------------------------------------------------------------------------
+// name: map_get()
+// desc: get value of element at key, using the key's cached hash
+//-----------------------------------------------------------------------------
+t_CKINT Chuck_ArrayInt::map_get( Chuck_String * key, t_CKUINT * val )
+{
+    // find
+    t_CKUINT * found = m_map.find( key->str(), key->hash() );
+    // copy value, or zero if not found
+    if( found ) *val = *found;
+    else *val = 0;
+    // return whether found
+    return found != NULL;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: get() -- signed edition | 1.5.2.0
 // desc: get value of element at key
@@ -590,11 +621,11 @@ t_CKINT Chuck_ArrayInt::get( const string & key, t_CKINT * val )
     // set to zero
     *val = 0;
     // find
-    map<string, t_CKUINT>::iterator iter = m_map.find( key );
+    t_CKUINT * found = m_map.find( key );
     // check
-    if( iter == m_map.end() ) return 0;
+    if( !found ) return 0;
     // copy value
-    *val = (t_CKINT)(*iter).second;
+    *val = (t_CKINT)*found;
     // return good
     return 1;
 }
@@ -634,11 +665,11 @@ t_CKINT Chuck_ArrayInt::set( t_CKINT i, t_CKUINT val )
 t_CKINT Chuck_ArrayInt::set( const string & key, t_CKUINT val )
 {
     // look for key
-    map<string, t_CKUINT>::iterator iter = m_map.find( key );
+    t_CKUINT * found = m_map.find( key );
 
     // if Object, release
-    if( m_is_obj && iter != m_map.end() && iter->second != 0 )
-        ((Chuck_Object *)iter->second)->release();
+    if( m_is_obj && found && *found != 0 )
+        ((Chuck_Object *)*found)->release();
 
     // if 0, remove the element
     if( !val ) m_map.erase( key );
@@ -682,7 +713,7 @@ t_CKINT Chuck_ArrayInt::insert( t_CKINT i, t_CKUINT val )
 //-----------------------------------------------------------------------------
 t_CKINT Chuck_ArrayInt::map_find( const string & key )
 {
-    return m_map.find( key ) != m_map.end();
+    return m_map.find( key ) != NULL;
 }
 
 
@@ -694,12 +725,12 @@ t_CKINT Chuck_ArrayInt::map_find( const string & key )
 //-----------------------------------------------------------------------------
 t_CKINT Chuck_ArrayInt::map_erase( const string & key )
 {
-    map<string, t_CKUINT>::iterator iter = m_map.find( key );
-    t_CKINT v = iter != m_map.end();
+    t_CKUINT * found = m_map.find( key );
+    t_CKINT v = found != NULL;
 
     // if obj
-    if( m_is_obj && iter != m_map.end() )
-        ((Chuck_Object *)(*iter).second)->release();
+    if( m_is_obj && found )
+        ((Chuck_Object *)*found)->release();
 
     // erase
     if( v ) m_map.erase( key );
@@ -876,14 +907,8 @@ t_CKINT Chuck_ArrayInt::erase( t_CKINT begin, t_CKINT end )
 //-----------------------------------------------------------------------------
 void Chuck_ArrayInt::get_keys( std::vector<std::string> & keys )
 {
-    // clear the return array
-    keys.clear();
-    // iterator
-    for( std::map<std::string, t_CKUINT>::iterator iter = m_map.begin(); iter !=m_map.end(); iter++ )
-    {
-        // add to list
-        keys.push_back((*iter).first);
-    }
+    // get keys (in ascending order)
+    m_map.keys( keys );
 }
 
 
@@ -1252,6 +1277,19 @@ t_CKUINT Chuck_ArrayFloat::addr( const string & key )
 
 
 
+//-----------------------------------------------------------------------------
+// name: map_addr()
+// desc: return address of element at key, using the key's cached hash
+//-----------------------------------------------------------------------------
+t_CKUINT Chuck_ArrayFloat::map_addr( Chuck_String * key )
+{
+    // get the addr
+    return (t_CKUINT)m_map.insert( key->str(), key->hash() );
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: get()
 // desc: ...
@@ -1282,14 +1320,14 @@ t_CKINT Chuck_ArrayFloat::get( const string & key, t_CKFLOAT * val )
     // set to zero
     *val = 0.0;
 
-    // iterator
-    map<string, t_CKFLOAT>::iterator iter = m_map.find( key );
+    // find
+    t_CKFLOAT * found = m_map.find( key );
 
     // check
-    if( iter != m_map.end() )
+    if( found )
     {
         // get the value
-        *val = (*iter).second;
+        *val = *found;
     }
 
     // return good
@@ -1299,6 +1337,24 @@ t_CKINT Chuck_ArrayFloat::get( const string & key, t_CKFLOAT * val )
 
 
 
+//-----------------------------------------------------------------------------
+// name: map_get()
+// desc: get value of element at key, using the key's cached hash
+//-----------------------------------------------------------------------------
+t_CKINT Chuck_ArrayFloat::map_get( Chuck_String * key, t_CKFLOAT * val )
+{
+    // find
+    t_CKFLOAT * found = m_map.find( key->str(), key->hash() );
+    // copy value, or zero if not found
+    if( found ) *val = *found;
+    else *val = 0.0;
+    // return good
+    return 1;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: set()
 // desc: ...
@@ -1369,7 +1425,7 @@ t_CKINT Chuck_ArrayFloat::insert( t_CKINT i, t_CKFLOAT val )
 //-----------------------------------------------------------------------------
 t_CKINT Chuck_ArrayFloat::map_find( const string & key )
 {
-    return m_map.find( key ) != m_map.end();
+    return m_map.find( key ) != NULL;
 }
 
 
@@ -1506,14 +1562,8 @@ t_CKINT Chuck_ArrayFloat::erase( t_CKINT begin, t_CKINT end )
 //-----------------------------------------------------------------------------
 void Chuck_ArrayFloat::get_keys( std::vector<std::string> & keys )
 {
-    // clear the return array
-    keys.clear();
-    // iterator
-    for( std::map<std::string,t_CKFLOAT>::iterator iter = m_map.begin(); iter !=m_map.end(); iter++ )
-    {
-        // add to list
-        keys.push_back((*iter).first);
-    }
+    // get keys (in ascending order)
+    m_map.keys( keys );
 }
 
 
@@ -1725,6 +1775,19 @@ t_CKUINT Chuck_ArrayVec2::addr( const string & key )
 
 
 
+//-----------------------------------------------------------------------------
+// name: map_addr()
+// desc: return address of element at key, using the key's cached hash
+//-----------------------------------------------------------------------------
+t_CKUINT Chuck_ArrayVec2::map_addr( Chuck_String * key )
+{
+    // get the addr
+    return (t_CKUINT)m_map.insert( key->str(), key->hash() );
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: get()
 // desc: ...
@@ -1759,14 +1822,14 @@ t_CKINT Chuck_ArrayVec2::get( const string & key, t_CKVEC2 * val )
     val->x = 0;
     val->y = 0;
 
-    // iterator
-    map<string, t_CKVEC2>::iterator iter = m_map.find( key );
+    // find
+    t_CKVEC2 * found = m_map.find( key );
 
     // check
-    if( iter != m_map.end() )
+    if( found )
     {
         // get the value
-        *val = (*iter).second;
+        *val = *found;
     }
 
     // return good
@@ -1779,6 +1842,24 @@ t_CKINT Chuck_ArrayVec2::get( const string & key, t_CKCOMPLEX * val )
 
 
 
+//-----------------------------------------------------------------------------
+// name: map_get()
+// desc: get value of element at key, using the key's cached hash
+//-----------------------------------------------------------------------------
+t_CKINT Chuck_ArrayVec2::map_get( Chuck_String * key, t_CKVEC2 * val )
+{
+    // find
+    t_CKVEC2 * found = m_map.find( key->str(), key->hash() );
+    // copy value, or zero if not found
+    if( found ) *val = *found;
+    else *val = t_CKVEC2();
+    // return good
+    return 1;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: set()
 // desc: ...
@@ -1853,7 +1934,7 @@ t_CKINT Chuck_ArrayVec2::insert( t_CKINT i, const t_CKVEC2 & val )
 //-----------------------------------------------------------------------------
 t_CKINT Chuck_ArrayVec2::map_find( const string & key )
 {
-    return m_map.find( key ) != m_map.end();
+    return m_map.find( key ) != NULL;
 }
 
 
@@ -1991,14 +2072,8 @@ t_CKINT Chuck_ArrayVec2::erase( t_CKINT begin, t_CKINT end )
 //-----------------------------------------------------------------------------
 void Chuck_ArrayVec2::get_keys( std::vector<std::string> & keys )
 {
-    // clear the return array
-    keys.clear();
-    // iterator
-    for( std::map<std::string,t_CKVEC2>::iterator iter = m_map.begin(); iter !=m_map.end(); iter++ )
-    {
-        // add to list
-        keys.push_back((*iter).first);
-    }
+    // get keys (in ascending order)
+    m_map.keys( keys );
 }
 
 
@@ -2289,6 +2364,19 @@ t_CKUINT Chuck_ArrayVec3::addr( const string & key )
 
 
 
+//-----------------------------------------------------------------------------
+// name: map_addr()
+// desc: return address of element at key, using the key's cached hash
+//-----------------------------------------------------------------------------
+t_CKUINT Chuck_ArrayVec3::map_addr( Chuck_String * key )
+{
+    // get the addr
+    return (t_CKUINT)m_map.insert( key->str(), key->hash() );
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: get()
 // desc: ...
@@ -2319,14 +2407,14 @@ t_CKINT Chuck_ArrayVec3::get( const string & key, t_CKVEC3 * val )
     // set to zero
     val->x = val->y = val->z = 0;
 
-    // iterator
-    map<string, t_CKVEC3>::iterator iter = m_map.find( key );
+    // find
+    t_CKVEC3 * found = m_map.find( key );
 
     // check
-    if( iter != m_map.end() )
+    if( found )
     {
         // get the value
-        *val = (*iter).second;
+        *val = *found;
     }
 
     // return good
@@ -2336,6 +2424,24 @@ t_CKINT Chuck_ArrayVec3::get( const string & key, t_CKVEC3 * val )
 
 
 
+//-----------------------------------------------------------------------------
+// name: map_get()
+// desc: get value of element at key, using the key's cached hash
+//-----------------------------------------------------------------------------
+t_CKINT Chuck_ArrayVec3::map_get( Chuck_String * key, t_CKVEC3 * val )
+{
+    // find
+    t_CKVEC3 * found = m_map.find( key->str(), key->hash() );
+    // copy value, or zero if not found
+    if( found ) *val = *found;
+    else *val = t_CKVEC3();
+    // return good
+    return 1;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: set()
 // desc: ...
@@ -2403,7 +2509,7 @@ t_CKINT Chuck_ArrayVec3::insert( t_CKINT i, const t_CKVEC3 & val )
 //-----------------------------------------------------------------------------
 t_CKINT Chuck_ArrayVec3::map_find( const string & key )
 {
-    return m_map.find( key ) != m_map.end();
+    return m_map.find( key ) != NULL;
 }
 
 
@@ -2652,14 +2758,8 @@ void Chuck_ArrayVec3::zero( t_CKUINT start, t_CKUINT end )
 //-----------------------------------------------------------------------------
 void Chuck_ArrayVec3::get_keys( std::vector<std::string> & keys )
 {
-    // clear the return array
-    keys.clear();
-    // iterator
-    for( std::map<std::string, t_CKVEC3>::iterator iter = m_map.begin(); iter !=m_map.end(); iter++ )
-    {
-        // add to list
-        keys.push_back((*iter).first);
-    }
+    // get keys (in ascending order)
+    m_map.keys( keys );
 }
 
 
@@ -2786,6 +2886,19 @@ t_CKUINT Chuck_ArrayVec4::addr( const string & key )
 
 
 
+//-----------------------------------------------------------------------------
+// name: map_addr()
+// desc: return address of element at key, using the key's cached hash
+//-----------------------------------------------------------------------------
+t_CKUINT Chuck_ArrayVec4::map_addr( Chuck_String * key )
+{
+    // get the addr
+    return (t_CKUINT)m_map.insert( key->str(), key->hash() );
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: get()
 // desc: ...
@@ -2816,14 +2929,14 @@ t_CKINT Chuck_ArrayVec4::get( const string & key, t_CKVEC4 * val )
     // set to zero
     val->x = val->y = val->z = val->w = 0;
 
-    // iterator
-    map<string, t_CKVEC4>::iterator iter = m_map.find( key );
+    // find
+    t_CKVEC4 * found = m_map.find( key );
 
     // check
-    if( iter != m_map.end() )
+    if( found )
     {
         // get the value
-        *val = (*iter).second;
+        *val = *found;
     }
 
     // return good
@@ -2833,6 +2946,24 @@ t_CKINT Chuck_ArrayVec4::get( const string & key, t_CKVEC4 * val )
 
 
 
+//-----------------------------------------------------------------------------
+// name: map_get()
+// desc: get value of element at key, using the key's cached hash
+//-----------------------------------------------------------------------------
+t_CKINT Chuck_ArrayVec4::map_get( Chuck_String * key, t_CKVEC4 * val )
+{
+    // find
+    t_CKVEC4 * found = m_map.find( key->str(), key->hash() );
+    // copy value, or zero if not found
+    if( found ) *val = *found;
+    else *val = t_CKVEC4();
+    // return good
+    return 1;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: set()
 // desc: ...
@@ -2903,7 +3034,7 @@ t_CKINT Chuck_ArrayVec4::insert( t_CKINT i, const t_CKVEC4 & val )
 //-----------------------------------------------------------------------------
 t_CKINT Chuck_ArrayVec4::map_find( const string & key )
 {
-    return m_map.find( key ) != m_map.end();
+    return m_map.find( key ) != NULL;
 }
 
 
@@ -3154,14 +3285,8 @@ void Chuck_ArrayVec4::zero( t_CKUINT start, t_CKUINT end )
 //-----------------------------------------------------------------------------
 void Chuck_ArrayVec4::get_keys( std::vector<std::string> & keys )
 {
-    // clear the return array
-    keys.clear();
-    // iterator
-    for( std::map<std::string, t_CKVEC4>::iterator iter = m_map.begin(); iter !=m_map.end(); iter++ )
-    {
-        // add to list
-        keys.push_back((*iter).first);
-    }
+    // get keys (in ascending order)
+    m_map.keys( keys );
 }
 
 
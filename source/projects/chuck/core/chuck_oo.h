@@ -45,6 +45,9 @@
 #include <vector>
 #include <map>
 #include <queue>
+#include <deque>
+#include <algorithm>
+#include <functional>
 
 
 
@@ -60,6 +63,7 @@ struct Chuck_VM_Code;
 struct Chuck_VM_Shred;
 struct Chuck_VM;
 struct Chuck_IO_File;
+struct Chuck_String;
 // utilities
 class  CBufferSimple;
 
@@ -175,6 +179,173 @@ public: // static
 
 
 
+//-----------------------------------------------------------------------------
+// name: ck_assoc_hash()
+// desc: hash function for associative array keys
+//-----------------------------------------------------------------------------
+inline t_CKUINT ck_assoc_hash( const std::string & key )
+{
+    return (t_CKUINT)std::hash<std::string>()( key );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_AssocMap
+// desc: string-keyed hash table backing the associative part of arrays
+//       (replaces std::map); open addressing with linear probing over an
+//       index of slots; entries live in a deque so the address of a value
+//       stays valid until its key is erased (the VM holds on to value
+//       addresses returned by addr())
+//-----------------------------------------------------------------------------
+template <typename T>
+struct Chuck_AssocMap
+{
+public:
+    Chuck_AssocMap() : m_count(0), m_used(0) { }
+
+public:
+    // number of keys
+    t_CKUINT size() const { return m_count; }
+
+    // find value by key; NULL if not present
+    T * find( const std::string & key ) { return find( key, ck_assoc_hash(key) ); }
+    // find value by key and precomputed hash; NULL if not present
+    T * find( const std::string & key, t_CKUINT hash )
+    {
+        t_CKUINT slot = lookup( key, hash );
+        return slot == NPOS ? NULL : &m_entries[m_slots[slot].index - SLOT_FIRST].value;
+    }
+
+    // find value by key, inserting a zero value if not present
+    T & operator[]( const std::string & key ) { return *insert( key, ck_assoc_hash(key) ); }
+    // find value by key and precomputed hash, inserting a zero value if not present
+    T * insert( const std::string & key, t_CKUINT hash )
+    {
+        // already there?
+        T * value = find( key, hash );
+        if( value ) return value;
+
+        // keep at most half of the slots used (incl. erased), so probes stay short
+        if( (m_used + 1) * 2 > m_slots.size() ) rehash();
+
+        // reuse an erased entry, or append a new one
+        t_CKUINT e;
+        if( m_free.size() ) { e = m_free.back(); m_free.pop_back(); }
+        else { e = m_entries.size(); m_entries.push_back( Entry() ); }
+        m_entries[e].key = key;
+        m_entries[e].hash = hash;
+        m_entries[e].value = T();
+        m_entries[e].live = TRUE;
+
+        // claim the first empty slot
+        t_CKUINT mask = m_slots.size() - 1;
+        t_CKUINT i = hash & mask;
+        while( m_slots[i].index != SLOT_EMPTY ) i = (i+1) & mask;
+        m_slots[i].index = e + SLOT_FIRST;
+        m_slots[i].hash = hash;
+        m_count++; m_used++;
+
+        return &m_entries[e].value;
+    }
+
+    // erase by key; returns number of entries erased (0 or 1)
+    t_CKUINT erase( const std::string & key )
+    {
+        t_CKUINT slot = lookup( key, ck_assoc_hash(key) );
+        if( slot == NPOS ) return 0;
+
+        // release the entry for reuse; leave a tombstone in the slot
+        t_CKUINT e = m_slots[slot].index - SLOT_FIRST;
+        m_entries[e].key.clear();
+        m_entries[e].live = FALSE;
+        m_free.push_back( e );
+        m_slots[slot].index = SLOT_ERASED;
+        m_count--;
+
+        return 1;
+    }
+
+    // get all keys, in ascending (lexicographic) order, same as std::map
+    void keys( std::vector<std::string> & keys ) const
+    {
+        keys.clear();
+        keys.reserve( m_count );
+        for( t_CKUINT i = 0; i < m_entries.size(); i++ )
+            if( m_entries[i].live ) keys.push_back( m_entries[i].key );
+        std::sort( keys.begin(), keys.end() );
+    }
+
+protected:
+    // slot index values
+    enum { SLOT_EMPTY = 0, SLOT_ERASED = 1, SLOT_FIRST = 2 };
+    static const t_CKUINT NPOS = (t_CKUINT)-1;
+
+    // one key/value
+    struct Entry
+    {
+        std::string key;
+        t_CKUINT hash;
+        T value;
+        t_CKBOOL live;
+        Entry() : hash(0), value(), live(FALSE) { }
+    };
+    // one slot in the index: entry index (+SLOT_FIRST), and hash for quick compare
+    struct Slot
+    {
+        t_CKUINT index;
+        t_CKUINT hash;
+        Slot() : index(SLOT_EMPTY), hash(0) { }
+    };
+
+    // slot holding key, or NPOS
+    t_CKUINT lookup( const std::string & key, t_CKUINT hash ) const
+    {
+        if( !m_count ) return NPOS;
+        t_CKUINT mask = m_slots.size() - 1;
+        for( t_CKUINT i = hash & mask; ; i = (i+1) & mask )
+        {
+            const Slot & s = m_slots[i];
+            if( s.index == SLOT_EMPTY ) return NPOS;
+            if( s.index != SLOT_ERASED && s.hash == hash
+                && m_entries[s.index - SLOT_FIRST].key == key ) return i;
+        }
+    }
+
+    // rebuild the index (dropping tombstones), growing it as needed
+    void rehash()
+    {
+        t_CKUINT n = 8;
+        while( n < (m_count + 1) * 4 ) n <<= 1;
+        m_slots.assign( n, Slot() );
+        t_CKUINT mask = n - 1;
+        for( t_CKUINT e = 0; e < m_entries.size(); e++ )
+        {
+            if( !m_entries[e].live ) continue;
+            t_CKUINT i = m_entries[e].hash & mask;
+            while( m_slots[i].index != SLOT_EMPTY ) i = (i+1) & mask;
+            m_slots[i].index = e + SLOT_FIRST;
+            m_slots[i].hash = m_entries[e].hash;
+        }
+        m_used = m_count;
+    }
+
+protected:
+    // index into m_entries; size is 0 or a power of 2
+    std::vector<Slot> m_slots;
+    // keys and values; a deque so values never move
+    std::deque<Entry> m_entries;
+    // erased entries available for reuse
+    std::vector<t_CKUINT> m_free;
+    // number of live keys
+    t_CKUINT m_count;
+    // number of non-empty slots (live + erased)
+    t_CKUINT m_used;
+};
+
+
+
 
 // ISSUE: 64-bit (fixed 1.3.1.0)
 #define CHUCK_ARRAYINT_DATASIZE sz_INT
@@ -275,9 +446,11 @@ public: // specific to this class
     // get address
     t_CKUINT addr( t_CKINT i );
     t_CKUINT addr( const std::string & key );
+    t_CKUINT map_addr( Chuck_String * key ); // (map only) uses the key's cached hash
     // get value
     t_CKINT get( t_CKINT i, t_CKUINT * val );
     t_CKINT get( const std::string & key, t_CKUINT * val );
+    t_CKINT map_get( Chuck_String * key, t_CKUINT * val ); // (map only) uses the key's cached hash
     t_CKINT get( t_CKINT i, t_CKINT * val ); // signed | 1.5.2.0
     t_CKINT get( const std::string & key, t_CKINT * val ); // signed | 1.5.2.0
     // set value
@@ -346,7 +519,7 @@ public: // map only
 
 public:
     std::vector<t_CKUINT> m_vector;
-    std::map<std::string, t_CKUINT> m_map;
+    Chuck_AssocMap<t_CKUINT> m_map;
     t_CKBOOL m_is_obj;
 
     // TODO: may need additional information here for set_size, if this is part of a multi-dim array
@@ -373,9 +546,11 @@ public: // specific to this class
     // get address
     t_CKUINT addr( t_CKINT i );
     t_CKUINT addr( const std::string & key );
+    t_CKUINT map_addr( Chuck_String * key ); // (map only) uses the key's cached hash
     // get value
     t_CKINT get( t_CKINT i, t_CKFLOAT * val );
     t_CKINT get( const std::string & key, t_CKFLOAT * val );
+    t_CKINT map_get( Chuck_String * key, t_CKFLOAT * val ); // (map only) uses the key's cached hash
     // set value
     t_CKINT set( t_CKINT i, t_CKFLOAT val );
     t_CKINT set( const std::string & key, t_CKFLOAT val );
@@ -439,7 +614,7 @@ public: // map only
 
 public:
     std::vector<t_CKFLOAT> m_vector;
-    std::map<std::string, t_CKFLOAT> m_map;
+    Chuck_AssocMap<t_CKFLOAT> m_map;
     // t_CKINT m_size;
     // t_CKINT m_capacity;
 };
@@ -462,10 +637,12 @@ public: // specific to this class
     // get address
     t_CKUINT addr( t_CKINT i );
     t_CKUINT addr( const std::string & key );
+    t_CKUINT map_addr( Chuck_String * key ); // (map only) uses the key's cached hash
     // get value
     t_CKINT get( t_CKINT i, t_CKVEC2 * val );
     t_CKINT get( t_CKINT i, t_CKCOMPLEX * val );
     t_CKINT get( const std::string & key, t_CKVEC2 * val );
+    t_CKINT map_get( Chuck_String * key, t_CKVEC2 * val ); // (map only) uses the key's cached hash
     t_CKINT get( const std::string & key, t_CKCOMPLEX * val );
     // set value
     t_CKINT set( t_CKINT i, const t_CKVEC2 & val );
@@ -532,7 +709,7 @@ public: // map only
 
 public:
     std::vector<t_CKVEC2> m_vector;
-    std::map<std::string, t_CKVEC2> m_map;
+    Chuck_AssocMap<t_CKVEC2> m_map;
     // semantic hint; in certain situations (like sorting)
     // need to distinguish between complex and polar | 1.5.1.0
     t_CKBOOL m_isPolarType;
@@ -556,9 +733,11 @@ public: // specific to this class
     // get address
     t_CKUINT addr( t_CKINT i );
     t_CKUINT addr( const std::string & key );
+    t_CKUINT map_addr( Chuck_String * key ); // (map only) uses the key's cached hash
     // get value
     t_CKINT get( t_CKINT i, t_CKVEC3 * val );
     t_CKINT get( const std::string & key, t_CKVEC3 * val );
+    t_CKINT map_get( Chuck_String * key, t_CKVEC3 * val ); // (map only) uses the key's cached hash
     // set value
     t_CKINT set( t_CKINT i, const t_CKVEC3 & val );
     t_CKINT set( const std::string & key, const t_CKVEC3 & val );
@@ -622,7 +801,7 @@ public: // map only
 
 public:
     std::vector<t_CKVEC3> m_vector;
-    std::map<std::string, t_CKVEC3> m_map;
+    Chuck_AssocMap<t_CKVEC3> m_map;
 };
 
 
@@ -643,9 +822,11 @@ public: // specific to this class
     // get address
     t_CKUINT addr( t_CKINT i );
     t_CKUINT addr( const std::string & key );
+    t_CKUINT map_addr( Chuck_String * key ); // (map only) uses the key's cached hash
     // get value
     t_CKINT get( t_CKINT i, t_CKVEC4 * val );
     t_CKINT get( const std::string & key, t_CKVEC4 * val );
+    t_CKINT map_get( Chuck_String * key, t_CKVEC4 * val ); // (map only) uses the key's cached hash
     // set value
     t_CKINT set( t_CKINT i, const t_CKVEC4 & val );
     t_CKINT set( const std::string & key, const t_CKVEC4 & val );
@@ -709,7 +890,7 @@ public: // map only
 
 public:
     std::vector<t_CKVEC4> m_vector;
-    std::map<std::string, t_CKVEC4> m_map;
+    Chuck_AssocMap<t_CKVEC4> m_map;
 };
 
 
@@ -816,17 +997,24 @@ public:
     virtual ~Chuck_String() { }
 
     // set string (makes copy)
-    void set( const std::string & s ) { m_str = s; m_charptr = m_str.c_str(); }
+    void set( const std::string & s ) { m_str = s; m_charptr = m_str.c_str(); m_hashed = FALSE; }
     // get as standard c++ string
     const std::string & str() { return m_str; }
     // get as C string (NOTE: use this in dynamical modules like chugins!)
     const char * c_str() { return m_charptr; }
+    // get hash of contents, as associative array key (computed once per set())
+    t_CKUINT hash()
+    { if( !m_hashed ) { m_hash = ck_assoc_hash( m_str ); m_hashed = TRUE; } return m_hash; }
 
 private:
     // c pointer | HACK: needed for ensure string passing in dynamic modules
     const char * m_charptr; // REFACTOR-2017
     // c++ string
     std::string m_str;
+    // cached hash of m_str
+    t_CKUINT m_hash;
+    // whether m_hash is current
+    t_CKBOOL m_hashed;
 };
 
 
@@ -39,6 +39,7 @@
 #if defined(__CHUCK_STAT_TRACK__)
 
 #include "chuck_vm.h"
+#include "chuck_errmsg.h"
 using namespace std;
 
 // static members
@@ -211,6 +212,9 @@ void Chuck_Stats::remove_shred( Chuck_VM_Shred * shred )
     stat->state = 3;  // deleted
     // set free time
     stat->free_time = vm->shreduler()->now_system;
+    // VM cycles (dispatches; a superinstruction counts once)
+    EM_log( CK_LOG_INFO, "shred %lu '%s' removed after %lu VM cycles",
+            stat->xid, stat->name.c_str(), stat->cycles );
     // remove
     mutex.acquire();
     shreds.erase( shreds.find( stat->xid ) );
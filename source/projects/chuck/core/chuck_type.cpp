@@ -45,6 +45,7 @@
 #include "ulib_doc.h" // for CKDoc::shouldSkip()
 #include "util_string.h"
 
+#include <math.h>
 #include <limits.h>
 
 #include <sstream>
@@ -70,6 +71,7 @@ t_CKBOOL type_engine_check_continue( Chuck_Env * env, a_Stmt_Continue cont );
 t_CKBOOL type_engine_check_return( Chuck_Env * env, a_Stmt_Return stmt );
 t_CKBOOL type_engine_check_switch( Chuck_Env * env, a_Stmt_Switch stmt );
 t_CKTYPE type_engine_check_exp( Chuck_Env * env, a_Exp exp );
+void type_engine_fold_exp( Chuck_Env * env, a_Exp exp );
 t_CKTYPE type_engine_check_exp_binary( Chuck_Env * env, a_Exp_Binary binary );
 t_CKTYPE type_engine_check_op( Chuck_Env * env, ae_Operator op, a_Exp lhs, a_Exp rhs, a_Exp_Binary binary );
 t_CKTYPE type_engine_check_op_chuck( Chuck_Env * env, a_Exp lhs, a_Exp rhs, a_Exp_Binary binary );
@@ -392,6 +394,8 @@ void Chuck_Env::clear_user_namespace()
     this->op_registry.reset2public();
     // reset @import registry | 1.5.4.0 (ge) added
     this->compiler()->imports()->clearAllUserImports();
+    // cached code may refer to user types and imports just cleared
+    this->compiler()->clearCodeCache();
 }
 
 
@@ -2058,6 +2062,8 @@ t_CKTYPE type_engine_check_exp( Chuck_Env * env, a_Exp exp )
     {
         // reset the type
         curr->type = NULL;
+        // reset constant folding
+        curr->cval_kind = ae_const_none;
         // increment first exp's group size
         exp->group_size++;
 
@@ -2129,6 +2135,9 @@ t_CKTYPE type_engine_check_exp( Chuck_Env * env, a_Exp exp )
         if( !curr->type )
             return NULL;
 
+        // fold if constant; operands were checked (and folded) above
+        type_engine_fold_exp( env, curr );
+
         // advance to next expression
         curr = curr->next;
     }
@@ -2140,6 +2149,221 @@ t_CKTYPE type_engine_check_exp( Chuck_Env * env, a_Exp exp )
 
 
 
+//-----------------------------------------------------------------------------
+// name: type_engine_fold_int() / type_engine_fold_float()
+// desc: set exp as a folded int or float constant
+//-----------------------------------------------------------------------------
+static void type_engine_fold_int( a_Exp exp, t_CKINT val )
+{ exp->cval_kind = ae_const_int; exp->cval_num = val; }
+static void type_engine_fold_float( a_Exp exp, t_CKFLOAT val )
+{ exp->cval_kind = ae_const_float; exp->cval_fnum = val; }
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: type_engine_fold_value()
+// desc: fold a const int/float builtin (e.g., `pi`, `true`, `Math.PI`)
+//-----------------------------------------------------------------------------
+static void type_engine_fold_value( Chuck_Env * env, a_Exp exp, Chuck_Value * v )
+{
+    // must be const, not instanced, and have its data at compile time
+    if( !v || !v->is_const || v->is_instance_member || !v->addr || v->func_ref ) return;
+    // int or float only (durations change with sample rate)
+    if( equals( v->type, env->ckt_int ) )
+        type_engine_fold_int( exp, *(t_CKINT *)v->addr );
+    else if( equals( v->type, env->ckt_float ) )
+        type_engine_fold_float( exp, *(t_CKFLOAT *)v->addr );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: type_engine_fold_kind()
+// desc: kind of a folded operand, after any implicit cast
+//-----------------------------------------------------------------------------
+static ae_Exp_Const type_engine_fold_kind( Chuck_Env * env, a_Exp e )
+{
+    // not folded, or part of a multi-value exp
+    if( e->cval_kind == ae_const_none || e->next ) return ae_const_none;
+    // no implicit cast
+    if( !e->cast_to ) return e->cval_kind;
+    // int to float
+    if( e->cval_kind == ae_const_int && equals( e->cast_to, env->ckt_float ) )
+        return ae_const_float;
+    // other casts (e.g., to complex) are not folded
+    return ae_const_none;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: type_engine_fold_as_float()
+// desc: value of a folded operand as float
+//-----------------------------------------------------------------------------
+static t_CKFLOAT type_engine_fold_as_float( a_Exp e )
+{
+    return e->cval_kind == ae_const_int ? (t_CKFLOAT)e->cval_num : e->cval_fnum;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: type_engine_fold_exp()
+// desc: mark exp as a compile-time constant if it is an int/float literal,
+//       a const builtin value, or an arithmetic, comparison, logical, or
+//       bitwise operation on constants; the emitter pushes folded exps as
+//       immediates and prunes branches on constant conditions
+//-----------------------------------------------------------------------------
+void type_engine_fold_exp( Chuck_Env * env, a_Exp exp )
+{
+    // only int and float results are folded
+    t_CKBOOL is_int = equals( exp->type, env->ckt_int );
+    if( !is_int && !equals( exp->type, env->ckt_float ) ) return;
+
+    switch( exp->s_type )
+    {
+    case ae_exp_primary:
+    {
+        a_Exp_Primary prim = &exp->primary;
+        if( prim->s_type == ae_primary_num ) type_engine_fold_int( exp, prim->num );
+        else if( prim->s_type == ae_primary_float ) type_engine_fold_float( exp, prim->fnum );
+        else if( prim->s_type == ae_primary_var ) type_engine_fold_value( env, exp, prim->value );
+        else if( prim->s_type == ae_primary_exp && !prim->exp->next && !prim->exp->cast_to )
+        {
+            // parenthesized
+            exp->cval_kind = prim->exp->cval_kind;
+            if( exp->cval_kind == ae_const_int ) exp->cval_num = prim->exp->cval_num;
+            else if( exp->cval_kind == ae_const_float ) exp->cval_fnum = prim->exp->cval_fnum;
+        }
+        break;
+    }
+
+    case ae_exp_dot_member:
+    {
+        // static members of a class only (e.g., `Math.PI`), never through an object
+        a_Exp_Dot_Member member = &exp->dot_member;
+        if( !type_engine_is_base_type_static( env, member->t_base ) ) break;
+        type_engine_fold_value( env, exp, type_engine_find_value( member->t_base->actual_type, member->xid ) );
+        break;
+    }
+
+    case ae_exp_cast:
+    {
+        a_Exp e = exp->cast.exp;
+        ae_Exp_Const kind = type_engine_fold_kind( env, e );
+        if( kind == ae_const_none ) break;
+        if( is_int ) type_engine_fold_int( exp, kind == ae_const_int ? e->cval_num : (t_CKINT)e->cval_fnum );
+        else type_engine_fold_float( exp, type_engine_fold_as_float( e ) );
+        break;
+    }
+
+    case ae_exp_unary:
+    {
+        a_Exp_Unary unary = &exp->unary;
+        if( unary->ck_overload_func || !unary->exp ) break;
+        ae_Exp_Const kind = type_engine_fold_kind( env, unary->exp );
+        if( kind == ae_const_int )
+        {
+            t_CKINT v = unary->exp->cval_num;
+            // negate with wrap-around, as the VM does
+            if( unary->op == ae_op_minus ) type_engine_fold_int( exp, (t_CKINT)(0 - (t_CKUINT)v) );
+            else if( unary->op == ae_op_tilda ) type_engine_fold_int( exp, ~v );
+            else if( unary->op == ae_op_exclamation ) type_engine_fold_int( exp, !v );
+        }
+        else if( kind == ae_const_float && unary->op == ae_op_minus )
+            type_engine_fold_float( exp, -unary->exp->cval_fnum );
+        break;
+    }
+
+    case ae_exp_binary:
+    {
+        a_Exp_Binary binary = &exp->binary;
+        a_Exp lhs = binary->lhs, rhs = binary->rhs;
+        if( binary->ck_overload_func ) break;
+        ae_Exp_Const lk = type_engine_fold_kind( env, lhs );
+        ae_Exp_Const rk = type_engine_fold_kind( env, rhs );
+        if( lk == ae_const_none || lk != rk ) break;
+
+        if( lk == ae_const_int )
+        {
+            // unsigned for wrap-around, as the VM does
+            t_CKINT l = lhs->cval_num, r = rhs->cval_num;
+            t_CKUINT ul = (t_CKUINT)l, ur = (t_CKUINT)r;
+            switch( binary->op )
+            {
+            case ae_op_plus: type_engine_fold_int( exp, (t_CKINT)(ul + ur) ); break;
+            case ae_op_minus: type_engine_fold_int( exp, (t_CKINT)(ul - ur) ); break;
+            case ae_op_times: type_engine_fold_int( exp, (t_CKINT)(ul * ur) ); break;
+            // divide/modulo by zero is left to the VM, which throws an exception
+            case ae_op_divide: if( r != 0 && r != -1 ) type_engine_fold_int( exp, l / r ); break;
+            case ae_op_percent: if( r != 0 && r != -1 ) type_engine_fold_int( exp, l % r ); break;
+            case ae_op_eq: type_engine_fold_int( exp, l == r ); break;
+            case ae_op_neq: type_engine_fold_int( exp, l != r ); break;
+            case ae_op_lt: type_engine_fold_int( exp, l < r ); break;
+            case ae_op_le: type_engine_fold_int( exp, l <= r ); break;
+            case ae_op_gt: type_engine_fold_int( exp, l > r ); break;
+            case ae_op_ge: type_engine_fold_int( exp, l >= r ); break;
+            case ae_op_and: type_engine_fold_int( exp, l && r ); break;
+            case ae_op_or: type_engine_fold_int( exp, l || r ); break;
+            case ae_op_s_and: type_engine_fold_int( exp, l & r ); break;
+            case ae_op_s_or: type_engine_fold_int( exp, l | r ); break;
+            case ae_op_s_xor: type_engine_fold_int( exp, l ^ r ); break;
+            default: break;
+            }
+        }
+        else
+        {
+            t_CKFLOAT l = type_engine_fold_as_float( lhs ), r = type_engine_fold_as_float( rhs );
+            switch( binary->op )
+            {
+            case ae_op_plus: type_engine_fold_float( exp, l + r ); break;
+            case ae_op_minus: type_engine_fold_float( exp, l - r ); break;
+            case ae_op_times: type_engine_fold_float( exp, l * r ); break;
+            case ae_op_divide: type_engine_fold_float( exp, l / r ); break;
+            case ae_op_percent: if( r != 0 ) type_engine_fold_float( exp, ::fmod( l, r ) ); break;
+            case ae_op_eq: type_engine_fold_int( exp, l == r ); break;
+            case ae_op_neq: type_engine_fold_int( exp, l != r ); break;
+            case ae_op_lt: type_engine_fold_int( exp, l < r ); break;
+            case ae_op_le: type_engine_fold_int( exp, l <= r ); break;
+            case ae_op_gt: type_engine_fold_int( exp, l > r ); break;
+            case ae_op_ge: type_engine_fold_int( exp, l >= r ); break;
+            default: break;
+            }
+        }
+
+        // result kind must agree with the checked type
+        if( exp->cval_kind != (is_int ? ae_const_int : ae_const_float) )
+            exp->cval_kind = ae_const_none;
+        break;
+    }
+
+    case ae_exp_if:
+    {
+        // constant condition selecting a constant of the same type
+        a_Exp_If exp_if = &exp->exp_if;
+        ae_Exp_Const ck = type_engine_fold_kind( env, exp_if->cond );
+        if( ck == ae_const_none ) break;
+        t_CKBOOL cond = ck == ae_const_int ? exp_if->cond->cval_num != 0 : exp_if->cond->cval_fnum != 0;
+        a_Exp e = cond ? exp_if->if_exp : exp_if->else_exp;
+        if( e->cast_to || e->next || !equals( e->type, exp->type ) ) break;
+        exp->cval_kind = e->cval_kind;
+        if( exp->cval_kind == ae_const_int ) exp->cval_num = e->cval_num;
+        else if( exp->cval_kind == ae_const_float ) exp->cval_fnum = e->cval_fnum;
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: type_engine_check_exp_binary()
 // desc: ...
@@ -7387,11 +7611,14 @@ Chuck_Type * type_engine_import_ugen_begin( Chuck_Env * env, const char * name,
     info->add_ref();
     info->tick = type->parent_type->ugen_info->tick;
     info->tickf = type->parent_type->ugen_info->tickf; // added 1.3.0.0
+    info->tickv = type->parent_type->ugen_info->tickv;
+    info->isolated = type->parent_type->ugen_info->isolated;
     info->pmsg = type->parent_type->ugen_info->pmsg;
     info->num_ins = type->parent_type->ugen_info->num_ins;
     info->num_outs = type->parent_type->ugen_info->num_outs;
-    if( tick ) info->tick = tick;
-    if( tickf ) { info->tickf = tickf; info->tick = NULL; } // added 1.3.0.0
+    // a new tick invalidates any inherited block tick (see import_ugen_tickv)
+    if( tick ) { info->tick = tick; info->tickv = NULL; info->isolated = FALSE; }
+    if( tickf ) { info->tickf = tickf; info->tick = NULL; info->tickv = NULL; info->isolated = FALSE; } // added 1.3.0.0
     if( pmsg ) info->pmsg = pmsg;
     if( num_ins != CK_NO_VALUE ) info->num_ins = num_ins;
     if( num_outs != CK_NO_VALUE ) info->num_outs = num_outs;
@@ -7441,6 +7668,46 @@ Chuck_Type * type_engine_import_ugen_begin( Chuck_Env * env, const char * name,
 
 
 
+//-----------------------------------------------------------------------------
+// name: type_engine_import_ugen_tickv()
+// desc: add a block tick to the ugen currently being imported; it computes
+//       nframes of mono output from nframes of input in one call, and is
+//       used instead of the per-sample tick when the VM ticks in blocks
+//       (e.g., adaptive mode); must be called after import_ugen_begin();
+//       isolated (off unless given) declares that the tick functions touch
+//       no state outside of the ugen (e.g., the global random number
+//       generator), which lets the VM render independent ugens on multiple
+//       threads
+//-----------------------------------------------------------------------------
+t_CKBOOL type_engine_import_ugen_tickv( Chuck_Env * env, f_tickv tickv, t_CKBOOL isolated )
+{
+    // make sure we are in a ugen class
+    if( !env->class_def || !env->class_def->ugen_info )
+    {
+        // error
+        EM_error2( 0, "(import error) import_ugen_tickv invoked outside of ugen begin/end" );
+        return FALSE;
+    }
+
+    // the per-sample tick is the fallback, and must be there
+    if( !env->class_def->ugen_info->tick )
+    {
+        // error
+        EM_error2( 0, "(import error) import_ugen_tickv: '%s' has no per-sample tick",
+                   env->class_def->c_name() );
+        return FALSE;
+    }
+
+    // set it
+    env->class_def->ugen_info->tickv = tickv;
+    env->class_def->ugen_info->isolated = isolated;
+
+    return TRUE;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: type_engine_import_uana_begin()
 // desc: ...
@@ -9380,6 +9647,9 @@ t_CKBOOL type_engine_add_class_from_dl( Chuck_Env * env, Chuck_DL_Class * c )
                                             c->ugen_num_in, c->ugen_num_out,
                                             c->doc.length() > 0 ? c->doc.c_str() : NULL ) )
             goto error;
+        // block tick, if any; chugins are not assumed to be isolated
+        if( c->ugen_tickv && !type_engine_import_ugen_tickv( env, c->ugen_tickv, FALSE ) )
+            goto error;
     }
     else
     {
@@ -899,6 +899,11 @@ struct Chuck_UGen_Info : public Chuck_VM_Object
     f_tick tick;
     // multichannel/vector tick function pointer (added 1.3.0.0)
     f_tickf tickf;
+    // mono block tick function pointer, alongside tick (DL API 10.3)
+    f_tickv tickv;
+    // tick/tickv touch only the ugen's own state (no globals, no ChucK code),
+    // so independent ugens may be ticked concurrently (see Chuck_UGen_Parallel)
+    t_CKBOOL isolated;
     // pmsg function pointer
     f_pmsg pmsg;
     // number of incoming channels
@@ -915,7 +920,7 @@ struct Chuck_UGen_Info : public Chuck_VM_Object
 
     // constructor
     Chuck_UGen_Info()
-    { tick = NULL; tickf = NULL; pmsg = NULL; num_ins = num_outs = 1;
+    { tick = NULL; tickf = NULL; tickv = NULL; isolated = FALSE; pmsg = NULL; num_ins = num_outs = 1;
       tock = NULL; num_ins_ana = num_outs_ana = 1; }
 };
 
@@ -1412,6 +1417,7 @@ Chuck_Type * type_engine_import_uana_begin( Chuck_Env * env, const char * name,
                                             t_CKUINT num_outs_ana = CK_NO_VALUE,
                                             const char * doc = NULL );
 t_CKBOOL type_engine_import_ctor( Chuck_Env * env, Chuck_DL_Func * ctor ); // 1.5.2.0 (ge) added
+t_CKBOOL type_engine_import_ugen_tickv( Chuck_Env * env, f_tickv tickv, t_CKBOOL isolated = FALSE ); // DL API 10.3 added
 t_CKBOOL type_engine_import_mfun( Chuck_Env * env, Chuck_DL_Func * mfun );
 t_CKBOOL type_engine_import_sfun( Chuck_Env * env, Chuck_DL_Func * sfun );
 t_CKUINT type_engine_import_mvar( Chuck_Env * env, const char * type,
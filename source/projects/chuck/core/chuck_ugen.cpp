@@ -41,6 +41,7 @@
 #include "chuck_lang.h"
 #include "chuck_errmsg.h"
 #include "ugen_xxx.h" // for subgraph ops
+#include "util_thread.h"
 using namespace std;
 
 
@@ -182,6 +183,7 @@ void Chuck_UGen::init()
 {
     tick = NULL;
     tickf = NULL; // added 1.3.0.0
+    tickv = NULL;
     pmsg = NULL;
     m_multi_chan = NULL;
     m_multi_chan_size = 0;
@@ -229,6 +231,14 @@ void Chuck_UGen::init()
     m_is_buffered = FALSE;
     // buffer empty for any ugen that is not buffered
     m_buffer.resize( 0 );
+
+    // not yet visited by any schedule
+    m_sched_mark = 0;
+    m_tick_isolated = FALSE;
+    m_par_mark = 0;
+    m_par_sink = FALSE;
+    m_par_root = FALSE;
+    m_par_owner = -1;
 }
 
 
@@ -316,8 +326,10 @@ t_CKBOOL Chuck_UGen::alloc_v( t_CKUINT size )
     // go
     if( size > 0 )
     {
-        m_sum_v = new SAMPLE[size];
-        m_current_v = new SAMPLE[size];
+        // zeroed, since a feedback cycle can read a ugen's block
+        // before that ugen has ever been ticked
+        m_sum_v = new SAMPLE[size]();
+        m_current_v = new SAMPLE[size]();
 
         return ( m_sum_v != NULL && m_current_v != NULL );
     }
@@ -606,6 +618,8 @@ void Chuck_UGen::add_by( Chuck_UGen * dest, t_CKBOOL isUpChuck )
     // dest->add_ref();
     // increment dest count
     m_num_dest++;
+    // connections changed
+    Chuck_UGen_Schedule::graph_changed();
 
     // uana
     if( isUpChuck )
@@ -740,6 +754,9 @@ void Chuck_UGen::remove_by( Chuck_UGen * dest )
         return;
     }
 
+    // connections changed
+    Chuck_UGen_Schedule::graph_changed();
+
     // remove from uana list (first due to reference count)
     for( t_CKUINT j = 0; j < m_num_uana_dest; j++ )
         if( m_dest_uana_list[j] == dest )
@@ -798,6 +815,8 @@ void Chuck_UGen::remove_all( )
         {
             // TODO: figure out why this is necessary!
 
+            // connections changed
+            Chuck_UGen_Schedule::graph_changed();
             // get rid of it, but don't release
             for( t_CKUINT j = 1; j < m_num_src; j++ )
                 m_src_list[j-1] = m_src_list[j];
@@ -832,6 +851,8 @@ t_CKBOOL Chuck_UGen::disconnect( t_CKBOOL recursive )
         // make sure at least one got disconnected
         if( !m_dest_list[0]->remove( this ) )
         {
+            // connections changed
+            Chuck_UGen_Schedule::graph_changed();
             // get rid of it, but don't release
             for( t_CKUINT j = 1; j < m_num_dest; j++ )
                 m_dest_list[j-1] = m_dest_list[j];
@@ -1042,6 +1063,24 @@ t_CKBOOL Chuck_UGen::system_tick( t_CKTIME now )
     }
 
     // part 2: synthesize with tick function
+    return synthesize();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: synthesize()
+// desc: part 2 of system_tick(): run tick/tickf on the gathered input, apply
+//       gain/pan, and update current/last (and the buffer, if buffered)
+//       NOTE assumes m_sum / m_multi_in_v have been gathered for `now`
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_UGen::synthesize()
+{
+    t_CKUINT i;
+    Chuck_UGen * ugen = NULL;
+    SAMPLE multi;
+
     if( m_multi_chan_size && tickf )
     {
         // evaluate multi-channel tickf (added 1.3.0.0)
@@ -1157,7 +1196,6 @@ t_CKBOOL Chuck_UGen::system_tick_v( t_CKTIME now, t_CKUINT numFrames )
     t_CKUINT i, j;
     Chuck_UGen * ugen = NULL;
     SAMPLE factor;
-    SAMPLE multi;
 
     // inc time
     m_time = now;
@@ -1252,6 +1290,23 @@ t_CKBOOL Chuck_UGen::system_tick_v( t_CKTIME now, t_CKUINT numFrames )
     }
 
     // part 2: synthesize with tick function
+    return synthesize_v( numFrames );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: synthesize_v()
+// desc: part 2 of system_tick_v(): vectorized counterpart of synthesize()
+//       NOTE assumes m_sum_v / m_multi_in_v have been gathered for `now`
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_UGen::synthesize_v( t_CKUINT numFrames )
+{
+    t_CKUINT j;
+    SAMPLE factor;
+    SAMPLE multi;
+
     if( m_multi_chan_size && tickf )
     {
         // evaluate multi-channel tick (added added 1.3.0.0)
@@ -1275,7 +1330,7 @@ t_CKBOOL Chuck_UGen::system_tick_v( t_CKTIME now, t_CKUINT numFrames )
                 for( int c = 0; c < m_multi_chan_size; c++ )
                 {
                     // apply gain/pan
-                    m_multi_out_v[f*m_multi_chan_size+c] *= ugen->m_gain * ugen->m_pan;
+                    m_multi_out_v[f*m_multi_chan_size+c] *= m_multi_chan[c]->m_gain * m_multi_chan[c]->m_pan;
                     // dedenormal
                     CK_DDN( m_multi_out_v[f*m_multi_chan_size+c] );
                     // copy from tickf output to channel's current sample
@@ -1335,8 +1390,11 @@ t_CKBOOL Chuck_UGen::system_tick_v( t_CKTIME now, t_CKUINT numFrames )
         // evaluate single-channel tick
         if( m_op > 0 )  // UGEN_OP_TICK
         {
+            // tick the whole block at once, if the ugen can
+            if( tickv )
+                m_valid = tickv( this, m_sum_v, m_current_v, numFrames, Chuck_DL_Api::instance() );
             // tick the ugen (Chuck_DL_Api::instance() added 1.3.0.0)
-            if( tick )
+            else if( tick )
                 for( j = 0; j < numFrames; j++ ) // REFACTOR-2017: remove NULL shred
                     m_valid = tick( this, m_sum_v[j], &(m_current_v[j]), Chuck_DL_Api::instance() );
             if( !m_valid )
@@ -1387,6 +1445,170 @@ t_CKBOOL Chuck_UGen::system_tick_v( t_CKTIME now, t_CKUINT numFrames )
 
 
 
+//-----------------------------------------------------------------------------
+// name: gather()
+// desc: part 1 of system_tick() without the upstream recursion; sum input
+//       from sources, which must already have been ticked for `now`
+//-----------------------------------------------------------------------------
+void Chuck_UGen::gather( t_CKTIME now )
+{
+    t_CKUINT i;
+    Chuck_UGen * ugen = NULL;
+
+    // inc time
+    m_time = now;
+    // initial sum
+    m_sum = 0.0f;
+    // sum sources (see system_tick() for the special ops)
+    if( m_num_src )
+    {
+        m_sum = m_src_list[0]->m_current;
+        for( i = 1; i < m_num_src; i++ )
+        {
+            ugen = m_src_list[i];
+            if( ugen->m_valid )
+            {
+                if( m_op <= 1 )
+                    m_sum += ugen->m_current;
+                else
+                {
+                    switch( m_op )
+                    {
+                    case 2: m_sum -= ugen->m_current; break;
+                    case 3: m_sum *= ugen->m_current; break;
+                    case 4: m_sum /= ugen->m_current; break;
+                    default: m_sum += ugen->m_current; break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: gather_multi()
+// desc: gather input from per-channel sub-ugens, which must already have
+//       been ticked for `now` (the multi-channel section of system_tick())
+//-----------------------------------------------------------------------------
+void Chuck_UGen::gather_multi()
+{
+    t_CKUINT i;
+    SAMPLE multi = 0.0f;
+
+    // multichannel tick function: per-channel input
+    if( tickf )
+    {
+        for( i = 0; i < m_multi_chan_size; i++ )
+            m_multi_in_v[i] = m_sum + m_multi_chan[i]->m_sum;
+    }
+    else
+    {
+        // multiple channels are added
+        for( i = 0; i < m_multi_chan_size; i++ )
+            multi += m_multi_chan[i]->m_current;
+        // scale multi
+        multi /= m_multi_chan_size;
+        m_sum += multi;
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: gather_v()
+// desc: vectorized gather()
+//-----------------------------------------------------------------------------
+void Chuck_UGen::gather_v( t_CKTIME now, t_CKUINT numFrames )
+{
+    t_CKUINT i, j;
+    Chuck_UGen * ugen = NULL;
+
+    // inc time
+    m_time = now;
+    // sum sources (see system_tick_v() for the special ops)
+    if( m_num_src )
+    {
+        memcpy( m_sum_v, m_src_list[0]->m_current_v, numFrames * sizeof(SAMPLE) );
+        for( i = 1; i < m_num_src; i++ )
+        {
+            ugen = m_src_list[i];
+            if( ugen->m_valid )
+            {
+                if( m_op <= 1 )
+                    for( j = 0; j < numFrames; j++ )
+                        m_sum_v[j] += ugen->m_current_v[j];
+                else
+                {
+                    switch( m_op )
+                    {
+                        case 2:
+                            for( j = 0; j < numFrames; j++ )
+                                m_sum_v[j] -= ugen->m_current_v[j];
+                            break;
+                        case 3:
+                            for( j = 0; j < numFrames; j++ )
+                                m_sum_v[j] *= ugen->m_current_v[j];
+                            break;
+                        case 4:
+                            for( j = 0; j < numFrames; j++ )
+                                m_sum_v[j] /= ugen->m_current_v[j];
+                            break;
+                        default:
+                            for( j = 0; j < numFrames; j++ )
+                                m_sum_v[j] += ugen->m_current_v[j];
+                            break;
+                    }
+                }
+            }
+        }
+    }
+    else
+    {
+        memset( m_sum_v, 0, numFrames * sizeof(SAMPLE) );
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: gather_multi_v()
+// desc: vectorized gather_multi()
+//-----------------------------------------------------------------------------
+void Chuck_UGen::gather_multi_v( t_CKUINT numFrames )
+{
+    t_CKUINT i, j;
+    Chuck_UGen * ugen = NULL;
+
+    // multichannel tick function: interleaved per-channel input
+    if( tickf )
+    {
+        for( i = 0; i < m_multi_chan_size; i++ )
+        {
+            ugen = m_multi_chan[i];
+            for( j = 0; j < numFrames; j++ )
+                m_multi_in_v[j*m_multi_chan_size+i] = m_sum_v[j] + ugen->m_sum_v[j];
+        }
+    }
+    else
+    {
+        SAMPLE factor = 1.0f / m_multi_chan_size;
+        for( i = 0; i < m_multi_chan_size; i++ )
+        {
+            ugen = m_multi_chan[i];
+            for( j = 0; j < numFrames; j++ )
+                m_sum_v[j] += ugen->m_current_v[j] * factor;
+        }
+    }
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: init_subgraph()
 // desc: init subgraph, added 1.3.0.0
@@ -1717,3 +1939,595 @@ Chuck_UGen * ugen_generic_get_dst( Chuck_Object * obj, t_CKINT chan, t_CKBOOL is
         return ((Chuck_UGen *) obj)->dst_for_src_chan( chan );
     }
 }
+
+
+
+
+//-----------------------------------------------------------------------------
+// Chuck_UGen_Schedule statics
+//-----------------------------------------------------------------------------
+std::atomic<t_CKUINT> Chuck_UGen_Schedule::s_graph_version( 1 );
+std::atomic<t_CKUINT> Chuck_UGen_Schedule::s_next_mark( 1 );
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: Chuck_UGen_Schedule()
+// desc: constructor
+//-----------------------------------------------------------------------------
+Chuck_UGen_Schedule::Chuck_UGen_Schedule()
+{
+    m_version = 0;
+    m_built = FALSE;
+    m_mark = 0;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: rebuild()
+// desc: record the order in which system_tick() would visit the graph
+//       NOTE called at the top of a tick; ugens already ticked for `now`
+//       (e.g., the adc, which the shreduler fills directly) are left out
+//-----------------------------------------------------------------------------
+void Chuck_UGen_Schedule::rebuild( Chuck_UGen * const * roots, t_CKUINT numRoots,
+                                   t_CKTIME now )
+{
+    // snapshot the version first; a change during rebuild forces another
+    m_version = s_graph_version.load( std::memory_order_relaxed );
+    // new visit mark
+    m_mark = s_next_mark.fetch_add( 1, std::memory_order_relaxed );
+    // clear (keeps capacity)
+    m_steps.clear();
+
+    // visit each root in the order the shreduler ticks them
+    for( t_CKUINT i = 0; i < numRoots; i++ )
+        if( roots[i] ) visit( roots[i], now );
+
+    // done
+    m_built = TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: visit()
+// desc: mirror the control flow of system_tick(), recording steps instead of
+//       computing; the emitted order is therefore exactly the recursive one
+//-----------------------------------------------------------------------------
+void Chuck_UGen_Schedule::visit( Chuck_UGen * ugen, t_CKTIME now )
+{
+    // already ticked or visited
+    if( ugen->m_time >= now || ugen->m_sched_mark == m_mark ) return;
+    // mark (system_tick() does this by setting m_time on entry)
+    ugen->m_sched_mark = m_mark;
+
+    // part 1: upstream ugens, then sum them
+    for( t_CKUINT i = 0; i < ugen->m_num_src; i++ )
+        visit( ugen->m_src_list[i], now );
+    m_steps.push_back( Step( ugen, OP_GATHER ) );
+
+    // multiple channels
+    if( ugen->m_multi_chan_size )
+    {
+        for( t_CKUINT i = 0; i < ugen->m_multi_chan_size; i++ )
+            visit( ugen->m_multi_chan[i], now );
+        m_steps.push_back( Step( ugen, OP_GATHER_MULTI ) );
+    }
+
+    // owner of this channel
+    Chuck_UGen * owner = ugen->owner_ugen;
+    if( owner != NULL && owner->m_time < now && owner->m_sched_mark != m_mark )
+    {
+        visit( owner, now );
+        // the owner's tickf synthesizes this channel
+        if( owner->tickf )
+        {
+            m_steps.push_back( Step( ugen, OP_LAST ) );
+            return;
+        }
+    }
+
+    // part 2
+    m_steps.push_back( Step( ugen, OP_SYNTHESIZE ) );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: tick()
+// desc: tick everything reachable from roots for `now`
+//-----------------------------------------------------------------------------
+void Chuck_UGen_Schedule::tick( Chuck_UGen * const * roots, t_CKUINT numRoots,
+                                t_CKTIME now )
+{
+    // rebuild if connections have changed
+    if( !current() ) rebuild( roots, numRoots, now );
+
+    // linear sweep
+    const Step * step = m_steps.data();
+    const Step * end = step + m_steps.size();
+    for( ; step != end; step++ )
+    {
+        switch( step->op )
+        {
+        case OP_GATHER: step->ugen->gather( now ); break;
+        case OP_GATHER_MULTI: step->ugen->gather_multi(); break;
+        case OP_SYNTHESIZE: step->ugen->synthesize(); break;
+        case OP_LAST: step->ugen->m_last = step->ugen->m_current; break;
+        }
+
+        // a tick (e.g., a Chugen) changed the graph; ugens not yet ticked
+        // still have m_time < now, so finish recursively
+        if( !current() )
+        {
+            for( t_CKUINT i = 0; i < numRoots; i++ )
+                if( roots[i] ) roots[i]->system_tick( now );
+            return;
+        }
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: tick_v()
+// desc: tick everything reachable from roots for numFrames ending at `now`
+//-----------------------------------------------------------------------------
+void Chuck_UGen_Schedule::tick_v( Chuck_UGen * const * roots, t_CKUINT numRoots,
+                                  t_CKTIME now, t_CKUINT numFrames )
+{
+    // rebuild if connections have changed
+    if( !current() ) rebuild( roots, numRoots, now );
+
+    // linear sweep
+    const Step * step = m_steps.data();
+    const Step * end = step + m_steps.size();
+    for( ; step != end; step++ )
+    {
+        switch( step->op )
+        {
+        case OP_GATHER: step->ugen->gather_v( now, numFrames ); break;
+        case OP_GATHER_MULTI: step->ugen->gather_multi_v( numFrames ); break;
+        case OP_SYNTHESIZE: step->ugen->synthesize_v( numFrames ); break;
+        case OP_LAST: step->ugen->m_last = step->ugen->m_current_v[numFrames-1]; break;
+        }
+
+        // graph changed mid-tick; finish recursively
+        if( !current() )
+        {
+            for( t_CKUINT i = 0; i < numRoots; i++ )
+                if( roots[i] ) roots[i]->system_tick_v( now, numFrames );
+            return;
+        }
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: Chuck_UGen_Parallel()
+// desc: constructor
+//-----------------------------------------------------------------------------
+Chuck_UGen_Parallel::Chuck_UGen_Parallel()
+    : m_next_pool( NULL ), m_retired( NULL ), m_num_threads( 0 ), m_next( 0 )
+{
+    m_num_serial = 0;
+    m_version = 0;
+    m_built = FALSE;
+    m_mark = 0;
+    m_pool = NULL;
+    m_now = 0;
+    m_num_frames = 0;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ~Chuck_UGen_Parallel()
+// desc: destructor
+//-----------------------------------------------------------------------------
+Chuck_UGen_Parallel::~Chuck_UGen_Parallel()
+{
+    reap();
+    CK_SAFE_DELETE( m_pool );
+    Pool * pool = m_next_pool.exchange( NULL );
+    CK_SAFE_DELETE( pool );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: set_threads()
+// desc: start a pool with numThreads workers, for tick_v() to switch to; the
+//       audio thread also renders, so N workers make for N+1 threads in all
+//-----------------------------------------------------------------------------
+void Chuck_UGen_Parallel::set_threads( t_CKUINT numThreads )
+{
+    // stop the pools no longer in use
+    reap();
+    if( numThreads == m_num_threads.load( std::memory_order_relaxed ) ) return;
+    m_num_threads.store( numThreads, std::memory_order_relaxed );
+
+    // the new pool; one never switched to (set twice between blocks) is
+    // stopped right away
+    Pool * unused = m_next_pool.exchange( new Pool( this, numThreads ), std::memory_order_acq_rel );
+    CK_SAFE_DELETE( unused );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: reap()
+// desc: stop the pools tick_v() has switched away from
+//-----------------------------------------------------------------------------
+void Chuck_UGen_Parallel::reap()
+{
+    Pool * pool = m_retired.exchange( NULL, std::memory_order_acquire );
+    while( pool )
+    {
+        Pool * next = pool->next;
+        delete pool;
+        pool = next;
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: Pool()
+// desc: start numThreads workers; they wait for the first block
+//-----------------------------------------------------------------------------
+Chuck_UGen_Parallel::Pool::Pool( Chuck_UGen_Parallel * o, t_CKUINT numThreads )
+    : owner( o ), generation( 0 ), finished( 0 ), quit( FALSE ), next( NULL )
+{
+    for( t_CKUINT i = 0; i < numThreads; i++ )
+        threads.push_back( std::thread( &Pool::worker, this ) );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ~Pool()
+// desc: stop and join the workers; they are between blocks
+//-----------------------------------------------------------------------------
+Chuck_UGen_Parallel::Pool::~Pool()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        quit = TRUE;
+    }
+    cond.notify_all();
+    for( t_CKUINT i = 0; i < threads.size(); i++ )
+        threads[i].join();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: find()
+// desc: union-find root, with path halving
+//-----------------------------------------------------------------------------
+t_CKUINT Chuck_UGen_Parallel::find( t_CKUINT i )
+{
+    while( m_parent[i] != i )
+    {
+        m_parent[i] = m_parent[m_parent[i]];
+        i = m_parent[i];
+    }
+    return i;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: touch()
+// desc: reset a ugen's partition state the first time a rebuild visits it
+//-----------------------------------------------------------------------------
+void Chuck_UGen_Parallel::touch( Chuck_UGen * ugen )
+{
+    if( ugen->m_par_mark == m_mark ) return;
+    ugen->m_par_mark = m_mark;
+    ugen->m_par_sink = FALSE;
+    ugen->m_par_root = FALSE;
+    ugen->m_par_owner = -1;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: expand()
+// desc: put a ugen in the sink (ticked by the caller after the groups) and
+//       consider its sources, in the order system_tick_v() visits them
+//-----------------------------------------------------------------------------
+void Chuck_UGen_Parallel::expand( Chuck_UGen * ugen, t_CKTIME now )
+{
+    touch( ugen );
+    ugen->m_par_sink = TRUE;
+    for( t_CKUINT c = 0; c < ugen->m_multi_chan_size; c++ )
+    {
+        touch( ugen->m_multi_chan[c] );
+        ugen->m_multi_chan[c]->m_par_sink = TRUE;
+    }
+
+    for( t_CKUINT i = 0; i < ugen->m_num_src; i++ )
+        consider( ugen->m_src_list[i], now );
+    for( t_CKUINT c = 0; c < ugen->m_multi_chan_size; c++ )
+    {
+        Chuck_UGen * chan = ugen->m_multi_chan[c];
+        for( t_CKUINT i = 0; i < chan->m_num_src; i++ )
+            consider( chan->m_src_list[i], now );
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: consider()
+// desc: look through a mono mixer whose outputs all go to the sink; anything
+//       else becomes a root, unless it is already ticked (e.g., the adc)
+//-----------------------------------------------------------------------------
+void Chuck_UGen_Parallel::consider( Chuck_UGen * ugen, t_CKTIME now )
+{
+    // already ticked
+    if( ugen->m_time >= now ) return;
+    // in the sink, or a root
+    touch( ugen );
+    if( ugen->m_par_sink || ugen->m_par_root ) return;
+
+    // a mixer?
+    t_CKBOOL mixer = ugen->m_num_src > 0 && ugen->m_multi_chan_size == 0
+                     && ugen->owner_ugen == NULL;
+    for( t_CKUINT i = 0; mixer && i < ugen->m_num_dest; i++ )
+    {
+        Chuck_UGen * dest = ugen->m_dest_list[i];
+        if( dest->m_par_mark != m_mark || !dest->m_par_sink ) mixer = FALSE;
+    }
+
+    if( mixer ) expand( ugen, now );
+    else
+    {
+        // new root
+        ugen->m_par_root = TRUE;
+        m_parent.push_back( m_roots.size() );
+        m_serial.push_back( FALSE );
+        m_roots.push_back( ugen );
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: claim()
+// desc: claim everything system_tick_v() would reach from a root, merging
+//       groups that meet; reaching the sink means feedback around it, which
+//       only the recursive tick gets right
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_UGen_Parallel::claim( Chuck_UGen * ugen, t_CKUINT root, t_CKTIME now )
+{
+    // already ticked
+    if( ugen->m_time >= now ) return TRUE;
+    touch( ugen );
+    // feedback
+    if( ugen->m_par_sink ) return FALSE;
+
+    // claimed already?
+    if( ugen->m_par_owner >= 0 )
+    {
+        // by another root: merge the two groups
+        t_CKUINT a = find( ugen->m_par_owner ), b = find( root );
+        if( a != b )
+        {
+            // keep the earlier one as representative
+            if( b < a ) { t_CKUINT t = a; a = b; b = t; }
+            m_parent[b] = a;
+            m_serial[a] = m_serial[a] || m_serial[b];
+        }
+        return TRUE;
+    }
+    ugen->m_par_owner = (t_CKINT)root;
+
+    // anything not isolated holds its group back
+    if( !ugen->m_tick_isolated ) m_serial[find( root )] = TRUE;
+
+    // what system_tick_v() visits
+    for( t_CKUINT i = 0; i < ugen->m_num_src; i++ )
+        if( !claim( ugen->m_src_list[i], root, now ) ) return FALSE;
+    for( t_CKUINT i = 0; i < ugen->m_multi_chan_size; i++ )
+        if( !claim( ugen->m_multi_chan[i], root, now ) ) return FALSE;
+    if( ugen->owner_ugen && !claim( ugen->owner_ugen, root, now ) ) return FALSE;
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: rebuild()
+// desc: partition the graph upstream of root into groups
+//       NOTE called at the top of a tick, like Chuck_UGen_Schedule::rebuild();
+//       its scratch keeps its memory, so once the graph has been this big
+//       a rebuild allocates nothing
+//-----------------------------------------------------------------------------
+void Chuck_UGen_Parallel::rebuild( Chuck_UGen * root, t_CKTIME now )
+{
+    // snapshot the version first; a change during rebuild forces another
+    m_version = Chuck_UGen_Schedule::s_graph_version.load( std::memory_order_relaxed );
+    m_built = TRUE;
+    // a fresh mark, so no ugen has state from an earlier rebuild
+    m_mark = Chuck_UGen_Schedule::s_next_mark.fetch_add( 1, std::memory_order_relaxed );
+    // clear (keeps capacity)
+    m_roots.clear();
+    m_groups.clear();
+    m_num_serial = 0;
+    m_parent.clear();
+    m_serial.clear();
+
+    // find the roots, looking through mixers
+    expand( root, now );
+
+    // claim upstream of each root
+    t_CKUINT numRoots = m_roots.size();
+    for( t_CKUINT i = 0; i < numRoots; i++ )
+    {
+        if( !claim( m_roots[i], i, now ) )
+        {
+            // feedback; leave it all to the caller
+            m_roots.clear();
+            m_num_serial = 1;
+            return;
+        }
+    }
+
+    // lay out the roots by group, keeping serial order within each
+    m_layout.clear();
+    m_count.assign( numRoots, 0 );
+    m_start.assign( numRoots, 0 );
+    for( t_CKUINT i = 0; i < numRoots; i++ )
+        m_count[find( i )]++;
+    for( t_CKUINT i = 0; i < numRoots; i++ )
+    {
+        if( find( i ) != i ) continue;
+        // groups that are not isolated stay with the caller
+        if( m_serial[i] ) { m_num_serial++; continue; }
+        m_start[i] = m_layout.size();
+        m_groups.push_back( Group( m_start[i], m_start[i] + m_count[i] ) );
+        m_layout.resize( m_layout.size() + m_count[i] );
+    }
+    for( t_CKUINT i = 0; i < numRoots; i++ )
+    {
+        t_CKUINT g = find( i );
+        if( !m_serial[g] ) m_layout[m_start[g]++] = m_roots[i];
+    }
+    m_roots.swap( m_layout );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: work()
+// desc: claim and tick groups until there are none left
+//-----------------------------------------------------------------------------
+void Chuck_UGen_Parallel::work()
+{
+    t_CKUINT numGroups = m_groups.size();
+    for( ;; )
+    {
+        t_CKUINT g = m_next.fetch_add( 1, std::memory_order_relaxed );
+        if( g >= numGroups ) break;
+        for( t_CKUINT i = m_groups[g].begin; i < m_groups[g].end; i++ )
+            if( m_roots[i]->m_time < m_now )
+                m_roots[i]->system_tick_v( m_now, m_num_frames );
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: worker()
+// desc: worker thread loop; spins briefly for the next block, then sleeps
+//-----------------------------------------------------------------------------
+void Chuck_UGen_Parallel::Pool::worker()
+{
+    // same priority as the audio thread, if set
+    if( XThreadUtil::our_priority != 0x7fffffff )
+        XThreadUtil::set_priority( XThreadUtil::our_priority );
+
+    t_CKUINT seen = 0;
+    for( ;; )
+    {
+        // spin for a bit; blocks come back to back under load
+        t_CKUINT gen = seen;
+        for( t_CKUINT i = 0; i < 2000 && gen == seen; i++ )
+            gen = generation.load( std::memory_order_acquire );
+        // then sleep
+        if( gen == seen )
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            while( !quit && (gen = generation.load( std::memory_order_acquire )) == seen )
+                cond.wait( lock );
+            if( quit ) return;
+        }
+        seen = gen;
+
+        // render, and report
+        owner->work();
+        finished.fetch_add( 1, std::memory_order_release );
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: tick_v()
+// desc: pre-tick the isolated groups upstream of root, on the workers and
+//       the calling thread, and wait for all of them
+//-----------------------------------------------------------------------------
+void Chuck_UGen_Parallel::tick_v( Chuck_UGen * root, t_CKTIME now, t_CKUINT numFrames )
+{
+    // switch to the pool set_threads() made, if any; the one before is
+    // between blocks, and is left for set_threads() to stop
+    if( m_next_pool.load( std::memory_order_relaxed ) )
+    {
+        Pool * pool = m_next_pool.exchange( NULL, std::memory_order_acq_rel );
+        if( pool && m_pool )
+        {
+            m_pool->next = m_retired.load( std::memory_order_relaxed );
+            while( !m_retired.compare_exchange_weak( m_pool->next, m_pool,
+                       std::memory_order_release, std::memory_order_relaxed ) ) { }
+        }
+        if( pool ) m_pool = pool;
+    }
+
+    // rebuild if connections have changed
+    if( !m_built || m_version != Chuck_UGen_Schedule::s_graph_version.load( std::memory_order_relaxed ) )
+        rebuild( root, now );
+
+    // the block
+    m_now = now;
+    m_num_frames = numFrames;
+    m_next.store( 0, std::memory_order_relaxed );
+
+    // not worth waking anyone
+    if( m_groups.size() < 2 || !m_pool || m_pool->threads.empty() )
+    {
+        work();
+        return;
+    }
+
+    // hand out the block (under the lock, so no sleeping worker misses it)
+    Pool * pool = m_pool;
+    pool->finished.store( 0, std::memory_order_relaxed );
+    {
+        std::lock_guard<std::mutex> lock( pool->mutex );
+        pool->generation.fetch_add( 1, std::memory_order_release );
+    }
+    pool->cond.notify_all();
+
+    // help out
+    work();
+
+    // join: every worker has seen this block and is done with it
+    while( pool->finished.load( std::memory_order_acquire ) < pool->threads.size() )
+        std::this_thread::yield();
+}
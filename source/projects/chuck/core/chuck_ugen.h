@@ -41,6 +41,11 @@
 #include "chuck_oo.h"
 #include "chuck_dl.h"
 #include "util_buffers.h"
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 
 // forward reference
@@ -85,6 +90,17 @@ public: // src
     Chuck_UGen * src_chan( t_CKUINT chan );
     Chuck_UGen * dst_for_src_chan( t_CKUINT chan );
 
+public: // non-recursive pieces of system_tick(), used by Chuck_UGen_Schedule
+    // gather input from sources (assumes sources already ticked for `now`)
+    void gather( t_CKTIME now );
+    void gather_v( t_CKTIME now, t_CKUINT numFrames );
+    // gather input from per-channel sub-ugens
+    void gather_multi();
+    void gather_multi_v( t_CKUINT numFrames );
+    // synthesize output from gathered input (part 2 of system_tick)
+    t_CKBOOL synthesize();
+    t_CKBOOL synthesize_v( t_CKUINT numFrames );
+
 protected:
     t_CKVOID add_by( Chuck_UGen * dest, t_CKBOOL isUpChuck );
     t_CKVOID remove_by( Chuck_UGen * dest );
@@ -94,6 +110,9 @@ public:
     f_tick tick;
     // multichannel/vectorized tick function (added 1.3.0.0)
     f_tickf tickf;
+    // mono block tick function; when set, used in place of tick for
+    // block-rate (e.g., adaptive mode) ticking (DL API 10.3)
+    f_tickv tickv;
     // msg function
     f_pmsg pmsg;
     // channels (if more than one is required)
@@ -158,6 +177,202 @@ public: // data
     // what a hack! (added some time after REFACTOR-2017)
     t_CKBOOL m_is_buffered;
     AccumBuffer m_buffer;
+
+    // visit mark used when (re)building a Chuck_UGen_Schedule
+    t_CKUINT m_sched_mark;
+    // partition state used when (re)building a Chuck_UGen_Parallel; only
+    // valid while m_par_mark is the rebuild's mark
+    t_CKUINT m_par_mark;
+    t_CKBOOL m_par_sink;
+    t_CKBOOL m_par_root;
+    t_CKINT m_par_owner;
+    // tick only touches this ugen's own state (see Chuck_UGen_Info::isolated)
+    t_CKBOOL m_tick_isolated;
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_UGen_Schedule
+// desc: flattened, topologically ordered pull-order of a UGen graph; it is
+//       recorded once from the same traversal system_tick() performs, and
+//       replayed as a linear sweep (no recursion or per-edge time checks)
+//       until the graph's connections change
+//-----------------------------------------------------------------------------
+struct Chuck_UGen_Schedule
+{
+public:
+    Chuck_UGen_Schedule();
+
+public:
+    // tick everything reachable from roots (e.g., dac and blackhole)
+    void tick( Chuck_UGen * const * roots, t_CKUINT numRoots, t_CKTIME now );
+    // vectorized edition
+    void tick_v( Chuck_UGen * const * roots, t_CKUINT numRoots, t_CKTIME now,
+                 t_CKUINT numFrames );
+    // number of steps in current schedule
+    t_CKUINT size() const { return m_steps.size(); }
+
+public:
+    // note a change in UGen connections; all schedules rebuild on next tick
+    static void graph_changed() { s_graph_version.fetch_add( 1, std::memory_order_relaxed ); }
+
+protected:
+    // step operations
+    enum { OP_GATHER = 0, OP_GATHER_MULTI, OP_SYNTHESIZE, OP_LAST };
+    struct Step
+    {
+        Chuck_UGen * ugen;
+        t_CKUINT op;
+        Step( Chuck_UGen * u, t_CKUINT o ) : ugen(u), op(o) { }
+    };
+
+protected:
+    // up to date?
+    t_CKBOOL current() const
+    { return m_built && m_version == s_graph_version.load( std::memory_order_relaxed ); }
+    // record the pull-order from roots
+    void rebuild( Chuck_UGen * const * roots, t_CKUINT numRoots, t_CKTIME now );
+    // record one ugen (and, first, what it pulls from)
+    void visit( Chuck_UGen * ugen, t_CKTIME now );
+
+protected:
+    // the flattened schedule
+    std::vector<Step> m_steps;
+    // graph version the schedule was built against
+    t_CKUINT m_version;
+    t_CKBOOL m_built;
+    // current visit mark (during rebuild)
+    t_CKUINT m_mark;
+
+    // bumped whenever any UGen connection changes
+    static std::atomic<t_CKUINT> s_graph_version;
+    // source of unique visit marks across schedules
+    static std::atomic<t_CKUINT> s_next_mark;
+
+    friend struct Chuck_UGen_Parallel;
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_UGen_Parallel
+// desc: renders independent voices feeding a root ugen (e.g., dac) on a
+//       persistent pool of worker threads; mixers between the voices and
+//       the root are looked through, and the voices are split into groups
+//       that share no ugens; groups whose ugens are all isolated (see
+//       Chuck_UGen_Info::isolated) are ticked ahead of time, each by one
+//       thread in the order serial rendering would use, and everything else
+//       is left to the caller's recursive tick of the root, which then only
+//       gathers the pre-ticked groups -- the output is bit-identical
+//-----------------------------------------------------------------------------
+struct Chuck_UGen_Parallel
+{
+public:
+    Chuck_UGen_Parallel();
+    ~Chuck_UGen_Parallel();
+
+public:
+    // set number of worker threads; 0 stops them
+    //   NOTE not on the audio thread: this starts and joins threads; the
+    //   new pool takes over at the next tick_v()
+    void set_threads( t_CKUINT numThreads );
+    // number of worker threads, as last set
+    t_CKUINT threads() const { return m_num_threads.load( std::memory_order_relaxed ); }
+    // pre-tick the isolated groups upstream of root for numFrames ending at
+    // `now`; the caller must then tick root (and anything else) as usual
+    void tick_v( Chuck_UGen * root, t_CKTIME now, t_CKUINT numFrames );
+    // number of groups ticked ahead of time / left to the caller
+    t_CKUINT num_parallel() const { return m_groups.size(); }
+    t_CKUINT num_serial() const { return m_num_serial; }
+
+protected:
+    // a set of ugens shared with no other group; m_roots[begin,end)
+    struct Group
+    {
+        t_CKUINT begin, end;
+        Group( t_CKUINT b, t_CKUINT e ) : begin(b), end(e) { }
+    };
+
+    // a pool of worker threads; made and stopped by set_threads(), used by
+    // tick_v() in between
+    struct Pool
+    {
+        Pool( Chuck_UGen_Parallel * owner, t_CKUINT numThreads );
+        // stop and join the workers
+        ~Pool();
+        // worker thread loop
+        void worker();
+
+        Chuck_UGen_Parallel * owner;
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable cond;
+        // bumped to hand out a block; workers wait on it
+        std::atomic<t_CKUINT> generation;
+        // workers done with the current block
+        std::atomic<t_CKUINT> finished;
+        // shutting down
+        t_CKBOOL quit;
+        // next in the list of retired pools
+        Pool * next;
+    };
+
+protected:
+    // (re)partition the graph upstream of root
+    void rebuild( Chuck_UGen * root, t_CKTIME now );
+    // this rebuild's partition state of a ugen, reset on first visit
+    void touch( Chuck_UGen * ugen );
+    // look through a ugen between the voices and the root
+    void expand( Chuck_UGen * ugen, t_CKTIME now );
+    // expand or add as a root
+    void consider( Chuck_UGen * ugen, t_CKTIME now );
+    // claim everything upstream of a root; FALSE on feedback into the sink
+    t_CKBOOL claim( Chuck_UGen * ugen, t_CKUINT root, t_CKTIME now );
+    // union-find over root indices
+    t_CKUINT find( t_CKUINT i );
+    // tick groups until none are left
+    void work();
+    // stop the pools tick_v() has switched away from
+    void reap();
+
+protected:
+    // roots in serial tick order, then rearranged by group
+    std::vector<Chuck_UGen *> m_roots;
+    // groups to tick ahead of time
+    std::vector<Group> m_groups;
+    // groups left to the caller
+    t_CKUINT m_num_serial;
+    // graph version the partition was built against
+    t_CKUINT m_version;
+    t_CKBOOL m_built;
+
+    // rebuild scratch, kept to reuse its memory: union-find parents,
+    // non-isolated groups, and the roots laid out by group; the rest of the
+    // partition state lives in the ugens (see Chuck_UGen::m_par_mark)
+    std::vector<t_CKUINT> m_parent;
+    std::vector<t_CKBOOL> m_serial;
+    std::vector<Chuck_UGen *> m_layout;
+    std::vector<t_CKUINT> m_count;
+    std::vector<t_CKUINT> m_start;
+    // current visit mark (during rebuild)
+    t_CKUINT m_mark;
+
+    // the pool in use (audio thread)
+    Pool * m_pool;
+    // a pool set_threads() has made, for tick_v() to switch to
+    std::atomic<Pool *> m_next_pool;
+    // pools tick_v() has switched away from, for set_threads() to stop
+    std::atomic<Pool *> m_retired;
+    // number of worker threads, as last set
+    std::atomic<t_CKUINT> m_num_threads;
+    // next group to claim
+    std::atomic<t_CKUINT> m_next;
+    // the block being rendered
+    t_CKTIME m_now;
+    t_CKUINT m_num_frames;
 };
 
 
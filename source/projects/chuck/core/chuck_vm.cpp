@@ -59,6 +59,8 @@
 #include <iomanip>
 #include <string>
 #include <algorithm>
+#include <map>
+#include <typeinfo>
 using namespace std;
 
 
@@ -90,6 +92,61 @@ using namespace std;
 
 
 
+//-----------------------------------------------------------------------------
+// name: struct Chuck_VM_Op_Pairs
+// desc: dynamic instruction pair counts across all shreds of a VM; when
+//       enabled, every instruction is counted, and the most frequent pairs
+//       are printed on VM shutdown; used to choose which sequences to fuse
+//       into superinstructions (see ck_fuse_ops())
+//-----------------------------------------------------------------------------
+struct Chuck_VM_Op_Pair_Count
+{
+    std::string first;
+    std::string second;
+    t_CKUINT count;
+};
+struct Chuck_VM_Op_Pairs
+{
+    std::map< std::pair<const char *, const char *>, Chuck_VM_Op_Pair_Count > counts;
+    t_CKUINT total;
+
+    Chuck_VM_Op_Pairs() : total( 0 ) { }
+};
+static void ckvm_count_op_pair( Chuck_VM_Op_Pairs * p, Chuck_Instr * prev, Chuck_Instr * curr )
+{
+    p->total++;
+    if( !prev ) return;
+
+    // key by type, name on first sight
+    std::pair<const char *, const char *> key( typeid(*prev).name(), typeid(*curr).name() );
+    std::map< std::pair<const char *, const char *>, Chuck_VM_Op_Pair_Count >::iterator it = p->counts.find( key );
+    if( it == p->counts.end() )
+    {
+        Chuck_VM_Op_Pair_Count & c = p->counts[key];
+        c.first = prev->name(); c.second = curr->name(); c.count = 1;
+    }
+    else it->second.count++;
+}
+static void ckvm_dump_op_pairs( Chuck_VM_Op_Pairs * p )
+{
+    // sort by count
+    std::vector<Chuck_VM_Op_Pair_Count> pairs;
+    std::map< std::pair<const char *, const char *>, Chuck_VM_Op_Pair_Count >::iterator it;
+    for( it = p->counts.begin(); it != p->counts.end(); it++ ) pairs.push_back( it->second );
+    std::sort( pairs.begin(), pairs.end(),
+        []( const Chuck_VM_Op_Pair_Count & a, const Chuck_VM_Op_Pair_Count & b ) { return a.count > b.count; } );
+
+    CK_FPRINTF_STDERR( "[chuck]:(VM DEBUG) %lu instructions executed; most frequent pairs:\n", p->total );
+    for( t_CKUINT i = 0; i < pairs.size() && i < 50; i++ )
+    {
+        CK_FPRINTF_STDERR( "[chuck]:(VM DEBUG) %12lu %5.2f%% %s -> %s\n", pairs[i].count,
+                           100.0 * pairs[i].count / p->total,
+                           pairs[i].first.c_str(), pairs[i].second.c_str() );
+    }
+}
+
+
+
 
 //-----------------------------------------------------------------------------
 // name: struct SortByID_LT()
@@ -188,6 +245,7 @@ Chuck_VM::Chuck_VM()
     m_init = FALSE;
     m_halt = TRUE;
     m_is_running = FALSE;
+    m_op_pairs = NULL;
 
     // shred management
     m_num_shreds = 0;
@@ -228,6 +286,8 @@ Chuck_VM::~Chuck_VM()
         // cleanup
         shutdown();
     }
+    // in case never initialized
+    CK_SAFE_DELETE( m_op_pairs );
 }
 
 
@@ -264,6 +324,8 @@ t_CKBOOL Chuck_VM::initialize( t_CKUINT srate, t_CKUINT dac_chan,
     m_shreduler = new Chuck_VM_Shreduler;
     m_shreduler->vm_ref = this;
     m_shreduler->set_adaptive( adaptive > 0 ? adaptive : 0 );
+    // stats need the VM for shreduler time
+    CK_TRACK( Chuck_Stats::instance()->set_vm_ref( this ) );
 
     // log
     EM_log( CK_LOG_SYSTEM, "allocating messaging buffers..." );
@@ -367,6 +429,7 @@ t_CKBOOL Chuck_VM::initialize_synthesis()
     m_bunghole->lock();
     initialize_object( m_bunghole, env()->ckt_ugen, NULL, this );
     m_bunghole->tick = NULL;
+    m_bunghole->tickv = NULL;
     m_bunghole->alloc_v( m_shreduler->m_max_block_size );
     m_shreduler->m_dac = m_dac;
     m_shreduler->m_adc = m_adc;
@@ -413,6 +476,9 @@ t_CKBOOL Chuck_VM::shutdown()
     // push indent
     EM_pushlog();
 
+    // if enabled, print instruction pair counts
+    if( m_op_pairs ) { ckvm_dump_op_pairs( m_op_pairs ); CK_SAFE_DELETE( m_op_pairs ); }
+
     // unlockdown
     // REFACTOR-2017: TODO: don't unlock all objects for all VMs? see relockdown below
     Chuck_VM_Object::unlock_all();
@@ -683,8 +749,15 @@ t_CKBOOL Chuck_VM::run( t_CKINT N, const SAMPLE * input, SAMPLE * output )
         // advance the shreduler
         if( !m_shreduler->m_adaptive )
         {
-            m_shreduler->advance( frame++ );
-            if( N > 0 ) N--;
+            // block-rate shreduling: tick straight through to the next wake time
+            t_CKINT frames = m_shreduler->m_block_shreduling ?
+                             m_shreduler->frames_until_next( N ) : 1;
+            // advance one sample at a time (UGen graph stays sample-accurate)
+            while( frames-- > 0 )
+            {
+                m_shreduler->advance( frame++ );
+                if( N > 0 ) N--;
+            }
         }
         else m_shreduler->advance_v( N, frame );
     }
@@ -1204,6 +1277,19 @@ t_CKUINT Chuck_VM::srate() const
 
 
 
+//-----------------------------------------------------------------------------
+// name: set_op_pairs()
+// desc: enable/disable counting executed instruction pairs
+//-----------------------------------------------------------------------------
+void Chuck_VM::set_op_pairs( t_CKBOOL enable )
+{
+    if( enable && !m_op_pairs ) m_op_pairs = new Chuck_VM_Op_Pairs;
+    else if( !enable ) CK_SAFE_DELETE( m_op_pairs );
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: now() | 1.5.0.8 (ge) added
 // desc: get the current chuck time
@@ -1744,6 +1830,7 @@ Chuck_VM_Code::Chuck_VM_Code()
 {
     instr = NULL;
     num_instr = 0;
+    ops = NULL;
     stack_depth = 0;
     need_this = FALSE;
     is_static = FALSE;
@@ -1770,6 +1857,8 @@ Chuck_VM_Code::~Chuck_VM_Code()
         // free the array
         CK_SAFE_DELETE_ARRAY( instr );
     }
+    // free the ops
+    CK_SAFE_DELETE_ARRAY( ops );
 
     num_instr = 0;
 }
@@ -1777,6 +1866,19 @@ Chuck_VM_Code::~Chuck_VM_Code()
 
 
 
+//-----------------------------------------------------------------------------
+// name: lower()
+// desc: lower instr to compact ops, for the shred run loop
+//-----------------------------------------------------------------------------
+void Chuck_VM_Code::lower()
+{
+    CK_SAFE_DELETE_ARRAY( ops );
+    if( instr ) ops = ck_lower_instr( instr, num_instr );
+}
+
+
+
+
 // minimum stack size | 1.5.1.5 (ge) added
 #define VM_STACK_MINIMUM_SIZE 2048
 // offset in bytes at the beginning of a stack for initializing data
@@ -1866,7 +1968,8 @@ Chuck_VM_Shred::Chuck_VM_Shred()
     mem = NULL;
     reg = NULL;
     code = code_orig = NULL;
-    next = prev = NULL;
+    heap_index = -1;
+    shredule_seq = 0;
     instr = NULL;
     parent = NULL;
     base_ref = NULL;
@@ -2347,6 +2450,10 @@ static void ckvm_observe_stackdepth_across_all_shreds( Chuck_VM_Shred * currentS
 
 
 
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: run()
 // desc: run this shred's VM code
@@ -2358,10 +2465,27 @@ t_CKBOOL Chuck_VM_Shred::run( Chuck_VM * vm )
     is_running = TRUE;
     // pointer to running state
     const t_CKBOOL * loop_running = &(vm_ref->runningState());
+    // lowered ops of the current code (NULL: execute instr only)
+    Chuck_VM_Code * ops_code = code;
+    const Chuck_VM_Op * ops = code->ops;
+    // instruction pair counts, if enabled (every instruction through execute())
+    Chuck_VM_Op_Pairs * op_pairs = vm->op_pairs();
+    Chuck_Instr * prev = NULL;
+    if( op_pairs ) ops = NULL;
 
     // go!
     while( is_running && *loop_running && !is_abort )
     {
+#if !CK_VM_STACK_DEBUG_ENABLE
+        // run compact ops inline, up to the next instruction that isn't one
+        if( ops && ops[pc].op != CK_OP_INSTR )
+        {
+            // stop on overflow, or if interrupted in a loop
+            if( !run_ops( ops, loop_running ) ) break;
+            // interrupted in a loop
+            if( !*loop_running || is_abort ) continue;
+        }
+#endif
 //-----------------------------------------------------------------------------
 CK_VM_STACK_DEBUG( CK_FPRINTF_STDERR( "CK_VM_DEBUG =--------------------------------=\n" ) );
 CK_VM_STACK_DEBUG( CK_FPRINTF_STDERR( "CK_VM_DEBUG shred %04lu code %s pc %04lu %s( %s )\n",
@@ -2370,6 +2494,8 @@ CK_VM_STACK_DEBUG( CK_FPRINTF_STDERR( "CK_VM_DEBUG shred %04lu code %s pc %04lu
 CK_VM_STACK_DEBUG( t_CKBYTE * t_mem_sp = this->mem->sp );
 CK_VM_STACK_DEBUG( t_CKBYTE * t_reg_sp = this->reg->sp );
 //-----------------------------------------------------------------------------
+        // count instruction pairs
+        if( op_pairs ) { ckvm_count_op_pair( op_pairs, prev, instr[pc] ); prev = instr[pc]; }
         // execute the instruction
         instr[pc]->execute( vm, this );
 //-----------------------------------------------------------------------------
@@ -2390,6 +2516,8 @@ CK_VM_STACK_DEBUG( CK_FPRINTF_STDERR( "CK_VM_DEBUG reg sp in: 0x%08lx out: 0x%08
         pc = next_pc;
         // advance program counter
         next_pc++;
+        // function call or return: switch ops along with code
+        if( code != ops_code ) { ops_code = code; ops = op_pairs ? NULL : code->ops; }
 
         // track number of cycles
         CK_TRACK( this->stat->cycles++ );
@@ -2413,6 +2541,222 @@ CK_VM_STACK_DEBUG( CK_FPRINTF_STDERR( "CK_VM_DEBUG reg sp in: 0x%08lx out: 0x%08
 
 
 
+//-----------------------------------------------------------------------------
+// name: run_ops()
+// desc: execute compact ops from pc, with the operand stack pointer held
+//       locally, until reaching a CK_OP_INSTR; these ops never call, yield,
+//       or touch the mem stack pointer, so only the operand stack and pc
+//       need writing back; returns FALSE if the shred should stop
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_VM_Shred::run_ops( const Chuck_VM_Op * ops, const t_CKBOOL * loop_running )
+{
+    t_CKBYTE * sp = reg->sp;
+    t_CKBYTE * sp_max = reg->sp_max;
+    t_CKBYTE * mem_sp = mem->sp;
+    t_CKUINT p = pc;
+    CK_TRACK( t_CKUINT count = 0 );
+    t_CKBOOL ok = TRUE;
+
+// push onto / pop off the operand stack, as a given type
+#define CK_OP_PUSH( type, val ) do { *(type *)sp = (val); sp += sizeof(type); } while(0)
+#define CK_OP_POP( type, n ) do { sp -= (n) * sizeof(type); } while(0)
+// binary op: pop two of type, push expr as rtype
+#define CK_OP_BINARY( type, rtype, expr ) \
+    { type * a = (type *)sp - 2; *(rtype *)a = (rtype)(expr); sp = (t_CKBYTE *)((rtype *)a + 1); p++; break; }
+// conditional jump; backward jumps check whether to keep running
+#define CK_OP_JUMP( target ) \
+    { t_CKUINT t = (target); if( t <= p && (!*loop_running || is_abort) ) { p = t; goto done; } p = t; }
+
+    for( ;; )
+    {
+        const Chuck_VM_Op & op = ops[p];
+        CK_TRACK( count++ );
+        switch( op.op )
+        {
+        case CK_OP_REG_PUSH_IMM: CK_OP_PUSH( t_CKUINT, op.uval ); p++; break;
+        case CK_OP_REG_PUSH_IMM2: CK_OP_PUSH( t_CKFLOAT, op.fval ); p++; break;
+        case CK_OP_REG_PUSH_MEM: CK_OP_PUSH( t_CKUINT, *(t_CKUINT *)(mem_sp + op.uval) ); p++; break;
+        case CK_OP_REG_PUSH_MEM_BASE: CK_OP_PUSH( t_CKUINT, *(t_CKUINT *)(base_ref->stack + op.uval) ); p++; break;
+        case CK_OP_REG_PUSH_MEM2: CK_OP_PUSH( t_CKFLOAT, *(t_CKFLOAT *)(mem_sp + op.uval) ); p++; break;
+        case CK_OP_REG_PUSH_MEM2_BASE: CK_OP_PUSH( t_CKFLOAT, *(t_CKFLOAT *)(base_ref->stack + op.uval) ); p++; break;
+        case CK_OP_REG_PUSH_MEM_ADDR: CK_OP_PUSH( t_CKUINT, (t_CKUINT)(mem_sp + op.uval) ); p++; break;
+        case CK_OP_REG_PUSH_MEM_ADDR_BASE: CK_OP_PUSH( t_CKUINT, (t_CKUINT)(base_ref->stack + op.uval) ); p++; break;
+        case CK_OP_REG_POP_INT: CK_OP_POP( t_CKUINT, 1 ); p++; break;
+        case CK_OP_REG_POP_FLOAT: CK_OP_POP( t_CKFLOAT, 1 ); p++; break;
+        case CK_OP_REG_POP_WORDS: pop_( sp, op.uval * sz_WORD ); p++; break;
+
+        case CK_OP_ASSIGN_PRIMITIVE:
+            // [value, addr] -> store, leave [value]
+            CK_OP_POP( t_CKUINT, 1 );
+            *(t_CKUINT *)(*(t_CKUINT *)sp) = *((t_CKUINT *)sp - 1);
+            p++; break;
+        case CK_OP_ASSIGN_PRIMITIVE2:
+            // [value, addr] -> store, leave [value]
+            CK_OP_POP( t_CKUINT, 1 );
+            *(t_CKFLOAT *)(*(t_CKUINT *)sp) = *((t_CKFLOAT *)sp - 1);
+            p++; break;
+
+        case CK_OP_ADD_INT: CK_OP_BINARY( t_CKINT, t_CKINT, a[0] + a[1] )
+        case CK_OP_MINUS_INT: CK_OP_BINARY( t_CKINT, t_CKINT, a[0] - a[1] )
+        case CK_OP_TIMES_INT: CK_OP_BINARY( t_CKINT, t_CKINT, a[0] * a[1] )
+        case CK_OP_ADD_DOUBLE: CK_OP_BINARY( t_CKFLOAT, t_CKFLOAT, a[0] + a[1] )
+        case CK_OP_MINUS_DOUBLE: CK_OP_BINARY( t_CKFLOAT, t_CKFLOAT, a[0] - a[1] )
+        case CK_OP_TIMES_DOUBLE: CK_OP_BINARY( t_CKFLOAT, t_CKFLOAT, a[0] * a[1] )
+        case CK_OP_DIVIDE_DOUBLE: CK_OP_BINARY( t_CKFLOAT, t_CKFLOAT, a[0] / a[1] )
+        case CK_OP_LT_INT: CK_OP_BINARY( t_CKINT, t_CKINT, a[0] < a[1] )
+        case CK_OP_GT_INT: CK_OP_BINARY( t_CKINT, t_CKINT, a[0] > a[1] )
+        case CK_OP_LE_INT: CK_OP_BINARY( t_CKINT, t_CKINT, a[0] <= a[1] )
+        case CK_OP_GE_INT: CK_OP_BINARY( t_CKINT, t_CKINT, a[0] >= a[1] )
+        case CK_OP_EQ_INT: CK_OP_BINARY( t_CKINT, t_CKINT, a[0] == a[1] )
+        case CK_OP_NEQ_INT: CK_OP_BINARY( t_CKINT, t_CKINT, a[0] != a[1] )
+        case CK_OP_LT_DOUBLE: CK_OP_BINARY( t_CKFLOAT, t_CKUINT, a[0] < a[1] )
+        case CK_OP_GT_DOUBLE: CK_OP_BINARY( t_CKFLOAT, t_CKUINT, a[0] > a[1] )
+        case CK_OP_LE_DOUBLE: CK_OP_BINARY( t_CKFLOAT, t_CKUINT, a[0] <= a[1] )
+        case CK_OP_GE_DOUBLE: CK_OP_BINARY( t_CKFLOAT, t_CKUINT, a[0] >= a[1] )
+
+        case CK_OP_PREINC_INT:
+        {
+            // [addr] -> [value after]
+            t_CKINT * a = (t_CKINT *)sp - 1;
+            *a = ++(**(t_CKINT **)a);
+            p++; break;
+        }
+        case CK_OP_POSTINC_INT:
+        {
+            // [addr] -> [value before]
+            t_CKINT * a = (t_CKINT *)sp - 1;
+            *a = (**(t_CKINT **)a)++;
+            p++; break;
+        }
+        case CK_OP_CAST_INT2DOUBLE:
+        {
+            CK_OP_POP( t_CKINT, 1 );
+            t_CKINT v = *(t_CKINT *)sp;
+            CK_OP_PUSH( t_CKFLOAT, (t_CKFLOAT)v );
+            p++; break;
+        }
+        case CK_OP_CAST_DOUBLE2INT:
+        {
+            CK_OP_POP( t_CKFLOAT, 1 );
+            t_CKFLOAT v = *(t_CKFLOAT *)sp;
+            CK_OP_PUSH( t_CKINT, (t_CKINT)v );
+            p++; break;
+        }
+
+        case CK_OP_BRANCH_EQ_INT:
+            CK_OP_POP( t_CKINT, 2 );
+            if( ((t_CKINT *)sp)[0] == ((t_CKINT *)sp)[1] ) CK_OP_JUMP( op.uval ) else p++;
+            break;
+        case CK_OP_BRANCH_NEQ_INT:
+            CK_OP_POP( t_CKINT, 2 );
+            if( ((t_CKINT *)sp)[0] != ((t_CKINT *)sp)[1] ) CK_OP_JUMP( op.uval ) else p++;
+            break;
+        case CK_OP_GOTO:
+            CK_OP_JUMP( op.uval )
+            break;
+        case CK_OP_REG_DUP_LAST:
+            CK_OP_PUSH( t_CKUINT, *((t_CKUINT *)sp - 1) ); p++; break;
+
+        // superinstructions (see ck_fuse_ops()); each skips what it covers
+        case CK_OP_PUSH_MEM_MEM:
+            CK_OP_PUSH( t_CKUINT, *(t_CKUINT *)(mem_sp + op.uval) );
+            CK_OP_PUSH( t_CKUINT, *(t_CKUINT *)(mem_sp + op.uval2) );
+            p += 2; break;
+        case CK_OP_PUSH_MEM_MEM_BASE:
+            CK_OP_PUSH( t_CKUINT, *(t_CKUINT *)(base_ref->stack + op.uval) );
+            CK_OP_PUSH( t_CKUINT, *(t_CKUINT *)(base_ref->stack + op.uval2) );
+            p += 2; break;
+        case CK_OP_PUSH_MEM_IMM:
+            CK_OP_PUSH( t_CKUINT, *(t_CKUINT *)(mem_sp + op.uval) );
+            CK_OP_PUSH( t_CKUINT, op.uval2 );
+            p += 2; break;
+        case CK_OP_PUSH_MEM_IMM_BASE:
+            CK_OP_PUSH( t_CKUINT, *(t_CKUINT *)(base_ref->stack + op.uval) );
+            CK_OP_PUSH( t_CKUINT, op.uval2 );
+            p += 2; break;
+        case CK_OP_PUSH_IMM_AS_FLOAT:
+            CK_OP_PUSH( t_CKFLOAT, op.fval ); p += 2; break;
+
+        case CK_OP_ADD_INT_IMM: *((t_CKINT *)sp - 1) += (t_CKINT)op.uval; p += 2; break;
+        case CK_OP_MINUS_INT_IMM: *((t_CKINT *)sp - 1) -= (t_CKINT)op.uval; p += 2; break;
+        case CK_OP_TIMES_INT_IMM: *((t_CKINT *)sp - 1) *= (t_CKINT)op.uval; p += 2; break;
+        case CK_OP_ADD_DOUBLE_IMM: *((t_CKFLOAT *)sp - 1) += op.fval; p += 2; break;
+        case CK_OP_MINUS_DOUBLE_IMM: *((t_CKFLOAT *)sp - 1) -= op.fval; p += 2; break;
+        case CK_OP_TIMES_DOUBLE_IMM: *((t_CKFLOAT *)sp - 1) *= op.fval; p += 2; break;
+        case CK_OP_DIVIDE_DOUBLE_IMM: *((t_CKFLOAT *)sp - 1) /= op.fval; p += 2; break;
+
+// compare two of type, jump if false, else skip compare/push/branch
+#define CK_OP_BRANCH_FALSE( type, cmp ) \
+    { CK_OP_POP( type, 2 ); type * a = (type *)sp; \
+      if( !(a[0] cmp a[1]) ) CK_OP_JUMP( op.uval ) else p += 3; break; }
+        case CK_OP_LT_INT_BRANCH_FALSE: CK_OP_BRANCH_FALSE( t_CKINT, < )
+        case CK_OP_GT_INT_BRANCH_FALSE: CK_OP_BRANCH_FALSE( t_CKINT, > )
+        case CK_OP_LE_INT_BRANCH_FALSE: CK_OP_BRANCH_FALSE( t_CKINT, <= )
+        case CK_OP_GE_INT_BRANCH_FALSE: CK_OP_BRANCH_FALSE( t_CKINT, >= )
+        case CK_OP_EQ_INT_BRANCH_FALSE: CK_OP_BRANCH_FALSE( t_CKINT, == )
+        case CK_OP_NEQ_INT_BRANCH_FALSE: CK_OP_BRANCH_FALSE( t_CKINT, != )
+        case CK_OP_LT_DOUBLE_BRANCH_FALSE: CK_OP_BRANCH_FALSE( t_CKFLOAT, < )
+        case CK_OP_GT_DOUBLE_BRANCH_FALSE: CK_OP_BRANCH_FALSE( t_CKFLOAT, > )
+        case CK_OP_LE_DOUBLE_BRANCH_FALSE: CK_OP_BRANCH_FALSE( t_CKFLOAT, <= )
+        case CK_OP_GE_DOUBLE_BRANCH_FALSE: CK_OP_BRANCH_FALSE( t_CKFLOAT, >= )
+#undef CK_OP_BRANCH_FALSE
+
+        case CK_OP_ASSIGN_POP:
+            // [value, addr] -> store, leave nothing
+            CK_OP_POP( t_CKUINT, 2 );
+            *(t_CKUINT *)(((t_CKUINT *)sp)[1]) = *(t_CKUINT *)sp;
+            p += 2; break;
+        case CK_OP_ASSIGN_POP2:
+            // [value, addr] -> store, leave nothing
+            CK_OP_POP( t_CKUINT, 1 );
+            CK_OP_POP( t_CKFLOAT, 1 );
+            *(t_CKFLOAT *)(*(t_CKUINT *)((t_CKFLOAT *)sp + 1)) = *(t_CKFLOAT *)sp;
+            p += 2; break;
+        case CK_OP_STORE_MEM:
+            CK_OP_POP( t_CKUINT, 1 ); *(t_CKUINT *)(mem_sp + op.uval) = *(t_CKUINT *)sp; p += 3; break;
+        case CK_OP_STORE_MEM_BASE:
+            CK_OP_POP( t_CKUINT, 1 ); *(t_CKUINT *)(base_ref->stack + op.uval) = *(t_CKUINT *)sp; p += 3; break;
+        case CK_OP_STORE_MEM2:
+            CK_OP_POP( t_CKFLOAT, 1 ); *(t_CKFLOAT *)(mem_sp + op.uval) = *(t_CKFLOAT *)sp; p += 3; break;
+        case CK_OP_STORE_MEM2_BASE:
+            CK_OP_POP( t_CKFLOAT, 1 ); *(t_CKFLOAT *)(base_ref->stack + op.uval) = *(t_CKFLOAT *)sp; p += 3; break;
+        case CK_OP_INC_MEM:
+            (*(t_CKINT *)(mem_sp + op.uval))++; p += 3; break;
+        case CK_OP_INC_MEM_BASE:
+            (*(t_CKINT *)(base_ref->stack + op.uval))++; p += 3; break;
+        case CK_OP_SKIP:
+            p += op.uval; break;
+
+        default:
+            // CK_OP_INSTR: leave it to the caller
+            goto done;
+        }
+
+        // detect operand stack overflow
+        if( sp > sp_max ) { ok = FALSE; goto done; }
+    }
+
+done:
+#undef CK_OP_JUMP
+#undef CK_OP_BINARY
+#undef CK_OP_PUSH
+#undef CK_OP_POP
+    // write back
+    reg->sp = sp;
+    pc = p;
+    next_pc = p + 1;
+    CK_TRACK( this->stat->cycles += count );
+    // if enabled, update shred stacks depth observation
+    CK_VM_STACK_OBSERVE( ckvm_observe_stackdepth_across_all_shreds( this ) );
+    // handle overflow after writing back
+    if( !ok ) ck_handle_overflow( this, vm_ref, "shred operand stack exceeded" );
+
+    return ok;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: yield() | 1.5.0.5 (ge) made this a function from scattered code
 // desc: yield the shred in vm (without advancing time, politely yield to run
@@ -2581,7 +2925,7 @@ Chuck_VM_Shreduler::Chuck_VM_Shreduler()
 {
     now_system = 0;
     vm_ref = NULL;
-    shred_list = NULL;
+    m_shredule_seq = 0;
     m_current_shred = NULL;
     m_dac = NULL;
     m_adc = NULL;
@@ -2590,6 +2934,9 @@ Chuck_VM_Shreduler::Chuck_VM_Shreduler()
     m_num_adc_channels = 0;
 
     set_adaptive( 0 );
+    set_block_shreduling( FALSE );
+    set_ugen_schedule( FALSE );
+    set_ugen_threads( 0 );
 }
 
 
@@ -2645,6 +2992,80 @@ void Chuck_VM_Shreduler::set_adaptive( t_CKUINT max_block_size )
 
 
 
+//-----------------------------------------------------------------------------
+// name: set_block_shreduling()
+// desc: set block-rate shreduling; when enabled, the VM runs compute() only
+//       at sample boundaries where a shred is due to wake (or at the start of
+//       each block handed to Chuck_VM::run()), and ticks the UGen graph
+//       straight through in between; this is sample-accurate for shreds
+//       advancing time, while events / messages / global requests queued
+//       from other threads are serviced at the next such boundary
+//-----------------------------------------------------------------------------
+void Chuck_VM_Shreduler::set_block_shreduling( t_CKBOOL onOff )
+{
+    m_block_shreduling = onOff;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: set_ugen_schedule()
+// desc: when enabled, the UGen graph reachable from dac and blackhole is
+//       ticked from a flattened schedule (see Chuck_UGen_Schedule) that is
+//       rebuilt only when connections change; output is identical
+//       NOTE may be called from a thread other than the audio thread
+//-----------------------------------------------------------------------------
+void Chuck_VM_Shreduler::set_ugen_schedule( t_CKBOOL onOff )
+{
+    // start fresh next time (the schedule itself belongs to the audio thread)
+    Chuck_UGen_Schedule::graph_changed();
+    m_use_ugen_schedule.store( onOff, std::memory_order_relaxed );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: set_ugen_threads()
+// desc: when numThreads > 0 and in adaptive mode, voices feeding the dac that
+//       share no ugens are rendered on numThreads worker threads plus the
+//       audio thread (see Chuck_UGen_Parallel); output is identical
+//       NOTE not on the audio thread: this starts and stops the workers,
+//       which take over at the next block
+//-----------------------------------------------------------------------------
+void Chuck_VM_Shreduler::set_ugen_threads( t_CKUINT numThreads )
+{
+    m_ugen_parallel.set_threads( numThreads );
+    m_ugen_threads.store( numThreads, std::memory_order_relaxed );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: frames_until_next()
+// desc: number of frames that can be advanced before the next shred on the
+//       shreduler's ready list is due; clamped to [1, max_frames]
+//-----------------------------------------------------------------------------
+t_CKINT Chuck_VM_Shreduler::frames_until_next( t_CKINT max_frames ) const
+{
+    // nothing shreduled; the entire block is free
+    if( shred_heap.empty() ) return max_frames > 1 ? max_frames : 1;
+
+    // get() releases a shred when wake_time <= now + .5; find the first
+    // integer frame offset at which that becomes true
+    t_CKTIME delta = shred_heap[0]->wake_time - .5 - this->now_system;
+    t_CKINT frames = delta <= 1 ? 1 : (t_CKINT)ceil( delta );
+
+    // clamp
+    if( frames > max_frames ) frames = max_frames;
+    return frames > 1 ? frames : 1;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: add_blocked()
 // desc: add shred to the shreduler's blocked list
@@ -2708,7 +3129,7 @@ t_CKBOOL Chuck_VM_Shreduler::shredule( Chuck_VM_Shred * shred,
                                        t_CKTIME wake_time )
 {
     // sanity check
-    if( shred->prev || shred->next )
+    if( shred->heap_index >= 0 )
     {
         // something is really wrong here - no shred can be
         // shreduled more than once
@@ -2737,48 +3158,118 @@ t_CKBOOL Chuck_VM_Shreduler::shredule( Chuck_VM_Shred * shred,
 
     // set wake time
     shred->wake_time = wake_time;
+    // stamp order of arrival; shreds with equal wake times run FIFO
+    shred->shredule_seq = m_shredule_seq++;
 
-    // list empty
-    if( !shred_list )
-        shred_list = shred;
-    else
+    // insert into the ready heap; O(log n)
+    shred_heap.push_back( shred );
+    heap_set( (t_CKINT)shred_heap.size() - 1, shred );
+    heap_sift_up( shred->heap_index );
+
+    t_CKTIME diff = shred_heap[0]->wake_time - this->now_system;
+    if( diff < 0 ) diff = 0;
+    // if( diff < m_samps_until_next )
+    m_samps_until_next = diff;
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: heap_before()
+// desc: ready heap ordering; earlier wake time first, then the shred that
+//       was shreduled first (matching the FIFO order of the original list)
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_VM_Shreduler::heap_before( const Chuck_VM_Shred * a,
+                                          const Chuck_VM_Shred * b )
+{
+    if( a->wake_time != b->wake_time ) return a->wake_time < b->wake_time;
+    return a->shredule_seq < b->shredule_seq;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: heap_set()
+// desc: place shred at heap position i and record its index
+//-----------------------------------------------------------------------------
+void Chuck_VM_Shreduler::heap_set( t_CKINT i, Chuck_VM_Shred * shred )
+{
+    shred_heap[i] = shred;
+    shred->heap_index = i;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: heap_sift_up()
+// desc: move the shred at position i up until its parent precedes it
+//-----------------------------------------------------------------------------
+void Chuck_VM_Shreduler::heap_sift_up( t_CKINT i )
+{
+    Chuck_VM_Shred * shred = shred_heap[i];
+    while( i > 0 )
     {
-        // pointers to the shred queue
-        Chuck_VM_Shred * curr = shred_list;
-        Chuck_VM_Shred * prev = NULL;
+        t_CKINT parent = (i-1) >> 1;
+        if( !heap_before( shred, shred_heap[parent] ) ) break;
+        heap_set( i, shred_heap[parent] );
+        i = parent;
+    }
+    heap_set( i, shred );
+}
 
-        while( curr )
-        {
-            // found the place to insert
-            if( curr->wake_time > wake_time )
-                break;
 
-            prev = curr;
-            curr = curr->next;
-        }
 
-        if( !prev )
-        {
-            shred->next = shred_list;
-            if( shred_list ) shred_list->prev = shred;
-            shred_list = shred;
-        }
-        else
-        {
-            // insert the shred in sorted order
-            shred->next = prev->next;
-            shred->prev = prev;
-            if( prev->next ) prev->next->prev = shred;
-            prev->next = shred;
-        }
+
+//-----------------------------------------------------------------------------
+// name: heap_sift_down()
+// desc: move the shred at position i down until it precedes its children
+//-----------------------------------------------------------------------------
+void Chuck_VM_Shreduler::heap_sift_down( t_CKINT i )
+{
+    t_CKINT n = (t_CKINT)shred_heap.size();
+    Chuck_VM_Shred * shred = shred_heap[i];
+    while( TRUE )
+    {
+        t_CKINT child = 2*i + 1;
+        if( child >= n ) break;
+        // pick the earlier of the two children
+        if( child+1 < n && heap_before( shred_heap[child+1], shred_heap[child] ) )
+            child++;
+        if( !heap_before( shred_heap[child], shred ) ) break;
+        heap_set( i, shred_heap[child] );
+        i = child;
     }
+    heap_set( i, shred );
+}
 
-    t_CKTIME diff = shred_list->wake_time - this->now_system;
-    if( diff < 0 ) diff = 0;
-    // if( diff < m_samps_until_next )
-    m_samps_until_next = diff;
 
-    return TRUE;
+
+
+//-----------------------------------------------------------------------------
+// name: heap_erase()
+// desc: remove the shred at heap position i; O(log n)
+//-----------------------------------------------------------------------------
+void Chuck_VM_Shreduler::heap_erase( t_CKINT i )
+{
+    Chuck_VM_Shred * out = shred_heap[i];
+    Chuck_VM_Shred * last = shred_heap.back();
+    shred_heap.pop_back();
+    out->heap_index = -1;
+
+    // was it the last one?
+    if( last == out ) return;
+
+    // fill the hole with the last shred and restore order either way
+    heap_set( i, last );
+    if( i > 0 && heap_before( last, shred_heap[(i-1) >> 1] ) )
+        heap_sift_up( i );
+    else
+        heap_sift_down( i );
 }
 
 
@@ -2870,10 +3361,27 @@ void Chuck_VM_Shreduler::advance_v( t_CKINT & numLeft, t_CKINT & offset )
     m_adc->m_time = this->now_system;
 
     // PROCESSING
-    m_dac->system_tick_v( this->now_system, numFrames );
+    if( m_ugen_threads.load( std::memory_order_relaxed ) )
+    {
+        // voices first, on the workers; then the rest as usual, which only
+        // gathers the voices (the flattened schedule would tick them again)
+        m_ugen_parallel.tick_v( m_dac, this->now_system, numFrames );
+        m_dac->system_tick_v( this->now_system, numFrames );
+        m_bunghole->system_tick_v( this->now_system, numFrames );
+    }
+    else if( m_use_ugen_schedule.load( std::memory_order_relaxed ) )
+    {
+        // dac, then suck samples, as one flattened sweep
+        Chuck_UGen * roots[2] = { m_dac, m_bunghole };
+        m_ugen_schedule.tick_v( roots, 2, this->now_system, numFrames );
+    }
+    else
+    {
+        m_dac->system_tick_v( this->now_system, numFrames );
 
-    // suck samples
-    m_bunghole->system_tick_v( this->now_system, numFrames );
+        // suck samples
+        m_bunghole->system_tick_v( this->now_system, numFrames );
+    }
 
     // OUTPUT: adaptive block
     for( i = 0; i < numFrames; i++ )
@@ -2946,8 +3454,16 @@ void Chuck_VM_Shreduler::advance( t_CKINT N )
     m_adc->m_last = m_adc->m_current = sum / m_num_adc_channels;
     m_adc->m_time = this->now_system;
 
-    // PROCESSING
-    m_dac->system_tick( this->now_system );
+    // PROCESSING (read once, so dac and blackhole agree if it is toggled)
+    t_CKBOOL useSchedule = m_use_ugen_schedule.load( std::memory_order_relaxed );
+    if( useSchedule )
+    {
+        // dac and blackhole as one flattened sweep (the blackhole is ticked
+        // before the output copy below, which only reads from dac)
+        Chuck_UGen * roots[2] = { m_dac, m_bunghole };
+        m_ugen_schedule.tick( roots, 2, this->now_system );
+    }
+    else m_dac->system_tick( this->now_system );
     // OUTPUT
     for( i = 0; i < m_num_dac_channels; i++ )
     {
@@ -2963,7 +3479,7 @@ void Chuck_VM_Shreduler::advance( t_CKINT N )
     }
 
     // suck samples
-    m_bunghole->system_tick( this->now_system );
+    if( !useSchedule ) m_bunghole->system_tick( this->now_system );
 }
 
 
@@ -2976,34 +3492,28 @@ void Chuck_VM_Shreduler::advance( t_CKINT N )
 //-----------------------------------------------------------------------------
 Chuck_VM_Shred * Chuck_VM_Shreduler::get( )
 {
-    // shreduler's wait to run list
-    Chuck_VM_Shred * shred = shred_list;
-
-    // check if list empty
-    if( !shred )
+    // check if heap empty
+    if( shred_heap.empty() )
     {
         // if empty we are done
         m_samps_until_next = -1;
         return NULL;
     }
 
-    // check the front of the shred wait-to-run list; ready to run?
+    // the top of the heap is the next shred to wake
+    Chuck_VM_Shred * shred = shred_heap[0];
+
+    // ready to run?
     if( shred->wake_time <= ( this->now_system + .5 ) )
     {
-        // set beginning of list to next
-        shred_list = shred->next;
-
-        // sever links of ready-to-run shred
-        shred->next = NULL;
-        shred->prev = NULL;
+        // take it off the heap
+        heap_erase( 0 );
 
-        // if shred list is non-empty
-        if( shred_list )
+        // if heap is non-empty
+        if( !shred_heap.empty() )
         {
-            // set list head's prev pointer to NULL
-            shred_list->prev = NULL;
             // compute new samps until next
-            m_samps_until_next = shred_list->wake_time - this->now_system;
+            m_samps_until_next = shred_heap[0]->wake_time - this->now_system;
             // clamp to 0
             if( m_samps_until_next < 0 ) m_samps_until_next = 0;
         }
@@ -3058,21 +3568,16 @@ t_CKBOOL Chuck_VM_Shreduler::replace( Chuck_VM_Shred * out, Chuck_VM_Shred * in
     if( !out || !in )
         return FALSE;
 
-    if( !out->prev )
-        shred_list = in;
-    else
-        out->prev->next = in;
-
-    if( out->next )
-        out->next->prev = in;
-
-    in->next = out->next;
-    in->prev = out->prev;
-
-    out->next = out->prev = NULL;
+    // out must be shreduled, in must not
+    if( out->heap_index < 0 || in->heap_index >= 0 )
+        return FALSE;
 
+    // take over out's place; same key, so heap order is preserved
     in->wake_time = out->wake_time;
+    in->shredule_seq = out->shredule_seq;
     in->start = in->wake_time;
+    heap_set( out->heap_index, in );
+    out->heap_index = -1;
 
     return TRUE;
 }
@@ -3104,18 +3609,12 @@ t_CKBOOL Chuck_VM_Shreduler::remove( Chuck_VM_Shred * out )
     }
 
     // sanity check
-    if( !out->prev && !out->next && out != shred_list )
+    if( out->heap_index < 0 || out->heap_index >= (t_CKINT)shred_heap.size()
+        || shred_heap[out->heap_index] != out )
         return FALSE;
 
-    if( !out->prev )
-        shred_list = out->next;
-    else
-        out->prev->next = out->next;
-
-    if( out->next )
-        out->next->prev = out->prev;
-
-    out->next = out->prev = NULL;
+    // remove from heap; O(log n)
+    heap_erase( out->heap_index );
 
     return TRUE;
 }
@@ -3129,19 +3628,17 @@ t_CKBOOL Chuck_VM_Shreduler::remove( Chuck_VM_Shred * out )
 //-----------------------------------------------------------------------------
 Chuck_VM_Shred * Chuck_VM_Shreduler::lookup( t_CKUINT xid ) const
 {
-    Chuck_VM_Shred * shred = shred_list;
+    Chuck_VM_Shred * shred = NULL;
 
     // current shred?
     if( m_current_shred != NULL && m_current_shred->xid == xid )
         return m_current_shred;
 
-    // look for in shreduled list
-    while( shred )
+    // look for in shreduled heap
+    for( t_CKUINT i = 0; i < shred_heap.size(); i++ )
     {
-        if( shred->xid == xid )
-            return shred;
-
-        shred = shred->next;
+        if( shred_heap[i]->xid == xid )
+            return shred_heap[i];
     }
 
     // blocked?
@@ -3176,17 +3673,12 @@ void Chuck_VM_Shreduler::get_ready_shreds( std::vector<Chuck_VM_Shred *> & shred
     // clear; if not clear, then will append to existing contents
     if( clearVector ) shreds.clear();
 
-    // shred pointer
-    Chuck_VM_Shred * shred = shred_list;
-
-    // traverse shred list
-    while( shred )
-    {
-        // add
-        shreds.push_back( shred );
-        // next
-        shred = shred->next;
-    }
+    // where the ready shreds begin
+    t_CKUINT first = shreds.size();
+    // copy the heap
+    shreds.insert( shreds.end(), shred_heap.begin(), shred_heap.end() );
+    // heap order is partial; present them in wake-up (then FIFO) order
+    std::sort( shreds.begin() + first, shreds.end(), heap_before );
 }
 
 
@@ -3346,7 +3838,7 @@ void Chuck_VM_Shreduler::get_all_shred_ids( std::vector<t_CKUINT> & shredIDs,
 //-----------------------------------------------------------------------------
 void Chuck_VM_Shreduler::status( Chuck_VM_Status * status )
 {
-    Chuck_VM_Shred * shred = shred_list;
+    Chuck_VM_Shred * shred = NULL;
 
     t_CKUINT srate = vm_ref->srate(); // 1.3.5.3; was: Digitalio::sampling_rate();
     t_CKUINT s = (t_CKUINT)now_system;
@@ -3659,6 +4151,8 @@ t_CKBOOL Chuck_VM_MFunInvoker::setup( Chuck_Func * func, t_CKUINT func_vt_offset
     code->num_instr = instructions.size();
     // copy instructions
     for( t_CKUINT i = 0; i < instructions.size(); i++ ) code->instr[i] = instructions[i];
+    // NOTE: not lowered; invoke() patches the push instructions per call,
+    // so this code runs through Chuck_Instr::execute() (ops stays NULL)
     // TODO: should this be > 0
     code->stack_depth = 0;
     // TODO: should this be this true?
@@ -3923,6 +4417,8 @@ t_CKBOOL Chuck_VM_DtorInvoker::setup( Chuck_Func * dtor, Chuck_VM * vm )
     code->num_instr = instructions.size();
     // copy instructions
     for( t_CKUINT i = 0; i < instructions.size(); i++ ) code->instr[i] = instructions[i];
+    // NOTE: not lowered; invoke() patches the push instructions per call,
+    // so this code runs through Chuck_Instr::execute() (ops stays NULL)
     // TODO: should this be > 0
     code->stack_depth = 0;
     // TODO: should this be this true?
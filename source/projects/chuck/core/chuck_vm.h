@@ -66,6 +66,8 @@ struct Chuck_VM_FTable;
 struct Chuck_Msg;
 struct Chuck_Globals_Manager; // added 1.4.1.0 (jack)
 struct Chuck_Instr_Reg_Push_Imm; // 1.5.1.5 (ge)
+struct Chuck_VM_Op;
+struct Chuck_VM_Op_Pairs;
 class CBufferSimple;
 #ifndef __DISABLE_SERIAL__
 // hack: spencer?
@@ -133,6 +135,10 @@ public:
     Chuck_Instr ** instr;
     // size of the array
     t_CKUINT num_instr;
+    // instr lowered to compact ops, for the shred run loop
+    Chuck_VM_Op * ops;
+    // (re)lower instr to ops; call after instr is filled in
+    void lower();
 
     // name of this code
     std::string name;
@@ -177,6 +183,8 @@ public:
     t_CKBOOL shutdown();
     // run the shred on vm
     t_CKBOOL run( Chuck_VM * vm );
+    // run lowered ops inline until the next full instruction
+    t_CKBOOL run_ops( const Chuck_VM_Op * ops, const t_CKBOOL * loop_running );
     // yield the shred in vm (without advancing time, politely yield to run
     // all other shreds waiting to run at the current (i.e., 0::second +=> now;)
     t_CKBOOL yield(); // 1.5.0.5 (ge) made this a function from scattered code
@@ -270,9 +278,10 @@ public: // id
     std::vector<std::string> args;
 
 public:
-    // linked list
-    Chuck_VM_Shred * prev;
-    Chuck_VM_Shred * next;
+    // position in the shreduler's ready heap (-1 if not shreduled)
+    t_CKINT heap_index;
+    // order in which shred was shreduled; breaks ties in wake time (FIFO)
+    t_CKUINT shredule_seq;
 
 public:
     // tracking
@@ -501,6 +510,14 @@ public: // shreduling (shred interface part 1)
     void advance_v( t_CKINT & num_left, t_CKINT & offset );
     // set adaptive mode and adaptive max block size
     void set_adaptive( t_CKUINT max_block_size );
+    // set block-rate shreduling (skip VM compute between shred wake times)
+    void set_block_shreduling( t_CKBOOL onOff );
+    // number of frames (at most `max_frames`) until the next shred is due
+    t_CKINT frames_until_next( t_CKINT max_frames ) const;
+    // tick the UGen graph from a flattened schedule instead of recursively
+    void set_ugen_schedule( t_CKBOOL onOff );
+    // render independent voices on worker threads (adaptive mode); 0 is off
+    void set_ugen_threads( t_CKUINT numThreads );
 
 public: // remove, replace, status (shred interface part 2)
     // remove a shred from the shreduler
@@ -554,6 +571,17 @@ public: // shred lookup and retrieval (shred interface part 3)
     void get_all_shred_ids( std::vector<t_CKUINT> & shredIDs,
                             t_CKBOOL clearVector = TRUE ) const;
 
+protected: // ready heap maintenance
+    // strict ordering: earlier wake time first, then earlier shredule
+    static t_CKBOOL heap_before( const Chuck_VM_Shred * a, const Chuck_VM_Shred * b );
+    // place shred at heap position i and record its index
+    void heap_set( t_CKINT i, Chuck_VM_Shred * shred );
+    // restore heap order upward/downward from position i
+    void heap_sift_up( t_CKINT i );
+    void heap_sift_down( t_CKINT i );
+    // remove the shred at heap position i
+    void heap_erase( t_CKINT i );
+
 public: // for event related shred queue (shred interface part 4)
     // (should only be called from under the hood)
     t_CKBOOL add_blocked( Chuck_VM_Shred * shred );
@@ -568,8 +596,10 @@ public:
     // added ge: 1.3.5.3
     Chuck_VM * vm_ref;
 
-    // shreds to be shreduled
-    Chuck_VM_Shred * shred_list;
+    // shreds to be shreduled; binary min-heap by (wake_time, shredule_seq)
+    std::vector<Chuck_VM_Shred *> shred_heap;
+    // monotonic counter for FIFO ordering among equal wake times
+    t_CKUINT m_shredule_seq;
     // shreds waiting on events
     std::map<Chuck_VM_Shred *, Chuck_VM_Shred *> blocked;
     // current shred | TODO: ref count?
@@ -589,6 +619,17 @@ public:
     t_CKUINT m_max_block_size;
     t_CKBOOL m_adaptive;
     t_CKDUR m_samps_until_next;
+    // block-rate shreduling: only compute at shred wake times
+    t_CKBOOL m_block_shreduling;
+
+    // flattened UGen graph (dac + blackhole), rebuilt on connection changes;
+    // toggled by the host, picked up by the audio thread at the next tick
+    Chuck_UGen_Schedule m_ugen_schedule;
+    std::atomic<t_CKBOOL> m_use_ugen_schedule;
+    // worker pool for independent voices feeding the dac; resized by the
+    // host, picked up by the audio thread at the next block
+    Chuck_UGen_Parallel m_ugen_parallel;
+    std::atomic<t_CKUINT> m_ugen_threads;
 };
 
 
@@ -653,6 +694,13 @@ public: // shredsuck
 public: // audio
     t_CKUINT srate() const;
 
+public: // instruction pair counts
+    // count executed instruction pairs, printed on shutdown; this runs all
+    // code through execute(), so must be set before any shred runs
+    void set_op_pairs( t_CKBOOL enable );
+    // the counts, or NULL if not counting
+    Chuck_VM_Op_Pairs * op_pairs() const { return m_op_pairs; }
+
 public: // running the machine
     // compute next N frames
     t_CKBOOL run( t_CKINT numFrames, const SAMPLE * input, SAMPLE * output );
@@ -745,6 +793,8 @@ public:
     t_CKUINT m_num_dac_channels;
     t_CKBOOL m_halt;
     t_CKBOOL m_is_running;
+    // instruction pair counts (NULL unless enabled)
+    Chuck_VM_Op_Pairs * m_op_pairs;
 
     // for shreduler, ge: 1.3.5.3
     const SAMPLE * input_ref() { return m_input_ref; }
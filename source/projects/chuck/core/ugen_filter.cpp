@@ -177,6 +177,9 @@ DLL_QUERY filter_query( Chuck_DL_Query * QUERY )
                                         BPF_ctor, NULL, BPF_tick, BPF_pmsg, doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, BPF_tickv, TRUE ) ) goto error;
+
     type_engine_import_add_ex(env, "filter/bpf.ck");
 
     func = make_new_ctor( BPF_ctor_freq );
@@ -227,6 +230,9 @@ DLL_QUERY filter_query( Chuck_DL_Query * QUERY )
                                         BRF_ctor, NULL, BRF_tick, BRF_pmsg, doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, BRF_tickv, TRUE ) ) goto error;
+
     type_engine_import_add_ex(env, "filter/brf.ck");
 
     func = make_new_ctor( BRF_ctor_freq );
@@ -277,6 +283,9 @@ DLL_QUERY filter_query( Chuck_DL_Query * QUERY )
                                         RLPF_ctor, NULL, RLPF_tick, RLPF_pmsg, doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, RLPF_tickv, TRUE ) ) goto error;
+
     // add examples
     type_engine_import_add_ex(env, "filter/lpf.ck");
     type_engine_import_add_ex(env, "filter/rlpf.ck");
@@ -330,6 +339,9 @@ DLL_QUERY filter_query( Chuck_DL_Query * QUERY )
                                         RHPF_ctor, NULL, RHPF_tick, RHPF_pmsg, doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, RHPF_tickv, TRUE ) ) goto error;
+
     // add examples
     type_engine_import_add_ex(env, "filter/hpf.ck");
     type_engine_import_add_ex(env, "filter/rhpf.ck");
@@ -384,6 +396,9 @@ DLL_QUERY filter_query( Chuck_DL_Query * QUERY )
                                         ResonZ_ctor, NULL, ResonZ_tick, ResonZ_pmsg, doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, ResonZ_tickv, TRUE ) ) goto error;
+
     func = make_new_ctor( ResonZ_ctor_freq );
     func->add_arg( "float", "freq" );
     func->doc = "construct a ResonZ with specified frequency.";
@@ -435,6 +450,9 @@ DLL_QUERY filter_query( Chuck_DL_Query * QUERY )
                                         biquad_ctor, biquad_dtor, biquad_tick, NULL, doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, biquad_tickv, TRUE ) ) goto error;
+
     // member variable
     biquad_offset_data = type_engine_import_mvar ( env, "int", "@biquad_data", FALSE );
     if ( biquad_offset_data == CK_INVALID_OFFSET ) goto error;
@@ -1084,6 +1102,17 @@ struct FilterBasic_data
         return result;
     }
 
+    // tick a block through one of the tick_*() above; runs on a local copy
+    // so the filter state can stay in registers across the block
+    template <SAMPLE (FilterBasic_data::*TICK)( SAMPLE )>
+    inline void tick_v( const SAMPLE * in, SAMPLE * out, t_CKUINT nframes )
+    {
+        FilterBasic_data f = *this;
+        for( t_CKUINT i = 0; i < nframes; i++ ) out[i] = (f.*TICK)( in[i] );
+        m_y1 = f.m_y1;
+        m_y2 = f.m_y2;
+    }
+
 };
 
 struct Teabox_data
@@ -1455,6 +1484,18 @@ CK_DLL_TICK( BPF_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: BPF_tickv()
+// desc: TICKV function ...
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( BPF_tickv )
+{
+    FilterBasic_data * d = (FilterBasic_data *)OBJ_MEMBER_UINT(SELF, FilterBasic_offset_data);
+    d->tick_v<&FilterBasic_data::tick_bpf>( in, out, nframes );
+    return TRUE;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: BPF_ctrl_freq()
 // desc: CTRL function
@@ -1634,6 +1675,18 @@ CK_DLL_TICK( BRF_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: BRF_tickv()
+// desc: TICKV function ...
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( BRF_tickv )
+{
+    FilterBasic_data * d = (FilterBasic_data *)OBJ_MEMBER_UINT(SELF, FilterBasic_offset_data);
+    d->tick_v<&FilterBasic_data::tick_brf>( in, out, nframes );
+    return TRUE;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: BRF_ctrl_freq()
 // desc: CTRL function
@@ -1816,6 +1869,18 @@ CK_DLL_TICK( RLPF_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: RLPF_tickv()
+// desc: TICKV function ...
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( RLPF_tickv )
+{
+    FilterBasic_data * d = (FilterBasic_data *)OBJ_MEMBER_UINT(SELF, FilterBasic_offset_data);
+    d->tick_v<&FilterBasic_data::tick_rlpf>( in, out, nframes );
+    return TRUE;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: RLPF_ctrl_freq()
 // desc: CTRL function
@@ -1994,6 +2059,18 @@ CK_DLL_TICK( ResonZ_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: ResonZ_tickv()
+// desc: TICKV function ...
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( ResonZ_tickv )
+{
+    FilterBasic_data * d = (FilterBasic_data *)OBJ_MEMBER_UINT(SELF, FilterBasic_offset_data);
+    d->tick_v<&FilterBasic_data::tick_resonz>( in, out, nframes );
+    return TRUE;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: ResonZ_ctrl_freq()
 // desc: CTRL function
@@ -2186,6 +2263,18 @@ CK_DLL_TICK( RHPF_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: RHPF_tickv()
+// desc: TICKV function ...
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( RHPF_tickv )
+{
+    FilterBasic_data * d = (FilterBasic_data *)OBJ_MEMBER_UINT(SELF, FilterBasic_offset_data);
+    d->tick_v<&FilterBasic_data::tick_rhpf>( in, out, nframes );
+    return TRUE;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: RHPF_ctrl_freq()
 // desc: CTRL function
@@ -2454,6 +2543,42 @@ CK_DLL_TICK( biquad_tick )
     return TRUE;
 }
 
+//-----------------------------------------------------------------------------
+// name: biquad_tickv()
+// desc: TICKV function; same as biquad_tick, with state kept in locals
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( biquad_tickv )
+{
+    biquad_data * d = (biquad_data *)OBJ_MEMBER_UINT(SELF, biquad_offset_data );
+
+    const SAMPLE a0 = d->m_a0, a1 = d->m_a1, a2 = d->m_a2;
+    const SAMPLE b0 = d->m_b0, b1 = d->m_b1, b2 = d->m_b2;
+    SAMPLE input0 = d->m_input0, input1 = d->m_input1, input2 = d->m_input2;
+    SAMPLE output0 = d->m_output0, output1 = d->m_output1, output2 = d->m_output2;
+
+    for( t_CKUINT i = 0; i < nframes; i++ )
+    {
+        input0 = a0 * in[i];
+        output0 = b0 * input0 + b1 * input1 + b2 * input2;
+        output0 -= a2 * output2 + a1 * output1;
+        input2 = input1;
+        input1 = input0;
+        output2 = output1;
+        output1 = output0;
+
+        // be normal
+        CK_DDN(output1);
+        CK_DDN(output2);
+
+        out[i] = (SAMPLE)output0;
+    }
+
+    d->m_input0 = input0; d->m_input1 = input1; d->m_input2 = input2;
+    d->m_output0 = output0; d->m_output1 = output1; d->m_output2 = output2;
+
+    return TRUE;
+}
+
 void biquad_set_reson( biquad_data * d )
 {
     d->m_a2 = (SAMPLE)(d->prad * d->prad);
@@ -87,6 +87,9 @@ DLL_QUERY osc_query( Chuck_DL_Query * QUERY )
                                         doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, osc_tickv, TRUE ) ) goto error;
+
     // add member variable
     osc_offset_data = type_engine_import_mvar( env, "int", "@osc_data", FALSE );
     if( osc_offset_data == CK_INVALID_OFFSET ) goto error;
@@ -159,6 +162,9 @@ DLL_QUERY osc_query( Chuck_DL_Query * QUERY )
                                         doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, osc_tickv, TRUE ) ) goto error;
+
     // overload constructor (float freq)
     func = make_new_ctor( oscx_ctor_1 );
     func->add_arg( "float", "freq" );
@@ -187,6 +193,9 @@ DLL_QUERY osc_query( Chuck_DL_Query * QUERY )
                                         doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, sinosc_tickv, TRUE ) ) goto error;
+
     // overload constructor (float freq)
     func = make_new_ctor( oscx_ctor_1 );
     func->add_arg( "float", "freq" );
@@ -223,6 +232,9 @@ DLL_QUERY osc_query( Chuck_DL_Query * QUERY )
                                         doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, triosc_tickv, TRUE ) ) goto error;
+
     // overload constructor (float freq)
     func = make_new_ctor( oscx_ctor_1 );
     func->add_arg( "float", "freq" );
@@ -302,6 +314,9 @@ DLL_QUERY osc_query( Chuck_DL_Query * QUERY )
                                         doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, pulseosc_tickv, TRUE ) ) goto error;
+
     // overload constructor (float freq)
     func = make_new_ctor( oscx_ctor_1 );
     func->add_arg( "float", "freq" );
@@ -562,6 +577,42 @@ CK_DLL_TICK( osc_tick )
 
 
 
+//-----------------------------------------------------------------------------
+// name: osc_tickv()
+// desc: block tick; free-running phase is kept in a local across the block,
+//       otherwise (input drives freq/phase) falls back to osc_tick()
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( osc_tickv )
+{
+    // get the data
+    Osc_Data * d = (Osc_Data *)OBJ_MEMBER_UINT(SELF, osc_offset_data );
+    Chuck_UGen * ugen = (Chuck_UGen *)SELF;
+
+    // if input, sample by sample
+    if( ugen->m_num_src )
+    {
+        for( t_CKUINT i = 0; i < nframes; i++ ) osc_tick( SELF, in[i], &out[i], API );
+        return TRUE;
+    }
+
+    t_CKFLOAT phase = d->phase, num = d->num;
+    for( t_CKUINT i = 0; i < nframes; i++ )
+    {
+        // set output to current phase
+        out[i] = (SAMPLE)phase;
+        // step the phase; keep between 0 and 1
+        phase += num;
+        if( phase > 1.0 ) phase -= 1.0;
+        else if( phase < 0.0 ) phase += 1.0;
+    }
+    d->phase = phase;
+
+    return TRUE;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: sinosc_tick()
 // desc: ...
@@ -631,6 +682,41 @@ CK_DLL_TICK( sinosc_tick )
 
 
 
+//-----------------------------------------------------------------------------
+// name: sinosc_tickv()
+// desc: block tick; see osc_tickv()
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( sinosc_tickv )
+{
+    // get the data
+    Osc_Data * d = (Osc_Data *)OBJ_MEMBER_UINT(SELF, osc_offset_data );
+    Chuck_UGen * ugen = (Chuck_UGen *)SELF;
+
+    // if input, sample by sample
+    if( ugen->m_num_src )
+    {
+        for( t_CKUINT i = 0; i < nframes; i++ ) sinosc_tick( SELF, in[i], &out[i], API );
+        return TRUE;
+    }
+
+    t_CKFLOAT phase = d->phase, num = d->num;
+    for( t_CKUINT i = 0; i < nframes; i++ )
+    {
+        // set output
+        out[i] = (SAMPLE) ::sin( phase * CK_TWO_PI );
+        // next phase; keep between 0 and 1
+        phase += num;
+        if( phase > 1.0 ) phase -= 1.0;
+        else if( phase < 0.0 ) phase += 1.0;
+    }
+    d->phase = phase;
+
+    return TRUE;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: triosc_tick()
 // desc: ...
@@ -700,6 +786,43 @@ CK_DLL_TICK( triosc_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: triosc_tickv()
+// desc: block tick; see osc_tickv()
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( triosc_tickv )
+{
+    // get the data
+    Osc_Data * d = (Osc_Data *)OBJ_MEMBER_UINT(SELF, osc_offset_data );
+    Chuck_UGen * ugen = (Chuck_UGen *)SELF;
+
+    // if input, sample by sample
+    if( ugen->m_num_src )
+    {
+        for( t_CKUINT i = 0; i < nframes; i++ ) triosc_tick( SELF, in[i], &out[i], API );
+        return TRUE;
+    }
+
+    t_CKFLOAT phase = d->phase, num = d->num, width = d->width;
+    for( t_CKUINT i = 0; i < nframes; i++ )
+    {
+        // compute (same as triosc_tick)
+        t_CKFLOAT p = phase + .25; if( p > 1.0 ) p -= 1.0;
+        if( p < width ) out[i] = (SAMPLE) (width == 0.0) ? 1.0 : -1.0 + 2.0 * p / width;
+        else out[i] = (SAMPLE) (width == 1.0) ? 0 : 1.0 - 2.0 * (p - width) / (1.0 - width);
+        // advance internal phase; keep between 0 and 1
+        phase += num;
+        if( phase > 1.0 ) phase -= 1.0;
+        else if( phase < 0.0 ) phase += 1.0;
+    }
+    d->phase = phase;
+
+    return TRUE;
+}
+
+
+
+
 // sawosc_tick is tri_osc tick with width=0.0 or width=1.0  -pld
 
 
@@ -770,6 +893,41 @@ CK_DLL_TICK( pulseosc_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: pulseosc_tickv()
+// desc: block tick; see osc_tickv()
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( pulseosc_tickv )
+{
+    // get the data
+    Osc_Data * d = (Osc_Data *)OBJ_MEMBER_UINT(SELF, osc_offset_data );
+    Chuck_UGen * ugen = (Chuck_UGen *)SELF;
+
+    // if input, sample by sample
+    if( ugen->m_num_src )
+    {
+        for( t_CKUINT i = 0; i < nframes; i++ ) pulseosc_tick( SELF, in[i], &out[i], API );
+        return TRUE;
+    }
+
+    t_CKFLOAT phase = d->phase, num = d->num, width = d->width;
+    for( t_CKUINT i = 0; i < nframes; i++ )
+    {
+        // compute
+        out[i] = (SAMPLE) (phase < width) ? 1.0 : -1.0;
+        // move phase; keep between 0 and 1
+        phase += num;
+        if( phase > 1.0 ) phase -= 1.0;
+        else if( phase < 0.0 ) phase += 1.0;
+    }
+    d->phase = phase;
+
+    return TRUE;
+}
+
+
+
+
 // sqrosc_tick is pulseosc_tick at width=0.5 -pld;
 
 
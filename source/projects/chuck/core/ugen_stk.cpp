@@ -149,6 +149,7 @@ horn ok please -> written at the back of trucks, always, makes no sense.
 CK_DLL_CTOR( ADSR_ctor );
 CK_DLL_DTOR( ADSR_dtor );
 CK_DLL_TICK( ADSR_tick );
+CK_DLL_TICKV( ADSR_tickv );
 CK_DLL_PMSG( ADSR_pmsg );
 CK_DLL_CTOR( ADSR_ctor_floats );
 CK_DLL_CTOR( ADSR_ctor_durs );
@@ -222,6 +223,7 @@ CK_DLL_CTOR( Delay_ctor_delay );
 CK_DLL_CTOR( Delay_ctor_delay_max );
 CK_DLL_DTOR( Delay_dtor );
 CK_DLL_TICK( Delay_tick );
+CK_DLL_TICKV( Delay_tickv );
 CK_DLL_PMSG( Delay_pmsg );
 CK_DLL_CTRL( Delay_ctrl_set );
 CK_DLL_CTRL( Delay_ctrl_delay );
@@ -236,6 +238,7 @@ CK_DLL_CTOR( DelayA_ctor_delay );
 CK_DLL_CTOR( DelayA_ctor_delay_max );
 CK_DLL_DTOR( DelayA_dtor );
 CK_DLL_TICK( DelayA_tick );
+CK_DLL_TICKV( DelayA_tickv );
 CK_DLL_PMSG( DelayA_pmsg );
 CK_DLL_CTRL( DelayA_ctrl_set );
 CK_DLL_CTRL( DelayA_ctrl_delay );
@@ -250,6 +253,7 @@ CK_DLL_CTOR( DelayL_ctor_delay );
 CK_DLL_CTOR( DelayL_ctor_delay_max );
 CK_DLL_DTOR( DelayL_dtor );
 CK_DLL_TICK( DelayL_tick );
+CK_DLL_TICKV( DelayL_tickv );
 CK_DLL_PMSG( DelayL_pmsg );
 CK_DLL_CTRL( DelayL_ctrl_set );
 CK_DLL_CTRL( DelayL_ctrl_delay );
@@ -277,6 +281,7 @@ CK_DLL_CGET( Echo_cget_mix );
 CK_DLL_CTOR( Envelope_ctor );
 CK_DLL_DTOR( Envelope_dtor );
 CK_DLL_TICK( Envelope_tick );
+CK_DLL_TICKV( Envelope_tickv );
 CK_DLL_PMSG( Envelope_pmsg );
 CK_DLL_CTOR( Envelope_ctor_duration );
 CK_DLL_CTOR( Envelope_ctor_float );
@@ -3558,6 +3563,9 @@ by Perry R. Cook and Gary P. Scavone, 1995 - 2002.";
                         Delay_ctor, Delay_dtor,
                         Delay_tick, Delay_pmsg, doc.c_str() ) ) return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, Delay_tickv, TRUE ) ) goto error;
+
     // add examples
     if( !type_engine_import_add_ex( env, "basic/comb.ck" ) ) goto error;
     if( !type_engine_import_add_ex( env, "deep/plu.ck" ) ) goto error;
@@ -3625,6 +3633,9 @@ by Perry R. Cook and Gary P. Scavone, 1995 - 2002.";
     if( !type_engine_import_ugen_begin( env, "DelayA", "UGen", env->global(),
                         DelayA_ctor, DelayA_dtor,
                         DelayA_tick, DelayA_pmsg, doc.c_str() ) ) return FALSE;
+
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, DelayA_tickv, TRUE ) ) goto error;
     // add examples
     if( !type_engine_import_add_ex( env, "deep/ks-chord.ck" ) ) goto error;
 
@@ -3691,6 +3702,9 @@ by Perry R. Cook and Gary P. Scavone, 1995 - 2002.";
                         DelayL_ctor, DelayL_dtor,
                         DelayL_tick, DelayL_pmsg, doc.c_str() ) ) return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, DelayL_tickv, TRUE ) ) goto error;
+
     type_engine_import_add_ex(env, "basic/delay.ck");
     type_engine_import_add_ex(env, "basic/delay2.ck");
     type_engine_import_add_ex(env, "basic/i-robot.ck");
@@ -3831,6 +3845,9 @@ by Perry R. Cook and Gary P. Scavone, 1995 - 2002.";
                         Envelope_ctor, Envelope_dtor,
                         Envelope_tick, Envelope_pmsg, doc.c_str() ) ) return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, Envelope_tickv, TRUE ) ) goto error;
+
     type_engine_import_add_ex(env, "basic/envelope.ck");
     type_engine_import_add_ex(env, "basic/envelope2.ck");
     type_engine_import_add_ex(env, "basic/chirp2.ck");
@@ -3961,6 +3978,9 @@ by Perry R. Cook and Gary P. Scavone, 1995 - 2002.";
                                         ADSR_ctor, ADSR_dtor,
                                         ADSR_tick, ADSR_pmsg, doc.c_str() ) ) return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, ADSR_tickv, TRUE ) ) goto error;
+
     type_engine_import_add_ex(env, "basic/adsr.ck");
     type_engine_import_add_ex(env, "basic/blit2.ck");
 
@@ -24013,6 +24033,20 @@ CK_DLL_TICK( Delay_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: Delay_tickv()
+// desc: TICKV function; the object is always a DelayBase (see Delay_ctor),
+//       so call its tick() directly rather than through the vtable
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( Delay_tickv )
+{
+    DelayBase * d = (DelayBase *)OBJ_MEMBER_UINT(SELF, Delay_offset_data);
+    for( t_CKUINT i = 0; i < nframes; i++ )
+        out[i] = (SAMPLE)d->DelayBase::tick( in[i] );
+    return TRUE;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: Delay_pmsg()
 // desc: PMSG function ...
@@ -24165,6 +24199,20 @@ CK_DLL_TICK( DelayA_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: DelayA_tickv()
+// desc: TICKV function; the object is always a DelayA (see DelayA_ctor),
+//       so call its tick() directly rather than through the vtable
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( DelayA_tickv )
+{
+    DelayA * d = (DelayA *)OBJ_MEMBER_UINT(SELF, DelayA_offset_data);
+    for( t_CKUINT i = 0; i < nframes; i++ )
+        out[i] = (SAMPLE)d->DelayA::tick( in[i] );
+    return TRUE;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: DelayA_pmsg()
 // desc: PMSG function ...
@@ -24315,6 +24363,20 @@ CK_DLL_TICK( DelayL_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: DelayL_tickv()
+// desc: TICKV function; the object is always a DelayL (see DelayL_ctor),
+//       so call its tick() directly rather than through the vtable
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( DelayL_tickv )
+{
+    DelayL * d = (DelayL *)OBJ_MEMBER_UINT(SELF, DelayL_offset_data);
+    for( t_CKUINT i = 0; i < nframes; i++ )
+        out[i] = (SAMPLE)d->DelayL::tick( in[i] );
+    return TRUE;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: DelayL_pmsg()
 // desc: PMSG function ...
@@ -24581,6 +24643,19 @@ CK_DLL_TICK( Envelope_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: Envelope_tickv()
+// desc: TICKV function; ADSR has its own, so d is always an Envelope
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( Envelope_tickv )
+{
+    Envelope * d = (Envelope *)OBJ_MEMBER_UINT(SELF, Envelope_offset_data);
+    for( t_CKUINT i = 0; i < nframes; i++ )
+        out[i] = in[i] * d->Envelope::tick();
+    return TRUE;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: Envelope_pmsg()
 // desc: PMSG function
@@ -24895,6 +24970,19 @@ CK_DLL_TICK( ADSR_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: ADSR_tickv()
+// desc: TICKV function ...
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( ADSR_tickv )
+{
+    ADSR * d = (ADSR *)OBJ_MEMBER_UINT(SELF, Envelope_offset_data);
+    for( t_CKUINT i = 0; i < nframes; i++ )
+        out[i] = in[i] * d->ADSR::tick();
+    return TRUE;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: ADSR_pmsg()
 // desc: PMSG function ...
@@ -60,11 +60,17 @@
 #endif
 #endif
 
-#ifdef __ANDROID__
 #include "util_platforms.h"
-#endif
+#include "util_thread.h"
 
 #include <fstream>
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#ifndef __DISABLE_THREADS__
+#include <thread>
+#endif
 using namespace std;
 
 
@@ -435,6 +441,9 @@ DLL_QUERY xxx_query( Chuck_DL_Query * QUERY )
                                         NULL, NULL, noise_tick, NULL, doc.c_str() ) )
         return FALSE;
 
+    // block tick (not isolated: draws from the shared random generator)
+    if( !type_engine_import_ugen_tickv( env, noise_tickv ) ) goto error;
+
     if( !type_engine_import_add_ex( env, "basic/wind.ck" ) ) goto error;
     if( !type_engine_import_add_ex( env, "deep/smb.ck" ) ) goto error;
     if( !type_engine_import_add_ex( env, "shred/powerup.ck" ) ) goto error;
@@ -516,6 +525,9 @@ DLL_QUERY xxx_query( Chuck_DL_Query * QUERY )
                                         impulse_ctor, impulse_dtor, impulse_tick, NULL, doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, impulse_tickv, TRUE ) ) goto error;
+
     // add ctrl: value
     //func = make_new_mfun( "float", "value", impulse_ctrl_value );
     //func->add_arg( "float", "value" );
@@ -575,6 +587,9 @@ DLL_QUERY xxx_query( Chuck_DL_Query * QUERY )
                                         step_ctor, step_dtor, step_tick, NULL, doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, step_tickv, TRUE ) ) goto error;
+
     // add examples | 1.5.0.0 (ge)
     if( !type_engine_import_add_ex( env, "basic/step.ck" ) ) goto error;
     if( !type_engine_import_add_ex( env, "basic/fm3.ck" ) ) goto error;
@@ -626,6 +641,9 @@ DLL_QUERY xxx_query( Chuck_DL_Query * QUERY )
                                         NULL, NULL, halfrect_tick, NULL, doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, halfrect_tickv, TRUE ) ) goto error;
+
     // end import
     if( !type_engine_import_class_end( env ) )
         return FALSE;
@@ -644,6 +662,9 @@ DLL_QUERY xxx_query( Chuck_DL_Query * QUERY )
                                         NULL, NULL, fullrect_tick, NULL, doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, fullrect_tickv, TRUE ) ) goto error;
+
     // end import
     if( !type_engine_import_class_end( env ) )
         return FALSE;
@@ -765,6 +786,8 @@ DLL_QUERY xxx_query( Chuck_DL_Query * QUERY )
     if( !type_engine_import_add_ex( env, "basic/sndbuf.ck" ) ) goto error;
     if( !type_engine_import_add_ex( env, "basic/doh.ck" ) ) goto error;
     if( !type_engine_import_add_ex( env, "basic/valueat.ck" ) ) goto error;
+    if( !type_engine_import_add_ex( env, "basic/sndbuf-stream.ck" ) ) goto error;
+    if( !type_engine_import_add_ex( env, "basic/sndbuf-async.ck" ) ) goto error;
     if( !type_engine_import_add_ex( env, "otf_01.ck" ) ) goto error;
     if( !type_engine_import_add_ex( env, "otf_02.ck" ) ) goto error;
     if( !type_engine_import_add_ex( env, "otf_03.ck" ) ) goto error;
@@ -803,7 +826,13 @@ DLL_QUERY xxx_query( Chuck_DL_Query * QUERY )
 
     // add cget: ready
     func = make_new_mfun( "int", "ready", sndbuf_cget_ready );
-    func->doc = "query whether the SndBuf is ready for use (e.g., sound file successfully loaded).";
+    func->doc = "query whether the SndBuf is ready for use (e.g., sound file successfully loaded, and not still being read by .readAsync()).";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
+    // add mfun: readAsync
+    func = make_new_mfun( "Event", "readAsync", sndbuf_read_async );
+    func->add_arg( "string", "path" );
+    func->doc = "read file on a background thread (decoding all of it, whatever .chunks() and .stream() are set to); returns an Event that is signaled when the file is ready (e.g., buf.readAsync(path) => now;). Until then, the SndBuf keeps playing what it had, and .ready() is false.";
     if( !type_engine_import_mfun( env, func ) ) goto error;
 
     // add ctrl: write
@@ -914,6 +943,20 @@ DLL_QUERY xxx_query( Chuck_DL_Query * QUERY )
     func->doc = "get chunk size, in frames, for loading the file from disk. 0 indicates that chunking is disabled.";
     if( !type_engine_import_mfun( env, func ) ) goto error;
 
+    // add ctrl: stream
+    func = make_new_mfun( "int", "stream", sndbuf_ctrl_stream );
+    func->add_arg( "int", "frames" );
+    func->doc = "set lookahead, in frames, for streaming the file from disk on a background thread instead of loading it (e.g., for files too long to load); takes effect on the next .read(). The stream stays this far ahead of (or, for negative rates, behind) the play position; after a jump (e.g., setting .pos()), it takes a moment to catch up. .valueAt() only sees frames near the play position. Set to 0 (the default) to disable streaming.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+    // add cget: stream
+    func = make_new_mfun( "int", "stream", sndbuf_cget_stream );
+    func->doc = "get lookahead, in frames, for streaming the file from disk. 0 indicates that streaming is disabled.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+    // add cget: underruns
+    func = make_new_mfun( "int", "underruns", sndbuf_cget_underruns );
+    func->doc = "get number of frames played (as silence) since the last .read() because the stream had not read them from disk yet; if this keeps growing, try a longer .stream() lookahead.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
     // add cget: samples
     func = make_new_mfun( "int", "samples", sndbuf_cget_samples );
     func->doc = "get total number of sample frames in the file; same as .frames().";
@@ -2189,6 +2232,18 @@ CK_DLL_TICK( noise_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: noise_tickv()
+// desc: ...
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( noise_tickv )
+{
+    for( t_CKUINT i = 0; i < nframes; i++ )
+        out[i] = (SAMPLE)( -1.0 + 2.0 * ck_random_f() );
+    return TRUE;
+}
+
+
 enum { NOISE_WHITE=0, NOISE_PINK, NOISE_BROWN, NOISE_FBM, NOISE_FLIP, NOISE_XOR };
 
 class CNoise_Data
@@ -2496,6 +2551,26 @@ CK_DLL_TICK( impulse_tick )
 
 
 
+//-----------------------------------------------------------------------------
+// name: impulse_tickv()
+// desc: ...
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( impulse_tickv )
+{
+    Pulse_Data * d = (Pulse_Data *)OBJ_MEMBER_UINT(SELF, impulse_offset_data);
+    // the pending value, if any, goes out on the first frame
+    for( t_CKUINT i = 0; i < nframes; i++ ) out[i] = 0.0f;
+    if( d->when && nframes )
+    {
+        out[0] = d->value;
+        d->when = 0;
+    }
+
+    return TRUE;
+}
+
+
+
 //-----------------------------------------------------------------------------
 // name: impulse_ctrl_next()
 // desc: ...
@@ -2574,6 +2649,19 @@ CK_DLL_TICK( step_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: step_tickv()
+// desc: ...
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( step_tickv )
+{
+    SAMPLE v = *(SAMPLE *)OBJ_MEMBER_UINT(SELF, step_offset_data);
+    for( t_CKUINT i = 0; i < nframes; i++ ) out[i] = v;
+
+    return TRUE;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: step_ctrl_next()
 // desc: ...
@@ -2610,6 +2698,17 @@ CK_DLL_TICK( halfrect_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: halfrect_tickv()
+// desc: ...
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( halfrect_tickv )
+{
+    for( t_CKUINT i = 0; i < nframes; i++ ) out[i] = in[i] > 0.0f ? in[i] : 0.0f;
+    return TRUE;
+}
+
+
 
 
 //-----------------------------------------------------------------------------
@@ -2623,6 +2722,17 @@ CK_DLL_TICK( fullrect_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: fullrect_tickv()
+// desc: ...
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( fullrect_tickv )
+{
+    for( t_CKUINT i = 0; i < nframes; i++ ) out[i] = in[i] >= 0.0f ? in[i] : -in[i];
+    return TRUE;
+}
+
+
 
 
 /*
@@ -2939,6 +3049,14 @@ processing time is linearly related to this width */
 
 // default chunk size
 #define CK_SNDBUF_DEFAULT_CHUNK_SIZE (32768) // a little less than 1s of 44.1kHz
+// smallest lookahead, in frames, when streaming from disk
+#define CK_SNDBUF_MIN_STREAM_LOOKAHEAD (1024)
+// most frames the streaming thread reads into a SndBuf at a time
+#define CK_SNDBUF_STREAM_BLOCK_SIZE (4096)
+// most bytes of decoded files kept in the cache when not in use
+#define CK_SNDBUF_CACHE_IDLE_BYTES (64*1024*1024)
+// frames decoded into the cache at a time
+#define CK_SNDBUF_CACHE_BLOCK_SIZE (65536)
 
 #define USE_TABLE TRUE          /* this controls whether a linearly interpolated lookup
 table is used for sinc function calculation, or the
@@ -3134,6 +3252,607 @@ protected:
 };
 #endif /* CK_SNDBUF_MEMORY_BUFFER */
 
+//-----------------------------------------------------------------------------
+// name: struct sndbuf_stream
+// desc: a sound file streamed from disk, for SndBuf.stream(); a ring holds a
+//       window of frames around the play position, which the streaming
+//       thread keeps reading ahead of (or, for negative rates, behind), so
+//       the audio thread never touches the file
+//
+// frames are counted "virtually": when looping, they keep counting past the
+// end (and before the beginning) of the file, so that the window is always
+// one range [lo,hi) of at most 'capacity' frames; virtual frame v is file
+// frame v mod num_frames, and lives in ring slot v mod capacity.  the
+// streaming thread (the only writer) first shrinks the window away from the
+// slots it is about to overwrite, then writes them, then grows the window
+// over them; the audio thread checks that a frame is in the window, reads
+// it, and checks again (a frame that left the window meanwhile may have been
+// overwritten, and counts as missing).  the epoch changes whenever the window
+// could come back over frames it left (a jump, or a change of direction).
+//-----------------------------------------------------------------------------
+struct sndbuf_stream
+{
+public:
+    // takes over the (open) file, and reads in its beginning
+    sndbuf_stream( SNDFILE * fd, t_CKINT frames, t_CKINT channels, t_CKINT lookahead )
+        : m_fd( fd ), m_frames( frames ), m_channels( channels ),
+          m_lookahead( lookahead ), m_capacity( 2 * lookahead ),
+          m_lo( 0 ), m_hi( 0 ), m_epoch( 0 ), m_pos( 0 ), m_dir( 1 ),
+          m_loop( FALSE ), m_done( FALSE ), m_fill( 1 ), m_next( 0 ),
+          m_base( 0 ), m_frame( 0 ), m_looping( FALSE ), m_missed( FALSE ),
+          m_underruns( 0 ), sync( FALSE )
+    {
+        m_ring = new std::atomic<SAMPLE>[m_capacity * m_channels];
+        m_block = new float[CK_SNDBUF_STREAM_BLOCK_SIZE * m_channels];
+        // so playback can start right away
+        while( service() );
+    }
+
+    ~sndbuf_stream()
+    {
+        sf_close( m_fd );
+        CK_SAFE_DELETE_ARRAY( m_ring );
+        CK_SAFE_DELETE_ARRAY( m_block );
+    }
+
+public: // audio thread
+    // the play position moved to a (file) frame
+    inline void seek( t_CKINT frame, t_CKFLOAT rate, t_CKBOOL loop )
+    {
+        // some of the last frame was missing
+        if( m_missed ) { m_underruns++; m_missed = FALSE; }
+
+        // when looping, stay on the lap nearest the last position
+        m_looping = loop;
+        t_CKINT v = virtualize( frame );
+        m_base = loop ? v - frame : 0;
+        m_frame = frame;
+
+        // let the streaming thread know
+        t_CKINT pos = loop ? v : frame, dir = rate < 0 ? -1 : 1;
+        m_loop.store( loop, std::memory_order_relaxed );
+        m_dir.store( dir, std::memory_order_relaxed );
+        m_pos.store( pos, std::memory_order_release );
+
+        // no streaming thread: read here
+        if( sync ) service();
+        // wake it, if it is time to read more
+        else if( wants( pos, dir, loop ) ) wake();
+    }
+
+    // get a sample of a (file) frame; 0 if it isn't in the ring (yet)
+    inline SAMPLE get( t_CKINT frame, t_CKINT chan )
+    {
+        SAMPLE value = 0;
+        if( !peek( frame, chan, value ) ) m_missed = TRUE;
+        return value;
+    }
+
+    // get a sample of a (file) frame, if it is in the ring
+    inline t_CKBOOL peek( t_CKINT frame, t_CKINT chan, SAMPLE & value )
+    {
+        t_CKINT v = virtualize( frame );
+        t_CKINT epoch = m_epoch.load( std::memory_order_acquire );
+        if( v < m_lo.load( std::memory_order_acquire ) || v >= m_hi.load( std::memory_order_acquire ) )
+            return FALSE;
+        value = m_ring[slot( v ) * m_channels + chan].load( std::memory_order_relaxed );
+        // still there?
+        std::atomic_thread_fence( std::memory_order_acquire );
+        if( v < m_lo.load( std::memory_order_relaxed ) || v >= m_hi.load( std::memory_order_relaxed ) ||
+            epoch != m_epoch.load( std::memory_order_relaxed ) )
+        {
+            value = 0;
+            return FALSE;
+        }
+        return TRUE;
+    }
+
+    // number of frames played with samples missing
+    t_CKUINT underruns() const { return m_underruns; }
+
+protected: // audio thread
+    // whether the window is out of reach of the play position, or less than
+    // half the lookahead remains ahead of it (as far as the file goes)
+    inline t_CKBOOL wants( t_CKINT pos, t_CKINT dir, t_CKBOOL loop ) const
+    {
+        t_CKINT lo = m_lo.load( std::memory_order_relaxed );
+        t_CKINT hi = m_hi.load( std::memory_order_relaxed );
+        if( dir > 0 )
+        {
+            if( pos < lo || pos > hi ) return TRUE;
+            t_CKINT target = pos + m_lookahead / 2;
+            if( !loop && target > m_frames ) target = m_frames;
+            return hi < target;
+        }
+        if( pos >= hi || pos < lo - 1 ) return TRUE;
+        t_CKINT target = pos - m_lookahead / 2;
+        if( !loop && target < 0 ) target = 0;
+        return lo > target;
+    }
+
+    // wake the streaming thread (defined after sndbuf_streamer)
+    inline void wake();
+
+public: // streaming thread
+    // read the next block, if the window isn't far enough ahead of the play
+    // position; returns whether there was anything to read
+    t_CKBOOL service()
+    {
+        t_CKINT pos = m_pos.load( std::memory_order_acquire );
+        t_CKINT dir = m_dir.load( std::memory_order_relaxed );
+        t_CKBOOL loop = m_loop.load( std::memory_order_relaxed );
+        t_CKINT lo = m_lo.load( std::memory_order_relaxed );
+        t_CKINT hi = m_hi.load( std::memory_order_relaxed );
+        t_CKINT n = 0;
+
+        // the position jumped out of reach: start over around it (leaving
+        // room behind it for interpolation)
+        if( dir > 0 ? ( pos < lo || pos > hi ) : ( pos >= hi || pos < lo - 1 ) )
+        {
+            t_CKINT at = dir > 0 ? pos - WIDTH : pos + WIDTH + 1;
+            if( !loop ) at = ck_max( (t_CKINT)0, ck_min( at, m_frames ) );
+            m_epoch.fetch_add( 1 );
+            // empty the window (in an order that never widens it), then move it
+            if( at < lo ) { m_hi.store( at ); m_lo.store( at ); }
+            else { m_lo.store( at ); m_hi.store( at ); }
+            lo = hi = at;
+        }
+
+        // the window may come back over frames it has left
+        if( dir != m_fill ) { m_epoch.fetch_add( 1 ); m_fill = dir; }
+
+        if( dir > 0 )
+        {
+            t_CKINT target = pos + m_lookahead;
+            if( !loop && target > m_frames ) target = m_frames;
+            if( hi >= target ) return FALSE;
+            n = ck_min( target - hi, (t_CKINT)CK_SNDBUF_STREAM_BLOCK_SIZE );
+            // make room, read, then publish
+            if( hi + n - lo > m_capacity ) m_lo.store( hi + n - m_capacity, std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_release );
+            read( hi, n );
+            m_hi.store( hi + n, std::memory_order_release );
+        }
+        else
+        {
+            t_CKINT target = pos - m_lookahead;
+            if( !loop && target < 0 ) target = 0;
+            if( lo <= target ) return FALSE;
+            n = ck_min( lo - target, (t_CKINT)CK_SNDBUF_STREAM_BLOCK_SIZE );
+            // make room, read, then publish
+            if( hi - ( lo - n ) > m_capacity ) m_hi.store( lo - n + m_capacity, std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_release );
+            read( lo - n, n );
+            m_lo.store( lo - n, std::memory_order_release );
+        }
+
+        return TRUE;
+    }
+
+    // whether the SndBuf is done with the stream
+    t_CKBOOL done() const { return m_done.load( std::memory_order_acquire ); }
+    // the SndBuf is done with the stream
+    void finish() { m_done.store( TRUE, std::memory_order_release ); }
+
+protected:
+    // map a file frame to the virtual frame nearest the play position
+    inline t_CKINT virtualize( t_CKINT frame ) const
+    {
+        t_CKINT v = m_base + frame;
+        if( m_looping )
+        {
+            if( frame - m_frame > m_frames / 2 ) v -= m_frames;
+            else if( m_frame - frame > m_frames / 2 ) v += m_frames;
+        }
+        return v;
+    }
+
+    // ring slot of a virtual frame
+    inline t_CKINT slot( t_CKINT v ) const
+    {
+        t_CKINT i = v % m_capacity;
+        return i < 0 ? i + m_capacity : i;
+    }
+
+    // read virtual frames [v,v+n) into the ring (n <= block size)
+    void read( t_CKINT v, t_CKINT n )
+    {
+        while( n > 0 )
+        {
+            // file frame, and how much to read before the end of the file
+            t_CKINT f = v % m_frames;
+            if( f < 0 ) f += m_frames;
+            t_CKINT count = ck_min( n, m_frames - f );
+
+            if( f != m_next ) sf_seek( m_fd, f, SEEK_SET );
+            t_CKINT got = sf_readf_float( m_fd, m_block, count );
+            if( got < 0 ) got = 0;
+            // keep the next read from seeking if it picks up where this left off
+            m_next = got == count ? f + count : -1;
+            // fill anything that couldn't be read with silence
+            if( got < count ) memset( m_block + got * m_channels, 0, ( count - got ) * m_channels * sizeof(float) );
+
+            for( t_CKINT i = 0; i < count; i++ )
+            {
+                std::atomic<SAMPLE> * to = m_ring + slot( v + i ) * m_channels;
+                float * from = m_block + i * m_channels;
+                for( t_CKINT c = 0; c < m_channels; c++ )
+                    to[c].store( (SAMPLE)from[c], std::memory_order_relaxed );
+            }
+
+            v += count;
+            n -= count;
+        }
+    }
+
+protected:
+    // the file (streaming thread only, after construction)
+    SNDFILE * m_fd;
+    t_CKINT m_frames;
+    t_CKINT m_channels;
+    t_CKINT m_lookahead;
+    // ring of frames, and the window of virtual frames it holds
+    t_CKINT m_capacity;
+    std::atomic<SAMPLE> * m_ring;
+    std::atomic<t_CKINT> m_lo;
+    std::atomic<t_CKINT> m_hi;
+    std::atomic<t_CKINT> m_epoch;
+    // play position (virtual frame), direction, and looping
+    std::atomic<t_CKINT> m_pos;
+    std::atomic<t_CKINT> m_dir;
+    std::atomic<t_CKBOOL> m_loop;
+    std::atomic<t_CKBOOL> m_done;
+    // streaming thread: direction of the last fill, next file frame, block
+    t_CKINT m_fill;
+    t_CKINT m_next;
+    float * m_block;
+    // audio thread: virtual frame of the current lap's file frame 0, last
+    // file frame, looping, whether samples went missing since the last frame
+    t_CKINT m_base;
+    t_CKINT m_frame;
+    t_CKBOOL m_looping;
+    t_CKBOOL m_missed;
+    t_CKUINT m_underruns;
+
+public:
+    // no streaming thread: read on the audio thread
+    t_CKBOOL sync;
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct sndbuf_streamer
+// desc: the streaming thread shared by all streaming SndBufs; it takes turns
+//       reading a block into each stream that needs one, and sleeps when none
+//       do, until a stream is added or removed, or a play position gets near
+//       the end of what has been read; it exits when the last stream is gone
+//       (e.g., at VM shutdown), and is started again by the next add()
+//-----------------------------------------------------------------------------
+struct sndbuf_streamer
+{
+public:
+    // start streaming (starting the thread if not running); FALSE if there
+    // is no thread, in which case the stream must read on the audio thread
+    static t_CKBOOL add( sndbuf_stream * stream )
+    {
+#ifndef __DISABLE_THREADS__
+        o_mutex.acquire();
+        if( !o_running )
+        {
+            // detached: it exits on its own once there are no streams
+            try { std::thread( run ).detach(); o_running = TRUE; }
+            catch( ... ) { EM_log( CK_LOG_WARNING, "(sndbuf): cannot start streaming thread..." ); }
+        }
+        t_CKBOOL added = o_running;
+        if( added ) o_pending.push_back( stream );
+        o_mutex.release();
+        if( added ) o_wake.post();
+        return added;
+#else
+        return FALSE;
+#endif
+    }
+
+    // stop streaming; the stream is deleted (by the thread, if there is one)
+    static void remove( sndbuf_stream * stream )
+    {
+        if( stream->sync ) { delete stream; return; }
+        stream->finish();
+#ifndef __DISABLE_THREADS__
+        o_wake.post();
+#endif
+    }
+
+#ifndef __DISABLE_THREADS__
+    // wake the thread, if it is asleep (audio thread; never blocks)
+    static inline void wake()
+    {
+        // pairs with the fence in run(): either it sees the stream's new
+        // position, or this sees that it is going to sleep
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if( o_asleep.load( std::memory_order_relaxed ) && o_asleep.exchange( FALSE ) )
+            o_wake.post();
+    }
+
+protected:
+    static void run()
+    {
+        std::vector<sndbuf_stream *> streams;
+        // whether o_asleep is set (and the streams are being looked at once
+        // more before actually sleeping)
+        t_CKBOOL sleepy = FALSE;
+
+        while( true )
+        {
+            // take in new streams; exit if there are none left
+            o_mutex.acquire();
+            streams.insert( streams.end(), o_pending.begin(), o_pending.end() );
+            o_pending.clear();
+            if( streams.empty() )
+            {
+                o_asleep.store( FALSE );
+                o_running = FALSE;
+                o_mutex.release();
+                return;
+            }
+            o_mutex.release();
+
+            // one block each, for those that need it
+            t_CKBOOL busy = FALSE;
+            for( size_t i = 0; i < streams.size(); )
+            {
+                if( streams[i]->done() )
+                {
+                    delete streams[i];
+                    streams[i] = streams.back();
+                    streams.pop_back();
+                    continue;
+                }
+                if( streams[i]->service() ) busy = TRUE;
+                i++;
+            }
+
+            if( busy )
+            {
+                if( sleepy ) { o_asleep.store( FALSE ); sleepy = FALSE; }
+                continue;
+            }
+            // nothing to do: say so, then look once more (for positions that
+            // moved before the audio thread could see it)
+            if( !sleepy )
+            {
+                o_asleep.store( TRUE );
+                std::atomic_thread_fence( std::memory_order_seq_cst );
+                sleepy = TRUE;
+                continue;
+            }
+            // still nothing: sleep
+            o_wake.wait();
+            o_asleep.store( FALSE );
+            sleepy = FALSE;
+        }
+    }
+
+    // guards o_pending and o_running
+    static XMutex o_mutex;
+    static std::vector<sndbuf_stream *> o_pending;
+    static t_CKBOOL o_running;
+    // sleeping, and how to wake up
+    static std::atomic<t_CKBOOL> o_asleep;
+    static XSemaphore o_wake;
+#endif
+};
+
+#ifndef __DISABLE_THREADS__
+XMutex sndbuf_streamer::o_mutex;
+std::vector<sndbuf_stream *> sndbuf_streamer::o_pending;
+t_CKBOOL sndbuf_streamer::o_running = FALSE;
+std::atomic<t_CKBOOL> sndbuf_streamer::o_asleep( FALSE );
+XSemaphore sndbuf_streamer::o_wake;
+#endif
+
+// wake the streaming thread
+inline void sndbuf_stream::wake()
+{
+#ifndef __DISABLE_THREADS__
+    sndbuf_streamer::wake();
+#endif
+}
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct sndbuf_cache
+// desc: process-wide cache of decoded sound files, so that every SndBuf (and
+//       LiSa), in any ChucK instance, reading the same file shares one copy
+//       instead of decoding its own; entries are keyed by path and checked
+//       against the file's modification time and size.  entries are read-only
+//       (LiSa, which writes into its buffer, copies out of them), and when no
+//       one uses them, are kept (most recently used first) up to a budget
+//-----------------------------------------------------------------------------
+struct sndbuf_cache
+{
+public:
+    // a decoded file
+    struct Entry
+    {
+        // the file
+        std::string path;
+        time_t mtime;
+        t_CKINT size;
+        // interleaved samples, plus one silent frame
+        SAMPLE * data;
+        t_CKUINT frames;
+        t_CKUINT channels;
+        t_CKUINT samplerate;
+        // users, and whether the cache still hands it out
+        t_CKUINT refs;
+        t_CKBOOL current;
+    };
+
+public:
+    // the decoded file, if cached and unchanged (to release when done); NULL
+    // otherwise
+    static Entry * find( const std::string & path, const struct stat & s )
+    {
+        o_mutex.acquire();
+        Entry * e = NULL;
+        std::map<std::string, Entry *>::iterator it = o_entries.find( path );
+        if( it != o_entries.end() )
+        {
+            e = it->second;
+            // changed since: stop handing it out
+            if( e->mtime != s.st_mtime || e->size != (t_CKINT)s.st_size )
+            {
+                retire( e );
+                e = NULL;
+            }
+            else acquire( e );
+        }
+        o_mutex.release();
+        return e;
+    }
+
+    // decode an open file into the cache (to release when done); NULL if it
+    // couldn't be read in full, or 'stop' was raised meanwhile
+    static Entry * load( const std::string & path, const struct stat & s, SNDFILE * fd, const SF_INFO & info,
+                         const std::atomic<bool> * stop = NULL )
+    {
+        // decode (outside the lock)
+        Entry * e = new Entry;
+        e->path = path;
+        e->mtime = s.st_mtime;
+        e->size = (t_CKINT)s.st_size;
+        e->frames = info.frames;
+        e->channels = info.channels;
+        e->samplerate = info.samplerate;
+        e->data = new SAMPLE[( e->frames + 1 ) * e->channels];
+        memset( e->data, 0, ( e->frames + 1 ) * e->channels * sizeof(SAMPLE) );
+        e->refs = 1;
+        e->current = TRUE;
+
+        // (a block at a time, to check 'stop' in between)
+        sf_seek( fd, 0, SEEK_SET );
+        sf_count_t n = 0;
+        while( n < (sf_count_t)e->frames && !( stop && *stop ) )
+        {
+            sf_count_t count = ck_min( (sf_count_t)e->frames - n, (sf_count_t)CK_SNDBUF_CACHE_BLOCK_SIZE );
+#if defined(__CHUCK_USE_64_BIT_SAMPLE__)
+            sf_count_t got = sf_readf_double( fd, e->data + n * e->channels, count );
+#else
+            sf_count_t got = sf_readf_float( fd, e->data + n * e->channels, count );
+#endif
+            if( got <= 0 ) break;
+            n += got;
+        }
+        if( n != (sf_count_t)e->frames )
+        {
+            if( !( stop && *stop ) )
+                CK_FPRINTF_STDERR( "[chuck](via SndBuf): read %ld rather than %lu frames from %s\n",
+                                   (long)n, e->frames, path.c_str() );
+            CK_SAFE_DELETE_ARRAY( e->data );
+            CK_SAFE_DELETE( e );
+            return NULL;
+        }
+
+        o_mutex.acquire();
+        std::map<std::string, Entry *>::iterator it = o_entries.find( path );
+        // decoded elsewhere meanwhile: use that one
+        if( it != o_entries.end() && it->second->mtime == e->mtime && it->second->size == e->size )
+        {
+            CK_SAFE_DELETE_ARRAY( e->data );
+            CK_SAFE_DELETE( e );
+            e = it->second;
+            acquire( e );
+        }
+        else
+        {
+            if( it != o_entries.end() ) retire( it->second );
+            o_entries[path] = e;
+        }
+        o_mutex.release();
+
+        return e;
+    }
+
+    // done with a decoded file
+    static void release( Entry * e )
+    {
+        o_mutex.acquire();
+        if( --e->refs == 0 )
+        {
+            // no longer handed out: gone
+            if( !e->current ) destroy( e );
+            // keep around, in case it's read again
+            else
+            {
+                o_idle.push_front( e );
+                o_idleBytes += bytes( e );
+                trim();
+            }
+        }
+        o_mutex.release();
+    }
+
+protected:
+    // (the rest with the lock held)
+    static void acquire( Entry * e )
+    {
+        // no longer idle
+        if( e->refs++ == 0 )
+        {
+            o_idle.remove( e );
+            o_idleBytes -= bytes( e );
+        }
+    }
+
+    // stop handing out an entry; it's gone once no one uses it
+    static void retire( Entry * e )
+    {
+        o_entries.erase( e->path );
+        e->current = FALSE;
+        if( e->refs == 0 )
+        {
+            o_idle.remove( e );
+            o_idleBytes -= bytes( e );
+            destroy( e );
+        }
+    }
+
+    // drop the least recently used idle entries over budget
+    static void trim()
+    {
+        while( o_idleBytes > CK_SNDBUF_CACHE_IDLE_BYTES && o_idle.size() )
+            retire( o_idle.back() );
+    }
+
+    static t_CKUINT bytes( Entry * e ) { return ( e->frames + 1 ) * e->channels * sizeof(SAMPLE); }
+
+    static void destroy( Entry * e )
+    {
+        CK_SAFE_DELETE_ARRAY( e->data );
+        CK_SAFE_DELETE( e );
+    }
+
+    static XMutex o_mutex;
+    static std::map<std::string, Entry *> o_entries;
+    static std::list<Entry *> o_idle;
+    static t_CKUINT o_idleBytes;
+};
+
+XMutex sndbuf_cache::o_mutex;
+std::map<std::string, sndbuf_cache::Entry *> sndbuf_cache::o_entries;
+std::list<sndbuf_cache::Entry *> sndbuf_cache::o_idle;
+t_CKUINT sndbuf_cache::o_idleBytes = 0;
+
+
+
+
+// (see below)
+struct sndbuf_loader;
+
 // data for each sndbuf
 struct sndbuf_data
 {
@@ -3151,6 +3870,15 @@ struct sndbuf_data
     // 1.5.0.0 (ge) added (chunks will only affect next .read)
     t_CKUINT chunks_on_next_load;
 
+    // streaming from disk (lookahead in frames; affects next .read)
+    sndbuf_stream * stream;
+    t_CKUINT stream_on_next_load;
+
+    // shared decoded file (buffer points into it), if any
+    sndbuf_cache::Entry * cached;
+    // reading a file in the background (.readAsync), if ever
+    sndbuf_loader * loader;
+
     SAMPLE * eob;
     //SAMPLE * curr;
     SAMPLE current_val;
@@ -3198,6 +3926,10 @@ struct sndbuf_data
         chunk_map = NULL;
         chunk_num = 0;
         chunks_on_next_load = chunks; // whatever chunks default is
+        stream = NULL;
+        stream_on_next_load = 0;
+        cached = NULL;
+        loader = NULL;
 
         sinc_table_built = false;
         sinc_use_table = USE_TABLE;
@@ -3225,7 +3957,7 @@ struct sndbuf_data
             this->fd = NULL;
         }
 
-        CK_SAFE_DELETE_ARRAY( buffer );
+        free_buffer();
 
         if( chunk_map )
         {
@@ -3233,6 +3965,25 @@ struct sndbuf_data
                 CK_SAFE_DELETE_ARRAY(chunk_map[i]);
             CK_SAFE_DELETE_ARRAY(chunk_map);
         }
+
+        // done streaming
+        if( stream )
+        {
+            sndbuf_streamer::remove( stream );
+            stream = NULL;
+        }
+    }
+
+    // let go of the buffer (a shared one goes back to the cache)
+    void free_buffer()
+    {
+        if( cached )
+        {
+            sndbuf_cache::release( cached );
+            cached = NULL;
+            buffer = NULL;
+        }
+        else CK_SAFE_DELETE_ARRAY( buffer );
     }
 
     inline void sampleIndex2FrameIndexAndChannel(t_CKINT sample, t_CKINT *frame, t_CKINT *channel)
@@ -3243,6 +3994,260 @@ struct sndbuf_data
 };
 
 
+// get ready to play what was just read
+static void sndbuf_prepare( sndbuf_data * d )
+{
+    // d->interp = SNDBUF_INTERP;
+    d->sampleratio = (double)d->samplerate / (double)g_srateXxx;
+    // set the rate
+    d->rate = d->sampleratio * d->rate_factor;
+    d->current_val = 0;
+    d->curf = 0;
+    d->eob = d->buffer + d->num_samples;
+}
+
+// let go of what was read
+static void sndbuf_clear( sndbuf_data * d )
+{
+    // cleanup
+    d->free_buffer();
+    // clean up chunk map
+    if( d->chunk_map )
+    {
+        for(int i = 0; i < d->chunk_num; i++)
+            CK_SAFE_DELETE_ARRAY(d->chunk_map[i]);
+        CK_SAFE_DELETE_ARRAY(d->chunk_map);
+        d->chunk_num = 0;
+    }
+    // stop streaming
+    if( d->stream )
+    {
+        sndbuf_streamer::remove( d->stream );
+        d->stream = NULL;
+    }
+    // close file descriptor
+    if( d->fd )
+    {
+        sf_close( d->fd );
+        d->fd = NULL;
+    }
+}
+
+// play a decoded file from the cache (taking over the reference)
+static void sndbuf_share( sndbuf_data * d, sndbuf_cache::Entry * cached )
+{
+    d->cached = cached;
+    d->buffer = cached->data;
+    d->chunk_map = NULL;
+    d->chan = 0;
+    d->num_frames = cached->frames;
+    d->num_channels = cached->channels;
+    d->samplerate = cached->samplerate;
+    d->num_samples = d->num_frames * d->num_channels;
+    d->chunks_read = d->num_samples;
+    sndbuf_prepare( d );
+}
+
+//-----------------------------------------------------------------------------
+// name: struct sndbuf_loader
+// desc: decodes a file on a worker thread, for SndBuf.readAsync(); the SndBuf
+//       plays what it had until the new file is installed, on the VM thread,
+//       when the read's event is processed -- so a shred waiting on the
+//       event already sees the new file when it wakes; each read has its own
+//       event, and an abandoned read's worker is let go rather than joined
+//-----------------------------------------------------------------------------
+struct sndbuf_loader
+{
+public:
+    sndbuf_loader( sndbuf_data * d, Chuck_VM * vm )
+        : m_data( d ), m_vm( vm ), m_event( NULL )
+    {
+        // signaled through a buffer of our own
+        m_buffer = m_vm->create_event_buffer();
+    }
+
+    ~sndbuf_loader()
+    {
+        abandon();
+        retire();
+        m_vm->destroy_event_buffer( m_buffer );
+    }
+
+    // start reading a file, abandoning any read in progress; returns the event
+    // signaled when it is installed (or couldn't be read)
+    Chuck_Event * start( const std::string & path )
+    {
+        cancel();
+        retire();
+        // a new event for each read, so nothing left from an earlier read
+        // can signal it
+        m_event = (Chuck_Event *)instantiate_and_initialize_object( m_vm->env()->ckt_event, m_vm );
+        CK_SAFE_ADD_REF( m_event );
+        // called on the VM thread whenever the event is processed
+        m_event->global_listen( (t_CKINT)this, installer, TRUE );
+        m_job = std::make_shared<Job>( path );
+#ifndef __DISABLE_THREADS__
+        // the worker shares only the job (and, until it is abandoned, the
+        // event and buffer), so it never has to be joined
+        std::shared_ptr<Job> job = m_job;
+        Chuck_VM * vm = m_vm;
+        Chuck_Event * event = m_event;
+        CBufferSimple * buffer = m_buffer;
+        std::thread( [job, vm, event, buffer]()
+        {
+            finish( job, decode( job->path, job->stop ), vm, event, buffer );
+        } ).detach();
+#else
+        // no threads: read now; still installed when the event is processed
+        finish( m_job, decode( m_job->path, m_job->stop ), m_vm, m_event, m_buffer );
+#endif
+        return m_event;
+    }
+
+    // abandon the read in progress, if any; shreds waiting on its event wake
+    void cancel()
+    {
+        if( !m_job ) return;
+        abandon();
+        m_event->broadcast_local();
+    }
+
+    // whether a read is in progress (not installed yet)
+    t_CKBOOL busy() const { return m_job != NULL; }
+
+protected:
+    // one read, shared with its worker
+    struct Job
+    {
+        Job( const std::string & p )
+            : path( p ), stop( false ), done( FALSE ), abandoned( FALSE ), result( NULL ) { }
+
+        // guards done, abandoned, and result
+        XMutex mutex;
+        std::string path;
+        std::atomic<bool> stop;
+        t_CKBOOL done;
+        t_CKBOOL abandoned;
+        sndbuf_cache::Entry * result;
+    };
+
+    // (worker thread) hand over what was decoded and signal the event, unless
+    // the read was abandoned (then the event and buffer may be gone)
+    static void finish( const std::shared_ptr<Job> & job, sndbuf_cache::Entry * result,
+                        Chuck_VM * vm, Chuck_Event * event, CBufferSimple * buffer )
+    {
+        job->mutex.acquire();
+        if( job->abandoned )
+        {
+            if( result ) sndbuf_cache::release( result );
+        }
+        else
+        {
+            job->result = result;
+            job->done = TRUE;
+            vm->queue_event( event, 1, buffer );
+        }
+        job->mutex.release();
+    }
+
+    // (VM thread) let the read in progress go, if any
+    void abandon()
+    {
+        if( !m_job ) return;
+        m_job->stop = true;
+        m_job->mutex.acquire();
+        m_job->abandoned = TRUE;
+        sndbuf_cache::Entry * result = m_job->result;
+        m_job->result = NULL;
+        m_job->mutex.release();
+        if( result ) sndbuf_cache::release( result );
+        m_job.reset();
+        // drop its signal, if still queued (no other read has put one)
+        Chuck_Event * event = NULL;
+        while( m_buffer->get( &event, 1 ) ) { }
+    }
+
+    // (VM thread) let go of the last read's event
+    void retire()
+    {
+        if( !m_event ) return;
+        m_event->remove_listen( (t_CKINT)this, installer );
+        CK_SAFE_RELEASE( m_event );
+    }
+
+    // (worker thread) decode a file into the cache; NULL if it couldn't be
+    // read (or 'stop' was raised)
+    static sndbuf_cache::Entry * decode( const std::string & path, const std::atomic<bool> & stop )
+    {
+        const char * filename = path.c_str();
+        struct stat s;
+        if( stat( filename, &s ) )
+        {
+            CK_FPRINTF_STDERR( "[chuck](via SndBuf): cannot open file '%s'...\n", filename );
+            return NULL;
+        }
+
+        // already decoded?
+        sndbuf_cache::Entry * cached = sndbuf_cache::find( path, s );
+        if( cached ) return cached;
+
+        SF_INFO info;
+        info.format = 0;
+        const char * format = (const char *)strrchr( filename, '.');
+        if( format && strcmp( format, ".raw" ) == 0 )
+        {
+            info.format = SF_FORMAT_RAW | SF_FORMAT_PCM_16 | SF_ENDIAN_CPU ;
+            info.channels = 1;
+            info.samplerate = 44100;
+        }
+        SNDFILE * fd = sf_open( filename, SFM_READ, &info );
+        t_CKINT er = sf_error( fd );
+        if( er )
+        {
+            CK_FPRINTF_STDERR( "[chuck](via SndBuf): sndfile error '%li' opening '%s'...\n", er, filename );
+            CK_FPRINTF_STDERR( "[chuck](via SndBuf): ...(reason: %s)\n", sf_strerror( fd ) );
+            if( fd ) sf_close( fd );
+            return NULL;
+        }
+
+        cached = sndbuf_cache::load( path, s, fd, info, &stop );
+        sf_close( fd );
+        return cached;
+    }
+
+    // (VM thread) install the file just read
+    static void installer( t_CKINT id )
+    {
+        sndbuf_loader * loader = (sndbuf_loader *)id;
+        if( !loader->m_job ) return;
+        // not done if the event was signaled some other way
+        Job * job = loader->m_job.get();
+        job->mutex.acquire();
+        t_CKBOOL done = job->done;
+        sndbuf_cache::Entry * result = job->result;
+        job->result = NULL;
+        job->mutex.release();
+        if( !done ) return;
+
+        // out with the old, in with the new (if it could be read)
+        sndbuf_data * d = loader->m_data;
+        sndbuf_clear( d );
+        if( result )
+        {
+            EM_log( CK_LOG_INFO, "(sndbuf): installing '%s'...", job->path.c_str() );
+            sndbuf_share( d, result );
+        }
+        loader->m_job.reset();
+    }
+
+    sndbuf_data * m_data;
+    Chuck_VM * m_vm;
+    Chuck_Event * m_event;
+    CBufferSimple * m_buffer;
+    std::shared_ptr<Job> m_job;
+};
+
+
 double sndbuf_sinc( sndbuf_data * d, double x );
 double sndbuf_t_sinc( sndbuf_data * d, double x );
 void   sndbuf_make_sinc( sndbuf_data * d );
@@ -3256,6 +4261,8 @@ CK_DLL_CTOR( sndbuf_ctor )
 CK_DLL_DTOR( sndbuf_dtor )
 {
     sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
+    // stop any .readAsync() first
+    if( d ) CK_SAFE_DELETE( d->loader );
     CK_SAFE_DELETE(d);
     OBJ_MEMBER_UINT(SELF, sndbuf_offset_data) = 0;
 }
@@ -3368,7 +4375,7 @@ inline t_CKINT sndbuf_load( sndbuf_data * d, t_CKUINT sample )
 inline void sndbuf_setpos( sndbuf_data *d, double frame_pos )
 {
     // if no buffer allocate (nothing read)
-    if( d->buffer == NULL && d->chunk_map == NULL ) return;
+    if( d->buffer == NULL && d->chunk_map == NULL && d->stream == NULL ) return;
 
     d->curf = frame_pos;
 
@@ -3394,6 +4401,14 @@ inline void sndbuf_setpos( sndbuf_data *d, double frame_pos )
         }
     }
 
+    // streaming: let the stream know where we are
+    if( d->stream )
+    {
+        d->stream->seek( (t_CKINT)d->curf, d->rate, d->loop );
+        d->current_val = d->stream->get( (t_CKINT)d->curf, d->chan );
+        return;
+    }
+
     t_CKUINT index = d->chan + ((t_CKINT)d->curf) * d->num_channels;
     // ensure load
     if( d->fd != NULL ) sndbuf_load( d, index );
@@ -3430,6 +4445,9 @@ inline SAMPLE sndbuf_sampleAt( sndbuf_data * d, t_CKINT frame_pos, t_CKINT arg_c
     else if(arg_chan < d->num_channels)
         chan = arg_chan;
 
+    // streaming
+    if( d->stream ) return d->stream->get( frame_pos, chan );
+
     t_CKUINT index = chan + frame_pos * d->num_channels;
     // ensure load
     if( d->fd != NULL ) sndbuf_load( d, index );
@@ -3444,7 +4462,7 @@ inline SAMPLE sndbuf_sampleAt( sndbuf_data * d, t_CKINT frame_pos, t_CKINT arg_c
 inline double sndbuf_getpos( sndbuf_data * d )
 {
     // if no buffer allocated (nothing read)
-    if( d->buffer == NULL && d->chunk_map == NULL ) return 0;
+    if( d->buffer == NULL && d->chunk_map == NULL && d->stream == NULL ) return 0;
     return floor(d->curf);
 }
 
@@ -3611,7 +4629,7 @@ CK_DLL_TICK( sndbuf_tick )
     // 1.5.0.0 (ge) modified for clarity;
     // was: if( !(d->buffer || d->chunk_map) ) { ... }
     // if no buffer allocated; nothing read
-    if( d->buffer == NULL && d->chunk_map == NULL )
+    if( d->buffer == NULL && d->chunk_map == NULL && d->stream == NULL )
     {
         *out = 0;
         return TRUE;
@@ -3658,7 +4676,7 @@ CK_DLL_TICKF( sndbuf_tickf )
     sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
 
     // if no buffer allocated, nothing read
-    if( d->buffer == NULL && d->chunk_map == NULL ) return FALSE;
+    if( d->buffer == NULL && d->chunk_map == NULL && d->stream == NULL ) return FALSE;
 
     // we're ticking once per sample ( system )
     // curf in samples;
@@ -3735,22 +4753,10 @@ CK_DLL_CTRL( sndbuf_ctrl_read )
     // set return value
     RETURN->v_string = ckfilename;
 
+    // supersedes any .readAsync() in progress
+    if( d->loader ) d->loader->cancel();
     // cleanup
-    CK_SAFE_DELETE_ARRAY(d->buffer);
-    // clean up chunk map
-    if( d->chunk_map )
-    {
-        for(int i = 0; i < d->chunk_num; i++)
-            CK_SAFE_DELETE_ARRAY(d->chunk_map[i]);
-        CK_SAFE_DELETE_ARRAY(d->chunk_map);
-        d->chunk_num = 0;
-    }
-    // close file descriptor
-    if( d->fd )
-    {
-        sf_close( d->fd );
-        d->fd = NULL;
-    }
+    sndbuf_clear( d );
 
     // check | 1.5.0.0 (ge) added check to avert crash on null argument
     if( !ckfilename )
@@ -3883,6 +4889,10 @@ CK_DLL_CTRL( sndbuf_ctrl_read )
     }
     else // read file
     {
+        // file info, to check the cache against
+        struct stat s;
+        t_CKBOOL cacheable = TRUE;
+
 #ifdef __ANDROID__
         bool is_jar_url = strstr(filename, "jar:") == filename;
         int jar_fd = 0;
@@ -3893,12 +4903,12 @@ CK_DLL_CTRL( sndbuf_ctrl_read )
                 CK_FPRINTF_STDERR( "[chuck](via SndBuf): could not download file '%s' from JAR\n", filename );
                 return;
             }
+            cacheable = FALSE;
         }
         else
 #endif
         {
             // check if file exists
-            struct stat s;
             if( stat( filename, &s ) )
             {
                 CK_FPRINTF_STDERR( "[chuck](via SndBuf): cannot open file '%s'...\n", filename );
@@ -3906,6 +4916,15 @@ CK_DLL_CTRL( sndbuf_ctrl_read )
             }
         }
 
+        // already decoded (by any SndBuf or LiSa in this process)? share it
+        sndbuf_cache::Entry * cached = cacheable ? sndbuf_cache::find( filename, s ) : NULL;
+        if( cached )
+        {
+            EM_log( CK_LOG_INFO, "(sndbuf): using cached '%s'...", filename );
+            sndbuf_share( d, cached );
+            return;
+        }
+
         // open it
         SF_INFO info;
         info.format = 0;
@@ -3944,9 +4963,21 @@ CK_DLL_CTRL( sndbuf_ctrl_read )
             return;
         }
 
-        // allocate
+        // stream from disk instead of loading?
+        t_CKBOOL streaming = d->stream_on_next_load > 0 && info.frames > 0;
         t_CKINT size = info.channels * info.frames;
-        if(d->chunks)
+        // or decode it whole into the cache, unless chunked (and longer
+        // than a chunk)?
+        t_CKBOOL whole = cacheable && !streaming && ( !d->chunks || size <= (t_CKINT)d->chunks );
+
+        // allocate
+        if( streaming || whole )
+        {
+            // nothing to allocate here; the stream or the cache does
+            d->buffer = NULL;
+            d->chunk_map = NULL;
+        }
+        else if(d->chunks)
         {
             // split into small allocations
             d->chunk_num = ceil(((t_CKFLOAT) size) / ((t_CKFLOAT) d->chunks)); // 1.5.0.0 (ge) | ceilf => ceil
@@ -3975,13 +5006,33 @@ CK_DLL_CTRL( sndbuf_ctrl_read )
         EM_log( CK_LOG_INFO, "frames: %d", d->num_frames );
         EM_log( CK_LOG_INFO, "srate: %d", d->samplerate );
         EM_log( CK_LOG_INFO, "chunks: %d", d->chunks );
+        EM_log( CK_LOG_INFO, "stream: %d", streaming ? d->stream_on_next_load : 0 );
         EM_poplog();
 
         // read
         sf_seek( d->fd, 0, SEEK_SET );
 
+        // stream: hand the file over to a stream, which reads the beginning
+        // now and the rest on the streaming thread
+        if( streaming )
+        {
+            d->stream = new sndbuf_stream( d->fd, d->num_frames, d->num_channels,
+                ck_max( (t_CKINT)d->stream_on_next_load, (t_CKINT)CK_SNDBUF_MIN_STREAM_LOOKAHEAD ) );
+            d->fd = NULL;
+            if( !sndbuf_streamer::add( d->stream ) ) d->stream->sync = TRUE;
+        }
+        // whole: decode into the cache, and share from there
+        else if( whole )
+        {
+            d->cached = sndbuf_cache::load( filename, s, d->fd, info );
+            sf_close( d->fd );
+            d->fd = NULL;
+            if( !d->cached ) return;
+            d->buffer = d->cached->data;
+            d->chunks_read = d->num_samples;
+        }
         // no chunk
-        if( !d->chunks )
+        else if( !d->chunks )
         {
             // read all
             t_CKUINT f = sndbuf_read( d, 0, d->num_frames );
@@ -3998,13 +5049,29 @@ CK_DLL_CTRL( sndbuf_ctrl_read )
         }
     }
 
-    // d->interp = SNDBUF_INTERP;
-    d->sampleratio = (double)d->samplerate / (double)g_srateXxx;
-    // set the rate
-    d->rate = d->sampleratio * d->rate_factor;
-    d->current_val = 0;
-    d->curf = 0;
-    d->eob = d->buffer + d->num_samples;
+    // get ready to play
+    sndbuf_prepare( d );
+}
+
+CK_DLL_MFUN( sndbuf_read_async )
+{
+    sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
+    Chuck_String * ckfilename = GET_CK_STRING(ARGS);
+
+    // first time
+    if( !d->loader ) d->loader = new sndbuf_loader( d, VM );
+
+    // check
+    if( !ckfilename )
+    {
+        CK_FPRINTF_STDERR( "[chuck] SndBuf.readAsync() given null argument; nothing read...\n" );
+        d->loader->cancel();
+        RETURN->v_object = NULL;
+        return;
+    }
+
+    EM_log( CK_LOG_INFO, "(sndbuf): reading '%s' in the background...", ckfilename->str().c_str() );
+    RETURN->v_object = d->loader->start( ckfilename->str() );
 }
 
 CK_DLL_CTRL( sndbuf_ctrl_write )
@@ -4035,8 +5102,10 @@ CK_DLL_CGET( sndbuf_cget_ready )
 {
     // get the internal representation
     sndbuf_data * d = ( sndbuf_data * )OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
-    // ready if we have a file descriptor
-    RETURN->v_int = d->fd != NULL;
+    // ready if something was read (loaded, chunked, cached, or streaming),
+    // and no .readAsync() is still in progress
+    RETURN->v_int = ( d->buffer != NULL || d->chunk_map != NULL || d->stream != NULL ) &&
+                    !( d->loader && d->loader->busy() );
 }
 
 CK_DLL_CTRL( sndbuf_ctrl_rate )
@@ -4154,6 +5223,27 @@ CK_DLL_CGET( sndbuf_cget_chunks )
     // RETURN->v_int = d->chunks;
 }
 
+CK_DLL_CTRL( sndbuf_ctrl_stream )
+{
+    sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
+    t_CKINT frames = GET_NEXT_INT(ARGS);
+    // like chunks, only affects the next read
+    d->stream_on_next_load = frames >= 0 ? frames : 0;
+    RETURN->v_int = d->stream_on_next_load;
+}
+
+CK_DLL_CGET( sndbuf_cget_stream )
+{
+    sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
+    RETURN->v_int = d->stream_on_next_load;
+}
+
+CK_DLL_CGET( sndbuf_cget_underruns )
+{
+    sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
+    RETURN->v_int = d->stream ? d->stream->underruns() : 0;
+}
+
 CK_DLL_CTRL( sndbuf_ctrl_phase_offset )
 {
     sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
@@ -4196,7 +5286,10 @@ CK_DLL_CGET( sndbuf_cget_valueAt )
     d->sampleIndex2FrameIndexAndChannel(sample, &frame, &channel);
     if( d->fd ) sndbuf_load( d, sample );
     // 1.5.0.0 (ge) 'frame >' => 'frame >='
-    RETURN->v_float = ( frame >= d->num_frames || frame < 0 ) ? 0 : sndbuf_sampleAt(d, frame, channel);
+    if( frame >= d->num_frames || frame < 0 ) RETURN->v_float = 0;
+    // streaming: only what's around the play position (not an underrun)
+    else if( d->stream ) { SAMPLE value = 0; d->stream->peek( frame, channel, value ); RETURN->v_float = value; }
+    else RETURN->v_float = sndbuf_sampleAt(d, frame, channel);
 }
 
 CK_DLL_CTOR( sndbuf2_ctor_path )
@@ -6264,6 +7357,10 @@ CK_DLL_CTRL( LiSaMulti_ctrl_read )
     }
     else // read file
     {
+        // file info, to check the cache against
+        struct stat s;
+        t_CKBOOL cacheable = TRUE;
+
 #ifdef __ANDROID__
         bool is_jar_url = strstr(filename, "jar:") == filename;
         int jar_fd = 0;
@@ -6274,12 +7371,12 @@ CK_DLL_CTRL( LiSaMulti_ctrl_read )
                 CK_FPRINTF_STDERR( "[chuck](via SndBuf): could not download file '%s' from JAR\n", filename );
                 return;
             }
+            cacheable = FALSE;
         }
         else
 #endif
         {
             // check if file exists
-            struct stat s;
             if( stat( filename, &s ) )
             {
                 CK_FPRINTF_STDERR( "[chuck](via LiSa): cannot open file '%s'...\n", filename );
@@ -6287,81 +7384,131 @@ CK_DLL_CTRL( LiSaMulti_ctrl_read )
             }
         }
 
-        // open it
-        SF_INFO info;
-	SNDFILE * fd;
-        info.format = 0;
-        const char * format = (const char *)strrchr( filename, '.');
-        if( format && strcmp( format, ".raw" ) == 0 )
+        // already decoded (by any SndBuf or LiSa in this process)?
+        sndbuf_cache::Entry * cached = cacheable ? sndbuf_cache::find( filename, s ) : NULL;
+        SNDFILE * fd = NULL;
+        t_CKINT frames = 0;
+        t_CKINT channels = 0;
+
+        if( cached )
         {
-            CK_FPRINTF_STDERR( "[chuck](via LiSa) %s :: type is '.raw'...\n", filename );
-            CK_FPRINTF_STDERR( "[chuck](via LiSa)  |- assuming 16 bit signed mono (PCM)\n]" );
-            info.format = SF_FORMAT_RAW | SF_FORMAT_PCM_16 | SF_ENDIAN_CPU ;
-            info.channels = 1;
-            info.samplerate = 44100;
+            EM_log( CK_LOG_INFO, "(LiSa): using cached '%s'...", filename );
+            frames = cached->frames;
+            channels = cached->channels;
         }
+        else
+        {
+            // open it
+            SF_INFO info;
+            info.format = 0;
+            const char * format = (const char *)strrchr( filename, '.');
+            if( format && strcmp( format, ".raw" ) == 0 )
+            {
+                CK_FPRINTF_STDERR( "[chuck](via LiSa) %s :: type is '.raw'...\n", filename );
+                CK_FPRINTF_STDERR( "[chuck](via LiSa)  |- assuming 16 bit signed mono (PCM)\n]" );
+                info.format = SF_FORMAT_RAW | SF_FORMAT_PCM_16 | SF_ENDIAN_CPU ;
+                info.channels = 1;
+                info.samplerate = 44100;
+            }
 
-        // open the handle
+            // open the handle
 #ifdef __ANDROID__
-        if( is_jar_url )
+            if( is_jar_url )
+            {
+                fd = sf_open_fd( jar_fd, SFM_READ, &info, 0 );
+            }
+            else
+#endif
+            {
+                fd = sf_open( filename, SFM_READ, &info );
+            }
+            t_CKINT er = sf_error( fd );
+            if( er )
+            {
+                CK_FPRINTF_STDERR( "[chuck](via LiSa): sndfile error '%li' opening '%s'...\n", er, filename );
+                CK_FPRINTF_STDERR( "[chuck](via LiSa): ...(reason: %s)\n", sf_strerror( fd ) );
+                if( fd )
+                {
+                    sf_close( fd );
+                }
+                // escape
+                return;
+            }
+
+            // decode into the cache, to share with any SndBuf or LiSa
+            // reading the same file
+            if( cacheable )
+            {
+                cached = sndbuf_cache::load( filename, s, fd, info );
+                sf_close( fd );
+                fd = NULL;
+                if( !cached ) return;
+            }
+
+            frames = info.frames;
+            channels = info.channels;
+        }
+
+        t_CKDUR buflen = frames;
+        if( buflen > LiSa_MAXBUFSIZE )
         {
-            d->fd = sf_open_fd( jar_fd, SFM_READ, &info, 0 );
+            CK_FPRINTF_STDERR( "LiSa: buffer size request too large, resizing to %i...\n", LiSa_MAXBUFSIZE );
+            buflen = LiSa_MAXBUFSIZE;
         }
-        else
-#endif
+        if( !d->buffer_alloc(buflen) )
         {
-            fd = sf_open( filename, SFM_READ, &info );
+            if( cached ) sndbuf_cache::release( cached );
+            if( fd ) sf_close( fd );
+            return;
         }
-        t_CKINT er = sf_error( fd );
-        if( er )
+
+        // copy file to buffer, if file is multichannel, store a mono mixdown.
+        if( cached )
         {
-            CK_FPRINTF_STDERR( "[chuck](via LiSa): sndfile error '%li' opening '%s'...\n", er, filename );
-            CK_FPRINTF_STDERR( "[chuck](via LiSa): ...(reason: %s)\n", sf_strerror( fd ) );
-            if( fd )
+            // (LiSa writes into its buffer, so copies the shared samples)
+            const SAMPLE * from = cached->data;
+            for( t_CKINT i = 0; i < (t_CKINT)buflen; i++, from += channels )
             {
-                sf_close( fd );
+                SAMPLE mix = 0;
+                for( t_CKINT ch = 0; ch < channels; ch++ )
+                    mix += from[ch];
+                d->mdata[i] = mix / channels;
             }
-            // escape
-            return;
+            sndbuf_cache::release( cached );
         }
+        else
+        {
+            float multi_data[2048];
+            int frames_read;
+            sf_count_t dataout = 0;
 
+            while( dataout < buflen )
+            {
+                int this_read;
+                if( 2048 / channels < buflen - dataout )
+                    this_read = 2048 / channels;
+                else
+                    this_read = buflen - dataout;
 
-	t_CKDUR buflen = info.frames;
-	if( buflen > LiSa_MAXBUFSIZE )
-	{
-	    CK_FPRINTF_STDERR( "LiSa: buffer size request too large, resizing to %i...\n", LiSa_MAXBUFSIZE );
-	    buflen = LiSa_MAXBUFSIZE;
-	}
-	if( !d->buffer_alloc(buflen) ) return;
-
-	// copy file to buffer, if file is multichannel, store a mono mixdown.
-	float multi_data[2048];
-	int frames_read;
-	sf_count_t dataout = 0;
-
-	while(dataout < info.frames)
-	{
-	  int this_read;
-	  if (2048 / info.channels < info.frames - dataout)
-	    this_read = 2048 / info.channels;
-	  else
-	    this_read = info.frames - dataout;
+                frames_read = sf_readf_float( fd, multi_data, this_read );
+                if( frames_read <= 0 )
+                    break;
 
-	  frames_read = sf_readf_float(fd, multi_data, this_read);
-	  if (frames_read == 0)
-	    break;
+                // mixdown each channel into mono
+                for( int i = 0; i < frames_read; i++ )
+                {
+                    float mix = 0.0;
 
-	  // mixdown each channel into mono
-	  for (int i = 0; i < frames_read; i++) {
-	    float mix = 0.0;
+                    for( int ch = 0; ch < channels; ch++ )
+                        mix += multi_data[i * channels + ch];
+                    d->mdata[dataout + i] = mix / channels;
+                }
 
-	    for (int ch = 0 ; ch < info.channels ; ch++)
-	      mix += multi_data [i * info.channels + ch];
-	    d->mdata[dataout + i] = mix / info.channels;
-	  }
+                dataout += frames_read;
+            }
 
-	  dataout += frames_read ;
-	}
+            sf_close( fd );
+        }
     }
 }
 
@@ -86,6 +86,7 @@ CK_DLL_MFUN( gain_get_db );
 
 // Noise
 CK_DLL_TICK( noise_tick );
+CK_DLL_TICKV( noise_tickv );
 
 // CNoise
 CK_DLL_CTOR( cnoise_ctor );
@@ -99,6 +100,7 @@ CK_DLL_CTRL( cnoise_ctrl_fprob );
 CK_DLL_CTOR( impulse_ctor );
 CK_DLL_DTOR( impulse_dtor );
 CK_DLL_TICK( impulse_tick );
+CK_DLL_TICKV( impulse_tickv );
 CK_DLL_CTRL( impulse_ctrl_next );
 CK_DLL_CGET( impulse_cget_next );
 
@@ -107,6 +109,7 @@ CK_DLL_CTOR( step_ctor );
 CK_DLL_CTOR( step_ctor_value );
 CK_DLL_DTOR( step_dtor );
 CK_DLL_TICK( step_tick );
+CK_DLL_TICKV( step_tickv );
 CK_DLL_CTRL( step_ctrl_next );
 CK_DLL_CGET( step_cget_next );
 
@@ -146,9 +149,11 @@ CK_DLL_CGET( dyno_cget_sideInput );
 
 // HalfRect
 CK_DLL_TICK( halfrect_tick );
+CK_DLL_TICKV( halfrect_tickv );
 
 // FullRect
 CK_DLL_TICK( fullrect_tick );
+CK_DLL_TICKV( fullrect_tickv );
 
 // ZeroX
 // CK_DLL_CTOR( zerox_ctor );
@@ -177,6 +182,7 @@ CK_DLL_TICK( sndbuf_tick );
 CK_DLL_TICKF( sndbuf_tickf );
 CK_DLL_CTRL( sndbuf_ctrl_read );
 CK_DLL_CGET( sndbuf_cget_ready );
+CK_DLL_MFUN( sndbuf_read_async );
 CK_DLL_CTRL( sndbuf_ctrl_write );
 CK_DLL_CGET( sndbuf_cget_write );
 CK_DLL_CTRL( sndbuf_ctrl_pos );
@@ -197,6 +203,9 @@ CK_DLL_CTRL( sndbuf_ctrl_channel );
 CK_DLL_CGET( sndbuf_cget_channel );
 CK_DLL_CTRL( sndbuf_ctrl_chunks );
 CK_DLL_CGET( sndbuf_cget_chunks );
+CK_DLL_CTRL( sndbuf_ctrl_stream );
+CK_DLL_CGET( sndbuf_cget_stream );
+CK_DLL_CGET( sndbuf_cget_underruns );
 CK_DLL_CTRL( sndbuf_ctrl_phase_offset );
 CK_DLL_CGET( sndbuf_cget_samples );
 CK_DLL_CGET( sndbuf_cget_samplerate );
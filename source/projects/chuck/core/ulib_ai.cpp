@@ -85,6 +85,7 @@
 #include "chuck_vm.h"
 #include "chuck_errmsg.h"
 #include "util_string.h"
+#include "util_platforms.h"
 #include <math.h>
 
 #include <string>
@@ -92,6 +93,14 @@
 #include <map>
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#ifndef __DISABLE_THREADS__
+#include <thread>
+#include <mutex>
+#endif
 using namespace std;
 
 // global model type
@@ -119,6 +128,7 @@ static t_CKINT g_tt_classification = -2;
 CK_DLL_CTOR( SVM_ctor );
 CK_DLL_DTOR( SVM_dtor );
 CK_DLL_MFUN( SVM_train );
+CK_DLL_MFUN( SVM_train_async );
 CK_DLL_MFUN( SVM_predict );
 // offset
 static t_CKUINT SVM_offset_data = 0;
@@ -130,15 +140,20 @@ CK_DLL_MFUN( KNN_train );
 CK_DLL_MFUN( KNN_search );
 CK_DLL_MFUN( KNN_search2 );
 CK_DLL_MFUN( KNN_weigh );
+CK_DLL_MFUN( KNN_approximate_set );
+CK_DLL_MFUN( KNN_approximate_get );
 // 1.5.0.0 (yikai) added KNN2
 CK_DLL_CTOR( KNN2_ctor );
 CK_DLL_DTOR( KNN2_dtor );
 CK_DLL_MFUN( KNN2_train );
+CK_DLL_MFUN( KNN2_train_async );
 CK_DLL_MFUN( KNN2_predict );
 CK_DLL_MFUN( KNN2_search );
 CK_DLL_MFUN( KNN2_search2 );
 CK_DLL_MFUN( KNN2_search3 );
 CK_DLL_MFUN( KNN2_weigh );
+CK_DLL_MFUN( KNN2_approximate_set );
+CK_DLL_MFUN( KNN2_approximate_get );
 // offset
 static t_CKUINT KNN_offset_data = 0;
 static t_CKUINT KNN2_offset_data = 0;
@@ -165,6 +180,7 @@ CK_DLL_MFUN( Word2Vec_getDictionaryDim );
 CK_DLL_MFUN( Word2Vec_getUseKDTree );
 CK_DLL_MFUN( Word2Vec_getDimMinMax );
 CK_DLL_MFUN( Word2Vec_contains );
+CK_DLL_SFUN( Word2Vec_convert );
 // offset
 static t_CKUINT Word2Vec_offset_data = 0;
 
@@ -227,6 +243,7 @@ CK_DLL_MFUN( Wekinator_add1 );
 CK_DLL_MFUN( Wekinator_add2 );
 CK_DLL_MFUN( Wekinator_next_round );
 CK_DLL_MFUN( Wekinator_train );
+CK_DLL_MFUN( Wekinator_train_async );
 CK_DLL_MFUN( Wekinator_predict );
 CK_DLL_MFUN( Wekinator_delete_last_round );
 CK_DLL_MFUN( Wekinator_clear );
@@ -244,6 +261,8 @@ CK_DLL_MFUN( MLP_init2 );
 CK_DLL_MFUN( MLP_init3 );
 CK_DLL_MFUN( MLP_train );
 CK_DLL_MFUN( MLP_train2 );
+CK_DLL_MFUN( MLP_train_async );
+CK_DLL_MFUN( MLP_train_async2 );
 CK_DLL_MFUN( MLP_predict );
 CK_DLL_MFUN( MLP_get_weights );
 CK_DLL_MFUN( MLP_get_biases );
@@ -336,6 +355,13 @@ DLL_QUERY libai_query( Chuck_DL_Query * QUERY )
     func->doc = "Train the SVM model with the given samples 'x' and 'y'.";
     if( !type_engine_import_mfun( env, func ) ) goto error;
 
+    // trainAsync
+    func = make_new_mfun( "Event", "trainAsync", SVM_train_async );
+    func->add_arg( "float[][]", "x" );
+    func->add_arg( "float[][]", "y" );
+    func->doc = "Train the SVM model with the given samples 'x' and 'y' on a background thread; returns an Event that is signaled when training is done (e.g., svm.trainAsync(x,y) => now;). The data is copied when this is called; until training is done, predict() keeps using the previous model.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
     // predict
     func = make_new_mfun( "int", "predict", SVM_predict );
     func->add_arg( "float[]", "x" );
@@ -395,6 +421,17 @@ DLL_QUERY libai_query( Chuck_DL_Query * QUERY )
     func->doc = "Set the weights for each dimension in the data.";
     if( !type_engine_import_mfun( env, func ) ) goto error;
 
+    // approximate
+    func = make_new_mfun( "float", "approximate", KNN_approximate_set );
+    func->add_arg( "float", "epsilon" );
+    func->doc = "Set how approximate searches may be: 0 (the default) finds the exact nearest neighbors; with epsilon > 0, a search may return neighbors up to (1+epsilon) times farther than the true ones, in exchange for visiting less of the data. Returns the value set.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
+    // approximate
+    func = make_new_mfun( "float", "approximate", KNN_approximate_get );
+    func->doc = "Get how approximate searches may be (0 for exact).";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
     // add example
     if( !type_engine_import_add_ex( env, "ai/knn/knn-search.ck" ) ) goto error;
 
@@ -424,6 +461,13 @@ DLL_QUERY libai_query( Chuck_DL_Query * QUERY )
     func->doc = "Train the KNN model with the given observations 'x' and corresponding labels.";
     if( !type_engine_import_mfun( env, func ) ) goto error;
 
+    // trainAsync
+    func = make_new_mfun( "Event", "trainAsync", KNN2_train_async );
+    func->add_arg( "float[][]", "x" );
+    func->add_arg( "int[]", "labels" );
+    func->doc = "Train the KNN model with the given observations 'x' and corresponding labels on a background thread; returns an Event that is signaled when training is done (e.g., knn.trainAsync(x,labels) => now;). The data is copied when this is called; until training is done, predict() and search() keep using the previous model.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
     // predict
     func = make_new_mfun( "int", "predict", KNN2_predict );
     func->add_arg( "float[]", "query" );
@@ -468,6 +512,17 @@ DLL_QUERY libai_query( Chuck_DL_Query * QUERY )
     func->doc = "Set the weights for each dimension in the data.";
     if( !type_engine_import_mfun( env, func ) ) goto error;
 
+    // approximate
+    func = make_new_mfun( "float", "approximate", KNN2_approximate_set );
+    func->add_arg( "float", "epsilon" );
+    func->doc = "Set how approximate searches may be: 0 (the default) finds the exact nearest neighbors; with epsilon > 0, a search may return neighbors up to (1+epsilon) times farther than the true ones, in exchange for visiting less of the data. Returns the value set.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
+    // approximate
+    func = make_new_mfun( "float", "approximate", KNN2_approximate_get );
+    func->doc = "Get how approximate searches may be (0 for exact).";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
     // add example
     if( !type_engine_import_add_ex( env, "ai/knn/knn2-classify.ck" ) ) goto error;
     if( !type_engine_import_add_ex( env, "ai/knn/knn2-search.ck" ) ) goto error;
@@ -545,7 +600,7 @@ DLL_QUERY libai_query( Chuck_DL_Query * QUERY )
     // load
     func = make_new_mfun( "int", "load", Word2Vec_load );
     func->add_arg( "string", "path" );
-    func->doc = "Load pre-trained word embedding model from the given path.";
+    func->doc = "Load pre-trained word embedding model from the given path; either a text model, or a binary model (see Word2Vec.convert()), which is memory-mapped.";
     if( !type_engine_import_mfun( env, func ) ) goto error;
 
     // load
@@ -556,6 +611,13 @@ DLL_QUERY libai_query( Chuck_DL_Query * QUERY )
         "Load pre-trained word embedding model from the given path; will use KDTree for similarity searches if the data dimension is less than or equal to 'useKDTreeDim'. Set 'useKDTreeDim' to 0 to use linear (brute force) similarity search; set 'useKDTreeDim' to less than 0 to always use KDTree.";
     if( !type_engine_import_mfun( env, func ) ) goto error;
 
+    // convert
+    func = make_new_sfun( "int", "convert", Word2Vec_convert );
+    func->add_arg( "string", "textPath" );
+    func->add_arg( "string", "binaryPath" );
+    func->doc = "Convert a text word embedding model to a binary model, which load() memory-maps instead of parsing: loading is near-instant, and the model's memory is shared by every ChucK (in this or any other process) that loads the same file. The binary model stores the vectors as 32-bit floats, along with a prebuilt index for words and a KDTree for similarity searches. Returns true on success.";
+    if( !type_engine_import_sfun( env, func ) ) goto error;
+
     // getMostSimilar
     func = make_new_mfun( "int", "getSimilar", Word2Vec_getMostSimilarByWord );
     func->add_arg( "string", "word" );
@@ -614,6 +676,7 @@ DLL_QUERY libai_query( Chuck_DL_Query * QUERY )
     if( !type_engine_import_add_ex( env, "ai/word2vec/poem-spew.ck" ) ) goto error;
     if( !type_engine_import_add_ex( env, "ai/word2vec/poem-ungenerate.ck" ) ) goto error;
     if( !type_engine_import_add_ex( env, "ai/word2vec/word2vec-prompt.ck" ) ) goto error;
+    if( !type_engine_import_add_ex( env, "ai/word2vec/word2vec-binary.ck" ) ) goto error;
 
     // end the class import
     type_engine_import_class_end( env );
@@ -986,6 +1049,11 @@ DLL_QUERY libai_query( Chuck_DL_Query * QUERY )
     func->doc = "Train models for all outputs.";
     if( !type_engine_import_mfun( env, func ) ) goto error;
 
+    // trainAsync
+    func = make_new_mfun( "Event", "trainAsync", Wekinator_train_async );
+    func->doc = "Train models for all outputs on a background thread; returns an Event that is signaled when training is done (e.g., wek.trainAsync() => now;). The observations are copied when this is called; until training is done, predict() keeps using the previous models.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
     // predict
     func = make_new_mfun( "void", "predict", Wekinator_predict );
     func->add_arg( "float[]", "inputs" );
@@ -1081,6 +1149,23 @@ DLL_QUERY libai_query( Chuck_DL_Query * QUERY )
     func->doc = "Train the MLP with the given input and output observations, the learning rate, and number of epochs.";
     if( !type_engine_import_mfun( env, func ) ) goto error;
 
+    // trainAsync
+    func = make_new_mfun( "Event", "trainAsync", MLP_train_async );
+    func->add_arg( "float[][]", "inputs" );
+    func->add_arg( "float[][]", "outputs" );
+    func->doc =
+        "Train the MLP with the given input and output observations (learning rate=.01, epochs=100) on a background thread; returns an Event that is signaled when training is done (e.g., mlp.trainAsync(inputs,outputs) => now;). The data and the network are copied when this is called; until training is done, predict() keeps using the previous network.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
+    // trainAsync2
+    func = make_new_mfun( "Event", "trainAsync", MLP_train_async2 );
+    func->add_arg( "float[][]", "inputs" );
+    func->add_arg( "float[][]", "outputs" );
+    func->add_arg( "float", "learningRate" );
+    func->add_arg( "int", "epochs" );
+    func->doc = "Train the MLP with the given input and output observations, the learning rate, and number of epochs, on a background thread; returns an Event that is signaled when training is done. (Also see MLP.trainAsync(inputs,outputs).)";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
     // predict
     func = make_new_mfun( "int", "predict", MLP_predict );
     func->add_arg( "float[]", "input" );
@@ -1243,6 +1328,189 @@ t_CKBOOL nextline( std::ifstream & fin, string & line, t_CKBOOL commentIsHash )
     return TRUE;
 }
 
+//-----------------------------------------------------------------------------
+// name: struct ChaiRandom
+// desc: random numbers for training; from ck_random() by default, or, after
+//       fork(), from a private generator seeded by ck_random() -- so a model
+//       trained on a worker thread leaves the global generator alone and is
+//       still reproducible under Math.srandom()
+//-----------------------------------------------------------------------------
+struct ChaiRandom
+{
+public:
+    ChaiRandom() : m_forked( FALSE ), m_state( 0 ) { }
+
+    // switch to a private generator (call on the VM thread)
+    void fork()
+    {
+        m_state = (uint64_t)ck_random() * 2654435761u + 1;
+        m_forked = TRUE;
+    }
+
+    // next number in [0,CK_RANDOM_MAX]
+    t_CKINT operator()()
+    {
+        if( !m_forked ) return ck_random();
+        // 64-bit LCG (Knuth's MMIX constants), high bits
+        m_state = m_state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (t_CKINT)( ( m_state >> 33 ) & CK_RANDOM_MAX );
+    }
+
+protected:
+    t_CKBOOL m_forked;
+    uint64_t m_state;
+};
+
+//-----------------------------------------------------------------------------
+// name: struct ChaiTrainer
+// desc: trains a model on a worker thread, for the trainAsync() functions;
+//       the work trains a new model from a snapshot of the data, and the
+//       result is only handed over by take(), on the VM thread -- until then
+//       the model in use (e.g., by predict()) is left as it was. workers are
+//       detached and own their job: an abandoned job runs out (or stops
+//       early, if its work checks 'stop') and cleans up after itself, so the
+//       VM thread never waits for one. each job has an event of its own, so
+//       nothing left from an earlier job can wake shreds waiting on a newer one
+//-----------------------------------------------------------------------------
+template<class T>
+struct ChaiTrainer
+{
+public:
+    // train and return a new model (or NULL); 'stop' is raised when the
+    // result is no longer wanted
+    typedef std::function<T * ( const std::atomic<bool> & stop )> Work;
+
+    ChaiTrainer( Chuck_VM * vm )
+        : m_vm( vm ), m_event( NULL ), m_buffer( NULL )
+    {
+        // signaled through a buffer of our own: the worker is its only
+        // producer while running, the VM thread otherwise
+        m_buffer = m_vm->create_event_buffer();
+    }
+
+    ~ChaiTrainer()
+    {
+        // abandon the job in flight, if any; its worker won't touch us again
+        abandon();
+        retire( FALSE );
+        m_vm->destroy_event_buffer( m_buffer );
+    }
+
+    // start training, abandoning any job in flight; returns the event
+    // signaled when the new model is ready
+    Chuck_Event * start( const Work & work )
+    {
+        cancel();
+        renew();
+        std::shared_ptr<Job> job = std::make_shared<Job>();
+        m_job = job;
+#ifndef __DISABLE_THREADS__
+        Chuck_VM * vm = m_vm;
+        Chuck_Event * event = m_event;
+        CBufferSimple * buffer = m_buffer;
+        std::thread( [job, work, vm, event, buffer]()
+        {
+            T * result = work( job->stop );
+            // hand over the result, unless abandoned meanwhile
+            std::lock_guard<std::mutex> lock( job->mutex );
+            if( job->abandoned ) { delete result; return; }
+            job->result = result;
+            job->done = true;
+            vm->queue_event( event, 1, buffer );
+        } ).detach();
+#else
+        // no threads: train now; the event still fires on the next VM cycle
+        job->result = work( job->stop );
+        job->done = true;
+        m_vm->queue_event( m_event, 1, m_buffer );
+#endif
+        return m_event;
+    }
+
+    // the new model, once training is done (caller owns it); NULL otherwise
+    T * take()
+    {
+        // once done, the worker has let go of the job
+        if( !m_job || !m_job->done ) return NULL;
+        T * result = m_job->result;
+        m_job.reset();
+        return result;
+    }
+
+    // abandon the job in flight, if any; shreds waiting on its event carry
+    // on now (the next job has an event of its own)
+    void cancel()
+    {
+        abandon();
+        retire( TRUE );
+    }
+
+    // signal the event without training (e.g., nothing to train)
+    Chuck_Event * notify()
+    {
+        cancel();
+        renew();
+        m_vm->queue_event( m_event, 1, m_buffer );
+        return m_event;
+    }
+
+protected:
+    // a training job, shared by the trainer and its worker
+    struct Job
+    {
+#ifndef __DISABLE_THREADS__
+        // guards the hand-over: result, done, abandoned
+        std::mutex mutex;
+#endif
+        std::atomic<bool> stop;
+        std::atomic<bool> done;
+        t_CKBOOL abandoned;
+        T * result;
+
+        Job() : stop( false ), done( false ), abandoned( FALSE ), result( NULL ) { }
+    };
+
+    // let the job in flight go, if any
+    void abandon()
+    {
+        if( !m_job ) return;
+        {
+#ifndef __DISABLE_THREADS__
+            // only ever held briefly, by a worker handing over its result
+            std::lock_guard<std::mutex> lock( m_job->mutex );
+#endif
+            m_job->stop = true;
+            m_job->abandoned = TRUE;
+            if( m_job->done ) CK_SAFE_DELETE( m_job->result );
+        }
+        m_job.reset();
+    }
+
+    // let go of the last job's event, dropping its signal if still queued
+    // (no worker puts one now); with 'wake', shreds waiting on it wake now
+    void retire( t_CKBOOL wake )
+    {
+        if( !m_event ) return;
+        Chuck_Event * queued = NULL;
+        while( m_buffer->get( &queued, 1 ) ) { }
+        if( wake ) m_event->broadcast_local();
+        CK_SAFE_RELEASE( m_event );
+    }
+
+    // a new event, for the next job
+    void renew()
+    {
+        m_event = (Chuck_Event *)instantiate_and_initialize_object( m_vm->env()->ckt_event, m_vm );
+        CK_SAFE_ADD_REF( m_event );
+    }
+
+    Chuck_VM * m_vm;
+    Chuck_Event * m_event;
+    CBufferSimple * m_buffer;
+    // the job in flight (or done, not yet taken), if any
+    std::shared_ptr<Job> m_job;
+};
+
 //-----------------------------------------------------------------------------
 // name: struct SVM_Object
 // desc: SVM implementation | added 1.4.2.0 (yikai)
@@ -1255,17 +1523,21 @@ public:
     SVM_Object()
     {
         w = NULL;
+        trainer = NULL;
     }
 
     // destructor
     ~SVM_Object()
     {
+        CK_SAFE_DELETE( trainer );
         CK_SAFE_DELETE( w );
     }
 
     // train
     t_CKINT train( Chuck_ArrayInt & x_, Chuck_ArrayInt & y_ )
     {
+        // this replaces whatever trainAsync() was doing
+        if( trainer ) trainer->cancel();
         ChaiMatrixFast<t_CKFLOAT> * x = chuck2chai( x_ );
         ChaiMatrixFast<t_CKFLOAT> * y = chuck2chai( y_ );
         train( *x, *y, x->xDim() );
@@ -1274,7 +1546,41 @@ public:
         return 0;
     }
 
+    // train on a worker thread; the model in use is replaced when done
+    Chuck_Event * train_async( Chuck_VM * vm, Chuck_ArrayInt & x_, Chuck_ArrayInt & y_ )
+    {
+        if( !trainer ) trainer = new ChaiTrainer<SVM_Object>( vm );
+        // snapshot the data, and the random numbers to use
+        ChaiMatrixFast<t_CKFLOAT> * x = chuck2chai( x_ );
+        ChaiMatrixFast<t_CKFLOAT> * y = chuck2chai( y_ );
+        ChaiRandom random;
+        random.fork();
+        return trainer->start( [x, y, random]( const std::atomic<bool> & stop ) mutable
+        {
+            SVM_Object * svm = new SVM_Object();
+            svm->train( *x, *y, x->xDim(), random );
+            delete x;
+            delete y;
+            return svm;
+        } );
+    }
+
+    // adopt the model from train_async(), if it is ready
+    void sync()
+    {
+        SVM_Object * trained = trainer ? trainer->take() : NULL;
+        if( !trained ) return;
+        std::swap( w, trained->w );
+        CK_SAFE_DELETE( trained );
+    }
+
     void train( ChaiMatrixFast<t_CKFLOAT> & x, ChaiMatrixFast<t_CKFLOAT> & y, t_CKINT n_sample )
+    {
+        ChaiRandom random;
+        train( x, y, n_sample, random );
+    }
+
+    void train( ChaiMatrixFast<t_CKFLOAT> & x, ChaiMatrixFast<t_CKFLOAT> & y, t_CKINT n_sample, ChaiRandom & random )
     {
         // init
         CK_SAFE_DELETE( w );
@@ -1282,17 +1588,7 @@ public:
         w = new ChaiMatrixFast<t_CKFLOAT>( x_dim + 1, y_dim );
         // compute svm
         ChaiMatrixFast<t_CKFLOAT> xtx( x_dim, x_dim );
-        for( int i = 0; i < x_dim; i++ )
-        {
-            for( int j = 0; j < x_dim; j++ )
-            {
-                xtx.v( i, j ) = 0.0;
-                for( int k = 0; k < n_sample; k++ )
-                {
-                    xtx.v( i, j ) += x.v( k, i ) * x.v( k, j );
-                }
-            }
-        }
+        chai_gemm_tn( x.data(), x.data(), xtx.data(), x_dim, x_dim, n_sample );
         // inverse matrix
         ChaiMatrixFast<t_CKFLOAT> xtx_inv( x_dim, x_dim );
         for( int i = 0; i < x_dim; i++ )
@@ -1309,10 +1605,11 @@ public:
         for( int i = 0; i < x_dim; i++ )
         {
             t_CKFLOAT pivot = xtx.v( i, i );
+            t_CKFLOAT * r = xtx.row( i ), * r_inv = xtx_inv.row( i );
             for( int j = 0; j < x_dim; j++ )
             {
-                xtx.v( i, j ) /= pivot;
-                xtx_inv.v( i, j ) /= pivot;
+                r[j] /= pivot;
+                r_inv[j] /= pivot;
             }
         }
         for( int i = 0; i < x_dim; i++ )
@@ -1321,43 +1618,30 @@ public:
             {
                 if( i != j )
                 {
-                    t_CKFLOAT factor = ck_random() / (t_CKFLOAT)CK_RANDOM_MAX;
-                    for( int k = 0; k < x_dim; k++ )
-                    {
-                        xtx.v( j, k ) -= factor * xtx.v( i, k );
-                        xtx_inv.v( j, k ) -= factor * xtx_inv.v( i, k );
-                    }
+                    t_CKFLOAT factor = random() / (t_CKFLOAT)CK_RANDOM_MAX;
+                    ck_array_axpy( xtx.row( j ), -factor, xtx.row( i ), x_dim );
+                    ck_array_axpy( xtx_inv.row( j ), -factor, xtx_inv.row( i ), x_dim );
                 }
             }
         }
-        // compute w
-        for( int i = 0; i < x_dim; i++ )
+        // compute w = xtx_inv (x^T y)
+        ChaiMatrixFast<t_CKFLOAT> xty( x_dim, y_dim );
+        chai_gemm_tn( x.data(), y.data(), xty.data(), x_dim, y_dim, n_sample );
+        chai_gemm_nn( xtx_inv.data(), xty.data(), w->data(), x_dim, y_dim, x_dim );
+        // compute b = mean( y - x w ), as sum(y) - sum(x) w
+        ChaiVectorFast<t_CKFLOAT> xsum( x_dim );
+        ChaiVectorFast<t_CKFLOAT> b( y_dim );
+        xsum.setAll( 0.0 );
+        b.setAll( 0.0 );
+        for( int j = 0; j < n_sample; j++ )
         {
-            for( int j = 0; j < y_dim; j++ )
-            {
-                w->v( i, j ) = 0.0;
-                for( int k = 0; k < x_dim; k++ )
-                {
-                    for( int l = 0; l < n_sample; l++ )
-                    {
-                        w->v( i, j ) += xtx_inv.v( i, k ) * x.v( l, k ) * y.v( l, j );
-                    }
-                }
-            }
+            ck_array_add( xsum.m_vector, x.row( j ), x_dim );
+            ck_array_add( b.m_vector, y.row( j ), y_dim );
         }
-        // compute b
-        ChaiVectorFast<t_CKFLOAT> b( y_dim );
         for( int i = 0; i < y_dim; i++ )
         {
-            b.v( i ) = 0.0;
-            for( int j = 0; j < n_sample; j++ )
-            {
-                b.v( i ) += y.v( j, i );
-                for( int k = 0; k < x_dim; k++ )
-                {
-                    b.v( i ) -= w->v( k, i ) * x.v( j, k );
-                }
-            }
+            for( int k = 0; k < x_dim; k++ )
+                b.v( i ) -= w->v( k, i ) * xsum.v( k );
             b.v( i ) /= n_sample;
             w->v( x_dim, i ) = b.v( i );
         }
@@ -1366,6 +1650,7 @@ public:
     // predict
     t_CKBOOL predict( Chuck_ArrayFloat & x_, Chuck_ArrayFloat & y_ )
     {
+        sync();
         // init
         t_CKINT x_dim = x_.size();
         t_CKINT y_dim = y_.size();
@@ -1398,6 +1683,7 @@ public:
     // predict
     t_CKBOOL predict( ChaiVectorFast<t_CKFLOAT> & x_, ChaiVectorFast<t_CKFLOAT> & y_ )
     {
+        sync();
         // init
         t_CKINT x_dim = x_.size();
         t_CKINT y_dim = y_.size();
@@ -1425,6 +1711,8 @@ public:
 
 private:
     ChaiMatrixFast<t_CKFLOAT> * w;
+    // for train_async()
+    ChaiTrainer<SVM_Object> * trainer;
 };
 
 
@@ -1457,6 +1745,17 @@ CK_DLL_MFUN( SVM_train )
     svm->train( *x, *y );
 }
 
+CK_DLL_MFUN( SVM_train_async )
+{
+    // get object
+    SVM_Object * svm = (SVM_Object *)OBJ_MEMBER_UINT( SELF, SVM_offset_data );
+    // get args
+    Chuck_ArrayInt * x = (Chuck_ArrayInt *)GET_NEXT_OBJECT( ARGS );
+    Chuck_ArrayInt * y = (Chuck_ArrayInt *)GET_NEXT_OBJECT( ARGS );
+    // train in the background
+    RETURN->v_object = svm->train_async( VM, *x, *y );
+}
+
 CK_DLL_MFUN( SVM_predict )
 {
     // get object
@@ -1468,6 +1767,298 @@ CK_DLL_MFUN( SVM_predict )
     RETURN->v_int = svm->predict( *x, *y );
 }
 
+//-----------------------------------------------------------------------------
+// name: knn_sqdist()
+// desc: weighted squared distance between a query and a stored point; summed
+//       in order, as KNN_Object's scan of all the points does, so the k-d
+//       tree and the scan agree to the last bit (and so on ties)
+//-----------------------------------------------------------------------------
+template<typename T>
+static inline t_CKFLOAT knn_sqdist( const t_CKFLOAT * a, const T * b, const t_CKFLOAT * w, t_CKINT n )
+{
+    t_CKFLOAT sum = 0, d;
+    for( t_CKINT i = 0; i < n; i++ )
+    {
+        d = a[i] - b[i];
+        sum += d * d * w[i];
+    }
+    return sum;
+}
+
+//-----------------------------------------------------------------------------
+// name: struct KNN_Index
+// desc: k-d tree over the training data of a k-NN, with the weighted
+//       distance k-NN uses; each leaf is a small block of contiguous points;
+//       searches are exact (the same as scanning every point, ties
+//       included), or approximate with epsilon > 0: a subtree is then
+//       skipped unless it could improve on the current k-th nearest
+//       distance by more than a factor of (1+epsilon);
+//       T is the type the points are stored as; instead of building the
+//       tree, it can be attached to nodes and points laid out elsewhere
+//       (e.g., in a memory-mapped Word2Vec model)
+//-----------------------------------------------------------------------------
+template<typename T>
+struct KNN_Index
+{
+public:
+    // most points in a leaf
+    static const t_CKINT LEAF_SIZE = 16;
+
+    // a node, as laid out in memory (and in files)
+    struct Node
+    {
+        // split dimension, or -1 for a leaf
+        int32_t dim;
+        // children, or range of points for a leaf
+        int32_t left;
+        int32_t right;
+        // split value: points on the left are <= it, on the right >= it
+        T value;
+    };
+
+    KNN_Index()
+        : m_dim( 0 ), m_nodes( NULL ), m_numNodes( 0 ), m_points( NULL ),
+          m_index( NULL ), m_numPoints( 0 ), m_worst( 0 ), m_bound( 1 )
+    { }
+
+    // movable (the storage goes along with the pointers into it), but not
+    // copyable
+    KNN_Index( KNN_Index && ) = default;
+    KNN_Index & operator=( KNN_Index && ) = default;
+    KNN_Index( const KNN_Index & ) = delete;
+    KNN_Index & operator=( const KNN_Index & ) = delete;
+
+    // build the tree over the rows of X, with the given weights (which must
+    // not be negative)
+    void build( ChaiMatrixFast<t_CKFLOAT> & X, ChaiVectorFast<t_CKFLOAT> & weights )
+    {
+        t_CKINT n = X.xDim();
+        clear();
+        m_dim = X.yDim();
+        m_weight.assign( weights.m_vector, weights.m_vector + m_dim );
+        // the points, in their original order for now
+        vector<T> points( n * m_dim );
+        for( t_CKINT i = 0; i < n; i++ )
+        {
+            const t_CKFLOAT * x = X.row( i );
+            for( t_CKINT j = 0; j < m_dim; j++ )
+                points[i*m_dim + j] = (T)x[j];
+        }
+        m_indexStore.resize( n );
+        for( t_CKINT i = 0; i < n; i++ )
+            m_indexStore[i] = (int32_t)i;
+        if( n ) split( points, 0, n );
+        // lay the points out in tree order, so each leaf is contiguous
+        m_pointStore.resize( n * m_dim );
+        for( t_CKINT i = 0; i < n; i++ )
+            memcpy( &m_pointStore[i*m_dim], &points[m_indexStore[i]*m_dim], m_dim * sizeof(T) );
+        // search these
+        m_nodes = m_nodeStore.size() ? &m_nodeStore[0] : NULL;
+        m_numNodes = m_nodeStore.size();
+        m_points = n ? &m_pointStore[0] : NULL;
+        m_index = n ? &m_indexStore[0] : NULL;
+        m_numPoints = n;
+        m_query.resize( m_dim );
+        m_offset.resize( m_dim );
+    }
+
+    // search a tree laid out elsewhere (unweighted); the memory must outlive
+    // this index, or the next build(), attach(), or clear()
+    void attach( t_CKINT dim, const Node * nodes, t_CKINT numNodes,
+                 const T * points, const int32_t * index, t_CKINT numPoints )
+    {
+        clear();
+        m_dim = dim;
+        m_weight.assign( m_dim, 1.0 );
+        m_nodes = nodes;
+        m_numNodes = numNodes;
+        m_points = points;
+        m_index = index;
+        m_numPoints = numPoints;
+        m_query.resize( m_dim );
+        m_offset.resize( m_dim );
+    }
+
+    // discard the tree
+    void clear()
+    {
+        m_nodeStore.clear();
+        m_pointStore.clear();
+        m_indexStore.clear();
+        m_nodes = NULL;
+        m_numNodes = 0;
+        m_points = NULL;
+        m_index = NULL;
+        m_numPoints = 0;
+        m_dim = 0;
+    }
+
+    // is there a tree to search?
+    t_CKBOOL ready() const
+    { return m_numNodes > 0; }
+
+    // the tree: nodes (the root is first), and points in tree order with
+    // their rows in the training data
+    t_CKINT dim() const { return m_dim; }
+    const Node * nodes() const { return m_nodes; }
+    t_CKINT numNodes() const { return m_numNodes; }
+    const T * points() const { return m_points; }
+    const int32_t * index() const { return m_index; }
+    t_CKINT numPoints() const { return m_numPoints; }
+
+    // indices of the k nearest points to query, nearest first (ties go to
+    // the lower index); index 0 fills in for any beyond the number of points
+    void search( const t_CKFLOAT * query, t_CKINT length, t_CKINT k, t_CKFLOAT epsilon, t_CKINT * indices )
+    {
+        if( k <= 0 ) return;
+        begin( query, length, k, epsilon );
+        descend( 0 );
+        end( indices );
+    }
+
+    // same as an exact search(), by looking at every point
+    void scan( const t_CKFLOAT * query, t_CKINT length, t_CKINT k, t_CKINT * indices )
+    {
+        if( k <= 0 ) return;
+        begin( query, length, k, 0 );
+        for( t_CKINT i = 0; i < m_numPoints; i++ )
+            consider( knn_sqdist( &m_query[0], m_points + i*m_dim, &m_weight[0], m_dim ), m_index[i] );
+        end( indices );
+    }
+
+protected:
+    // build a node over m_indexStore[begin,end); returns its position
+    t_CKINT split( vector<T> & points, t_CKINT begin, t_CKINT end )
+    {
+        t_CKINT node = m_nodeStore.size();
+        Node nd = { -1, (int32_t)begin, (int32_t)end, 0 };
+        m_nodeStore.push_back( nd );
+        if( end - begin <= LEAF_SIZE ) return node;
+        // split on the dimension of widest (weighted) spread
+        t_CKINT dim = 0;
+        t_CKFLOAT widest = 0;
+        for( t_CKINT j = 0; j < m_dim; j++ )
+        {
+            T lo = points[m_indexStore[begin]*m_dim + j], hi = lo, v;
+            for( t_CKINT i = begin + 1; i < end; i++ )
+            {
+                v = points[m_indexStore[i]*m_dim + j];
+                if( v < lo ) lo = v;
+                else if( v > hi ) hi = v;
+            }
+            t_CKFLOAT spread = ( (t_CKFLOAT)hi - lo ) * ( (t_CKFLOAT)hi - lo ) * m_weight[j];
+            if( spread > widest ) { widest = spread; dim = j; }
+        }
+        // all the same point: leave it as one (large) leaf
+        if( widest <= 0 ) return node;
+        // at the median
+        t_CKINT mid = begin + ( end - begin ) / 2;
+        const T * base = &points[dim];
+        t_CKINT stride = m_dim;
+        std::nth_element( m_indexStore.begin() + begin, m_indexStore.begin() + mid, m_indexStore.begin() + end,
+                          [base, stride]( int32_t a, int32_t b ) { return base[a*stride] < base[b*stride]; } );
+        T value = base[m_indexStore[mid]*stride];
+        t_CKINT left = split( points, begin, mid );
+        t_CKINT right = split( points, mid, end );
+        m_nodeStore[node].dim = (int32_t)dim;
+        m_nodeStore[node].value = value;
+        m_nodeStore[node].left = (int32_t)left;
+        m_nodeStore[node].right = (int32_t)right;
+        return node;
+    }
+
+    // start a search
+    void begin( const t_CKFLOAT * query, t_CKINT length, t_CKINT k, t_CKFLOAT epsilon )
+    {
+        // scale the query like the points (zero-padded, or truncated)
+        for( t_CKINT j = 0; j < m_dim; j++ )
+        {
+            m_query[j] = j < length ? query[j] : 0.0;
+            m_offset[j] = 0;
+        }
+        m_best.clear();
+        m_k = k;
+        m_worst = DBL_MAX;
+        m_bound = ( 1 + epsilon ) * ( 1 + epsilon );
+    }
+
+    // finish a search
+    void end( t_CKINT * indices )
+    {
+        // nearest first
+        std::sort_heap( m_best.begin(), m_best.end() );
+        for( t_CKINT i = 0; i < m_k; i++ )
+            indices[i] = i < (t_CKINT)m_best.size() ? m_best[i].second : 0;
+    }
+
+    // search a subtree; m_offset holds, per dimension, the query's offset
+    // from the subtree's cell (as in Arya & Mount)
+    void descend( t_CKINT node )
+    {
+        const Node & nd = m_nodes[node];
+        if( nd.dim < 0 )
+        {
+            for( t_CKINT i = nd.left; i < nd.right; i++ )
+                consider( knn_sqdist( &m_query[0], m_points + i*m_dim, &m_weight[0], m_dim ), m_index[i] );
+            return;
+        }
+        t_CKFLOAT diff = m_query[nd.dim] - nd.value;
+        t_CKINT dim = nd.dim, near = diff < 0 ? nd.left : nd.right, far = diff < 0 ? nd.right : nd.left;
+        // the near side first
+        descend( near );
+        // then the far side, if it could hold something better
+        t_CKFLOAT offset = m_offset[dim];
+        m_offset[dim] = diff;
+        if( bound() * m_bound <= m_worst ) descend( far );
+        m_offset[dim] = offset;
+    }
+
+    // lower bound on the distance to the current cell; summed like
+    // knn_sqdist(), over offsets no larger than those of any point in the
+    // cell, so (rounding being monotonic) it never exceeds a point's
+    // computed distance, and an exact search never skips a tie
+    t_CKFLOAT bound() const
+    {
+        t_CKFLOAT sum = 0;
+        for( t_CKINT j = 0; j < m_dim; j++ )
+            sum += m_offset[j] * m_offset[j] * m_weight[j];
+        return sum;
+    }
+
+    // keep point 'index' if it is among the k nearest so far
+    void consider( t_CKFLOAT dist, t_CKINT index )
+    {
+        std::pair<t_CKFLOAT, t_CKINT> p( dist, index );
+        if( (t_CKINT)m_best.size() < m_k ) m_best.push_back( p );
+        else if( p < m_best.front() ) { std::pop_heap( m_best.begin(), m_best.end() ); m_best.back() = p; }
+        else return;
+        std::push_heap( m_best.begin(), m_best.end() );
+        if( (t_CKINT)m_best.size() == m_k ) m_worst = m_best.front().first;
+    }
+
+    t_CKINT m_dim;
+    // the weight of each dimension
+    vector<t_CKFLOAT> m_weight;
+    // the tree being searched: nodes (the root is first), points in tree
+    // order, and their rows in the training data
+    const Node * m_nodes;
+    t_CKINT m_numNodes;
+    const T * m_points;
+    const int32_t * m_index;
+    t_CKINT m_numPoints;
+    // storage for a tree built here
+    vector<Node> m_nodeStore;
+    vector<T> m_pointStore;
+    vector<int32_t> m_indexStore;
+    // search state
+    vector<t_CKFLOAT> m_query;
+    vector<t_CKFLOAT> m_offset;
+    vector<std::pair<t_CKFLOAT, t_CKINT> > m_best;
+    t_CKINT m_k;
+    t_CKFLOAT m_worst;
+    t_CKFLOAT m_bound;
+};
+
 //-----------------------------------------------------------------------------
 // name: struct KNN_Object
 // desc: k-nearest neighbor implementation | added 1.4.2.0 (yikai)
@@ -1481,11 +2072,14 @@ public:
         X = NULL;
         Y = NULL;
         weights = NULL;
+        trainer = NULL;
+        epsilon = 0;
     }
 
     // destructor
     ~KNN_Object()
     {
+        CK_SAFE_DELETE( trainer );
         clear();
     }
 
@@ -1495,6 +2089,7 @@ public:
         CK_SAFE_DELETE( X );
         CK_SAFE_DELETE( Y );
         CK_SAFE_DELETE( weights );
+        index.clear();
     }
 
     // train
@@ -1524,6 +2119,8 @@ public:
         {
             weights->v( i ) = 1.0;
         }
+        // index
+        reindex();
         return 0;
     }
 
@@ -1547,11 +2144,23 @@ public:
         {
             weights->v( i ) = 1.0;
         }
+        // index
+        reindex();
         return;
     }
 
     // train
     t_CKINT train( Chuck_ArrayInt & x_, Chuck_ArrayInt & y_ )
+    {
+        // this replaces whatever trainAsync() was doing
+        if( trainer ) trainer->cancel();
+        copy( x_, y_ );
+        reindex();
+        return 0;
+    }
+
+    // copy training data, with labels
+    void copy( Chuck_ArrayInt & x_, Chuck_ArrayInt & y_ )
     {
         clear();
         // init
@@ -1579,11 +2188,34 @@ public:
         {
             weights->v( i ) = 1.0;
         }
-        return 0;
+    }
+
+    // (re)build the search index; with a negative weight, searches fall
+    // back to scanning all the points
+    void reindex()
+    {
+        index.clear();
+        if( X == NULL ) return;
+        for( t_CKINT j = 0; j < weights->size(); j++ )
+            if( weights->v( j ) < 0 ) return;
+        index.build( *X, *weights );
+    }
+
+    // set the approximation for searches (0 for exact)
+    void approximate( t_CKFLOAT epsilon_ )
+    {
+        epsilon = epsilon_ > 0 ? epsilon_ : 0;
+    }
+
+    // get the approximation for searches
+    t_CKFLOAT approximate()
+    {
+        return epsilon;
     }
 
     void getNearestNeighbors( const vector<t_CKFLOAT> & query, t_CKINT k, ChaiVectorFast<t_CKINT> & indices )
     {
+        sync();
         // check query dimension against training dimensions
         if( query.size() < X->yDim() )
         {
@@ -1592,6 +2224,14 @@ public:
                        query.size(), X->yDim() );
         }
 
+        // search the index
+        if( index.ready() )
+        {
+            index.search( query.data(), query.size(), k, epsilon, indices.m_vector );
+            return;
+        }
+
+        // otherwise (negative weights), scan all the points
         // allocate
         ChaiVectorFast<t_CKFLOAT> top_distances( k );
         ChaiVectorFast<t_CKINT> top_indices( k );
@@ -1605,12 +2245,13 @@ public:
         t_CKFLOAT distance, diff;
         for( t_CKINT i = 0; i < X->xDim(); i++ )
         {
+            const t_CKFLOAT * x = X->row( i );
             distance = 0.0;
             for( t_CKINT j = 0; j < X->yDim(); j++ )
             {
                 // extra check in case query less than training dimensions
-                diff = ( j < query.size() ? query[j] : 0.0 ) - X->v( i, j );
-                distance += diff * diff * weights->v( j );
+                diff = ( j < query.size() ? query[j] : 0.0 ) - x[j];
+                distance += diff * diff * weights->m_vector[j];
             }
             // check
             for( t_CKINT j = 0; j < k; j++ )
@@ -1786,6 +2427,7 @@ public:
     // weigh
     void weigh( const vector<t_CKFLOAT> & weights_ )
     {
+        sync();
         // sanity check
         if( X == NULL )
         {
@@ -1803,12 +2445,46 @@ public:
         {
             weights->v( i ) = weights_[i];
         }
+        // the index depends on the weights
+        reindex();
+    }
+
+    // train on a worker thread; the model in use is replaced when done
+    Chuck_Event * train_async( Chuck_VM * vm, Chuck_ArrayInt & x_, Chuck_ArrayInt & y_ )
+    {
+        if( !trainer ) trainer = new ChaiTrainer<KNN_Object>( vm );
+        // snapshot the data, and index it on the worker
+        KNN_Object * knn = new KNN_Object();
+        knn->copy( x_, y_ );
+        return trainer->start( [knn]( const std::atomic<bool> & stop )
+        {
+            knn->reindex();
+            return knn;
+        } );
+    }
+
+    // adopt the model from train_async(), if it is ready
+    void sync()
+    {
+        KNN_Object * trained = trainer ? trainer->take() : NULL;
+        if( !trained ) return;
+        std::swap( X, trained->X );
+        std::swap( Y, trained->Y );
+        std::swap( weights, trained->weights );
+        std::swap( index, trained->index );
+        CK_SAFE_DELETE( trained );
     }
 
 private:
     ChaiMatrixFast<t_CKFLOAT> * X;
     ChaiVectorFast<t_CKUINT> * Y;
     ChaiVectorFast<t_CKFLOAT> * weights;
+    // search index over X (weighted)
+    KNN_Index<t_CKFLOAT> index;
+    // approximation for searches
+    t_CKFLOAT epsilon;
+    // for train_async()
+    ChaiTrainer<KNN_Object> * trainer;
 };
 
 
@@ -1900,6 +2576,26 @@ CK_DLL_MFUN( KNN_weigh )
     knn->weigh( weights->m_vector );
 }
 
+CK_DLL_MFUN( KNN_approximate_set )
+{
+    // get object
+    KNN_Object * knn = (KNN_Object *)OBJ_MEMBER_UINT( SELF, KNN_offset_data );
+    // get args
+    t_CKFLOAT epsilon = GET_NEXT_FLOAT( ARGS );
+    // set
+    knn->approximate( epsilon );
+    // return
+    RETURN->v_float = knn->approximate();
+}
+
+CK_DLL_MFUN( KNN_approximate_get )
+{
+    // get object
+    KNN_Object * knn = (KNN_Object *)OBJ_MEMBER_UINT( SELF, KNN_offset_data );
+    // return
+    RETURN->v_float = knn->approximate();
+}
+
 
 
 
@@ -1938,6 +2634,26 @@ CK_DLL_MFUN( KNN2_train )
     knn->train( *x, *y );
 }
 
+CK_DLL_MFUN( KNN2_train_async )
+{
+    // get object
+    KNN_Object * knn = (KNN_Object *)OBJ_MEMBER_UINT( SELF, KNN2_offset_data );
+    // get args
+    Chuck_ArrayInt * x = (Chuck_ArrayInt *)GET_NEXT_OBJECT( ARGS );
+    Chuck_ArrayInt * y = (Chuck_ArrayInt *)GET_NEXT_OBJECT( ARGS );
+
+    // check for NULL
+    if( x == NULL || y == NULL )
+    {
+        EM_error3( "KNN2.trainAsync(): NULL input encountered..." );
+        RETURN->v_object = NULL;
+        return;
+    }
+
+    // train in the background
+    RETURN->v_object = knn->train_async( VM, *x, *y );
+}
+
 CK_DLL_MFUN( KNN2_predict )
 {
     // get object
@@ -2031,6 +2747,26 @@ CK_DLL_MFUN( KNN2_weigh )
     knn->weigh( weights->m_vector );
 }
 
+CK_DLL_MFUN( KNN2_approximate_set )
+{
+    // get object
+    KNN_Object * knn = (KNN_Object *)OBJ_MEMBER_UINT( SELF, KNN2_offset_data );
+    // get args
+    t_CKFLOAT epsilon = GET_NEXT_FLOAT( ARGS );
+    // set
+    knn->approximate( epsilon );
+    // return
+    RETURN->v_float = knn->approximate();
+}
+
+CK_DLL_MFUN( KNN2_approximate_get )
+{
+    // get object
+    KNN_Object * knn = (KNN_Object *)OBJ_MEMBER_UINT( SELF, KNN2_offset_data );
+    // return
+    RETURN->v_float = knn->approximate();
+}
+
 //-----------------------------------------------------------------------------
 // name: struct HMM_Object
 // desc: hidden markov model implementation | added 1.4.2.0 (yikai)
@@ -2349,9 +3085,73 @@ CK_DLL_MFUN( HMM_generate )
     hmm->generate( length, *output );
 }
 
+//-----------------------------------------------------------------------------
+// name: struct W2V_BinaryHeader
+// desc: header of a binary Word2Vec model (see Word2Vec.convert()); the
+//       file holds a hash index of the words, the min/max of each dimension,
+//       and the vectors as 32-bit floats, laid out as a KNN_Index tree, so it
+//       can be memory-mapped and searched in place; each section starts at
+//       the given byte offset from the start of the file (8-byte aligned)
+//-----------------------------------------------------------------------------
+struct W2V_BinaryHeader
+{
+    // W2V_BINARY_MAGIC
+    char magic[8];
+    // W2V_BINARY_VERSION
+    uint32_t version;
+    // W2V_BINARY_ENDIAN, as written (models are not byte-swapped)
+    uint32_t endian;
+    // number of words, and dimensions
+    uint64_t size;
+    uint64_t dim;
+    // number of hash slots (a power of 2), and of tree nodes
+    uint64_t numSlots;
+    uint64_t numNodes;
+    // char[wordsBytes]: the words, each NUL-terminated
+    uint64_t words;
+    uint64_t wordsBytes;
+    // uint64_t[size]: where each word starts in 'words'
+    uint64_t wordOffsets;
+    // uint32_t[numSlots]: word index + 1, or 0 for an empty slot
+    uint64_t slots;
+    // double[dim]: minimum and maximum of each dimension
+    uint64_t mins;
+    uint64_t maxs;
+    // KNN_Index<float>::Node[numNodes]: the tree, root first
+    uint64_t nodes;
+    // float[size*dim]: the vectors, in tree order
+    uint64_t points;
+    // int32_t[size]: word index of each point
+    uint64_t order;
+    // int32_t[size]: point of each word index
+    uint64_t rows;
+};
+
+#define W2V_BINARY_MAGIC    "CKW2VBIN"
+#define W2V_BINARY_VERSION  1
+#define W2V_BINARY_ENDIAN   0x01020304
+
+//-----------------------------------------------------------------------------
+// name: w2v_hash()
+// desc: FNV-1a hash of a word, for the binary model's word index
+//-----------------------------------------------------------------------------
+static uint64_t w2v_hash( const char * word )
+{
+    uint64_t h = 14695981039346656037ULL;
+    for( ; *word; word++ )
+    {
+        h ^= (unsigned char)*word;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
 //-----------------------------------------------------------------------------
 // name: struct W2V_Dictionary
 // desc: struct for caching Word2Vec | added 1.5.0.0 (ge)
+//       a dictionary is either parsed from a text model, or memory-mapped
+//       from a binary model, in which case it is read-only, and its pages
+//       are shared with any other process (e.g., chuck~ instance) using it
 //-----------------------------------------------------------------------------
 struct W2V_Dictionary
 {
@@ -2363,6 +3163,17 @@ struct W2V_Dictionary
     // bounds for each dimension
     ChaiVectorFast<t_CKFLOAT> mins;
     ChaiVectorFast<t_CKFLOAT> maxs;
+    // binary model: the mapped file, and its sections
+    void * mapped;
+    size_t mappedSize;
+    const W2V_BinaryHeader * header;
+    const char * words;
+    const uint64_t * wordOffsets;
+    const uint32_t * slots;
+    const KNN_Index<float>::Node * nodes;
+    const float * points;
+    const int32_t * order;
+    const int32_t * rows;
 
     W2V_Dictionary()
       : dictionarySize( 0 ),
@@ -2370,9 +3181,24 @@ struct W2V_Dictionary
         key_to_index( NULL ),
         index_to_key( NULL ),
         word_vectors( NULL ),
-        tree( NULL )
+        tree( NULL ),
+        mapped( NULL ),
+        mappedSize( 0 ),
+        header( NULL ),
+        words( NULL ),
+        wordOffsets( NULL ),
+        slots( NULL ),
+        nodes( NULL ),
+        points( NULL ),
+        order( NULL ),
+        rows( NULL )
     { }
 
+    ~W2V_Dictionary()
+    {
+        clear();
+    }
+
     // clear
     void clear()
     {
@@ -2381,7 +3207,279 @@ struct W2V_Dictionary
         CK_SAFE_DELETE( key_to_index );
         CK_SAFE_DELETE( index_to_key );
         CK_SAFE_DELETE( word_vectors );
-        kdtree_destroy( tree );
+        if( tree != NULL ) kdtree_destroy( tree );
+        tree = NULL;
+        ck_unmapfile( mapped, mappedSize );
+        mapped = NULL;
+        mappedSize = 0;
+        header = NULL;
+    }
+
+    // is this a memory-mapped binary model?
+    t_CKBOOL isBinary() const
+    {
+        return mapped != NULL;
+    }
+
+    // index of a word, or -1 if not in the dictionary
+    t_CKINT find( const string & word ) const
+    {
+        // binary: probe the hash index
+        if( isBinary() )
+        {
+            uint64_t mask = header->numSlots - 1;
+            for( uint64_t s = w2v_hash( word.c_str() ) & mask; slots[s] != 0; s = ( s + 1 ) & mask )
+            {
+                t_CKINT i = slots[s] - 1;
+                if( word == words + wordOffsets[i] ) return i;
+            }
+            return -1;
+        }
+        // text
+        std::map<string, t_CKUINT>::const_iterator it = key_to_index->find( word );
+        return it != key_to_index->end() ? (t_CKINT)it->second : -1;
+    }
+
+    // word at an index
+    string word( t_CKINT i ) const
+    {
+        return isBinary() ? string( words + wordOffsets[i] ) : index_to_key->v( i );
+    }
+
+    // copy the vector at an index
+    void getVector( t_CKINT i, t_CKFLOAT * vector ) const
+    {
+        if( isBinary() )
+        {
+            const float * p = points + rows[i] * vectorLength;
+            for( t_CKINT j = 0; j < vectorLength; j++ ) vector[j] = p[j];
+        }
+        else if( tree != NULL )
+        {
+            for( t_CKINT j = 0; j < vectorLength; j++ ) vector[j] = tree->coord_table[i][j];
+        }
+        else
+        {
+            for( t_CKINT j = 0; j < vectorLength; j++ ) vector[j] = word_vectors->v( i, j );
+        }
+    }
+
+    // does this file start like a binary model?
+    static t_CKBOOL isBinaryFile( const string & path )
+    {
+        char magic[8];
+        FILE * file = fopen( path.c_str(), "rb" );
+        if( file == NULL ) return FALSE;
+        t_CKBOOL yes = fread( magic, 1, 8, file ) == 8 && memcmp( magic, W2V_BINARY_MAGIC, 8 ) == 0;
+        fclose( file );
+        return yes;
+    }
+
+    // memory-map a binary model
+    t_CKBOOL map( const string & path )
+    {
+        clear();
+        // map the file
+        mapped = ck_mapfile( path, &mappedSize );
+        if( mapped == NULL )
+        {
+            EM_error3( "Word2Vec: cannot map model file: %s", path.c_str() );
+            return FALSE;
+        }
+        // check everything the searches rely on, since the file could be
+        // anything, and save() only ever produces valid ones
+        if( !check() )
+        {
+            EM_error3( "Word2Vec: invalid or incompatible binary model: %s", path.c_str() );
+            clear();
+            return FALSE;
+        }
+        const char * base = (const char *)mapped;
+        dictionarySize = (t_CKINT)header->size;
+        vectorLength = (t_CKINT)header->dim;
+        words = base + header->words;
+        wordOffsets = (const uint64_t *)( base + header->wordOffsets );
+        slots = (const uint32_t *)( base + header->slots );
+        nodes = (const KNN_Index<float>::Node *)( base + header->nodes );
+        points = (const float *)( base + header->points );
+        order = (const int32_t *)( base + header->order );
+        rows = (const int32_t *)( base + header->rows );
+        // copy the bounds
+        mins.allocate( vectorLength );
+        maxs.allocate( vectorLength );
+        memcpy( mins.m_vector, base + header->mins, vectorLength * sizeof(double) );
+        memcpy( maxs.m_vector, base + header->maxs, vectorLength * sizeof(double) );
+        return TRUE;
+    }
+
+    // write a (text) model as a binary model; written to a temporary file
+    // next to it, then moved over 'path', so a model already mapped from
+    // 'path' keeps its (old) contents
+    t_CKBOOL save( const string & path ) const
+    {
+        // need the vectors as a matrix (parsed without a kdtree)
+        if( word_vectors == NULL || isBinary() || dictionarySize == 0 || dictionarySize > INT32_MAX )
+            return FALSE;
+
+        t_CKINT n = dictionarySize, dim = vectorLength;
+        // build the tree over the vectors, as floats
+        KNN_Index<float> index;
+        ChaiVectorFast<t_CKFLOAT> ones( dim );
+        for( t_CKINT j = 0; j < dim; j++ ) ones[j] = 1;
+        index.build( *word_vectors, ones );
+        // bounds, of the vectors as stored
+        vector<double> lo( dim, DBL_MAX ), hi( dim, -DBL_MAX );
+        for( t_CKINT i = 0; i < n * dim; i++ )
+        {
+            double v = index.points()[i];
+            if( v < lo[i % dim] ) lo[i % dim] = v;
+            if( v > hi[i % dim] ) hi[i % dim] = v;
+        }
+        // point of each word
+        vector<int32_t> rowOf( n );
+        for( t_CKINT p = 0; p < n; p++ ) rowOf[index.index()[p]] = (int32_t)p;
+        // the words, and their offsets
+        string pool;
+        vector<uint64_t> offsets( n );
+        for( t_CKINT i = 0; i < n; i++ )
+        {
+            offsets[i] = pool.size();
+            pool += index_to_key->v( i );
+            pool += '\0';
+        }
+        // hash index, at most half full; a repeated word maps to its last
+        // occurrence, same as the text dictionary
+        uint64_t numSlots = 16;
+        while( numSlots < 2 * (uint64_t)n ) numSlots *= 2;
+        vector<uint32_t> table( numSlots, 0 );
+        for( t_CKINT i = 0; i < n; i++ )
+        {
+            uint64_t s = w2v_hash( pool.c_str() + offsets[i] ) & ( numSlots - 1 );
+            while( table[s] != 0 && index_to_key->v( table[s] - 1 ) != index_to_key->v( i ) )
+                s = ( s + 1 ) & ( numSlots - 1 );
+            table[s] = (uint32_t)( i + 1 );
+        }
+
+        // lay out the sections
+        W2V_BinaryHeader h;
+        memset( &h, 0, sizeof(h) );
+        memcpy( h.magic, W2V_BINARY_MAGIC, 8 );
+        h.version = W2V_BINARY_VERSION;
+        h.endian = W2V_BINARY_ENDIAN;
+        h.size = n;
+        h.dim = dim;
+        h.numSlots = numSlots;
+        h.numNodes = index.numNodes();
+        uint64_t at = sizeof(h);
+        h.words = align( at ); at = h.words + pool.size();
+        h.wordsBytes = pool.size();
+        h.wordOffsets = align( at ); at = h.wordOffsets + n * sizeof(uint64_t);
+        h.slots = align( at ); at = h.slots + numSlots * sizeof(uint32_t);
+        h.mins = align( at ); at = h.mins + dim * sizeof(double);
+        h.maxs = align( at ); at = h.maxs + dim * sizeof(double);
+        h.nodes = align( at ); at = h.nodes + h.numNodes * sizeof(KNN_Index<float>::Node);
+        h.points = align( at ); at = h.points + n * dim * sizeof(float);
+        h.order = align( at ); at = h.order + n * sizeof(int32_t);
+        h.rows = align( at );
+
+        // write
+        string temp = path + ".tmp";
+        FILE * file = fopen( temp.c_str(), "wb" );
+        if( file == NULL ) return FALSE;
+        at = 0;
+        t_CKBOOL ok = write( file, at, 0, &h, sizeof(h) )
+            && write( file, at, h.words, pool.data(), pool.size() )
+            && write( file, at, h.wordOffsets, &offsets[0], n * sizeof(uint64_t) )
+            && write( file, at, h.slots, &table[0], numSlots * sizeof(uint32_t) )
+            && write( file, at, h.mins, &lo[0], dim * sizeof(double) )
+            && write( file, at, h.maxs, &hi[0], dim * sizeof(double) )
+            && write( file, at, h.nodes, index.nodes(), h.numNodes * sizeof(KNN_Index<float>::Node) )
+            && write( file, at, h.points, index.points(), n * dim * sizeof(float) )
+            && write( file, at, h.order, index.index(), n * sizeof(int32_t) )
+            && write( file, at, h.rows, &rowOf[0], n * sizeof(int32_t) );
+        if( fclose( file ) != 0 ) ok = FALSE;
+        // replace
+        if( ok ) ok = ck_replacefile( temp, path );
+        if( !ok ) remove( temp.c_str() );
+        return ok;
+    }
+
+protected:
+    // round up to the next section boundary
+    static uint64_t align( uint64_t offset )
+    {
+        return ( offset + 7 ) & ~(uint64_t)7;
+    }
+
+    // write bytes at an offset, zero-padding up to it from 'at' (where the
+    // file is now), and advance 'at'
+    static t_CKBOOL write( FILE * file, uint64_t & at, uint64_t offset, const void * data, size_t bytes )
+    {
+        for( ; at < offset; at++ )
+            if( fputc( 0, file ) == EOF ) return FALSE;
+        at += bytes;
+        return fwrite( data, 1, bytes, file ) == bytes;
+    }
+
+    // does a section fit in the file?
+    t_CKBOOL fits( uint64_t offset, uint64_t count, uint64_t size ) const
+    {
+        return offset % 8 == 0 && offset <= mappedSize && ( size == 0 || count <= ( mappedSize - offset ) / size );
+    }
+
+    // check a mapped binary model
+    t_CKBOOL check()
+    {
+        header = (const W2V_BinaryHeader *)mapped;
+        const W2V_BinaryHeader & h = *header;
+        if( mappedSize < sizeof(h) || memcmp( h.magic, W2V_BINARY_MAGIC, 8 ) != 0
+            || h.version != W2V_BINARY_VERSION || h.endian != W2V_BINARY_ENDIAN )
+            return FALSE;
+        // sizes
+        uint64_t n = h.size, dim = h.dim;
+        if( n == 0 || n > INT32_MAX || dim == 0 || dim > INT32_MAX || h.numSlots < n
+            || ( h.numSlots & ( h.numSlots - 1 ) ) != 0 || h.numNodes == 0 || h.numNodes > INT32_MAX
+            || h.wordsBytes == 0 || n > ( UINT64_MAX / sizeof(float) ) / dim )
+            return FALSE;
+        // sections
+        if( !fits( h.words, h.wordsBytes, 1 ) || !fits( h.wordOffsets, n, sizeof(uint64_t) )
+            || !fits( h.slots, h.numSlots, sizeof(uint32_t) ) || !fits( h.mins, dim, sizeof(double) )
+            || !fits( h.maxs, dim, sizeof(double) ) || !fits( h.nodes, h.numNodes, sizeof(KNN_Index<float>::Node) )
+            || !fits( h.points, n * dim, sizeof(float) ) || !fits( h.order, n, sizeof(int32_t) )
+            || !fits( h.rows, n, sizeof(int32_t) ) )
+            return FALSE;
+        // contents: every index stays in range
+        const char * base = (const char *)mapped;
+        const char * w = base + h.words;
+        if( w[h.wordsBytes - 1] != '\0' ) return FALSE;
+        const uint64_t * offsets = (const uint64_t *)( base + h.wordOffsets );
+        const int32_t * o = (const int32_t *)( base + h.order );
+        const int32_t * r = (const int32_t *)( base + h.rows );
+        for( uint64_t i = 0; i < n; i++ )
+            if( offsets[i] >= h.wordsBytes || o[i] < 0 || (uint64_t)o[i] >= n || r[i] < 0 || (uint64_t)r[i] >= n )
+                return FALSE;
+        const uint32_t * s = (const uint32_t *)( base + h.slots );
+        uint64_t empty = 0;
+        for( uint64_t i = 0; i < h.numSlots; i++ )
+        {
+            if( s[i] > n ) return FALSE;
+            if( s[i] == 0 ) empty++;
+        }
+        // (probing stops at an empty slot)
+        if( empty == 0 ) return FALSE;
+        const KNN_Index<float>::Node * nd = (const KNN_Index<float>::Node *)( base + h.nodes );
+        for( uint64_t i = 0; i < h.numNodes; i++ )
+        {
+            if( nd[i].dim < 0 )
+            {
+                if( nd[i].left < 0 || nd[i].left > nd[i].right || (uint64_t)nd[i].right > n ) return FALSE;
+            }
+            // children come after their parent, so the tree has no cycles
+            else if( (uint64_t)nd[i].dim >= dim || nd[i].left <= (int64_t)i || (uint64_t)nd[i].left >= h.numNodes
+                     || nd[i].right <= (int64_t)i || (uint64_t)nd[i].right >= h.numNodes )
+                return FALSE;
+        }
+        return TRUE;
     }
 };
 
@@ -2400,11 +3498,14 @@ private:
     W2V_Dictionary * dictionary;
     // line number for parsing error reporting
     t_CKINT m_lineNum;
+    // search over a binary model's tree (or every point, if not using it)
+    KNN_Index<float> m_index;
+    t_CKBOOL m_useIndex;
 
 public:
     // constructor
     Word2Vec_Object()
-        : dictionary( NULL ), m_lineNum( 0 )
+        : dictionary( NULL ), m_lineNum( 0 ), m_useIndex( FALSE )
     { }
 
     // destructor
@@ -2420,6 +3521,9 @@ public:
         dictionary = NULL;
         // zero out line number
         m_lineNum = 0;
+        // detach from the tree
+        m_index.clear();
+        m_useIndex = FALSE;
     }
 
     // get dictionary size
@@ -2466,7 +3570,7 @@ public:
     // get dictionary dimensions
     t_CKBOOL getUseKDTree() const
     {
-        return dictionary != NULL ? dictionary->tree != NULL : 0;
+        return dictionary != NULL ? dictionary->tree != NULL || m_useIndex : 0;
     }
 
     // read next non-empty or commented line
@@ -2501,17 +3605,50 @@ public:
         {
             // retrieve from cache
             dictionary = o_cache[path.str()];
-            // done
-            return true;
+        }
+        // binary model: memory-map it
+        else if( W2V_Dictionary::isBinaryFile( path.str() ) )
+        {
+            // instantiate dictionary
+            dictionary = new W2V_Dictionary();
+            if( !dictionary->map( path.str() ) )
+            {
+                CK_SAFE_DELETE( dictionary );
+                return false;
+            }
+            // add to cache
+            o_cache[path.str()] = dictionary;
+        }
+        // text model: parse it
+        else
+        {
+            dictionary = loadText( path.str(), useKDTreeIfDimLEQtoThis );
+            if( dictionary == NULL ) return false;
+            // add to cache
+            o_cache[path.str()] = dictionary;
         }
 
+        // a binary model always has its tree; search it, or every point
+        if( dictionary->isBinary() )
+        {
+            m_index.attach( dictionary->vectorLength, dictionary->nodes, dictionary->header->numNodes,
+                            dictionary->points, dictionary->order, dictionary->dictionarySize );
+            m_useIndex = useKDTreeIfDimLEQtoThis < 0 || dictionary->vectorLength <= useKDTreeIfDimLEQtoThis;
+        }
+
+        return true;
+    }
+
+    // parse a text model; returns NULL on error
+    W2V_Dictionary * loadText( const string & path, t_CKINT useKDTreeIfDimLEQtoThis )
+    {
         // open file
-        std::ifstream fin( path.str() );
+        std::ifstream fin( path );
         if( !fin.is_open() )
-            return false;
+            return NULL;
 
         // instantiate dictionary
-        dictionary = new W2V_Dictionary();
+        W2V_Dictionary * dict = new W2V_Dictionary();
         // string to hold the line
         string line;
 
@@ -2519,41 +3656,43 @@ public:
         if( !nextline( fin, line, TRUE ) )
         {
             EM_error3( "Word2Vec: error parsing model on line: %d", m_lineNum );
-            return false;
+            CK_SAFE_DELETE( dict );
+            return NULL;
         }
 
         // string stream
         istringstream strin( line );
         // read header
-        strin >> dictionary->dictionarySize >> dictionary->vectorLength;
+        strin >> dict->dictionarySize >> dict->vectorLength;
 
         // allocate
-        dictionary->key_to_index = new std::map<std::string, t_CKUINT>();
-        dictionary->index_to_key = new ChaiVectorFast<std::string>( dictionary->dictionarySize );
-        dictionary->mins.allocate( dictionary->vectorLength );
-        dictionary->maxs.allocate( dictionary->vectorLength );
-        for( int i = 0; i < dictionary->vectorLength; i++ )
+        dict->key_to_index = new std::map<std::string, t_CKUINT>();
+        dict->index_to_key = new ChaiVectorFast<std::string>( dict->dictionarySize );
+        dict->mins.allocate( dict->vectorLength );
+        dict->maxs.allocate( dict->vectorLength );
+        for( int i = 0; i < dict->vectorLength; i++ )
         {
             // initialize
-            dictionary->mins.v( i ) = 1e10;
-            dictionary->maxs.v( i ) = -1e10;
+            dict->mins.v( i ) = 1e10;
+            dict->maxs.v( i ) = -1e10;
         }
 
         // check if using kdtree
-        if( useKDTreeIfDimLEQtoThis < 0 || dictionary->vectorLength <= useKDTreeIfDimLEQtoThis )
+        if( useKDTreeIfDimLEQtoThis < 0 || dict->vectorLength <= useKDTreeIfDimLEQtoThis )
         {
             // read vectors and build kd-tree
-            dictionary->tree = kdtree_init( dictionary->vectorLength );
+            dict->tree = kdtree_init( dict->vectorLength );
             std::string key;
             t_CKFLOAT value;
-            ChaiVectorFast<t_CKFLOAT> vector( dictionary->vectorLength );
-            for( t_CKINT i = 0; i < dictionary->dictionarySize; i++ )
+            ChaiVectorFast<t_CKFLOAT> vector( dict->vectorLength );
+            for( t_CKINT i = 0; i < dict->dictionarySize; i++ )
             {
                 // get next non-empty line
                 if( !nextline( fin, line, FALSE ) )
                 {
                     EM_error3( "Word2Vec: error parsing model on line: %d", m_lineNum );
-                    return false;
+                    CK_SAFE_DELETE( dict );
+                    return NULL;
                 }
                 // set into string stream
                 strin.str( line );
@@ -2561,55 +3700,56 @@ public:
 
                 // get the word
                 strin >> key;
-                dictionary->index_to_key->v( i ) = key;
-                ( *( dictionary->key_to_index ) )[key] = i;
-                for( t_CKINT j = 0; j < dictionary->vectorLength; j++ )
+                dict->index_to_key->v( i ) = key;
+                ( *( dict->key_to_index ) )[key] = i;
+                for( t_CKINT j = 0; j < dict->vectorLength; j++ )
                 {
                     strin >> value;
                     vector.v( j ) = value;
 
                     // find min/max
-                    if( value < dictionary->mins.v( j ) ) dictionary->mins.v( j ) = value;
-                    else if( value > dictionary->maxs.v( j ) ) dictionary->maxs.v( j ) = value;
+                    if( value < dict->mins.v( j ) ) dict->mins.v( j ) = value;
+                    else if( value > dict->maxs.v( j ) ) dict->maxs.v( j ) = value;
                 }
-                kdtree_insert( dictionary->tree, vector.m_vector );
+                kdtree_insert( dict->tree, vector.m_vector );
             }
 
             // rebuild kdtree
-            kdtree_rebuild( dictionary->tree );
+            kdtree_rebuild( dict->tree );
         }
         else
         {
             // allocate word vectors
-            dictionary->word_vectors =
-                new ChaiMatrixFast<t_CKFLOAT>( dictionary->dictionarySize, dictionary->vectorLength );
+            dict->word_vectors =
+                new ChaiMatrixFast<t_CKFLOAT>( dict->dictionarySize, dict->vectorLength );
 
             // read vectors
             std::string key;
             t_CKFLOAT value;
-            for( t_CKINT i = 0; i < dictionary->dictionarySize; i++ )
+            for( t_CKINT i = 0; i < dict->dictionarySize; i++ )
             {
                 // get next non-empty line
                 if( !nextline( fin, line, FALSE ) )
                 {
                     EM_error3( "Word2Vec: error parsing model on line: %d", m_lineNum );
-                    return false;
+                    CK_SAFE_DELETE( dict );
+                    return NULL;
                 }
                 // set into string stream
                 strin.str( line );
                 strin.clear();
 
                 strin >> key;
-                dictionary->index_to_key->v( i ) = key;
-                ( *( dictionary->key_to_index ) )[key] = i;
-                for( t_CKINT j = 0; j < dictionary->vectorLength; j++ )
+                dict->index_to_key->v( i ) = key;
+                ( *( dict->key_to_index ) )[key] = i;
+                for( t_CKINT j = 0; j < dict->vectorLength; j++ )
                 {
                     strin >> value;
-                    dictionary->word_vectors->v( i, j ) = value;
+                    dict->word_vectors->v( i, j ) = value;
 
                     // find min/max
-                    if( value < dictionary->mins.v( j ) ) dictionary->mins.v( j ) = value;
-                    else if( value > dictionary->maxs.v( j ) ) dictionary->maxs.v( j ) = value;
+                    if( value < dict->mins.v( j ) ) dict->mins.v( j ) = value;
+                    else if( value > dict->maxs.v( j ) ) dict->maxs.v( j ) = value;
                 }
             }
         }
@@ -2617,10 +3757,35 @@ public:
         // close file
         fin.close();
 
-        // add to cache
-        o_cache[path.str()] = dictionary;
+        return dict;
+    }
 
-        return true;
+    // convert a text model to a binary model, which loads by memory-mapping
+    static t_CKBOOL convert( const string & from, const string & to )
+    {
+        // check
+        if( W2V_Dictionary::isBinaryFile( from ) )
+        {
+            EM_error3( "Word2Vec.convert(): already a binary model: %s", from.c_str() );
+            return FALSE;
+        }
+        // parse the text model (without a kdtree, and not cached)
+        Word2Vec_Object w2v;
+        W2V_Dictionary * dict = w2v.loadText( from, 0 );
+        if( dict == NULL )
+        {
+            EM_error3( "Word2Vec.convert(): cannot load text model: %s", from.c_str() );
+            return FALSE;
+        }
+        // write it
+        t_CKBOOL ok = dict->save( to );
+        if( !ok ) EM_error3( "Word2Vec.convert(): cannot write binary model: %s", to.c_str() );
+        // a later load() of 'to' reads the new model; objects that loaded
+        // the old one keep it (still mapped), so it isn't deleted here
+        else o_cache.erase( to );
+        // done with it
+        CK_SAFE_DELETE( dict );
+        return ok;
     }
 
     // get nearest neighbors (brute force)
@@ -2693,6 +3858,14 @@ public:
             return;
         }
 
+        // binary model: search its tree, or every point
+        if( dictionary->isBinary() )
+        {
+            if( m_useIndex ) m_index.search( vector.m_vector, vector.length(), topn, 0, indices.m_vector );
+            else m_index.scan( vector.m_vector, vector.length(), topn, indices.m_vector );
+            return;
+        }
+
         // check if using kdtree
         if( dictionary->tree != NULL ) return getNearestNeighborsKDTree( vector, topn, indices );
         else return getNearestNeighborsBF( vector, topn, indices );
@@ -2726,41 +3899,21 @@ public:
             hasError = TRUE;
         }
 
-        // see if word is there
-        if( !contains( word ) )
+        // get index; see if word is there
+        t_CKINT index = dictionary->find( word );
+        if( index < 0 )
         { return false; }
 
-        // get index
-        t_CKINT index = ( *( dictionary->key_to_index ) )[word];
         // get vector
         ChaiVectorFast<t_CKFLOAT> vector( dictionary->vectorLength );
-
-        // use tree?
-        if( dictionary->tree != NULL )
-        {
-            for( t_CKINT i = 0; i < dictionary->vectorLength; i++ )
-                vector.v( i ) = dictionary->tree->coord_table[index][i];
-            // get nearest neighbors
-            ChaiVectorFast<t_CKINT> top_indices( topn );
-            getNearestNeighbors( vector, topn, top_indices );
-            // copy
-            for( t_CKINT i = 0; i < topn; i++ )
-            {
-                ( (Chuck_String *)output_.m_vector[i] )->set( dictionary->index_to_key->v( top_indices.v( i ) ) );
-            }
-        }
-        else
+        dictionary->getVector( index, vector.m_vector );
+        // get nearest neighbors
+        ChaiVectorFast<t_CKINT> top_indices( topn );
+        getNearestNeighbors( vector, topn, top_indices );
+        // copy
+        for( t_CKINT i = 0; i < topn; i++ )
         {
-            for( t_CKINT i = 0; i < dictionary->vectorLength; i++ )
-                vector.v( i ) = dictionary->word_vectors->v( index, i );
-            // get nearest neighbors
-            ChaiVectorFast<t_CKINT> top_indices( topn );
-            getNearestNeighbors( vector, topn, top_indices );
-            // copy
-            for( t_CKINT i = 0; i < topn; i++ )
-            {
-                ( (Chuck_String *)output_.m_vector[i] )->set( dictionary->index_to_key->v( top_indices.v( i ) ) );
-            }
+            ( (Chuck_String *)output_.m_vector[i] )->set( dictionary->word( top_indices.v( i ) ) );
         }
 
         return !hasError;
@@ -2804,7 +3957,7 @@ public:
         // copy
         for( t_CKINT i = 0; i < topn; i++ )
         {
-            ( (Chuck_String *)output_.m_vector[i] )->set( dictionary->index_to_key->v( top_indices.v( i ) ) );
+            ( (Chuck_String *)output_.m_vector[i] )->set( dictionary->word( top_indices.v( i ) ) );
         }
 
         return !hasError;
@@ -2814,8 +3967,7 @@ public:
     t_CKBOOL contains( const string & word )
     {
         // see if word is there
-        std::map<string, t_CKUINT> & key2index = *( dictionary->key_to_index );
-        return key2index.find( word ) != key2index.end();
+        return dictionary != NULL && dictionary->find( word ) >= 0;
     }
 
     // getVector
@@ -2833,31 +3985,13 @@ public:
         { output_.set_size( dictionary->vectorLength ); }
         // zero out
         output_.zero( 0, output_.size() );
-        // see if word is there
-        if( !contains( word ) )
+        // get index; see if word is there
+        t_CKINT index = dictionary->find( word );
+        if( index < 0 )
         { return false; }
 
-        // get index
-        std::map<string, t_CKUINT> & key2index = *( dictionary->key_to_index );
-        t_CKINT index = key2index[word];
-
-        // whether we are using
-        if( dictionary->tree != NULL )
-        {
-            // copy
-            for( t_CKINT i = 0; i < dictionary->vectorLength; i++ )
-            {
-                output_.m_vector[i] = dictionary->tree->coord_table[index][i];
-            }
-        }
-        else
-        {
-            // copy
-            for( t_CKINT i = 0; i < dictionary->vectorLength; i++ )
-            {
-                output_.m_vector[i] = dictionary->word_vectors->v( index, i );
-            }
-        }
+        // copy
+        dictionary->getVector( index, &output_.m_vector[0] );
 
         // done
         return true;
@@ -2907,6 +4041,23 @@ CK_DLL_MFUN( Word2Vec_load2 )
     RETURN->v_int = word2vec->load( *path, useKDTreeDim );
 }
 
+CK_DLL_SFUN( Word2Vec_convert )
+{
+    // get args
+    Chuck_String * textPath = GET_NEXT_STRING( ARGS );
+    Chuck_String * binaryPath = GET_NEXT_STRING( ARGS );
+
+    // check for NULL
+    if( textPath == NULL || binaryPath == NULL )
+    {
+        RETURN->v_int = FALSE;
+        return;
+    }
+
+    // convert
+    RETURN->v_int = Word2Vec_Object::convert( textPath->str(), binaryPath->str() );
+}
+
 CK_DLL_MFUN( Word2Vec_getMostSimilarByWord )
 {
     // get object
@@ -3203,13 +4354,15 @@ public:
         ChaiMatrixFast<t_CKFLOAT> * output = chuck2chai( output_ );
 
         t_CKINT t, o;
-        t_CKINT o1, o2;
+        t_CKINT o1;
         t_CKINT n = input->xDim(), d = input->yDim(), dd = output->yDim();
 
         // Check output dimension
         if( npc > dd )
         {
             EM_error3( "PCA: number of principal components %d exceeds output dimension %d", npc, dd );
+            CK_SAFE_DELETE( input );
+            CK_SAFE_DELETE( output );
             return;
         }
 
@@ -3248,17 +4401,7 @@ public:
 
         ChaiMatrixFast<t_CKFLOAT> corr_matrix( d, d );
         // Calculate the correlation matrix
-        for( o1 = 0; o1 < d; o1++ )
-        {
-            corr_matrix( o1, o1 ) = 1.0;
-            for( o2 = o1; o2 < d; o2++ )
-            {
-                corr_matrix( o1, o2 ) = 0.0;
-                for( t = 0; t < n; t++ )
-                    corr_matrix( o1, o2 ) += temp_matrix( o1, t ) * temp_matrix( o2, t );
-                corr_matrix( o2, o1 ) = corr_matrix( o1, o2 );
-            }
-        }
+        chai_gemm_nt( temp_matrix.data(), temp_matrix.data(), corr_matrix.data(), d, d, n );
         corr_matrix( d - 1, d - 1 ) = 1.0;
 
         ChaiVectorFast<t_CKFLOAT> evals( d );
@@ -3286,20 +4429,24 @@ public:
            corr_matrix now contains the associated eigenvectors. */
 
         /* Project row data onto the top "npc_" principal components. */
+        // components as rows, in order of decreasing eigenvalue
+        ChaiMatrixFast<t_CKFLOAT> components( npc, d );
+        for( o = 0; o < npc; o++ )
+            for( o1 = 0; o1 < d; o1++ )
+                components( o, o1 ) = corr_matrix( o1, d - 1 - o );
+        ChaiMatrixFast<t_CKFLOAT> projected( n, npc );
+        chai_gemm_nt( input->data(), components.data(), projected.data(), n, npc, d );
         Chuck_ArrayFloat * vi;
         for( t = 0; t < n; t++ )
         {
             vi = (Chuck_ArrayFloat *)output_.m_vector[t];
             for( o = 0; o < npc; o++ )
-            {
-                vi->m_vector[o] = 0.0;
-                for( o1 = 0; o1 < d; o1++ )
-                    vi->m_vector[o] += input->v( t, o1 ) * corr_matrix( o1, d - 1 - o );
-            }
+                vi->m_vector[o] = projected( t, o );
         }
 
         // clean up
         CK_SAFE_DELETE( input );
+        CK_SAFE_DELETE( output );
     }
 
 private:
@@ -3344,27 +4491,32 @@ private:
     vector<ChaiVectorFast<t_CKFLOAT> *> biases;
     vector<ChaiVectorFast<t_CKFLOAT> *> activations;
     vector<ChaiVectorFast<t_CKFLOAT> *> gradients;
+    // for train_async()
+    ChaiTrainer<MLP_Object> * trainer;
 public:
     // constructor
     MLP_Object()
-    { }
+    {
+        trainer = NULL;
+    }
 
     // destructor
     ~MLP_Object()
     {
+        CK_SAFE_DELETE( trainer );
         clear();
     }
 
     // clear
     void clear()
     {
-        for( t_CKINT i = 0; i < weights.size(); i++ )
+        for( t_CKUINT i = 0; i < weights.size(); i++ )
             CK_SAFE_DELETE( weights[i] );
-        for( t_CKINT i = 0; i < biases.size(); i++ )
+        for( t_CKUINT i = 0; i < biases.size(); i++ )
             CK_SAFE_DELETE( biases[i] );
-        for( t_CKINT i = 0; i < activations.size(); i++ )
+        for( t_CKUINT i = 0; i < activations.size(); i++ )
             CK_SAFE_DELETE( activations[i] );
-        for( t_CKINT i = 0; i < gradients.size(); i++ )
+        for( t_CKUINT i = 0; i < gradients.size(); i++ )
             CK_SAFE_DELETE( gradients[i] );
         units_per_layer.clear();
         activation_per_layer.clear();
@@ -3377,6 +4529,8 @@ public:
     // init
     bool init( const vector<t_CKUINT> & units_per_layer_ )
     {
+        // this replaces whatever trainAsync() was doing
+        if( trainer ) trainer->cancel();
         // clear
         clear();
 
@@ -3407,11 +4561,11 @@ public:
         activation_per_layer.back() = g_at_linear;
 
         // random
-        for( t_CKINT i = 0; i < weights.size(); i++ )
+        for( t_CKUINT i = 0; i < weights.size(); i++ )
             for( t_CKINT j = 0; j < weights[i]->xDim(); j++ )
                 for( t_CKINT k = 0; k < weights[i]->yDim(); k++ )
                     weights[i]->v( j, k ) = ck_random() / (t_CKFLOAT)CK_RANDOM_MAX;
-        for( t_CKINT i = 0; i < biases.size(); i++ )
+        for( t_CKUINT i = 0; i < biases.size(); i++ )
             for( t_CKINT j = 0; j < biases[i]->size(); j++ )
                 biases[i]->v( j ) = ck_random() / (t_CKFLOAT)CK_RANDOM_MAX;
 
@@ -3446,6 +4600,7 @@ public:
     // forward
     void forward( ChaiVectorFast<t_CKFLOAT> & input )
     {
+        sync();
         // sanity check
         if( units_per_layer.size() == 0 )
         {
@@ -3458,14 +4613,15 @@ public:
             activations[0]->v( i ) = input[i];
         // forward
         t_CKFLOAT v, sum;
-        for( t_CKINT i = 0; i < weights.size(); i++ )
+        for( t_CKUINT i = 0; i < weights.size(); i++ )
         {
+            t_CKFLOAT * out = activations[i + 1]->m_vector;
+            // weighted sums
+            chai_gemv( weights[i]->data(), weights[i]->xDim(), weights[i]->yDim(),
+                       activations[i]->m_vector, out );
             for( t_CKINT j = 0; j < weights[i]->xDim(); j++ )
             {
-                v = 0.0;
-                for( t_CKINT k = 0; k < weights[i]->yDim(); k++ )
-                    v += weights[i]->v( j, k ) * activations[i]->v( k );
-                v += biases[i]->v( j );
+                v = out[j] + biases[i]->m_vector[j];
                 if( activation_per_layer[i] == g_at_sigmoid )
                     v = 1.0 / ( 1.0 + exp( -v ) );
                 else if( activation_per_layer[i] == g_at_tanh )
@@ -3476,7 +4632,7 @@ public:
                     v = exp( v );
                 else if( activation_per_layer[i] == g_at_linear )
                 {   /* v = v; */ }
-                activations[i + 1]->v( j ) = v;
+                out[j] = v;
             }
             if( activation_per_layer[i] == g_at_softmax )
             {
@@ -3492,6 +4648,7 @@ public:
     // backprop
     void backprop( ChaiVectorFast<t_CKFLOAT> & output, t_CKFLOAT lr )
     {
+        sync();
         // sanity check
         if( units_per_layer.size() == 0 )
         {
@@ -3506,18 +4663,19 @@ public:
         t_CKFLOAT v;
         for( t_CKINT i = weights.size() - 1; i >= 0; i-- )
         {
-            // prev layer
-            for( t_CKINT j = 0; j < weights[i]->yDim(); j++ )
-            {
-                v = 0.0;
-                for( t_CKINT k = 0; k < weights[i]->xDim(); k++ )
-                    v += weights[i]->v( k, j ) * gradients[i + 1]->v( k );
-                gradients[i]->v( j ) = v;
-            }
-            // gradient
+            t_CKFLOAT * g = gradients[i + 1]->m_vector;
+            t_CKFLOAT * g_prev = gradients[i]->m_vector;
+            t_CKINT n = weights[i]->yDim();
+            for( t_CKINT k = 0; k < n; k++ )
+                g_prev[k] = 0.0;
+            // one pass over the weights, a row at a time
             for( t_CKINT j = 0; j < weights[i]->xDim(); j++ )
             {
-                v = activations[i + 1]->v( j );
+                t_CKFLOAT * w = weights[i]->row( j );
+                // prev layer (from this row before it is updated)
+                ck_array_axpy( g_prev, g[j], w, n );
+                // gradient
+                v = activations[i + 1]->m_vector[j];
                 if( activation_per_layer[i] == g_at_sigmoid )
                     v = v * ( 1.0 - v );
                 else if( activation_per_layer[i] == g_at_tanh )
@@ -3528,11 +4686,10 @@ public:
                     v = v * ( 1.0 - v );
                 else if( activation_per_layer[i] == g_at_linear )
                     v = 1.0;
-                v = v * gradients[i + 1]->v( j ) * lr;
-                for( t_CKINT k = 0; k < weights[i]->yDim(); k++ )
-                    weights[i]->v( j, k ) += v * activations[i]->v( k );
-                biases[i]->v( j ) += v;
-                gradients[i + 1]->v( j ) = v;
+                v = v * g[j] * lr;
+                ck_array_axpy( w, v, activations[i]->m_vector, n );
+                biases[i]->m_vector[j] += v;
+                g[j] = v;
             }
         }
     }
@@ -3543,6 +4700,19 @@ public:
                 t_CKINT size,
                 t_CKFLOAT lr,
                 t_CKINT epochs )
+    {
+        ChaiRandom random;
+        train( X, Y, size, lr, epochs, random, NULL );
+    }
+
+    // train, with the given random numbers; gives up early if 'stop' is raised
+    void train( ChaiMatrixFast<t_CKFLOAT> & X,
+                ChaiMatrixFast<t_CKFLOAT> & Y,
+                t_CKINT size,
+                t_CKFLOAT lr,
+                t_CKINT epochs,
+                ChaiRandom & random,
+                const std::atomic<bool> * stop )
     {
         // sanity check
         if( units_per_layer.size() == 0 )
@@ -3558,14 +4728,13 @@ public:
             indices[i] = i;
         for( t_CKINT i = 0; i < epochs; i++ )
         {
-            indices.shuffle();
+            if( stop && *stop ) return;
+            indices.shuffle( random );
             for( t_CKINT j = 0; j < size; j++ )
             {
-                for( t_CKINT k = 0; k < X.yDim(); k++ )
-                    x[k] = X.v( indices[j], k );
+                memcpy( x.m_vector, X.row( indices.m_vector[j] ), X.yDim() * sizeof(t_CKFLOAT) );
                 forward( x );
-                for( t_CKINT k = 0; k < Y.yDim(); k++ )
-                    y[k] = Y.v( indices[j], k );
+                memcpy( y.m_vector, Y.row( indices.m_vector[j] ), Y.yDim() * sizeof(t_CKFLOAT) );
                 backprop( y, lr );
             }
         }
@@ -3584,6 +4753,9 @@ public:
     // train2
     void train( Chuck_ArrayInt & inputs_, Chuck_ArrayInt & outputs_, t_CKFLOAT learning_rate, t_CKINT max_iterations )
     {
+        // start from what trainAsync() finished, if anything; else stop it
+        sync();
+        if( trainer ) trainer->cancel();
         ChaiMatrixFast<t_CKFLOAT> * X = chuck2chai( inputs_ );
         ChaiMatrixFast<t_CKFLOAT> * Y = chuck2chai( outputs_ );
         train( *X, *Y, X->xDim(), learning_rate, max_iterations );
@@ -3591,9 +4763,82 @@ public:
         CK_SAFE_DELETE( Y );
     }
 
+    // train on a worker thread, starting from a copy of this network;
+    // the network in use is replaced when done
+    Chuck_Event * train_async( Chuck_VM * vm, Chuck_ArrayInt & inputs_, Chuck_ArrayInt & outputs_,
+                               t_CKFLOAT learning_rate, t_CKINT max_iterations )
+    {
+        if( !trainer ) trainer = new ChaiTrainer<MLP_Object>( vm );
+        // adopt what an earlier call trained, to start from there
+        sync();
+        // sanity check (here, rather than on the worker)
+        if( units_per_layer.size() == 0 )
+        {
+            EM_error3( "MLP.trainAsync(): network not initialized" );
+            return trainer->notify();
+        }
+        // snapshot the data, the network, and the random numbers to use
+        ChaiMatrixFast<t_CKFLOAT> * X = chuck2chai( inputs_ );
+        ChaiMatrixFast<t_CKFLOAT> * Y = chuck2chai( outputs_ );
+        MLP_Object * mlp = clone();
+        ChaiRandom random;
+        random.fork();
+        return trainer->start( [X, Y, mlp, learning_rate, max_iterations, random]( const std::atomic<bool> & stop ) mutable
+        {
+            mlp->train( *X, *Y, X->xDim(), learning_rate, max_iterations, random, &stop );
+            delete X;
+            delete Y;
+            return mlp;
+        } );
+    }
+
+    // adopt the network from train_async(), if it is ready
+    void sync()
+    {
+        MLP_Object * trained = trainer ? trainer->take() : NULL;
+        if( !trained ) return;
+        units_per_layer.swap( trained->units_per_layer );
+        activation_per_layer.swap( trained->activation_per_layer );
+        weights.swap( trained->weights );
+        biases.swap( trained->biases );
+        activations.swap( trained->activations );
+        gradients.swap( trained->gradients );
+        CK_SAFE_DELETE( trained );
+    }
+
+    // deep copy of the network (without its trainer)
+    MLP_Object * clone()
+    {
+        MLP_Object * mlp = new MLP_Object();
+        mlp->units_per_layer = units_per_layer;
+        mlp->activation_per_layer = activation_per_layer;
+        for( t_CKUINT i = 0; i < weights.size(); i++ )
+        {
+            ChaiMatrixFast<t_CKFLOAT> * w = new ChaiMatrixFast<t_CKFLOAT>( weights[i]->xDim(), weights[i]->yDim() );
+            memcpy( w->data(), weights[i]->data(), w->xDim() * w->yDim() * sizeof(t_CKFLOAT) );
+            mlp->weights.push_back( w );
+        }
+        for( t_CKUINT i = 0; i < biases.size(); i++ )
+            mlp->biases.push_back( copy( *biases[i] ) );
+        for( t_CKUINT i = 0; i < activations.size(); i++ )
+            mlp->activations.push_back( copy( *activations[i] ) );
+        for( t_CKUINT i = 0; i < gradients.size(); i++ )
+            mlp->gradients.push_back( copy( *gradients[i] ) );
+        return mlp;
+    }
+
+    // copy of a vector
+    static ChaiVectorFast<t_CKFLOAT> * copy( ChaiVectorFast<t_CKFLOAT> & v )
+    {
+        ChaiVectorFast<t_CKFLOAT> * c = new ChaiVectorFast<t_CKFLOAT>( v.size() );
+        memcpy( c->m_vector, v.m_vector, v.size() * sizeof(t_CKFLOAT) );
+        return c;
+    }
+
     // predict
     t_CKBOOL predict( Chuck_ArrayFloat & input_, Chuck_ArrayFloat & output_ )
     {
+        sync();
         // sanity check
         if( units_per_layer.size() == 0 )
         {
@@ -3635,6 +4880,7 @@ public:
     // get_weights
     void get_weights( t_CKINT layer, Chuck_ArrayInt & weights_ )
     {
+        sync();
         // sanity check
         if( units_per_layer.size() == 0 )
         {
@@ -3663,6 +4909,7 @@ public:
     // get_biases
     void get_biases( t_CKINT layer, Chuck_ArrayFloat & biases_ )
     {
+        sync();
         // sanity check
         if( units_per_layer.size() == 0 )
         {
@@ -3682,6 +4929,7 @@ public:
     // get_gradients
     void get_gradients( t_CKINT layer, Chuck_ArrayFloat & gradients_ )
     {
+        sync();
         // sanity check
         if( units_per_layer.size() == 0 )
         {
@@ -3701,6 +4949,7 @@ public:
     // get_activations
     void get_activations( t_CKINT layer, Chuck_ArrayFloat & activations_ )
     {
+        sync();
         // sanity check
         if( units_per_layer.size() == 0 )
         {
@@ -3736,6 +4985,7 @@ public:
     // save
     t_CKBOOL save( ofstream & fout )
     {
+        sync();
         fout << "# layers" << endl;
         // fout << units_per_layer.size() << endl;
         for( t_CKINT i = 0; i < units_per_layer.size(); i++ )
@@ -3748,7 +4998,7 @@ public:
         fout << endl;
 
         fout << "# weights" << endl;
-        for( t_CKINT i = 0; i < weights.size(); i++ )
+        for( t_CKUINT i = 0; i < weights.size(); i++ )
         {
             for( t_CKINT j = 0; j < weights[i]->xDim(); j++ )
             {
@@ -3759,7 +5009,7 @@ public:
         }
 
         fout << "# biases" << endl;
-        for( t_CKINT i = 0; i < biases.size(); i++ )
+        for( t_CKUINT i = 0; i < biases.size(); i++ )
         {
             for( t_CKINT j = 0; j < biases[i]->size(); j++ )
                 fout << biases[i]->v( j ) << " ";
@@ -3928,6 +5178,30 @@ CK_DLL_MFUN( MLP_train2 )
     mlp->train( *inputs, *outputs, learning_rate, max_iterations );
 }
 
+CK_DLL_MFUN( MLP_train_async )
+{
+    // get object
+    MLP_Object * mlp = (MLP_Object *)OBJ_MEMBER_UINT( SELF, MLP_offset_data );
+    // get args
+    Chuck_ArrayInt * inputs = (Chuck_ArrayInt *)GET_NEXT_OBJECT( ARGS );
+    Chuck_ArrayInt * outputs = (Chuck_ArrayInt *)GET_NEXT_OBJECT( ARGS );
+    // train in the background
+    RETURN->v_object = mlp->train_async( VM, *inputs, *outputs, .01, 100 );
+}
+
+CK_DLL_MFUN( MLP_train_async2 )
+{
+    // get object
+    MLP_Object * mlp = (MLP_Object *)OBJ_MEMBER_UINT( SELF, MLP_offset_data );
+    // get args
+    Chuck_ArrayInt * inputs = (Chuck_ArrayInt *)GET_NEXT_OBJECT( ARGS );
+    Chuck_ArrayInt * outputs = (Chuck_ArrayInt *)GET_NEXT_OBJECT( ARGS );
+    t_CKFLOAT learning_rate = GET_NEXT_FLOAT( ARGS );
+    t_CKINT max_iterations = GET_NEXT_INT( ARGS );
+    // train in the background
+    RETURN->v_object = mlp->train_async( VM, *inputs, *outputs, learning_rate, max_iterations );
+}
+
 CK_DLL_MFUN( MLP_predict )
 {
     // get object
@@ -4360,6 +5634,30 @@ public:
     }
 };
 
+//-----------------------------------------------------------------------------
+// name: struct Wekinator_Trained
+// desc: a Wekinator.trainAsync() job: for each output, its data and the
+//       network trained on it
+//-----------------------------------------------------------------------------
+struct Wekinator_Trained
+{
+public:
+    struct Output
+    {
+        Output() : mlp( NULL ), learning_rate( 0 ), epochs( 0 ) { }
+        ~Output() { CK_SAFE_DELETE( mlp ); }
+        MLP_Object * mlp;
+        ChaiMatrixFast<t_CKFLOAT> X;
+        ChaiMatrixFast<t_CKFLOAT> Y;
+        t_CKFLOAT learning_rate;
+        t_CKINT epochs;
+    };
+
+    Wekinator_Trained( t_CKINT num_outputs ) : outputs( num_outputs ) { }
+
+    vector<Output> outputs;
+};
+
 //-----------------------------------------------------------------------------
 // name: struct Wekinator_Object
 // desc: Wekinator implementation | 1.5.0.0 (yikai) added
@@ -4382,6 +5680,8 @@ private:
     // data
     vector<vector<t_CKFLOAT> > examples;
     t_CKINT recording_round;
+    // for train_async()
+    ChaiTrainer<Wekinator_Trained> * trainer;
 
     //-------------------------------------------------------------------------
     // why train a separate model for each output channel?
@@ -4422,11 +5722,13 @@ public:
         num_inputs = 0;
         num_outputs = 0;
         recording_round = 0;
+        trainer = NULL;
     }
 
     // destructor
     ~Wekinator_Object()
     {
+        CK_SAFE_DELETE( trainer );
         inputs.clear();
         inputs_names.clear();
         outputs.clear();
@@ -4454,6 +5756,8 @@ public:
         }
         if( num_inputs_ == num_inputs )
             return;
+        // models in training no longer fit
+        if( trainer ) trainer->cancel();
 
         num_inputs = num_inputs_;
 
@@ -4480,6 +5784,8 @@ public:
         }
         if( num_outputs_ == num_outputs )
             return;
+        // models in training no longer fit
+        if( trainer ) trainer->cancel();
 
         num_outputs = num_outputs_;
 
@@ -4525,56 +5831,120 @@ public:
     // train
     void train()
     {
+        // this replaces whatever trainAsync() was doing
+        if( trainer ) trainer->cancel();
         ChaiMatrixFast<t_CKFLOAT> X;
         ChaiMatrixFast<t_CKFLOAT> Y;
-        t_CKINT n, d, r;
         for( t_CKINT i = 0; i < num_outputs; i++ )
         {
-            // prepare data
-            n = models[i].example_ids.size();
-            d = models[i].connected_inputs.size();
-            X.allocate( n, d );
-            Y.allocate( n, 1 );
-            for( t_CKINT j = 0; j < n; j++ )
-            {
-                r = models[i].example_ids[j];
-                for( t_CKINT k = 0; k < d; k++ )
-                    X( j, k ) = examples[r][3 + models[i].connected_inputs[k]];
-                Y( j, 0 ) = examples[r][3 + num_inputs + i];
-            }
-            // prepare model
-            if( models[i].task_type == g_tt_regression )
+            // prepare data and model
+            MLP_Object * mlp = prepare( i, X, Y );
+            if( !mlp ) return;
+            CK_SAFE_DELETE( models[i].mlp );
+            models[i].mlp = mlp;
+            // train
+            mlp->train( X, Y, X.xDim(), models[i].mlp_learning_rate, models[i].mlp_epochs );
+            // set status
+            models[i].train_status = TRUE;
+        }
+    }
+
+    // train on a worker thread; the models in use are replaced when done
+    Chuck_Event * train_async( Chuck_VM * vm )
+    {
+        if( !trainer ) trainer = new ChaiTrainer<Wekinator_Trained>( vm );
+        // snapshot the data, with a new network for each output
+        Wekinator_Trained * job = new Wekinator_Trained( num_outputs );
+        for( t_CKINT i = 0; i < num_outputs; i++ )
+        {
+            Wekinator_Trained::Output & out = job->outputs[i];
+            out.mlp = prepare( i, out.X, out.Y );
+            if( !out.mlp )
             {
-                if( models[i].model_type == g_mt_mlp )
-                {
-                    CK_SAFE_DELETE( models[i].mlp );
-                    models[i].mlp = new MLP_Object();
-                    // init
-                    vector<t_CKUINT> units_per_layer;
-                    units_per_layer.push_back( d );
-                    t_CKINT nodes_per_hidden_layer =
-                        models[i].mlp_nodes_per_hidden_layer == 0 ? d : models[i].mlp_nodes_per_hidden_layer;
-                    for( t_CKINT j = 0; j < models[i].mlp_hidden_layers; j++ )
-                        units_per_layer.push_back( nodes_per_hidden_layer );
-                    units_per_layer.push_back( 1 );
-                    models[i].mlp->init( units_per_layer );
-                    // train
-                    models[i].mlp->train( X, Y, n, models[i].mlp_learning_rate, models[i].mlp_epochs );
-                }
-                else
-                {
-                    EM_error3( "Wekinator.train: unknown regression model_type." );
-                    return;
-                }
+                CK_SAFE_DELETE( job );
+                return trainer->notify();
             }
-            else if( models[i].task_type == g_tt_classification )
+            out.learning_rate = models[i].mlp_learning_rate;
+            out.epochs = models[i].mlp_epochs;
+        }
+        // and the random numbers to use
+        ChaiRandom random;
+        random.fork();
+        return trainer->start( [job, random]( const std::atomic<bool> & stop ) mutable
+        {
+            for( t_CKUINT i = 0; i < job->outputs.size() && !stop; i++ )
             {
-                EM_error3( "Wekinator.train: classification not implemented yet." );
-                return;
+                Wekinator_Trained::Output & out = job->outputs[i];
+                out.mlp->train( out.X, out.Y, out.X.xDim(), out.learning_rate, out.epochs, random, &stop );
+                // done with the data
+                out.X.cleanup();
+                out.Y.cleanup();
             }
-            // set status
+            return job;
+        } );
+    }
+
+    // adopt the models from train_async(), if they are ready
+    void sync()
+    {
+        Wekinator_Trained * trained = trainer ? trainer->take() : NULL;
+        if( !trained ) return;
+        for( t_CKINT i = 0; i < num_outputs; i++ )
+        {
+            CK_SAFE_DELETE( models[i].mlp );
+            models[i].mlp = trained->outputs[i].mlp;
+            trained->outputs[i].mlp = NULL;
             models[i].train_status = TRUE;
         }
+        CK_SAFE_DELETE( trained );
+    }
+
+    // prepare data for output i, and a new (untrained) model; NULL if the
+    // output's task or model type can't be trained
+    MLP_Object * prepare( t_CKINT i, ChaiMatrixFast<t_CKFLOAT> & X, ChaiMatrixFast<t_CKFLOAT> & Y )
+    {
+        // prepare data
+        t_CKINT n = models[i].example_ids.size();
+        t_CKINT d = models[i].connected_inputs.size();
+        t_CKINT r;
+        X.allocate( n, d );
+        Y.allocate( n, 1 );
+        for( t_CKINT j = 0; j < n; j++ )
+        {
+            r = models[i].example_ids[j];
+            for( t_CKINT k = 0; k < d; k++ )
+                X( j, k ) = examples[r][3 + models[i].connected_inputs[k]];
+            Y( j, 0 ) = examples[r][3 + num_inputs + i];
+        }
+        // prepare model
+        if( models[i].task_type == g_tt_regression )
+        {
+            if( models[i].model_type == g_mt_mlp )
+            {
+                MLP_Object * mlp = new MLP_Object();
+                // init
+                vector<t_CKUINT> units_per_layer;
+                units_per_layer.push_back( d );
+                t_CKINT nodes_per_hidden_layer =
+                    models[i].mlp_nodes_per_hidden_layer == 0 ? d : models[i].mlp_nodes_per_hidden_layer;
+                for( t_CKINT j = 0; j < models[i].mlp_hidden_layers; j++ )
+                    units_per_layer.push_back( nodes_per_hidden_layer );
+                units_per_layer.push_back( 1 );
+                mlp->init( units_per_layer );
+                return mlp;
+            }
+            else
+            {
+                EM_error3( "Wekinator.train: unknown regression model_type." );
+                return NULL;
+            }
+        }
+        else if( models[i].task_type == g_tt_classification )
+        {
+            EM_error3( "Wekinator.train: classification not implemented yet." );
+            return NULL;
+        }
+        return NULL;
     }
 
     // set_property
@@ -5226,6 +6596,7 @@ public:
     // predict
     void predict( Chuck_ArrayFloat & inputs_, Chuck_ArrayFloat & outputs_ )
     {
+        sync();
         // sanity check
         if( inputs_.size() != num_inputs )
         {
@@ -5447,6 +6818,7 @@ public:
     // save
     t_CKBOOL save( Chuck_String & filename )
     {
+        sync();
         ofstream fout( filename.str().c_str() );
         // check
         if( !fout.good() )
@@ -5491,6 +6863,8 @@ public:
             EM_error3( "Wekinator.load: could not open file '%s' for reading.", filename.str().c_str() );
             return FALSE;
         }
+        // this replaces whatever trainAsync() was doing
+        if( trainer ) trainer->cancel();
 
         t_CKINT num;
         string line;
@@ -6381,6 +7755,14 @@ CK_DLL_MFUN( Wekinator_train )
     wekinator->train();
 }
 
+CK_DLL_MFUN( Wekinator_train_async )
+{
+    // get object
+    Wekinator_Object * wekinator = (Wekinator_Object *)OBJ_MEMBER_UINT( SELF, Wekinator_offset_data );
+    // train in the background
+    RETURN->v_object = wekinator->train_async( VM );
+}
+
 CK_DLL_MFUN( Wekinator_predict )
 {
     // get object
@@ -182,6 +182,13 @@ public:
     t_CKINT yDim() const
     { return m_yDim; }
 
+    // get row x (not bound-checked; rows are contiguous, yDim apart)
+    T * row( t_CKINT x )
+    { return m_matrix + x * m_yDim; }
+    // get underlying storage (not bound-checked)
+    T * data()
+    { return m_matrix; }
+
     void cleanup()
     {
         // reclaim array memory and zero the pointer
@@ -265,6 +272,21 @@ public:
         }
     }
 
+    // shuffle, drawing from 'random()' instead of ck_random()
+    template<class R>
+    void shuffle( R & random )
+    {
+        T temp;
+        t_CKINT j;
+        for( t_CKINT i = m_length - 1; i > 0; i-- )
+        {
+            j = random() % ( i + 1 );
+            temp = m_vector[i];
+            m_vector[i] = m_vector[j];
+            m_vector[j] = temp;
+        }
+    }
+
     t_CKUINT length()
     { return m_length; }
 
@@ -328,6 +350,91 @@ public:
     t_CKINT m_length;
 };
 
+
+
+
+//-----------------------------------------------------------------------------
+// ChAI BLAS-like kernels over row-major t_CKFLOAT matrices
+// (e.g., ChaiMatrixFast::row()/data() and ChaiVectorFast::m_vector); these
+// are not bound-checked, and are vectorized by the ck_array_*() kernels in
+// util_math; the gemm variants work on tiles so operands stay in cache
+//-----------------------------------------------------------------------------
+// tile sizes for the gemm variants
+#define CHAI_GEMM_ROWS          32
+#define CHAI_GEMM_DEPTH         256
+
+//-----------------------------------------------------------------------------
+// name: chai_gemv()
+// desc: y = A x, where A is m x n
+//-----------------------------------------------------------------------------
+inline void chai_gemv( const t_CKFLOAT * A, t_CKINT m, t_CKINT n,
+                       const t_CKFLOAT * x, t_CKFLOAT * y )
+{
+    for( t_CKINT i = 0; i < m; i++ )
+        y[i] = ck_array_dot( A + i*n, x, n );
+}
+
+//-----------------------------------------------------------------------------
+// name: chai_gemm_nt()
+// desc: C = A B^T, where A is m x k, B is n x k, C is m x n
+//-----------------------------------------------------------------------------
+inline void chai_gemm_nt( const t_CKFLOAT * A, const t_CKFLOAT * B, t_CKFLOAT * C,
+                          t_CKINT m, t_CKINT n, t_CKINT k )
+{
+    for( t_CKINT i = 0; i < m*n; i++ ) C[i] = 0;
+    for( t_CKINT p0 = 0; p0 < k; p0 += CHAI_GEMM_DEPTH )
+    {
+        t_CKINT kb = ck_min( (t_CKINT)CHAI_GEMM_DEPTH, k - p0 );
+        for( t_CKINT i0 = 0; i0 < m; i0 += CHAI_GEMM_ROWS )
+        {
+            t_CKINT i1 = ck_min( i0 + CHAI_GEMM_ROWS, m );
+            for( t_CKINT j0 = 0; j0 < n; j0 += CHAI_GEMM_ROWS )
+            {
+                t_CKINT j1 = ck_min( j0 + CHAI_GEMM_ROWS, n );
+                for( t_CKINT i = i0; i < i1; i++ )
+                    for( t_CKINT j = j0; j < j1; j++ )
+                        C[i*n + j] += ck_array_dot( A + i*k + p0, B + j*k + p0, kb );
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// name: chai_gemm_tn()
+// desc: C = A^T B, where A is k x m, B is k x n, C is m x n
+//-----------------------------------------------------------------------------
+inline void chai_gemm_tn( const t_CKFLOAT * A, const t_CKFLOAT * B, t_CKFLOAT * C,
+                          t_CKINT m, t_CKINT n, t_CKINT k )
+{
+    for( t_CKINT i = 0; i < m*n; i++ ) C[i] = 0;
+    // a block of rows of C stays in cache while every row of B is added in
+    for( t_CKINT i0 = 0; i0 < m; i0 += CHAI_GEMM_ROWS )
+    {
+        t_CKINT i1 = ck_min( i0 + CHAI_GEMM_ROWS, m );
+        for( t_CKINT p = 0; p < k; p++ )
+            for( t_CKINT i = i0; i < i1; i++ )
+                ck_array_axpy( C + i*n, A[p*m + i], B + p*n, n );
+    }
+}
+
+//-----------------------------------------------------------------------------
+// name: chai_gemm_nn()
+// desc: C = A B, where A is m x k, B is k x n, C is m x n
+//-----------------------------------------------------------------------------
+inline void chai_gemm_nn( const t_CKFLOAT * A, const t_CKFLOAT * B, t_CKFLOAT * C,
+                          t_CKINT m, t_CKINT n, t_CKINT k )
+{
+    for( t_CKINT i = 0; i < m*n; i++ ) C[i] = 0;
+    // a block of rows of B stays in cache while it is applied to every row of C
+    for( t_CKINT p0 = 0; p0 < k; p0 += CHAI_GEMM_ROWS )
+    {
+        t_CKINT p1 = ck_min( p0 + CHAI_GEMM_ROWS, k );
+        for( t_CKINT i = 0; i < m; i++ )
+            for( t_CKINT p = p0; p < p1; p++ )
+                ck_array_axpy( C + i*n, A[i*k + p], B + p*n, n );
+    }
+}
+
 #endif
 
 #ifndef _KD_TREE_H
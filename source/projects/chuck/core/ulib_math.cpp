@@ -475,6 +475,62 @@ DLL_QUERY libmath_query( Chuck_DL_Query * QUERY )
     QUERY->add_arg( QUERY, "vec4", "b" );
     QUERY->doc_func( QUERY, "Compute the euclidean distance between 4D vectors a and b." );
 
+    // add dot
+    QUERY->add_sfun( QUERY, dot_impl, "float", "dot" ); //! dot product
+    QUERY->add_arg( QUERY, "float", "a[]" );
+    QUERY->add_arg( QUERY, "float", "b[]" );
+    QUERY->doc_func( QUERY, "Compute the dot product of arrays a and b (over the length of the shorter array)." );
+
+    // add sum
+    QUERY->add_sfun( QUERY, sum_impl, "float", "sum" ); //! sum
+    QUERY->add_arg( QUERY, "float", "a[]" );
+    QUERY->doc_func( QUERY, "Compute the sum of the elements of array a." );
+
+    // add mean
+    QUERY->add_sfun( QUERY, mean_impl, "float", "mean" ); //! mean
+    QUERY->add_arg( QUERY, "float", "a[]" );
+    QUERY->doc_func( QUERY, "Compute the mean of the elements of array a; returns 0 if a is empty." );
+
+    // add min
+    QUERY->add_sfun( QUERY, min_array_impl, "float", "min" ); //! min
+    QUERY->add_arg( QUERY, "float", "a[]" );
+    QUERY->doc_func( QUERY, "Return the smallest element of array a; returns 0 if a is empty." );
+
+    // add max
+    QUERY->add_sfun( QUERY, max_array_impl, "float", "max" ); //! max
+    QUERY->add_arg( QUERY, "float", "a[]" );
+    QUERY->doc_func( QUERY, "Return the largest element of array a; returns 0 if a is empty." );
+
+    // add add
+    QUERY->add_sfun( QUERY, add_array_impl, "void", "add" ); //! in-place add
+    QUERY->add_arg( QUERY, "float", "a[]" );
+    QUERY->add_arg( QUERY, "float", "b[]" );
+    QUERY->doc_func( QUERY, "Add array b to array a, element by element, in place (over the length of the shorter array)." );
+
+    // add mul
+    QUERY->add_sfun( QUERY, mul_array_impl, "void", "mul" ); //! in-place multiply
+    QUERY->add_arg( QUERY, "float", "a[]" );
+    QUERY->add_arg( QUERY, "float", "b[]" );
+    QUERY->doc_func( QUERY, "Multiply array a by array b, element by element, in place (over the length of the shorter array)." );
+
+    // add scale
+    QUERY->add_sfun( QUERY, scale_array_impl, "void", "scale" ); //! in-place scale
+    QUERY->add_arg( QUERY, "float", "a[]" );
+    QUERY->add_arg( QUERY, "float", "s" );
+    QUERY->doc_func( QUERY, "Multiply each element of array a by s, in place." );
+
+    // add axpy
+    QUERY->add_sfun( QUERY, axpy_impl, "void", "axpy" ); //! y += s*x
+    QUERY->add_arg( QUERY, "float", "s" );
+    QUERY->add_arg( QUERY, "float", "x[]" );
+    QUERY->add_arg( QUERY, "float", "y[]" );
+    QUERY->doc_func( QUERY, "Add s times array x to array y, element by element, in place (over the length of the shorter array)." );
+
+    // add normalize
+    QUERY->add_sfun( QUERY, normalize_impl, "float", "normalize" ); //! normalize
+    QUERY->add_arg( QUERY, "float", "a[]" );
+    QUERY->doc_func( QUERY, "Scale array a in place to unit length (euclidean norm); returns the norm before scaling. An array with norm 0 is left unchanged." );
+
     // add map (ge: added 1.5.0.0)
     QUERY->add_sfun( QUERY, map_impl, "float", "map" ); //! map
     QUERY->add_arg( QUERY, "float", "value" );
@@ -1201,12 +1257,7 @@ CK_DLL_SFUN( cossim_impl )
     std::vector<t_CKFLOAT> & v2 = b->m_vector;
 
     t_CKFLOAT sum = 0.0, norm1 = 0.0, norm2 = 0.0;
-    for( t_CKINT i = 0; i < size; i++ )
-    {
-        sum += v1[i] * v2[i];
-        norm1 += v1[i] * v1[i];
-        norm2 += v2[i] * v2[i];
-    }
+    ck_array_dot_norms( &v1[0], &v2[0], size, &sum, &norm1, &norm2 );
 
     // set return value
     RETURN->v_float = sum / (::sqrt(norm1) * ::sqrt(norm2));
@@ -1328,16 +1379,8 @@ CK_DLL_SFUN( euclidean_impl )
     std::vector<t_CKFLOAT> & v1 = a->m_vector;
     std::vector<t_CKFLOAT> & v2 = b->m_vector;
 
-    t_CKFLOAT d;
-    t_CKFLOAT sum = 0.0;
-    for( t_CKINT i = 0; i < size; i++ )
-    {
-        d = v1[i] - v2[i];
-        sum += d*d;
-    }
-
     // set return value
-    RETURN->v_float = ::sqrt(sum);
+    RETURN->v_float = ::sqrt( ck_array_sqdist( &v1[0], &v2[0], size ) );
 }
 
 
@@ -1400,6 +1443,141 @@ CK_DLL_SFUN( euclidean4d_impl )
     RETURN->v_float = ::sqrt(sum);
 }
 
+// check float[] arguments to the array functions below
+static t_CKBOOL math_arrays_ok( const char * name, Chuck_ArrayFloat * a, Chuck_ArrayFloat * b )
+{
+    // if either is NULL, go to error
+    if( a == NULL || b == NULL )
+    {
+        // log
+        EM_log( CK_LOG_WARNING, "Math.%s(...) was given one or more NULL arrays...", name );
+        return FALSE;
+    }
+    return TRUE;
+}
+
+
+// dot
+CK_DLL_SFUN( dot_impl )
+{
+    Chuck_ArrayFloat * a = (Chuck_ArrayFloat *)GET_NEXT_OBJECT( ARGS );
+    Chuck_ArrayFloat * b = (Chuck_ArrayFloat *)GET_NEXT_OBJECT( ARGS );
+    // in case of error
+    RETURN->v_float = 0.0;
+    if( !math_arrays_ok( "dot", a, b ) ) return;
+    // take the smaller size
+    t_CKINT size = ck_min( a->size(), b->size() );
+    if( size ) RETURN->v_float = ck_array_dot( &a->m_vector[0], &b->m_vector[0], size );
+}
+
+
+// sum
+CK_DLL_SFUN( sum_impl )
+{
+    Chuck_ArrayFloat * a = (Chuck_ArrayFloat *)GET_NEXT_OBJECT( ARGS );
+    // in case of error
+    RETURN->v_float = 0.0;
+    if( !math_arrays_ok( "sum", a, a ) ) return;
+    if( a->size() ) RETURN->v_float = ck_array_sum( &a->m_vector[0], a->size() );
+}
+
+
+// mean
+CK_DLL_SFUN( mean_impl )
+{
+    Chuck_ArrayFloat * a = (Chuck_ArrayFloat *)GET_NEXT_OBJECT( ARGS );
+    // in case of error
+    RETURN->v_float = 0.0;
+    if( !math_arrays_ok( "mean", a, a ) ) return;
+    if( a->size() ) RETURN->v_float = ck_array_sum( &a->m_vector[0], a->size() ) / a->size();
+}
+
+
+// min (of array)
+CK_DLL_SFUN( min_array_impl )
+{
+    Chuck_ArrayFloat * a = (Chuck_ArrayFloat *)GET_NEXT_OBJECT( ARGS );
+    // in case of error
+    RETURN->v_float = 0.0;
+    if( !math_arrays_ok( "min", a, a ) ) return;
+    if( a->size() ) RETURN->v_float = ck_array_min( &a->m_vector[0], a->size() );
+}
+
+
+// max (of array)
+CK_DLL_SFUN( max_array_impl )
+{
+    Chuck_ArrayFloat * a = (Chuck_ArrayFloat *)GET_NEXT_OBJECT( ARGS );
+    // in case of error
+    RETURN->v_float = 0.0;
+    if( !math_arrays_ok( "max", a, a ) ) return;
+    if( a->size() ) RETURN->v_float = ck_array_max( &a->m_vector[0], a->size() );
+}
+
+
+// add (in place)
+CK_DLL_SFUN( add_array_impl )
+{
+    Chuck_ArrayFloat * a = (Chuck_ArrayFloat *)GET_NEXT_OBJECT( ARGS );
+    Chuck_ArrayFloat * b = (Chuck_ArrayFloat *)GET_NEXT_OBJECT( ARGS );
+    if( !math_arrays_ok( "add", a, b ) ) return;
+    // take the smaller size
+    t_CKINT size = ck_min( a->size(), b->size() );
+    if( size ) ck_array_add( &a->m_vector[0], &b->m_vector[0], size );
+}
+
+
+// mul (in place)
+CK_DLL_SFUN( mul_array_impl )
+{
+    Chuck_ArrayFloat * a = (Chuck_ArrayFloat *)GET_NEXT_OBJECT( ARGS );
+    Chuck_ArrayFloat * b = (Chuck_ArrayFloat *)GET_NEXT_OBJECT( ARGS );
+    if( !math_arrays_ok( "mul", a, b ) ) return;
+    // take the smaller size
+    t_CKINT size = ck_min( a->size(), b->size() );
+    if( size ) ck_array_mul( &a->m_vector[0], &b->m_vector[0], size );
+}
+
+
+// scale (in place)
+CK_DLL_SFUN( scale_array_impl )
+{
+    Chuck_ArrayFloat * a = (Chuck_ArrayFloat *)GET_NEXT_OBJECT( ARGS );
+    t_CKFLOAT s = GET_NEXT_FLOAT( ARGS );
+    if( !math_arrays_ok( "scale", a, a ) ) return;
+    if( a->size() ) ck_array_scale( &a->m_vector[0], s, a->size() );
+}
+
+
+// axpy: y += s*x (in place)
+CK_DLL_SFUN( axpy_impl )
+{
+    t_CKFLOAT s = GET_NEXT_FLOAT( ARGS );
+    Chuck_ArrayFloat * x = (Chuck_ArrayFloat *)GET_NEXT_OBJECT( ARGS );
+    Chuck_ArrayFloat * y = (Chuck_ArrayFloat *)GET_NEXT_OBJECT( ARGS );
+    if( !math_arrays_ok( "axpy", x, y ) ) return;
+    // take the smaller size
+    t_CKINT size = ck_min( x->size(), y->size() );
+    if( size ) ck_array_axpy( &y->m_vector[0], s, &x->m_vector[0], size );
+}
+
+
+// normalize (in place)
+CK_DLL_SFUN( normalize_impl )
+{
+    Chuck_ArrayFloat * a = (Chuck_ArrayFloat *)GET_NEXT_OBJECT( ARGS );
+    // in case of error
+    RETURN->v_float = 0.0;
+    if( !math_arrays_ok( "normalize", a, a ) ) return;
+    if( !a->size() ) return;
+    // euclidean norm
+    t_CKFLOAT norm = ::sqrt( ck_array_dot( &a->m_vector[0], &a->m_vector[0], a->size() ) );
+    if( norm > 0 ) ck_array_scale( &a->m_vector[0], 1.0 / norm, a->size() );
+    // return the norm
+    RETURN->v_float = norm;
+}
+
+
 // map (ge) | added 1.5.0.0
 CK_DLL_SFUN( map_impl )
 {
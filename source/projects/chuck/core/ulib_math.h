@@ -116,6 +116,17 @@ CK_DLL_SFUN( euclidean2d_impl );
 CK_DLL_SFUN( euclidean3d_impl );
 CK_DLL_SFUN( euclidean4d_impl );
 
+CK_DLL_SFUN( dot_impl );
+CK_DLL_SFUN( sum_impl );
+CK_DLL_SFUN( mean_impl );
+CK_DLL_SFUN( min_array_impl );
+CK_DLL_SFUN( max_array_impl );
+CK_DLL_SFUN( add_array_impl );
+CK_DLL_SFUN( mul_array_impl );
+CK_DLL_SFUN( scale_array_impl );
+CK_DLL_SFUN( axpy_impl );
+CK_DLL_SFUN( normalize_impl );
+
 CK_DLL_SFUN( map_impl );
 CK_DLL_SFUN( map2_impl );
 
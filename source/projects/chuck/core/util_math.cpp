@@ -370,3 +370,288 @@ t_CKFLOAT ck_vec4_magnitude( const t_CKVEC4 & v )
 {
     return ::sqrt( v.x*v.x + v.y*v.y + v.z*v.z + v.w*v.w );
 }
+
+
+
+
+//-----------------------------------------------------------------------------
+// float array kernels
+// t_CKFLOAT is double, so a vector holds 4 (AVX) or 2 (SSE2, NEON) values;
+// the ISA is picked at compile time (e.g. -mavx enables AVX), and a scalar
+// loop handles the remainder, or everything if no SIMD is available.
+// reductions keep two vector accumulators to hide add latency
+//-----------------------------------------------------------------------------
+#if defined(__AVX__)
+  #include <immintrin.h>
+  #define CK_VD_N               4
+  typedef __m256d               ck_vd;
+  #define ck_vd_load(p)         _mm256_loadu_pd(p)
+  #define ck_vd_store(p,v)      _mm256_storeu_pd(p,v)
+  #define ck_vd_set1(x)         _mm256_set1_pd(x)
+  #define ck_vd_add(a,b)        _mm256_add_pd(a,b)
+  #define ck_vd_sub(a,b)        _mm256_sub_pd(a,b)
+  #define ck_vd_mul(a,b)        _mm256_mul_pd(a,b)
+  #define ck_vd_min(a,b)        _mm256_min_pd(a,b)
+  #define ck_vd_max(a,b)        _mm256_max_pd(a,b)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define CK_VD_N               2
+  typedef __m128d               ck_vd;
+  #define ck_vd_load(p)         _mm_loadu_pd(p)
+  #define ck_vd_store(p,v)      _mm_storeu_pd(p,v)
+  #define ck_vd_set1(x)         _mm_set1_pd(x)
+  #define ck_vd_add(a,b)        _mm_add_pd(a,b)
+  #define ck_vd_sub(a,b)        _mm_sub_pd(a,b)
+  #define ck_vd_mul(a,b)        _mm_mul_pd(a,b)
+  #define ck_vd_min(a,b)        _mm_min_pd(a,b)
+  #define ck_vd_max(a,b)        _mm_max_pd(a,b)
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  #include <arm_neon.h>
+  #define CK_VD_N               2
+  typedef float64x2_t           ck_vd;
+  #define ck_vd_load(p)         vld1q_f64(p)
+  #define ck_vd_store(p,v)      vst1q_f64(p,v)
+  #define ck_vd_set1(x)         vdupq_n_f64(x)
+  #define ck_vd_add(a,b)        vaddq_f64(a,b)
+  #define ck_vd_sub(a,b)        vsubq_f64(a,b)
+  #define ck_vd_mul(a,b)        vmulq_f64(a,b)
+  #define ck_vd_min(a,b)        vminq_f64(a,b)
+  #define ck_vd_max(a,b)        vmaxq_f64(a,b)
+#endif
+
+#ifdef CK_VD_N
+// sum of the lanes of a vector
+static inline t_CKFLOAT ck_vd_hsum( ck_vd v )
+{
+    t_CKFLOAT t[CK_VD_N]; ck_vd_store( t, v );
+    t_CKFLOAT s = t[0];
+    for( t_CKUINT i = 1; i < CK_VD_N; i++ ) s += t[i];
+    return s;
+}
+#endif
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ck_array_dot()
+// desc: dot product of a and b
+//-----------------------------------------------------------------------------
+t_CKFLOAT ck_array_dot( const t_CKFLOAT * a, const t_CKFLOAT * b, t_CKUINT n )
+{
+    t_CKUINT i = 0;
+    t_CKFLOAT sum = 0;
+#ifdef CK_VD_N
+    ck_vd s0 = ck_vd_set1(0), s1 = ck_vd_set1(0);
+    for( ; i + 2*CK_VD_N <= n; i += 2*CK_VD_N )
+    {
+        s0 = ck_vd_add( s0, ck_vd_mul( ck_vd_load(a+i), ck_vd_load(b+i) ) );
+        s1 = ck_vd_add( s1, ck_vd_mul( ck_vd_load(a+i+CK_VD_N), ck_vd_load(b+i+CK_VD_N) ) );
+    }
+    sum = ck_vd_hsum( ck_vd_add( s0, s1 ) );
+#endif
+    for( ; i < n; i++ ) sum += a[i] * b[i];
+    return sum;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ck_array_dot_norms()
+// desc: dot product of a and b, and of each with itself, in one pass
+//-----------------------------------------------------------------------------
+void ck_array_dot_norms( const t_CKFLOAT * a, const t_CKFLOAT * b, t_CKUINT n,
+                         t_CKFLOAT * ab, t_CKFLOAT * aa, t_CKFLOAT * bb )
+{
+    t_CKUINT i = 0;
+    t_CKFLOAT sab = 0, saa = 0, sbb = 0;
+#ifdef CK_VD_N
+    ck_vd vab = ck_vd_set1(0), vaa = ck_vd_set1(0), vbb = ck_vd_set1(0);
+    for( ; i + CK_VD_N <= n; i += CK_VD_N )
+    {
+        ck_vd x = ck_vd_load(a+i), y = ck_vd_load(b+i);
+        vab = ck_vd_add( vab, ck_vd_mul( x, y ) );
+        vaa = ck_vd_add( vaa, ck_vd_mul( x, x ) );
+        vbb = ck_vd_add( vbb, ck_vd_mul( y, y ) );
+    }
+    sab = ck_vd_hsum( vab ); saa = ck_vd_hsum( vaa ); sbb = ck_vd_hsum( vbb );
+#endif
+    for( ; i < n; i++ )
+    {
+        sab += a[i] * b[i];
+        saa += a[i] * a[i];
+        sbb += b[i] * b[i];
+    }
+    *ab = sab; *aa = saa; *bb = sbb;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ck_array_sqdist()
+// desc: squared euclidean distance between a and b
+//-----------------------------------------------------------------------------
+t_CKFLOAT ck_array_sqdist( const t_CKFLOAT * a, const t_CKFLOAT * b, t_CKUINT n )
+{
+    t_CKUINT i = 0;
+    t_CKFLOAT sum = 0, d;
+#ifdef CK_VD_N
+    ck_vd s0 = ck_vd_set1(0), s1 = ck_vd_set1(0), d0, d1;
+    for( ; i + 2*CK_VD_N <= n; i += 2*CK_VD_N )
+    {
+        d0 = ck_vd_sub( ck_vd_load(a+i), ck_vd_load(b+i) );
+        d1 = ck_vd_sub( ck_vd_load(a+i+CK_VD_N), ck_vd_load(b+i+CK_VD_N) );
+        s0 = ck_vd_add( s0, ck_vd_mul( d0, d0 ) );
+        s1 = ck_vd_add( s1, ck_vd_mul( d1, d1 ) );
+    }
+    sum = ck_vd_hsum( ck_vd_add( s0, s1 ) );
+#endif
+    for( ; i < n; i++ ) { d = a[i] - b[i]; sum += d*d; }
+    return sum;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ck_array_sum()
+// desc: sum of elements
+//-----------------------------------------------------------------------------
+t_CKFLOAT ck_array_sum( const t_CKFLOAT * a, t_CKUINT n )
+{
+    t_CKUINT i = 0;
+    t_CKFLOAT sum = 0;
+#ifdef CK_VD_N
+    ck_vd s0 = ck_vd_set1(0), s1 = ck_vd_set1(0);
+    for( ; i + 2*CK_VD_N <= n; i += 2*CK_VD_N )
+    {
+        s0 = ck_vd_add( s0, ck_vd_load(a+i) );
+        s1 = ck_vd_add( s1, ck_vd_load(a+i+CK_VD_N) );
+    }
+    sum = ck_vd_hsum( ck_vd_add( s0, s1 ) );
+#endif
+    for( ; i < n; i++ ) sum += a[i];
+    return sum;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ck_array_min()
+// desc: smallest element (n must be > 0)
+//-----------------------------------------------------------------------------
+t_CKFLOAT ck_array_min( const t_CKFLOAT * a, t_CKUINT n )
+{
+    t_CKUINT i = 0;
+    t_CKFLOAT m = a[0];
+#ifdef CK_VD_N
+    if( n >= CK_VD_N )
+    {
+        ck_vd v = ck_vd_load(a);
+        for( i = CK_VD_N; i + CK_VD_N <= n; i += CK_VD_N )
+            v = ck_vd_min( v, ck_vd_load(a+i) );
+        t_CKFLOAT t[CK_VD_N]; ck_vd_store( t, v );
+        for( t_CKUINT j = 0; j < CK_VD_N; j++ ) if( t[j] < m ) m = t[j];
+    }
+#endif
+    for( ; i < n; i++ ) if( a[i] < m ) m = a[i];
+    return m;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ck_array_max()
+// desc: largest element (n must be > 0)
+//-----------------------------------------------------------------------------
+t_CKFLOAT ck_array_max( const t_CKFLOAT * a, t_CKUINT n )
+{
+    t_CKUINT i = 0;
+    t_CKFLOAT m = a[0];
+#ifdef CK_VD_N
+    if( n >= CK_VD_N )
+    {
+        ck_vd v = ck_vd_load(a);
+        for( i = CK_VD_N; i + CK_VD_N <= n; i += CK_VD_N )
+            v = ck_vd_max( v, ck_vd_load(a+i) );
+        t_CKFLOAT t[CK_VD_N]; ck_vd_store( t, v );
+        for( t_CKUINT j = 0; j < CK_VD_N; j++ ) if( t[j] > m ) m = t[j];
+    }
+#endif
+    for( ; i < n; i++ ) if( a[i] > m ) m = a[i];
+    return m;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ck_array_add()
+// desc: a[i] += b[i]
+//-----------------------------------------------------------------------------
+void ck_array_add( t_CKFLOAT * a, const t_CKFLOAT * b, t_CKUINT n )
+{
+    t_CKUINT i = 0;
+#ifdef CK_VD_N
+    for( ; i + CK_VD_N <= n; i += CK_VD_N )
+        ck_vd_store( a+i, ck_vd_add( ck_vd_load(a+i), ck_vd_load(b+i) ) );
+#endif
+    for( ; i < n; i++ ) a[i] += b[i];
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ck_array_mul()
+// desc: a[i] *= b[i]
+//-----------------------------------------------------------------------------
+void ck_array_mul( t_CKFLOAT * a, const t_CKFLOAT * b, t_CKUINT n )
+{
+    t_CKUINT i = 0;
+#ifdef CK_VD_N
+    for( ; i + CK_VD_N <= n; i += CK_VD_N )
+        ck_vd_store( a+i, ck_vd_mul( ck_vd_load(a+i), ck_vd_load(b+i) ) );
+#endif
+    for( ; i < n; i++ ) a[i] *= b[i];
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ck_array_scale()
+// desc: a[i] *= s
+//-----------------------------------------------------------------------------
+void ck_array_scale( t_CKFLOAT * a, t_CKFLOAT s, t_CKUINT n )
+{
+    t_CKUINT i = 0;
+#ifdef CK_VD_N
+    ck_vd vs = ck_vd_set1( s );
+    for( ; i + CK_VD_N <= n; i += CK_VD_N )
+        ck_vd_store( a+i, ck_vd_mul( ck_vd_load(a+i), vs ) );
+#endif
+    for( ; i < n; i++ ) a[i] *= s;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ck_array_axpy()
+// desc: y[i] += s * x[i]
+//-----------------------------------------------------------------------------
+void ck_array_axpy( t_CKFLOAT * y, t_CKFLOAT s, const t_CKFLOAT * x, t_CKUINT n )
+{
+    t_CKUINT i = 0;
+#ifdef CK_VD_N
+    ck_vd vs = ck_vd_set1( s );
+    for( ; i + CK_VD_N <= n; i += CK_VD_N )
+        ck_vd_store( y+i, ck_vd_add( ck_vd_load(y+i), ck_vd_mul( vs, ck_vd_load(x+i) ) ) );
+#endif
+    for( ; i < n; i++ ) y[i] += s * x[i];
+}
@@ -113,6 +113,28 @@ t_CKFLOAT ck_vec3_magnitude( const t_CKVEC3 & v );
 // magnitude of vec4
 t_CKFLOAT ck_vec4_magnitude( const t_CKVEC4 & v );
 
+// float array kernels (SIMD where available; arrays may overlap only if equal)
+// dot product of a and b
+t_CKFLOAT ck_array_dot( const t_CKFLOAT * a, const t_CKFLOAT * b, t_CKUINT n );
+// dot product of a and b, and of each with itself
+void ck_array_dot_norms( const t_CKFLOAT * a, const t_CKFLOAT * b, t_CKUINT n,
+                         t_CKFLOAT * ab, t_CKFLOAT * aa, t_CKFLOAT * bb );
+// squared euclidean distance between a and b
+t_CKFLOAT ck_array_sqdist( const t_CKFLOAT * a, const t_CKFLOAT * b, t_CKUINT n );
+// sum of elements
+t_CKFLOAT ck_array_sum( const t_CKFLOAT * a, t_CKUINT n );
+// smallest / largest element (n must be > 0)
+t_CKFLOAT ck_array_min( const t_CKFLOAT * a, t_CKUINT n );
+t_CKFLOAT ck_array_max( const t_CKFLOAT * a, t_CKUINT n );
+// a[i] += b[i]
+void ck_array_add( t_CKFLOAT * a, const t_CKFLOAT * b, t_CKUINT n );
+// a[i] *= b[i]
+void ck_array_mul( t_CKFLOAT * a, const t_CKFLOAT * b, t_CKUINT n );
+// a[i] *= s
+void ck_array_scale( t_CKFLOAT * a, t_CKFLOAT s, t_CKUINT n );
+// y[i] += s * x[i]
+void ck_array_axpy( t_CKFLOAT * y, t_CKFLOAT s, const t_CKFLOAT * x, t_CKUINT n );
+
 
 
 #if defined (__cplusplus) || defined(_cplusplus)
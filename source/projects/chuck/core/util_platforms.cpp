@@ -55,6 +55,8 @@
   #include <unistd.h>
   #include <sys/ioctl.h>
   #include <sys/time.h>
+  #include <sys/mman.h>
+  #include <fcntl.h>
 
 #endif // #ifdef __PLATFORM_WINDOWS__
 
@@ -325,6 +327,95 @@ t_CKBOOL ck_fileexists( const std::string & path )
 
 
 
+
+//-----------------------------------------------------------------------------
+// name: ck_mapfile()
+// desc: map a file into memory, read-only; returns NULL on failure
+//-----------------------------------------------------------------------------
+void * ck_mapfile( const std::string & path, size_t * size )
+{
+    // data
+    void * data = NULL;
+    // zero out
+    *size = 0;
+
+#ifdef __PLATFORM_WINDOWS__
+    // open the file
+    HANDLE file = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+    if( file == INVALID_HANDLE_VALUE ) return NULL;
+    // get the size
+    LARGE_INTEGER length;
+    if( GetFileSizeEx( file, &length ) && length.QuadPart > 0 )
+    {
+        // map the whole file (the view keeps the mapping alive)
+        HANDLE mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+        if( mapping != NULL )
+        {
+            data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+            if( data != NULL ) *size = (size_t)length.QuadPart;
+            CloseHandle( mapping );
+        }
+    }
+    CloseHandle( file );
+#else
+    // open the file
+    int fd = open( path.c_str(), O_RDONLY );
+    if( fd < 0 ) return NULL;
+    // get the size
+    struct stat fs;
+    if( fstat( fd, &fs ) == 0 && fs.st_size > 0 )
+    {
+        // map the whole file (the mapping outlives the descriptor)
+        data = mmap( NULL, (size_t)fs.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+        if( data == MAP_FAILED ) data = NULL;
+        else *size = (size_t)fs.st_size;
+    }
+    close( fd );
+#endif
+
+    return data;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ck_unmapfile()
+// desc: unmap a file mapped by ck_mapfile()
+//-----------------------------------------------------------------------------
+void ck_unmapfile( void * data, size_t size )
+{
+    // check
+    if( data == NULL ) return;
+
+#ifdef __PLATFORM_WINDOWS__
+    UnmapViewOfFile( data );
+#else
+    munmap( data, size );
+#endif
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ck_replacefile()
+// desc: move a file over another (which need not exist)
+//-----------------------------------------------------------------------------
+t_CKBOOL ck_replacefile( const std::string & from, const std::string & to )
+{
+#ifdef __PLATFORM_WINDOWS__
+    // rename() won't replace an existing file on windows
+    return MoveFileExA( from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING ) != 0;
+#else
+    // atomic on posix
+    return rename( from.c_str(), to.c_str() ) == 0;
+#endif
+}
+
+
+
 #ifdef __PLATFORM_WINDOWS__
 //-----------------------------------------------------------------------------
 // name: win32_getline()
@@ -53,6 +53,15 @@ t_CKBOOL ck_isdir( const std::string & path );
 // check if file exists
 t_CKBOOL ck_fileexists( const std::string & path );
 
+// map a file into memory, read-only; returns NULL on failure; the pages are
+// shared with any other process mapping the same file
+void * ck_mapfile( const std::string & path, size_t * size );
+// unmap a file mapped by ck_mapfile()
+void ck_unmapfile( void * data, size_t size );
+// move a file over another, replacing it in one step where the platform
+// allows (mappings of the replaced file stay valid on posix)
+t_CKBOOL ck_replacefile( const std::string & from, const std::string & to );
+
 // do any platform-specific setup to enable ANSI escape codes
 t_CKBOOL ck_configANSI_ESCcodes();
 
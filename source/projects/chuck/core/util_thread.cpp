@@ -36,6 +36,8 @@
 #include "util_buffers.h"
 #include "util_platforms.h"
 #include "chuck_errmsg.h"
+#include <errno.h>
+#include <limits.h>
 
 
 
@@ -252,6 +254,79 @@ void XMutex::release( )
 
 
 
+//-----------------------------------------------------------------------------
+// name: XSemaphore()
+// desc: constructor; the count starts at 0
+//-----------------------------------------------------------------------------
+XSemaphore::XSemaphore( )
+{
+#if defined(__PLATFORM_APPLE__)
+    sem = dispatch_semaphore_create( 0 );
+#elif ( defined(__PLATFORM_LINUX__) || defined(__WINDOWS_PTHREAD__) )
+    sem_init( &sem, 0, 0 );
+#elif defined(__PLATFORM_WINDOWS__)
+    sem = CreateSemaphore( NULL, 0, LONG_MAX, NULL );
+#endif
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ~XSemaphore()
+// desc: destructor
+//-----------------------------------------------------------------------------
+XSemaphore::~XSemaphore( )
+{
+#if defined(__PLATFORM_APPLE__)
+    dispatch_release( sem );
+#elif ( defined(__PLATFORM_LINUX__) || defined(__WINDOWS_PTHREAD__) )
+    sem_destroy( &sem );
+#elif defined(__PLATFORM_WINDOWS__)
+    CloseHandle( sem );
+#endif
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: post()
+// desc: increment the count, waking a waiter if any
+//-----------------------------------------------------------------------------
+void XSemaphore::post( )
+{
+#if defined(__PLATFORM_APPLE__)
+    dispatch_semaphore_signal( sem );
+#elif ( defined(__PLATFORM_LINUX__) || defined(__WINDOWS_PTHREAD__) )
+    sem_post( &sem );
+#elif defined(__PLATFORM_WINDOWS__)
+    ReleaseSemaphore( sem, 1, NULL );
+#endif
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: wait()
+// desc: wait for the count to be positive, then decrement it
+//-----------------------------------------------------------------------------
+void XSemaphore::wait( )
+{
+#if defined(__PLATFORM_APPLE__)
+    dispatch_semaphore_wait( sem, DISPATCH_TIME_FOREVER );
+#elif ( defined(__PLATFORM_LINUX__) || defined(__WINDOWS_PTHREAD__) )
+    // retry if interrupted by a signal
+    while( sem_wait( &sem ) != 0 && errno == EINTR ) { }
+#elif defined(__PLATFORM_WINDOWS__)
+    WaitForSingleObject( sem, INFINITE );
+#endif
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: shared()
 // desc: get XWriteThread shared instance
@@ -52,6 +52,13 @@ template<typename T> class CircularBuffer;
   typedef void * (*THREAD_FUNCTION)(void *);
   typedef pthread_mutex_t MUTEX;
   #define CHUCK_THREAD pthread_t
+  #if defined(__PLATFORM_APPLE__)
+    #include <dispatch/dispatch.h>
+    typedef dispatch_semaphore_t SEMAPHORE;
+  #else
+    #include <semaphore.h>
+    typedef sem_t SEMAPHORE;
+  #endif
 #elif defined(__PLATFORM_WINDOWS__)
   #include <windows.h>
   #include <process.h>
@@ -60,6 +67,7 @@ template<typename T> class CircularBuffer;
   typedef unsigned THREAD_RETURN;
   typedef unsigned (__stdcall *THREAD_FUNCTION)(void *);
   typedef CRITICAL_SECTION MUTEX;
+  typedef HANDLE SEMAPHORE;
   #define CHUCK_THREAD HANDLE
 #endif
 
@@ -152,6 +160,30 @@ protected:
 
 
 
+//-----------------------------------------------------------------------------
+// name: struct XSemaphore
+// desc: counting semaphore; post() never blocks, so it can be called from
+//       the audio thread to wake a worker
+//-----------------------------------------------------------------------------
+struct XSemaphore
+{
+public:
+    XSemaphore();
+    ~XSemaphore();
+
+public:
+    // increment the count, waking a waiter if any
+    void post();
+    // wait for the count to be positive, then decrement it
+    void wait();
+
+protected:
+    SEMAPHORE sem;
+};
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: XWriteThread()
 // desc: utility class for scheduling writes to be executed on a separate
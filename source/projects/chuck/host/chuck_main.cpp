@@ -630,6 +630,10 @@ t_CKBOOL go( int argc, const char ** argv )
     t_CKBOOL enable_server = TRUE;
     t_CKBOOL do_watchdog = TRUE;
     t_CKINT  adaptive_size = 0;
+    t_CKBOOL block_shredule = FALSE;
+    t_CKBOOL ugen_schedule = FALSE;
+    t_CKINT  ugen_threads = 0;
+    t_CKBOOL vm_op_pairs = FALSE;
     t_CKINT  log_level = CK_LOG_CORE;
     t_CKINT  deprecate_level = 1; // 1 == warn
     t_CKINT  chugin_load = 1; // 1 == auto (variable added 1.3.0.0)
@@ -892,6 +896,14 @@ t_CKBOOL go( int argc, const char ** argv )
                 adaptive_size = argv[i][11] ? atoi( argv[i]+11 ) : -1;
             else if( !strncmp(argv[i], "--adaptive", 10) )
                 adaptive_size = argv[i][10] ? atoi( argv[i]+10 ) : -1;
+            else if( !strcmp(argv[i], "--block-shredule") )
+                block_shredule = TRUE;
+            else if( !strcmp(argv[i], "--ugen-schedule") )
+                ugen_schedule = TRUE;
+            else if( !strncmp(argv[i], "--ugen-threads:", 15) )
+                ugen_threads = atoi( argv[i]+15 );
+            else if( !strcmp(argv[i], "--vm-op-pairs") )
+                vm_op_pairs = TRUE;
             else if( !strncmp(argv[i], "--deprecate", 11) )
             {
                 // get the rest
@@ -1441,6 +1453,10 @@ t_CKBOOL go( int argc, const char ** argv )
     the_chuck->setParam( CHUCK_PARAM_INPUT_CHANNELS, adc_chans_before_rtaudio );
     the_chuck->setParam( CHUCK_PARAM_OUTPUT_CHANNELS, dac_chans );
     the_chuck->setParam( CHUCK_PARAM_VM_ADAPTIVE, adaptive_size );
+    the_chuck->setParam( CHUCK_PARAM_VM_BLOCK_SHREDULE, (t_CKINT)block_shredule );
+    the_chuck->setParam( CHUCK_PARAM_VM_UGEN_SCHEDULE, (t_CKINT)ugen_schedule );
+    the_chuck->setParam( CHUCK_PARAM_VM_UGEN_THREADS, ugen_threads );
+    the_chuck->setParam( CHUCK_PARAM_VM_OP_PAIRS, (t_CKINT)vm_op_pairs );
     the_chuck->setParam( CHUCK_PARAM_VM_HALT, (t_CKINT)(vm_halt) );
     the_chuck->setParam( CHUCK_PARAM_OTF_PORT, g_otf_port );
     the_chuck->setParam( CHUCK_PARAM_OTF_ENABLE, (t_CKINT)enableOTF );
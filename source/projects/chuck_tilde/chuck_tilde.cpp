@@ -64,6 +64,10 @@ typedef struct _ck {
     long tap_channels;              // number of tap outlet channels (0 = disabled)
     t_symbol* tap_ugens[16];        // names of global UGens to tap (one per outlet, max 16)
     float* tap_buffer;              // buffer for tapped samples
+
+    // param-related (handles for globals set by <param-name> <value>)
+    std::unordered_map<t_symbol*, t_CKINT>* int_handles;   // param name -> global int handle
+    std::unordered_map<t_symbol*, t_CKINT>* float_handles; // param name -> global float handle
 } t_ck;
 
 
@@ -82,6 +86,7 @@ t_max_err ck_demo(t_ck* x, t_symbol* s, long argc, t_atom* argv);
 // general message handlers
 t_max_err ck_bang(t_ck* x);                     // (re)load chuck file
 t_max_err ck_anything(t_ck* x, t_symbol* s, long argc, t_atom* argv); // set global params by name/value
+t_CKINT ck_param_handle(t_ck* x, t_symbol* s, te_GlobalType type);      // cached handle for a global param
 
 // basic message handlers
 t_max_err ck_run(t_ck* x, t_symbol* s);         // run chuck file
@@ -291,6 +296,10 @@ void* ck_new(t_symbol* s, long argc, t_atom* argv)
         }
         x->tap_buffer = NULL;
 
+        // param handle caches
+        x->int_handles = new std::unordered_map<t_symbol*, t_CKINT>();
+        x->float_handles = new std::unordered_map<t_symbol*, t_CKINT>();
+
         // get external editor
         if (const char* editor = std::getenv("EDITOR")) {
             ck_info(x, (char*)"editor from env: %s", editor);
@@ -467,6 +476,14 @@ void ck_free(t_ck* x)
         delete[] x->tap_buffer;
         x->tap_buffer = NULL;
     }
+    if (x->int_handles) {
+        delete x->int_handles;
+        x->int_handles = NULL;
+    }
+    if (x->float_handles) {
+        delete x->float_handles;
+        x->float_handles = NULL;
+    }
     if (x->chuck) {
         ChucK::globalCleanup();
         delete x->chuck;
@@ -1422,6 +1439,22 @@ t_max_err ck_loglevel(t_ck* x, t_symbol* s, long argc, t_atom* argv)
     return MAX_ERR_GENERIC;
 }
 
+t_CKINT ck_param_handle(t_ck* x, t_symbol* s, te_GlobalType type)
+{
+    // resolve once per param name; later sets skip the name lookup
+    std::unordered_map<t_symbol*, t_CKINT>* handles =
+        (type == te_globalInt) ? x->int_handles : x->float_handles;
+    auto it = handles->find(s);
+    if (it != handles->end()) {
+        return it->second;
+    }
+    t_CKINT handle = (type == te_globalInt)
+        ? x->chuck->vm()->globals_manager()->resolveGlobalInt(s->s_name)
+        : x->chuck->vm()->globals_manager()->resolveGlobalFloat(s->s_name);
+    (*handles)[s] = handle;
+    return handle;
+}
+
 t_max_err ck_anything(t_ck* x, t_symbol* s, long argc, t_atom* argv)
 {
     t_atom atoms[128];
@@ -1472,13 +1505,19 @@ t_max_err ck_anything(t_ck* x, t_symbol* s, long argc, t_atom* argv)
         case A_FLOAT: {
             float p_float = atom_getfloat(argv);
             ck_debug(x, (char*)"param %s: %f", s->s_name, p_float);            
-            x->chuck->vm()->globals_manager()->setGlobalFloat(s->s_name, p_float);
+            t_CKINT handle = ck_param_handle(x, s, te_globalFloat);
+            if (handle < 0 || !x->chuck->vm()->globals_manager()->setGlobalFloatHandle(handle, p_float)) {
+                x->chuck->vm()->globals_manager()->setGlobalFloat(s->s_name, p_float);
+            }
             break;
         }
         case A_LONG: {
             long p_long = atom_getlong(argv);
             ck_debug(x, (char*)"param %s: %d", s->s_name, p_long);
-            x->chuck->vm()->globals_manager()->setGlobalInt(s->s_name, p_long);
+            t_CKINT handle = ck_param_handle(x, s, te_globalInt);
+            if (handle < 0 || !x->chuck->vm()->globals_manager()->setGlobalIntHandle(handle, p_long)) {
+                x->chuck->vm()->globals_manager()->setGlobalInt(s->s_name, p_long);
+            }
             break;
         }
         case A_SYM: {
@@ -1700,6 +1739,9 @@ t_max_err ck_param(t_ck* x, t_symbol* s, long argc, t_atom* argv)
         CHUCK_PARAM_OUTPUT_CHANNELS,
         CHUCK_PARAM_VM_ADAPTIVE,
         CHUCK_PARAM_VM_HALT,
+        CHUCK_PARAM_VM_BLOCK_SHREDULE,
+        CHUCK_PARAM_VM_UGEN_SCHEDULE,
+        CHUCK_PARAM_VM_UGEN_THREADS,
         CHUCK_PARAM_OTF_ENABLE,
         CHUCK_PARAM_OTF_PORT,
         CHUCK_PARAM_DUMP_INSTRUCTIONS,
@@ -11,6 +11,7 @@
 
 // vendor includes
 #include "FFTConvolver.h"
+#include "TwoStageFFTConvolver.h"
 
 // local includes
 // #define CONV_REV_PROFILE // TODO: remove when building
@@ -20,6 +21,7 @@
 #endif
 
 // general includes
+#include <atomic>
 #include <iostream>
 #include <mutex>
 #include <string>
@@ -27,6 +29,20 @@
 #include <thread>
 #include <vector>
 
+#ifndef __EMSCRIPTEN__
+#if defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <climits>
+#else
+#include <semaphore.h>
+#endif
+#endif
+
 #ifdef __EMSCRIPTEN__
 #define CONV_REV_BLOCKSIZE 512 // default FFT blocksize
 #else
@@ -40,6 +56,10 @@ CK_DLL_DTOR(convrev_dtor);
 CK_DLL_MFUN(convrev_setBlockSize);
 CK_DLL_MFUN(convrev_getBlockSize);
 
+// Set head blocksize (0: uniform partitions)
+CK_DLL_MFUN(convrev_setHeadSize);
+CK_DLL_MFUN(convrev_getHeadSize);
+
 // Set order of IR buffer
 CK_DLL_MFUN(convrev_setOrder);
 CK_DLL_MFUN(convrev_getOrder);
@@ -61,12 +81,99 @@ CK_DLL_TICK(convrev_tick);
 // this is a special offset reserved for chugin internal data
 t_CKINT convrev_data_offset = 0;
 
+// lock-free single-producer single-consumer ring (audio thread -> worker)
+template <typename T, size_t N>
+class SPSCRing
+{
+    static_assert((N & (N - 1)) == 0, "SPSCRing size must be a power of 2");
+
+private:
+    T _items[N];
+    std::atomic<size_t> _head; // next to read (consumer)
+    std::atomic<size_t> _tail; // next to write (producer)
+
+public:
+    SPSCRing() : _head(0), _tail(0) {}
+
+    // producer only; false if full
+    bool push(const T &item)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == N)
+            return false;
+        _items[tail & (N - 1)] = item;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only; false if empty
+    bool pop(T &item)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+            return false;
+        item = _items[head & (N - 1)];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const
+    {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+};
+
+#ifndef __EMSCRIPTEN__
+// counting semaphore; post() never blocks or allocates, so the audio thread
+// can wake the worker with it
+class Semaphore
+{
+private:
+#if defined(__APPLE__)
+    dispatch_semaphore_t _sem;
+#elif defined(_WIN32)
+    HANDLE _sem;
+#else
+    sem_t _sem;
+#endif
+
+public:
+#if defined(__APPLE__)
+    Semaphore() { _sem = dispatch_semaphore_create(0); }
+    ~Semaphore() { dispatch_release(_sem); }
+    void post() { dispatch_semaphore_signal(_sem); }
+    void wait() { dispatch_semaphore_wait(_sem, DISPATCH_TIME_FOREVER); }
+#elif defined(_WIN32)
+    Semaphore() { _sem = CreateSemaphore(NULL, 0, LONG_MAX, NULL); }
+    ~Semaphore() { CloseHandle(_sem); }
+    void post() { ReleaseSemaphore(_sem, 1, NULL); }
+    void wait() { WaitForSingleObject(_sem, INFINITE); }
+#else
+    Semaphore() { sem_init(&_sem, 0, 0); }
+    ~Semaphore() { sem_destroy(&_sem); }
+    void post() { sem_post(&_sem); }
+    void wait()
+    {
+        // retry if interrupted by a signal
+        while (sem_wait(&_sem) != 0)
+            ;
+    }
+#endif
+
+private:
+    Semaphore(const Semaphore &);
+    Semaphore &operator=(const Semaphore &);
+};
+#endif
+
 class ConvRev
 {
 private:                // internal data
     t_CKFLOAT _SR;      // sample rate
     t_CKINT _blocksize; // FFT blocksize
     t_CKINT _order;     // filter order
+    t_CKINT _headsize;  // head blocksize, 0 for uniform partitions
+    t_CKINT _head;      // head blocksize in use, as of the last init()
 
     // internal buffers
     std::vector<fftconvolver::Sample> _ir_buffer;
@@ -83,11 +190,56 @@ private:                // internal data
 
     fftconvolver::FFTConvolver _convolver; // convolution engine
 
+    // two-stage engine: small head partitions on the audio thread, large
+    // tail partitions on the worker
+    class TwoStage : public fftconvolver::TwoStageFFTConvolver
+    {
+    public:
+        TwoStage(ConvRev *owner) : _owner(owner) {}
+
+        // worker side of a tail job
+        void background() { doBackgroundProcessing(); }
+
+#ifndef __EMSCRIPTEN__
+    protected:
+        void startBackgroundProcessing() override
+        {
+            Job job = {nullptr, nullptr, true};
+            _owner->_submit(job);
+        }
+
+        void waitForBackgroundProcessing() override { _owner->_wait(); }
+#endif
+
+    private:
+        ConvRev *_owner;
+    };
+
+    TwoStage _two_stage;
+
+    // head input/output, headsize samples each
+    std::vector<fftconvolver::Sample> _head_in;
+    std::vector<fftconvolver::Sample> _head_out;
+
     size_t _idx; // to track head of circular input buffer
 
 #ifndef __EMSCRIPTEN__
-    // threading
+    // one block of convolution for the worker
+    struct Job
+    {
+        fftconvolver::Sample *input;
+        fftconvolver::Sample *output;
+        bool tail; // run the two-stage tail instead
+    };
+
+    // threading: a long-lived worker, started by init()
     std::thread _conv_thr;
+    SPSCRing<Job, 4> _jobs;
+    // set by tick() when a block is handed off, cleared by the worker
+    std::atomic<bool> _busy;
+    // posted once per job, and to quit; the worker sleeps on it
+    Semaphore _wake;
+    std::atomic<bool> _quit;
 #endif
 
     // scale factor to normalize output
@@ -95,17 +247,29 @@ private:                // internal data
 
 public:
     ConvRev(t_CKFLOAT fs)
-        : _SR(fs), _blocksize(CONV_REV_BLOCKSIZE), _order(0), _convolver(),
+        : _SR(fs), _blocksize(CONV_REV_BLOCKSIZE), _order(0), _headsize(0), _head(0),
+          _convolver(), _two_stage(this),
           _idx(0), _scale_factor(1.0f), _which_input_buffer(false), _which_output_buffer(false),
           _output_buffer(nullptr), _staging_out_buffer(nullptr)
     {
+#ifndef __EMSCRIPTEN__
+        _busy = false;
+        _quit = false;
+#endif
     }
 
     ~ConvRev()
     {
 #ifndef __EMSCRIPTEN__
         if (_conv_thr.joinable())
+        {
+            // once the block in flight is done the worker is asleep, so the
+            // join only waits for it to wake and see _quit
+            _wait();
+            _quit.store(true, std::memory_order_release);
+            _wake.post();
             _conv_thr.join();
+        }
 #endif
         if (_output_buffer)
             delete[] _output_buffer;
@@ -146,6 +310,23 @@ public:
 #ifdef CONV_REV_PROFILE
         Timer timer("tick", _blocksize);
 #endif
+        // not initialized yet
+        if (!_output_buffer)
+            return 0;
+
+        // two-stage: the head is convolved here, every _head samples
+        if (_head > 0)
+        {
+            _head_in[_idx] = in;
+            SAMPLE output = _scale_factor * _head_out[_idx];
+            if (++_idx == _head)
+            {
+                _idx = 0;
+                _two_stage.process(_head_in.data(), _head_out.data(), _head);
+            }
+            return output;
+        }
+
         getInputBuffer()[_idx] = in;
         SAMPLE output = _scale_factor * (getOutputBuffer()[_idx]);
 
@@ -161,8 +342,7 @@ public:
 
 // wait for convolution engine to finish processing next block
 #ifndef __EMSCRIPTEN__
-            if (_conv_thr.joinable())
-                _conv_thr.join();
+            _wait();
 #endif
 
             // swap input and output buffers
@@ -177,8 +357,9 @@ public:
 #ifdef __EMSCRIPTEN__
             _process(getStagingInputBuffer(), getStagingOutputBuffer());
 #else
-            _conv_thr = std::thread([&]()
-                                    { _process(getStagingInputBuffer(), getStagingOutputBuffer()); });
+            // hand off to the worker; no allocation or thread creation here
+            Job job = {getStagingInputBuffer().data(), getStagingOutputBuffer(), false};
+            _submit(job);
 #endif
         }
 
@@ -186,14 +367,80 @@ public:
     }
 
     void _process(std::vector<fftconvolver::Sample> &input_buffer, fftconvolver::Sample *output_buffer)
+    {
+        _process(input_buffer.data(), output_buffer);
+    }
+
+    void _process(const fftconvolver::Sample *input_buffer, fftconvolver::Sample *output_buffer)
     {
         // TODO process does not work with std::vector for output buffer. why??
 #ifdef CONV_REV_PROFILE
         Timer timer("--------convolver.process()");
 #endif
-        _convolver.process(input_buffer.data(), output_buffer, _blocksize);
+        _convolver.process(input_buffer, output_buffer, _blocksize);
     }
 
+#ifndef __EMSCRIPTEN__
+    // hand a job to the worker; at most one is in flight
+    void _submit(const Job &job)
+    {
+        _busy.store(true, std::memory_order_relaxed);
+        if (_jobs.push(job))
+            _wake.post();
+        else
+        {
+            // can't happen with one block in flight; don't lose it
+            _run(job);
+            _busy.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    void _run(const Job &job)
+    {
+        if (job.tail)
+        {
+#ifdef CONV_REV_PROFILE
+            Timer timer("--------two-stage tail");
+#endif
+            _two_stage.background();
+        }
+        else
+            _process(job.input, job.output);
+    }
+
+    // block until the worker is done with the block in flight, if any;
+    // normally it is, having had a whole block's worth of time
+    void _wait()
+    {
+        if (!_busy.load(std::memory_order_acquire))
+            return;
+#ifdef CONV_REV_PROFILE
+        // the worker is late: this is time the audio thread stalls
+        Timer timer("----tick waited on convolver");
+#endif
+        while (_busy.load(std::memory_order_acquire))
+            std::this_thread::yield();
+    }
+
+    // worker thread: convolve blocks as they are handed off
+    void _worker()
+    {
+        Job job;
+        for (;;)
+        {
+            // one post per job, so no hand-off is missed
+            _wake.wait();
+            if (_quit.load(std::memory_order_acquire))
+                return;
+            while (_jobs.pop(job))
+            {
+                _run(job);
+                _busy.store(false, std::memory_order_release);
+            }
+        }
+    }
+#endif
+
     // set parameter example
     t_CKFLOAT setBlockSize(t_CKFLOAT p)
     {
@@ -204,6 +451,14 @@ public:
     // get parameter example
     t_CKFLOAT getBlockSize() { return _blocksize; }
 
+    t_CKINT setHeadSize(t_CKINT n)
+    {
+        _headsize = n;
+        return n;
+    }
+
+    t_CKINT getHeadSize() { return _headsize; }
+
     void setOrder(t_CKINT m)
     {
         _order = m;
@@ -224,7 +479,13 @@ public:
 
     t_CKVOID init()
     {
+#ifndef __EMSCRIPTEN__
+        // let the block in flight finish before touching the buffers
+        _wait();
+#endif
+
         // resize buffers and zero buffers
+        _idx = 0;
         _input_buffer.resize(_blocksize, 0);
         _staging_in_buffer.resize(_blocksize, 0);
 
@@ -240,8 +501,26 @@ public:
         memset(_output_buffer, 0, _blocksize * sizeof(fftconvolver::Sample));
         memset(_staging_out_buffer, 0, _blocksize * sizeof(fftconvolver::Sample));
 
-        // initialize convolution engine
-        _convolver.init(_blocksize, _ir_buffer.data(), _order);
+        // initialize convolution engine; only one of them is used
+        _head = (_headsize > 0 && _headsize < _blocksize) ? _headsize : 0;
+        if (_head > 0)
+        {
+            _head_in.assign(_head, 0);
+            _head_out.assign(_head, 0);
+            _convolver.reset();
+            _two_stage.init(_head, _blocksize, _ir_buffer.data(), _order);
+        }
+        else
+        {
+            _two_stage.reset();
+            _convolver.init(_blocksize, _ir_buffer.data(), _order);
+        }
+
+#ifndef __EMSCRIPTEN__
+        // start the worker once; it is reused across init() calls
+        if (!_conv_thr.joinable())
+            _conv_thr = std::thread(&ConvRev::_worker, this);
+#endif
 
         // set normalization scale factor
         _scale_factor = _SR / _order;
@@ -281,6 +560,18 @@ CK_DLL_QUERY(ConvRev)
     QUERY->add_mfun(QUERY, convrev_getBlockSize, "float", "blocksize");
     QUERY->doc_func(QUERY, "Get the blocksize of the FFT convolution engine.");
 
+    QUERY->add_mfun(QUERY, convrev_setHeadSize, "int", "headsize");
+    QUERY->add_arg(QUERY, "int", "arg");
+    QUERY->doc_func(QUERY,
+                    "Set the head blocksize for two-stage convolution, which takes effect on init(). "
+                    "When smaller than blocksize, the start of the IR is convolved on the audio thread "
+                    "in blocks of this size and the rest in blocks of blocksize on the worker thread, "
+                    "so latency is headsize samples while long IRs still use large, cheap partitions. "
+                    "Defaults to 0 (uniform blocksize partitions, latency 2*blocksize).");
+
+    QUERY->add_mfun(QUERY, convrev_getHeadSize, "int", "headsize");
+    QUERY->doc_func(QUERY, "Get the head blocksize for two-stage convolution.");
+
     QUERY->add_mfun(QUERY, convrev_setOrder, "int", "order");
     QUERY->add_arg(QUERY, "int", "arg");
     QUERY->doc_func(QUERY,
@@ -362,6 +653,32 @@ CK_DLL_MFUN(convrev_getBlockSize)
     RETURN->v_float = cr_obj->getBlockSize();
 }
 
+CK_DLL_MFUN(convrev_setHeadSize)
+{
+    ConvRev *cr_obj = (ConvRev *)OBJ_MEMBER_INT(SELF, convrev_data_offset);
+    t_CKINT n = GET_NEXT_INT(ARGS);
+
+    if (n < 0)
+    {
+        API->vm->throw_exception(
+            "InvalidArgument",
+            (std::string("Trying to set convolution head blocksize to a negative value!\n") + "headsize = " + std::to_string(n) + ".").c_str(),
+            SHRED);
+    }
+    else
+    {
+        cr_obj->setHeadSize(n);
+    }
+
+    RETURN->v_int = n;
+}
+
+CK_DLL_MFUN(convrev_getHeadSize)
+{
+    ConvRev *cr_obj = (ConvRev *)OBJ_MEMBER_INT(SELF, convrev_data_offset);
+    RETURN->v_int = cr_obj->getHeadSize();
+}
+
 CK_DLL_MFUN(convrev_setOrder)
 {
     ConvRev *cr_obj = (ConvRev *)OBJ_MEMBER_INT(SELF, convrev_data_offset);
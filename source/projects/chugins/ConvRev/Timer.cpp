@@ -1,4 +1,5 @@
 #include "Timer.h"
 
 std::unordered_map<std::string, double> Timer::s_Timings;
-std::unordered_map<std::string, size_t> Timer::s_CallCounts;
\ No newline at end of file
+std::unordered_map<std::string, size_t> Timer::s_CallCounts;
+std::mutex Timer::s_Mutex;
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <chrono>
 #include <cstdio>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <unordered_map>
@@ -36,6 +37,9 @@ public:
     auto elapsed_ms = elapsed_s * 1000;
     char buf[100]{0};                                                // NOLINT
 
+    // timers run on the audio thread and the convolution worker
+    std::lock_guard<std::mutex> lock(s_Mutex);
+
     // update average
     s_Timings[label] += elapsed_ms;
 
@@ -57,6 +61,8 @@ public:
     static std::unordered_map<std::string, double> s_Timings;
     // map for storing call counts
     static std::unordered_map<std::string, size_t> s_CallCounts;
+    // guards the maps above
+    static std::mutex s_Mutex;
 
 private:
   time_point  start_;
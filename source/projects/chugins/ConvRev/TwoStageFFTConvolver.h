@@ -0,0 +1,127 @@
+// ==================================================================================
+// Copyright (c) 2017 HiFi-LoFi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==================================================================================
+
+
+#ifndef _FFTCONVOLVER_TWOSTAGEFFTCONVOLVER_H
+#define _FFTCONVOLVER_TWOSTAGEFFTCONVOLVER_H
+
+#include "FFTConvolver.h"
+#include "Utilities.h"
+
+
+namespace fftconvolver
+{
+
+/**
+* @class TwoStageFFTConvolver
+* @brief FFT convolver with two different block sizes
+*
+* The 2-stage convolver consists internally of 2 convolvers:
+*
+* - A head convolver, which uses a small block size and processes the
+*   beginning of the impulse response, so the output has low latency
+*
+* - A tail convolver, which uses a bigger block size and processes the
+*   rest of the impulse response, which is cheaper per sample
+*
+* The tail convolver is run through startBackgroundProcessing() and
+* waitForBackgroundProcessing(), which by default just process it in place.
+* Override both to move it to a background thread: it then has a whole tail
+* block's worth of time to finish, and process() only waits for it when it
+* is late.
+*
+* The first tail block of the impulse response is processed with the head
+* block size (by the 2nd convolver) in the calling thread, so that the tail
+* output computed in the background is needed one tail block later.
+*/
+class TwoStageFFTConvolver
+{
+public:
+  TwoStageFFTConvolver();
+  virtual ~TwoStageFFTConvolver();
+
+  /**
+  * @brief Initialization the convolver
+  * @param headBlockSize The head block size
+  * @param tailBlockSize the tail block size
+  * @param ir The impulse response
+  * @param irLen Length of the impulse response in samples
+  * @return true: Success - false: Failed
+  */
+  bool init(size_t headBlockSize, size_t tailBlockSize, const Sample* ir, size_t irLen);
+
+  /**
+  * @brief Convolves the the given input samples and immediately outputs the result
+  * @param input The input samples
+  * @param output The convolution result
+  * @param len Number of input/output samples
+  */
+  void process(const Sample* input, Sample* output, size_t len);
+
+  /**
+  * @brief Resets the convolver and discards the set impulse response
+  */
+  void reset();
+
+protected:
+  /**
+  * @brief Starts the background processing of the tail
+  *
+  * The default implementation calls doBackgroundProcessing() directly.
+  * Override to run it in another thread; the call must not block.
+  */
+  virtual void startBackgroundProcessing();
+
+  /**
+  * @brief Waits until the background processing started last is finished
+  *
+  * The default implementation does nothing.
+  */
+  virtual void waitForBackgroundProcessing();
+
+  /**
+  * @brief Actually performs the background processing of the tail
+  */
+  void doBackgroundProcessing();
+
+private:
+  size_t _headBlockSize;
+  size_t _tailBlockSize;
+  FFTConvolver _headConvolver;
+  FFTConvolver _tailConvolver0;
+  SampleBuffer _tailOutput0;
+  SampleBuffer _tailPrecalculated0;
+  FFTConvolver _tailConvolver;
+  SampleBuffer _tailOutput;
+  SampleBuffer _tailPrecalculated;
+  SampleBuffer _tailInput;
+  size_t _tailInputFill;
+  size_t _precalculatedPos;
+  SampleBuffer _backgroundProcessingInput;
+
+  // Prevent uncontrolled usage
+  TwoStageFFTConvolver(const TwoStageFFTConvolver&);
+  TwoStageFFTConvolver& operator=(const TwoStageFFTConvolver&);
+};
+
+} // End of namespace fftconvolver
+
+#endif // Header guard
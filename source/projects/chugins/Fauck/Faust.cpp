@@ -19,6 +19,14 @@
 #ifndef MAX_OUTPUTS
   #define MAX_OUTPUTS 256
 #endif
+// frames per compute() call; larger blocks are computed in pieces
+#ifndef MAX_FRAMES
+  #define MAX_FRAMES 512
+#endif
+// compiled factories kept around after their last Faust instance is done
+#ifndef MAX_CACHED_FACTORIES
+  #define MAX_CACHED_FACTORIES 16
+#endif
 
 // this should align with the correct versions of these ChucK files
 #include <chugin.h>
@@ -30,11 +38,20 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <deque>
+#include <condition_variable>
 #include <fstream>
+#include <functional>
+#include <memory>
+#include <sys/stat.h>
 #if __PLATFORM_LINUX__
 #include <filesystem>
 #endif
 // faust include
+#include <faust/dsp/libfaust.h>
 #include <faust/dsp/llvm-dsp.h>
 #include <faust/dsp/proxy-dsp.h>
 #include <faust/dsp/poly-llvm-dsp.h>
@@ -52,7 +69,6 @@
 #include <faust/midi/rt-midi.h>
 #include <faust/midi/RtMidi.cpp>
 
-#include <TMutex.h>
 
 // declaration of chugin constructor
 CK_DLL_CTOR(faust_ctor);
@@ -64,6 +80,10 @@ CK_DLL_TICKF(faust_tickf);
 // example of getter/setter
 CK_DLL_MFUN(faust_eval);
 CK_DLL_MFUN(faust_compile);
+CK_DLL_MFUN(faust_eval_async);
+CK_DLL_MFUN(faust_compile_async);
+CK_DLL_MFUN(faust_crossfade_set);
+CK_DLL_MFUN(faust_crossfade_get);
 CK_DLL_MFUN(faust_v_set);
 CK_DLL_MFUN(faust_v_get);
 CK_DLL_MFUN(faust_nvoices_get);
@@ -75,6 +95,7 @@ CK_DLL_MFUN(faust_progchange);
 CK_DLL_MFUN(faust_ctrlchange);
 CK_DLL_MFUN(faust_assets_set);
 CK_DLL_MFUN(faust_libraries_set);
+CK_DLL_MFUN(faust_cachedir_set);
 CK_DLL_MFUN(faust_groupvoices_set);
 CK_DLL_MFUN(faust_dynamicvoices_set);
 CK_DLL_MFUN(faust_panic);
@@ -93,6 +114,10 @@ t_CKINT faust_data_offset = 0;
 
 std::list<GUI*> GUI::fGuiList;
 ztimedmap GUI::gTimedZoneMap;
+// guards GUI::fGuiList, which GUIs (MidiUI, the voice groups of a poly DSP)
+// join when created and leave when deleted, on the compiler thread too;
+// render() only tries it, and skips GUI::updateAllGuis() when it is busy
+static std::mutex g_guiListMutex;
 static int numCompiled = 0;
 
 #ifdef WIN32
@@ -348,6 +373,292 @@ public:
     }
 };
 
+//-----------------------------------------------------------------------------
+// name: class FactoryCache
+// desc: process-wide cache of compiled Faust factories, keyed by the code,
+//       compile arguments, target and polyphony; identical code in many Faust
+//       instances, or evaluated again, is only compiled by LLVM once.
+//       factories no longer in use are kept (up to MAX_CACHED_FACTORIES) for
+//       re-evals, and optionally saved as / loaded from machine code on disk.
+//       the lock only guards the entries: compiles and disk I/O run without
+//       it, and a second request for a key being compiled waits for that one
+//-----------------------------------------------------------------------------
+class FactoryCache
+{
+public:
+    struct Entry
+    {
+        llvm_dsp_factory * factory = NULL;
+        llvm_dsp_poly_factory * poly_factory = NULL;
+        // number of Faust instances using it (or waiting for it)
+        int refs = 0;
+        // when it was last released, for eviction
+        unsigned long released = 0;
+        // being compiled (or loaded) by the first to ask for it
+        bool pending = false;
+        // why it failed, for those that waited on it
+        std::string error;
+    };
+
+    // get a factory, compiling it if needed; NULL on error
+    Entry * acquire( const std::string & code, bool poly, int argc, const char ** argv,
+                     const std::string & target, const std::string & cacheDir,
+                     std::string & error )
+    {
+        // the key: everything that affects the compiled result
+        std::string key = std::string(poly ? "poly\n" : "mono\n") + getCLibFaustVersion() + "\n" + target + "\n";
+        for( int i = 0; i < argc; i++ ) key += std::string(argv[i]) + "\n";
+        key += code;
+
+        std::unique_lock<std::mutex> lock( m_mutex );
+
+        // in memory, or on its way
+        std::map<std::string, Entry>::iterator it = m_entries.find( key );
+        if( it != m_entries.end() )
+        {
+            Entry & e = it->second;
+            e.refs++;
+            while( e.pending ) m_done.wait( lock );
+            if( e.factory || e.poly_factory ) return &e;
+            // that compile failed; so does this one
+            error = e.error;
+            if( --e.refs == 0 ) m_entries.erase( it );
+            return NULL;
+        }
+
+        // ours to make; others asking for it meanwhile wait
+        Entry & e = m_entries[key];
+        e.refs = 1;
+        e.pending = true;
+        lock.unlock();
+
+        // on disk, named by a digest that is the same in every process
+        std::string path;
+        if( cacheDir != "" )
+            path = cacheDir + "/" + generateSHA1( key ) + (poly ? ".poly" : "") + ".fmc";
+
+        llvm_dsp_factory * factory = NULL;
+        llvm_dsp_poly_factory * poly_factory = NULL;
+        std::string diskError;
+        if( path != "" && std::ifstream( path.c_str() ).good() )
+        {
+            if( poly ) poly_factory = readPolyDSPFactoryFromMachineFile( path, target, diskError );
+            else factory = readDSPFactoryFromMachineFile( path, target, diskError );
+        }
+
+        // compile
+        bool ok = true;
+        if( !factory && !poly_factory )
+        {
+            const int optimize = -1;
+            if( poly ) poly_factory = createPolyDSPFactoryFromString( "chuck", code, argc, argv, target, error, optimize );
+            else factory = createDSPFactoryFromString( "chuck", code, argc, argv, target, error, optimize );
+            ok = error == "" && (factory || poly_factory);
+
+            // save for next time (the next process, mostly)
+            if( ok && path != "" )
+            {
+                bool saved = poly ? writePolyDSPFactoryToMachineFile( poly_factory, path, target )
+                                  : writeDSPFactoryToMachineFile( factory, path, target );
+                if( !saved ) std::cerr << "[Faust]: cannot write factory cache file: " << path << std::endl;
+            }
+        }
+
+        // publish it (entries don't move, and this one has a ref)
+        lock.lock();
+        e.pending = false;
+        e.factory = factory;
+        e.poly_factory = poly_factory;
+        m_done.notify_all();
+        if( ok ) return &e;
+
+        // failed
+        destroy( e );
+        e.error = error;
+        if( --e.refs == 0 ) m_entries.erase( key );
+        return NULL;
+    }
+
+    // done with a factory; it stays cached for a while
+    void release( Entry * e )
+    {
+        if( !e ) return;
+
+        std::lock_guard<std::mutex> lock( m_mutex );
+        if( --e->refs > 0 ) return;
+        e->released = ++m_clock;
+
+        // evict the least recently released beyond the limit
+        for( ;; )
+        {
+            std::map<std::string, Entry>::iterator oldest = m_entries.end();
+            int unused = 0;
+            for( std::map<std::string, Entry>::iterator it = m_entries.begin(); it != m_entries.end(); it++ )
+            {
+                if( it->second.refs > 0 ) continue;
+                unused++;
+                if( oldest == m_entries.end() || it->second.released < oldest->second.released ) oldest = it;
+            }
+            if( unused <= MAX_CACHED_FACTORIES ) break;
+            destroy( oldest->second );
+            m_entries.erase( oldest );
+        }
+    }
+
+    // delete factories no longer in use | on host shutdown
+    void purge()
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        for( std::map<std::string, Entry>::iterator it = m_entries.begin(); it != m_entries.end(); )
+        {
+            if( it->second.refs > 0 ) { it++; continue; }
+            destroy( it->second );
+            it = m_entries.erase( it );
+        }
+    }
+
+public: // singleton API
+    static FactoryCache * instance()
+    {
+        static FactoryCache cache;
+        return &cache;
+    }
+
+protected:
+    void destroy( Entry & e )
+    {
+        if( e.factory ) { deleteDSPFactory( e.factory ); e.factory = NULL; }
+        CK_SAFE_DELETE( e.poly_factory );
+    }
+
+    // entries by key; std::map so Entry pointers stay valid
+    std::map<std::string, Entry> m_entries;
+    std::mutex m_mutex;
+    // signalled when a pending entry is done
+    std::condition_variable m_done;
+    unsigned long m_clock = 0;
+
+private: // enforce singleton
+    FactoryCache() { }
+};
+
+
+//-----------------------------------------------------------------------------
+// name: class FaustCompiler
+// desc: background thread for evalAsync()/compileAsync(); compiles Faust
+//       programs off the audio thread, and deletes the ones they replaced.
+//       the VM thread never waits on it: a compile whose Faust goes away is
+//       abandoned, and finishes (and cleans up after itself) on its own
+//-----------------------------------------------------------------------------
+class Faust;
+class FaustCompiler
+{
+public:
+    // queue a task for the compiler thread, on behalf of vm
+    void post( Chuck_VM * vm, const std::function<void()> & task )
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        if( !m_thread.joinable() )
+        {
+            m_quit = false;
+            m_thread = std::thread( &FaustCompiler::run, this );
+        }
+        m_tasks.push_back( Task( vm, task ) );
+        m_cond.notify_one();
+    }
+
+    // delete a replaced program on the compiler thread; never blocks or
+    // allocates, false if the compiler is busy or its trash full (audio thread)
+    bool tryDelete( Faust * faust )
+    {
+        std::unique_lock<std::mutex> lock( m_mutex, std::try_to_lock );
+        if( !lock.owns_lock() || !m_thread.joinable() || m_numTrash == MAX_TRASH ) return false;
+        m_trash[m_numTrash++] = faust;
+        m_cond.notify_one();
+        return true;
+    }
+
+    // a VM (and the chugin in it) is loaded / shutting down
+    void attach( Chuck_VM * vm )
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_vms++;
+    }
+    void detach( Chuck_VM * vm )
+    {
+        std::unique_lock<std::mutex> lock( m_mutex );
+        // nothing more for this VM; shutting down, so waiting is fine
+        for( std::deque<Task>::iterator it = m_tasks.begin(); it != m_tasks.end(); )
+        {
+            if( it->vm != vm ) { it++; continue; }
+            it = m_tasks.erase( it );
+        }
+        while( m_running == vm ) m_idle.wait( lock );
+        if( --m_vms > 0 ) return;
+        // last one out: stop the thread before the chugin is unloaded
+        m_quit = true;
+        m_cond.notify_one();
+        lock.unlock();
+        if( m_thread.joinable() ) m_thread.join();
+    }
+
+public: // singleton API
+    static FaustCompiler * instance()
+    {
+        if( !o_compiler ) { o_compiler = new FaustCompiler(); }
+        return o_compiler;
+    }
+
+protected:
+    // a task, and the VM it is for
+    struct Task
+    {
+        Chuck_VM * vm;
+        std::function<void()> run;
+        Task( Chuck_VM * v, const std::function<void()> & r )
+            : vm(v), run(r) { }
+    };
+
+    // compiler thread loop (defined after Faust)
+    void run();
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::condition_variable m_idle;
+    std::deque<Task> m_tasks;
+    // VM of the task running, if any
+    Chuck_VM * m_running = NULL;
+    bool m_quit = false;
+    // replaced programs to delete, from tryDelete()
+    static const int MAX_TRASH = 64;
+    Faust * m_trash[MAX_TRASH];
+    int m_numTrash = 0;
+    int m_vms = 0;
+
+private: // enforce singleton
+    FaustCompiler() { }
+    static FaustCompiler * o_compiler;
+};
+
+// static global faust compiler
+FaustCompiler * FaustCompiler::o_compiler = NULL;
+
+
+//-----------------------------------------------------------------------------
+// name: struct FaustAsync
+// desc: what a Faust shares with its async compiles, which may outlive it
+//-----------------------------------------------------------------------------
+struct FaustAsync
+{
+    // a program compiled in the background, not adopted yet
+    std::atomic<Faust *> pending{ NULL };
+    // the Faust is done waiting (gone, or evaluated something else since);
+    // whoever takes a program from pending deletes it
+    std::atomic<bool> abandoned{ false };
+};
+
+
 //-----------------------------------------------------------------------------
 // name: class Faust
 // desc: class definition of internal chugin data
@@ -363,6 +674,7 @@ public:
         // clear
         m_factory = NULL;
         m_poly_factory = NULL;
+        m_cached = NULL;
         m_dsp = NULL;
         m_dsp_poly = NULL;
         m_ui = NULL;
@@ -379,6 +691,15 @@ public:
         import(\"stdfaust.lib\");\n";
         m_assetsDirPath = std::string("");
         m_faustLibrariesPath = std::string("");
+        m_cacheDirPath = std::string("");
+        // async
+        m_fading = NULL;
+        m_retired = NULL;
+        m_fadePos = 0;
+        m_crossfade = 0;
+        m_readyEvent = NULL;
+        m_vm = NULL;
+        m_api = NULL;
         
         clearMIDI();
     }
@@ -386,6 +707,10 @@ public:
     // destructor
     ~Faust()
     {
+        // async leftovers
+        cancelAsync();
+        CK_SAFE_DELETE(m_fading);
+        CK_SAFE_DELETE(m_retired);
         // clear
         clear();
         clearBufs();
@@ -405,6 +730,7 @@ public:
     // Channel 0 means "all channels" when receiving or sending.
     
     void noteOn(int pitch, int velocity) {
+        adopt();
         if (m_dsp_poly) {
             int channel = 0;
             m_dsp_poly->keyOn(channel, pitch, velocity);
@@ -412,6 +738,7 @@ public:
     }
     
     void noteOff(int pitch, int velocity) {
+        adopt();
         if (m_dsp_poly) {
             int channel = 0;
             m_dsp_poly->keyOff(channel, pitch, velocity);
@@ -419,6 +746,7 @@ public:
     }
     
     void sendAllNotesOff(int channel) {
+        adopt();
         if (m_dsp_poly) {
             m_dsp_poly->ctrlChange(channel, m_dsp_poly->ALL_NOTES_OFF, 0);
         }
@@ -432,6 +760,17 @@ public:
         m_faustLibrariesPath = librariesDir;
     }
     
+    bool setCacheDir(const std::string & cacheDir) {
+        // "" turns the disk cache off
+        struct stat st;
+        if (cacheDir != "" && (stat(cacheDir.c_str(), &st) != 0 || !(st.st_mode & S_IFDIR))) {
+            std::cerr << "[Faust]: cache directory not found: " << cacheDir << std::endl;
+            return false;
+        }
+        m_cacheDirPath = cacheDir;
+        return true;
+    }
+    
     void setGroupVoices(bool groupVoices) {
         m_groupVoices = groupVoices;
     }
@@ -445,18 +784,21 @@ public:
     }
     
     void pitchWheel(int channel, int wheel) {
+        adopt();
         if (m_dsp_poly) {
             m_dsp_poly->pitchWheel(channel, wheel);
         }
     }
 
     void progChange(int channel, int pgm) {
+        adopt();
         if (m_dsp_poly) {
             m_dsp_poly->progChange(channel, pgm);
         }
     }
 
     void ctrlChange(int channel, int ctrl, int value) {
+        adopt();
         if (m_dsp_poly) {
             m_dsp_poly->ctrlChange(channel, ctrl, value);
         }
@@ -477,12 +819,18 @@ public:
 
         CK_SAFE_DELETE(m_dsp);
         CK_SAFE_DELETE(m_ui);
-        CK_SAFE_DELETE(m_dsp_poly);
-        CK_SAFE_DELETE(m_midi_ui);
+        {
+            // these leave GUI::fGuiList
+            std::lock_guard<std::mutex> lock(g_guiListMutex);
+            CK_SAFE_DELETE(m_dsp_poly);
+            CK_SAFE_DELETE(m_midi_ui);
+        }
         CK_SAFE_DELETE(m_soundUI);
         
-        deleteDSPFactory(m_factory); m_factory = NULL;
-        CK_SAFE_DELETE(m_poly_factory);
+        // factories are shared; hand ours back to the cache
+        FactoryCache::instance()->release(m_cached); m_cached = NULL;
+        m_factory = NULL;
+        m_poly_factory = NULL;
         
         clearMIDI();
     }
@@ -526,13 +874,13 @@ public:
         // allocate buffers for each channel
         for( int i = 0; i < m_numInputChannels; i++ )
         {
-            // single sample for each
-            m_input[i] = new FAUSTFLOAT[1];
+            // a block for each
+            m_input[i] = new FAUSTFLOAT[MAX_FRAMES];
         }
         for( int i = 0; i < m_numOutputChannels; i++ )
         {
-            // single sample for each
-            m_output[i] = new FAUSTFLOAT[1];
+            // a block for each
+            m_output[i] = new FAUSTFLOAT[MAX_FRAMES];
         }
     }
     
@@ -567,9 +915,6 @@ public:
         // auto import
         std::string theCode = m_autoImport + "\n" + code;
         
-        // optimization level
-        const int optimize = -1;
-        
 #if __APPLE__
     std::string target = getDSPMachineTarget();
 #else
@@ -578,14 +923,13 @@ public:
         
         const bool polyphonyIsOn = m_nvoices > 0;
         
-        if (polyphonyIsOn) {
-            // create new factory
-            m_poly_factory = createPolyDSPFactoryFromString("chuck", theCode,
-                argc, argv, target, m_errorString, optimize);
-        } else {
-            // create new factory
-            m_factory = createDSPFactoryFromString("chuck", theCode,
-                argc, argv, target, m_errorString, optimize);
+        // get factory, compiled or from the cache
+        m_errorString = "";
+        m_cached = FactoryCache::instance()->acquire(theCode, polyphonyIsOn,
+            argc, argv, target, m_cacheDirPath, m_errorString);
+        if (m_cached) {
+            m_factory = m_cached->factory;
+            m_poly_factory = m_cached->poly_factory;
         }
         
         if (argv) {
@@ -596,7 +940,7 @@ public:
         }
 
         // check for error
-        if( m_errorString != "")
+        if( !m_cached )
         {
             // output error
             std::cerr << "[Faust]: " << m_errorString << std::endl;
@@ -626,6 +970,9 @@ public:
         }
     #endif
 
+        // the poly DSP's voice groups and the MidiUI join GUI::fGuiList
+        std::unique_lock<std::mutex> guiLock(g_guiListMutex);
+
         if (polyphonyIsOn) {
             m_dsp_poly = m_poly_factory->createPolyDSPInstance(m_nvoices, m_dynamicVoices, m_groupVoices);
             if (!m_dsp_poly) {
@@ -653,6 +1000,7 @@ public:
             m_midi_ui = new MidiUI(&m_midi_handler);
             theDsp->buildUserInterface(m_midi_ui);
         }
+        guiLock.unlock();
 
         // make new UI
         m_ui = new FauckUI();
@@ -706,10 +1054,155 @@ public:
         // eval it
         return eval( m_code );
     }
+
+    // eval (or compile, if isPath) on the compiler thread; the new program
+    // replaces the current one once it is ready, and the returned Event is
+    // signaled; the current program keeps running until then
+    Chuck_Object * evalAsync( const std::string & code, bool isPath, Chuck_VM * vm, CK_DL_API API )
+    {
+        // for signaling the ready event, from adopt()
+        m_vm = vm;
+        m_api = API;
+        // take the last compile's program if it is done; if it is still in
+        // flight, it is superseded: it drops its result, and shreds waiting
+        // on its event wake now
+        adopt();
+        cancelAsync( API );
+        // a ready event of its own, so nothing left from an earlier compile
+        // can wake shreds waiting on this one
+        m_readyEvent = API->object->create_without_shred( vm, API->type->lookup( vm, "Event" ), TRUE );
+        m_async = std::make_shared<FaustAsync>();
+
+        // compile with the settings as of now
+        std::shared_ptr<FaustAsync> async = m_async;
+        t_CKFLOAT srate = m_srate;
+        int nvoices = m_nvoices;
+        bool groupVoices = m_groupVoices;
+        bool dynamicVoices = m_dynamicVoices;
+        std::string assetsDir = m_assetsDirPath;
+        std::string librariesDir = m_faustLibrariesPath;
+        std::string cacheDir = m_cacheDirPath;
+
+        // the compiler thread never touches the event: adopt() signals it,
+        // on the VM thread, once the program is swapped in
+        FaustCompiler::instance()->post( vm, [=]() {
+            // nobody waiting anymore
+            if( async->abandoned ) return;
+
+            // a whole new Faust, swapped in by adopt()
+            Faust * next = new Faust( srate );
+            next->m_nvoices = nvoices;
+            next->m_groupVoices = groupVoices;
+            next->m_dynamicVoices = dynamicVoices;
+            next->m_assetsDirPath = assetsDir;
+            next->m_faustLibrariesPath = librariesDir;
+            next->m_cacheDirPath = cacheDir;
+
+            bool ok = isPath ? next->compile( code ) : next->eval( code );
+            if( !ok && next->m_errorString.empty() )
+                next->m_errorString = "Cannot create DSP instance.";
+            // for crossfading
+            next->m_scratch.resize( MAX_FRAMES * next->m_numOutputChannels );
+
+            // publish
+            Faust * old = async->pending.exchange( next );
+            delete old;
+            // abandoned (or superseded) meanwhile: the Faust may have missed it
+            if( async->abandoned ) delete async->pending.exchange( NULL );
+        });
+
+        return m_readyEvent;
+    }
+
+    // abandon async work in progress (e.g., before a synchronous eval);
+    // a compile still running finishes on its own and deletes its result
+    void cancelAsync()
+    {
+        if( !m_async ) return;
+        m_async->abandoned = true;
+        delete m_async->pending.exchange( NULL );
+        m_async.reset();
+    }
+
+    // abandon async work in progress, and wake shreds waiting on its event
+    // now, since it will not be signaled (VM thread)
+    void cancelAsync( CK_DL_API API )
+    {
+        cancelAsync();
+        retireEvent( API, true );
+    }
+
+    // let go of the last ready event; with 'wake', shreds waiting on it
+    // wake now (VM thread)
+    void retireEvent( CK_DL_API API, bool wake )
+    {
+        if( !m_readyEvent ) return;
+        if( wake )
+        {
+            // Event.broadcast(), as a shred would call it
+            t_CKINT offset = API->type->get_vtable_offset( m_vm, API->type->lookup( m_vm, "Event" ), "broadcast" );
+            if( offset >= 0 ) API->vm->invoke_mfun_immediate_mode( m_readyEvent, offset, m_vm, NULL, NULL, 0 );
+        }
+        API->object->release( m_readyEvent );
+        m_readyEvent = NULL;
+    }
+
+    // release chuck-side resources | called from the dtor with the API
+    void releaseEvent( CK_DL_API API )
+    {
+        cancelAsync();
+        // the Faust is going away; nobody to wake
+        retireEvent( API, false );
+    }
+
+    // take a program compiled in the background, if there is one, and
+    // signal the ready event (on the VM/audio thread: from tick() and the
+    // parameter setters)
+    void adopt()
+    {
+        // hand the last replaced program to the compiler thread to delete
+        if( m_retired && FaustCompiler::instance()->tryDelete( m_retired ) )
+            m_retired = NULL;
+        // still busy with the last swap
+        if( m_fading || m_retired ) return;
+
+        if( !m_async ) return;
+        Faust * next = m_async->pending.exchange( NULL );
+        if( !next ) return;
+
+        if( !next->m_errorString.empty() )
+        {
+            // failed: keep playing the current program, report the error
+            std::swap( m_errorString, next->m_errorString );
+            m_retired = next;
+            retireEvent( m_api, true );
+            return;
+        }
+
+        bool fade = m_crossfade > 0 && (m_dsp || m_dsp_poly) &&
+                    next->m_numInputChannels == m_numInputChannels &&
+                    next->m_numOutputChannels == m_numOutputChannels;
+
+        swapProgram( *next );
+        // next now holds the previous program
+        if( fade ) { m_fading = next; m_fadePos = 0; }
+        else m_retired = next;
+        // ready: the signal is processed right here, so the event can go
+        retireEvent( m_api, true );
+    }
+
+    // crossfade length in samples for async swaps
+    t_CKDUR setCrossfade( t_CKDUR d ) { m_crossfade = (int)std::max( 0.0, d ); return d; }
+    t_CKDUR getCrossfade() { return m_crossfade; }
+
+    // compile status
+    bool ok() { adopt(); return m_errorString.empty() && (m_dsp || m_dsp_poly); }
+    std::string error() { adopt(); return m_errorString; }
     
     // dump (snapshot)
     void dump()
     {
+        adopt();
         if(m_errorString.empty()){
         std::cerr << "---------------- DUMPING [Faust] PARAMETERS ---------------" << std::endl;
         m_ui->dumpParams();
@@ -721,8 +1214,40 @@ public:
         }
     }
     
-    void tick( SAMPLE * in, SAMPLE * out, int nframes ){
-        
+    void tick( SAMPLE * in, SAMPLE * out, int nframes )
+    {
+        // swap in a newly compiled program (and delete the last one replaced)
+        adopt();
+
+        render( in, out, nframes );
+
+        // fade out the program replaced, if any
+        if( m_fading )
+        {
+            const int len = m_crossfade;
+            for( int f0 = 0; f0 < nframes && m_fading; f0 += MAX_FRAMES )
+            {
+                const int n = std::min( nframes - f0, MAX_FRAMES );
+                SAMPLE * blockOut = out + f0*m_numOutputChannels;
+                m_fading->render( in + f0*m_numInputChannels, m_scratch.data(), n );
+                for( int f = 0; f < n; f++, m_fadePos++ )
+                {
+                    const SAMPLE g = m_fadePos < len ? (SAMPLE)m_fadePos / len : 1;
+                    for( int c = 0; c < m_numOutputChannels; c++ )
+                    {
+                        SAMPLE & o = blockOut[f*m_numOutputChannels+c];
+                        o = g * o + (1 - g) * m_scratch[f*m_numOutputChannels+c];
+                    }
+                }
+                // done: delete it (from the compiler thread) next tick
+                if( m_fadePos >= len ) { m_retired = m_fading; m_fading = NULL; }
+            }
+        }
+    }
+
+    // compute the current program
+    void render( const SAMPLE * in, SAMPLE * out, int nframes )
+    {
         const bool polyphonyIsOn = m_nvoices > 0;
         dsp* theDsp = polyphonyIsOn ? m_dsp_poly : m_dsp;
         
@@ -743,27 +1268,39 @@ public:
         // If polyphony is enabled and we're grouping voices,
         // several voices might share the same parameters in a group.
         // Therefore we have to call updateAllGuis to update all dependent parameters.
+        // (GUI::fGuiList is shared by all instances, and changes on other
+        // threads; if it is busy, the update waits for the next block)
         if (needGuiMutex) {
-            if (m_guiUpdateMutex.Lock()) {
+            std::unique_lock<std::mutex> guiLock(g_guiListMutex, std::try_to_lock);
+            if (guiLock.owns_lock()) {
                 // Have Faust update all GUIs.
                 GUI::updateAllGuis();
-
-                m_guiUpdateMutex.Unlock();
             }
         }
         
-        for(int f = 0; f < nframes; f++)
+        // compute a block at a time, up to MAX_FRAMES
+        for(int f0 = 0; f0 < nframes; f0 += MAX_FRAMES)
         {
+            const int n = std::min(nframes - f0, MAX_FRAMES);
+            const SAMPLE * blockIn = in + f0*m_numInputChannels;
+            SAMPLE * blockOut = out + f0*m_numOutputChannels;
+
+            // deinterleave
             for(int c = 0; c < m_numInputChannels; c++)
             {
-                m_input[c][0] = in[f*m_numInputChannels+c];
+                FAUSTFLOAT * chan = m_input[c];
+                for(int f = 0; f < n; f++)
+                    chan[f] = blockIn[f*m_numInputChannels+c];
             }
             
-            theDsp->compute( 1, m_input, m_output );
+            theDsp->compute( n, m_input, m_output );
             
+            // interleave
             for(int c = 0; c < m_numOutputChannels; c++)
             {
-                out[f*m_numOutputChannels+c] = m_output[c][0];
+                const FAUSTFLOAT * chan = m_output[c];
+                for(int f = 0; f < n; f++)
+                    blockOut[f*m_numOutputChannels+c] = chan[f];
             }
         }
     }
@@ -794,6 +1331,8 @@ public:
     // set parameter example
     t_CKFLOAT setParam( const std::string & n, t_CKFLOAT p )
     {
+        // a new program, if ready
+        adopt();
         // sanity check
         if( !m_ui ) return 0;
 
@@ -806,19 +1345,40 @@ public:
 
     // get parameter example
     t_CKFLOAT getParam( const std::string & n )
-    { return m_ui->getValue(n); }
+    { adopt(); return m_ui ? m_ui->getValue(n) : 0; }
     
     // get code
     std::string code() { return m_code; }
 
 private:
+    // swap everything compiled with another Faust (for async eval)
+    void swapProgram( Faust & other )
+    {
+        std::swap( m_code, other.m_code );
+        std::swap( m_factory, other.m_factory );
+        std::swap( m_poly_factory, other.m_poly_factory );
+        std::swap( m_cached, other.m_cached );
+        std::swap( m_dsp, other.m_dsp );
+        std::swap( m_dsp_poly, other.m_dsp_poly );
+        std::swap( m_errorString, other.m_errorString );
+        std::swap( m_input, other.m_input );
+        std::swap( m_output, other.m_output );
+        std::swap( m_numInputChannels, other.m_numInputChannels );
+        std::swap( m_numOutputChannels, other.m_numOutputChannels );
+        std::swap( m_ui, other.m_ui );
+        std::swap( m_midi_ui, other.m_midi_ui );
+        std::swap( m_soundUI, other.m_soundUI );
+        std::swap( m_scratch, other.m_scratch );
+    }
+
     // sample rate
     t_CKFLOAT m_srate;
     // code text (pre any modifications)
     std::string m_code;
-    // llvm factory
+    // llvm factory (shared, owned by the FactoryCache)
     llvm_dsp_factory * m_factory;
     llvm_dsp_poly_factory* m_poly_factory;
+    FactoryCache::Entry * m_cached;
     // faust DSP object
     dsp * m_dsp;
     dsp_poly* m_dsp_poly;
@@ -828,6 +1388,7 @@ private:
     std::string m_autoImport;
     std::string m_faustLibrariesPath;
     std::string m_assetsDirPath;
+    std::string m_cacheDirPath;
     
     // faust input buffer
     FAUSTFLOAT ** m_input;
@@ -841,8 +1402,6 @@ private:
     FauckUI * m_ui;
     MidiUI* m_midi_ui = nullptr;
     SoundUI* m_soundUI = nullptr;
-    
-    TMutex m_guiUpdateMutex;
 
     bool m_groupVoices = true;
     bool m_dynamicVoices = true;
@@ -852,9 +1411,64 @@ private:
     bool m_midi_virtual = false;
     std::string m_midi_virtual_name = std::string("");
     rt_midi m_midi_handler;
+
+    // async: shared with compiles in flight
+    std::shared_ptr<FaustAsync> m_async;
+    // the program replaced, while it is faded out
+    Faust * m_fading;
+    int m_fadePos;
+    // a program replaced, to delete on the compiler thread
+    Faust * m_retired;
+    // crossfade length in samples (0: swap at once)
+    int m_crossfade;
+    // the replaced program's output, for crossfading
+    std::vector<SAMPLE> m_scratch;
+    // signaled when the last async compile's program is swapped in
+    Chuck_Object * m_readyEvent;
+    Chuck_VM * m_vm;
+    CK_DL_API m_api;
 };
 
 
+//-----------------------------------------------------------------------------
+// name: run()
+// desc: compiler thread loop
+//-----------------------------------------------------------------------------
+void FaustCompiler::run()
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+    for( ;; )
+    {
+        while( !m_quit && m_tasks.empty() && !m_numTrash ) m_cond.wait( lock );
+        if( m_quit )
+        {
+            while( m_numTrash ) delete m_trash[--m_numTrash];
+            return;
+        }
+
+        // replaced programs
+        while( m_numTrash )
+        {
+            Faust * faust = m_trash[--m_numTrash];
+            lock.unlock();
+            delete faust;
+            lock.lock();
+        }
+        if( m_tasks.empty() ) continue;
+
+        // the next task
+        Task task = m_tasks.front();
+        m_tasks.pop_front();
+        m_running = task.vm;
+        lock.unlock();
+        task.run();
+        lock.lock();
+        m_running = NULL;
+        m_idle.notify_all();
+    }
+}
+
+
 //-----------------------------------------------------------------------------
 // name: class Faucktory | v0.2.0 added (ge)
 // desc: a fauck factory for globally keep track of open Faust instances
@@ -925,8 +1539,12 @@ Faucktory * Faucktory::o_faucktory = NULL;
 // callback to be called on host shutdown (so we can clean up)
 static void cb_on_host_shutdown( void * bindle )
 {
+    // stop compiling for this VM (bindle); joins the compiler thread if last
+    FaustCompiler::instance()->detach( (Chuck_VM *)bindle );
     // explcitly call cleanup (in case of SIGINT, global object dtors doesn't run)
     Faucktory::instance()->cleanup();
+    // then the factories they were using
+    FactoryCache::instance()->purge();
 }
 
 
@@ -956,7 +1574,9 @@ CK_DLL_QUERY( Faust )
     QUERY->setname(QUERY, "Faust");
     
     // register a callback to be called upon host shutdown (so we can clean up)
-    QUERY->register_callback_on_shutdown(QUERY, cb_on_host_shutdown, NULL);
+    QUERY->register_callback_on_shutdown(QUERY, cb_on_host_shutdown, QUERY->ck_vm(QUERY));
+    // one more VM for the compiler thread to serve
+    FaustCompiler::instance()->attach(QUERY->ck_vm(QUERY));
 
     // begin the class definition
     // can change the second argument to extend a different ChucK class
@@ -980,6 +1600,32 @@ CK_DLL_QUERY( Faust )
     // add argument
     QUERY->add_arg(QUERY, "string", "path");
 
+    // add .evalAsync()
+    QUERY->add_mfun(QUERY, faust_eval_async, "Event", "evalAsync");
+    // add argument
+    QUERY->add_arg(QUERY, "string", "code");
+    QUERY->doc_func(QUERY, "Evaluate a string of Faust code on a background thread. "
+        "The current program keeps running until the new one is ready, then they are swapped (see crossfade). "
+        "Returns a new Event that is signaled when done; check ok() and error() after. "
+        "A later eval drops the result of a compile still in progress, and wakes shreds waiting on its Event.");
+
+    // add .compileAsync()
+    QUERY->add_mfun(QUERY, faust_compile_async, "Event", "compileAsync");
+    // add argument
+    QUERY->add_arg(QUERY, "string", "path");
+    QUERY->doc_func(QUERY, "Load and evaluate Faust code from a file path on a background thread, like evalAsync().");
+
+    // add .crossfade()
+    QUERY->add_mfun(QUERY, faust_crossfade_set, "dur", "crossfade");
+    // add argument
+    QUERY->add_arg(QUERY, "dur", "length");
+    QUERY->doc_func(QUERY, "Set the crossfade from the old to the new program when evalAsync()/compileAsync() finishes. "
+        "Only used when both have the same number of channels. Default 0 (swap at once).");
+
+    // add .crossfade()
+    QUERY->add_mfun(QUERY, faust_crossfade_get, "dur", "crossfade");
+    QUERY->doc_func(QUERY, "Get the crossfade length for evalAsync()/compileAsync().");
+
     // add .v()
     QUERY->add_mfun(QUERY, faust_v_set, "float", "v");
     // add arguments
@@ -1040,6 +1686,11 @@ CK_DLL_QUERY( Faust )
     // add arguments
     QUERY->add_arg(QUERY, "string", "librariesDir");
     
+    // add .cacheDir()
+    QUERY->add_mfun(QUERY, faust_cachedir_set, "int", "cacheDir");
+    // add arguments
+    QUERY->add_arg(QUERY, "string", "cacheDir");
+    
     // add .groupVoices()
     QUERY->add_mfun(QUERY, faust_groupvoices_set, "int", "groupVoices");
     // add arguments
@@ -1101,6 +1752,8 @@ CK_DLL_DTOR(faust_dtor)
 
     // remove from global registry
     Faucktory::instance()->remove( faust_obj );
+    // stop async work, let go of the ready event
+    if( faust_obj ) faust_obj->releaseEvent( API );
 
     // clean up (this macro tests for NULL, deletes, and zeros out the variable)
     CK_SAFE_DELETE( faust_obj );
@@ -1127,6 +1780,8 @@ CK_DLL_MFUN(faust_eval)
     Faust * f = (Faust *) OBJ_MEMBER_INT(SELF, faust_data_offset);
     // get argument
     std::string code = GET_NEXT_STRING_SAFE(ARGS);
+    // any async eval in flight loses
+    f->cancelAsync( API );
     // eval it
     RETURN->v_int = f->eval( code );
 }
@@ -1137,10 +1792,48 @@ CK_DLL_MFUN(faust_compile)
     Faust * f = (Faust *) OBJ_MEMBER_INT(SELF, faust_data_offset);
     // get argument
     std::string code = GET_NEXT_STRING_SAFE(ARGS);
+    // any async eval in flight loses
+    f->cancelAsync( API );
     // eval it
     RETURN->v_int = f->compile( code );
 }
 
+CK_DLL_MFUN(faust_eval_async)
+{
+    // get our c++ class pointer
+    Faust * f = (Faust *) OBJ_MEMBER_INT(SELF, faust_data_offset);
+    // get argument
+    std::string code = GET_NEXT_STRING_SAFE(ARGS);
+    // eval it in the background
+    RETURN->v_object = f->evalAsync( code, false, VM, API );
+}
+
+CK_DLL_MFUN(faust_compile_async)
+{
+    // get our c++ class pointer
+    Faust * f = (Faust *) OBJ_MEMBER_INT(SELF, faust_data_offset);
+    // get argument
+    std::string path = GET_NEXT_STRING_SAFE(ARGS);
+    // compile it in the background
+    RETURN->v_object = f->evalAsync( path, true, VM, API );
+}
+
+CK_DLL_MFUN(faust_crossfade_set)
+{
+    // get our c++ class pointer
+    Faust * f = (Faust *)OBJ_MEMBER_INT(SELF, faust_data_offset);
+    // set and return it
+    RETURN->v_dur = f->setCrossfade( GET_NEXT_DUR(ARGS) );
+}
+
+CK_DLL_MFUN(faust_crossfade_get)
+{
+    // get our c++ class pointer
+    Faust * f = (Faust *)OBJ_MEMBER_INT(SELF, faust_data_offset);
+    // return it
+    RETURN->v_dur = f->getCrossfade();
+}
+
 CK_DLL_MFUN(faust_v_set)
 {
     // get our c++ class pointer
@@ -1275,6 +1968,16 @@ CK_DLL_MFUN(faust_libraries_set)
     RETURN->v_int = 1;
 }
 
+CK_DLL_MFUN(faust_cachedir_set)
+{
+    // get our c++ class pointer
+    Faust * f = (Faust *)OBJ_MEMBER_INT(SELF, faust_data_offset);
+    // get value
+    std::string v = GET_NEXT_STRING_SAFE(ARGS);
+    // call it, and return whether it took
+    RETURN->v_int = f->setCacheDir( v );
+}
+
 CK_DLL_MFUN(faust_groupvoices_set)
 {
     // get our c++ class pointer
@@ -1317,10 +2020,18 @@ CK_DLL_MFUN(faust_dump)
 
 CK_DLL_MFUN(faust_ok)
 {
+    // get our c++ class pointer
+    Faust * f = (Faust *)OBJ_MEMBER_INT(SELF, faust_data_offset);
+    // whether the last eval/compile worked
+    RETURN->v_int = f->ok();
 }
 
 CK_DLL_MFUN(faust_error)
 {
+    // get our c++ class pointer
+    Faust * f = (Faust *)OBJ_MEMBER_INT(SELF, faust_data_offset);
+    // the last compile error, if any
+    RETURN->v_string = API->object->create_string( VM, f->error().c_str(), false );
 }
 
 CK_DLL_MFUN(faust_code)
@@ -10,6 +10,9 @@
 #include <stdio.h>
 #include <limits.h>
 
+#include <string>
+#include <vector>
+
 #include <fluidsynth.h>
 
 CK_DLL_CTOR(fluidsynth_ctor);
@@ -40,27 +43,48 @@ CK_DLL_MFUN(fluidsynth_resetPitchBend);
 CK_DLL_MFUN(fluidsynth_resetPitchBendChan);
 CK_DLL_MFUN(fluidsynth_getPitchBend);
 CK_DLL_MFUN(fluidsynth_getPitchBendChan);
+CK_DLL_MFUN(fluidsynth_cc);
+CK_DLL_MFUN(fluidsynth_ccChan);
+CK_DLL_MFUN(fluidsynth_getBlockSize);
+CK_DLL_MFUN(fluidsynth_setBlockSize);
+CK_DLL_MFUN(fluidsynth_getCpuCores);
+CK_DLL_MFUN(fluidsynth_setCpuCores);
 
 
 // this is a special offset reserved for Chugin internal data
 t_CKINT fluidsynth_data_offset = 0;
 
+// default number of frames rendered per fluid_synth_write_float() call;
+// FluidSynth's own internal block size
+#define FLUIDSYNTH_DEFAULT_BLOCK_SIZE 64
+#define FLUIDSYNTH_MAX_BLOCK_SIZE 8192
+
 
 // class definition for internal Chugin data
 // (note: this isn't strictly necessary, but serves as example
 // of one recommended approach)
+//
+// audio is rendered a block at a time, blockSize-1 frames behind chuck time.
+// calls that change the synth are queued, stamped with chuck time, and
+// applied at that frame inside the block being rendered.
 class FluidSynth
 {
 public:
     // constructor
-    FluidSynth(t_CKFLOAT fs)
+    FluidSynth(t_CKFLOAT fs, Chuck_VM * vm, CK_DL_API api)
     {
         m_srate = fs;
+        m_vm = vm;
+        m_api = api;
+        m_cpuCores = 1;
+        m_synth = NULL;
+        m_settings = NULL;
+        createSynth();
 
-        m_settings = new_fluid_settings();
-        m_synth = new_fluid_synth(m_settings);
-
-        fluid_settings_setnum(m_settings, "synth.sample-rate", m_srate);
+        m_blockSize = 0;
+        m_left = NULL;
+        m_right = NULL;
+        setBlockSize(FLUIDSYNTH_DEFAULT_BLOCK_SIZE);
     }
 
     ~FluidSynth()
@@ -69,149 +93,337 @@ public:
         m_synth = NULL;
         delete_fluid_settings(m_settings);
         m_settings = NULL;
+        delete [] m_left;
+        delete [] m_right;
     }
 
     // for Chugins extending UGen
-    void tick( SAMPLE *in, SAMPLE *out )
+    void tick( SAMPLE *in, SAMPLE *out, int nframes )
     {
-        // default: this passes whatever input is patched into Chugin
-
-        fluid_synth_write_float(m_synth, 1, out, 0, 0, out+1, 0, 0);
+        // the VM advances `now` past the frames before ticking them, so
+        // frame i belongs to the shreds that ran at now - nframes + i
+        t_CKTIME now = m_api->vm->now(m_vm) - nframes;
+        for (int i = 0; i < nframes; i++) {
+            // played everything rendered: render the next block
+            if (m_pos == m_blockSize) {
+                render(now + i);
+            }
+            out[i*2] = m_left[m_pos];
+            out[i*2+1] = m_right[m_pos];
+            m_pos++;
+        }
     }
 
     int open(const std::string &sfont)
     {
-        return fluid_synth_sfload(m_synth, sfont.c_str(), 1);
+        // keep the order of calls
+        flush();
+
+        int id = fluid_synth_sfload(m_synth, sfont.c_str(), 1);
+        if (id != FLUID_FAILED) {
+            // to load again if the synth is recreated
+            m_soundfonts.push_back(sfont);
+        }
+        return id;
     }
 
     void noteOn(int chan, int key, int vel)
     {
-        fluid_synth_noteon(m_synth, chan, key, vel);
+        queue(SynthEvent::NOTE_ON, chan, key, vel);
     }
 
     void noteOff(int chan, int key)
     {
-        fluid_synth_noteoff(m_synth, chan, key);
+        queue(SynthEvent::NOTE_OFF, chan, key);
     }
 
     void progChange(int chan, int progNum)
     {
-        fluid_synth_program_change(m_synth, chan, progNum);
+        queue(SynthEvent::PROG_CHANGE, chan, progNum);
     }
 
     void setBank(int chan, int bankNum)
     {
-        fluid_synth_bank_select(m_synth, chan, bankNum);
+        queue(SynthEvent::BANK_SELECT, chan, bankNum);
     }
 
-    void setTuning(int chan, Chuck_ArrayFloat * tuning, CK_DL_API api)
+    void cc(int chan, int num, int val)
     {
-        bool allChans = false;
-        if (chan < 0) {
-            allChans = true;
-            chan = 0;
-        }
+        queue(SynthEvent::CC, chan, num, val);
+    }
 
-        double * tuningArr;
-        tuningArr = new double[api->object->array_float_size(tuning)];
+    void setTuning(int chan, Chuck_ArrayFloat * tuning, CK_DL_API api)
+    {
+        SynthEvent & e = queue(SynthEvent::KEY_TUNING, chan);
         for (int i = 0; i < api->object->array_float_size(tuning); i++) {
-            tuningArr[i] = (double) api->object->array_float_get_idx(tuning,i);
-        }
-
-        fluid_synth_activate_key_tuning(m_synth, 0, chan, "", tuningArr, false);
-
-        if (allChans) {
-            for (chan = 0 ; chan<16 ; chan++) {
-                fluid_synth_activate_tuning(m_synth, chan, 0, 0, false);
-            }
-        } else {
-            fluid_synth_activate_tuning(m_synth, chan, 0, chan, false);
+            e.pitches.push_back((double) api->object->array_float_get_idx(tuning,i));
         }
     }
 
     void setOctaveTuning(int chan, Chuck_ArrayFloat * tuning, CK_DL_API api)
     {
-        bool allChans = false;
-        if (chan < 0) {
-            allChans = true;
-            chan = 0;
-        }
-
-        double * tuningArr;
-        tuningArr = new double[api->object->array_float_size(tuning)];
+        SynthEvent & e = queue(SynthEvent::OCTAVE_TUNING, chan);
         for (int i = 0; i < api->object->array_float_size(tuning); i++) {
-            tuningArr[i] = (double) api->object->array_float_get_idx(tuning,i);
-        }
-
-        fluid_synth_activate_octave_tuning(m_synth, 0, chan, "", tuningArr, false);
-
-        if (allChans) {
-            for (chan = 0 ; chan<16 ; chan++) {
-                fluid_synth_activate_tuning(m_synth, chan, 0, 0, false);
-            }
-        } else {
-            fluid_synth_activate_tuning(m_synth, chan, 0, chan, false);
+            e.pitches.push_back((double) api->object->array_float_get_idx(tuning,i));
         }
     }
 
     void resetTuning(int chan)
     {
-        if (chan < 0) {
-            for (chan = 0 ; chan<16 ; chan++) {
-                fluid_synth_deactivate_tuning(m_synth, chan, false);
-            }
-        } else {
-            fluid_synth_deactivate_tuning(m_synth, chan, false);
-        }
+        queue(SynthEvent::RESET_TUNING, chan);
     }
 
     void tuneNote(int noteNum, double pitch, int chan)
     {
-        fluid_synth_tune_notes(m_synth, 0, chan, 1, &noteNum , &pitch, false);
+        SynthEvent & e = queue(SynthEvent::TUNE_NOTES, chan);
+        e.keys.push_back(noteNum);
+        e.pitches.push_back(pitch);
     }
 
     void tuneNotes(Chuck_ArrayInt * noteNums, Chuck_ArrayFloat * pitches, int chan, CK_DL_API api)
     {
         /*
-        This ugly hack is required because Chuck_ArrayInt doesn't actually
-        contain 4-byte ints (at least on my 64-bit linux system). So we
-        need to copy the elements into an int array.
+        Chuck_ArrayInt doesn't actually contain 4-byte ints (at least on
+        64-bit systems), so the elements are copied into an int array.
         */
-        int * noteNumArr;
-        noteNumArr = new int[api->object->array_int_size(noteNums)];
+        SynthEvent & e = queue(SynthEvent::TUNE_NOTES, chan);
         for (int i = 0; i < api->object->array_int_size(noteNums); i++) {
-            noteNumArr[i] = (int) api->object->array_int_get_idx(noteNums,i);
+            e.keys.push_back((int) api->object->array_int_get_idx(noteNums,i));
         }
-
-        double * pitchesArr;
-        pitchesArr = new double[api->object->array_float_size(pitches)];
         for (int i = 0; i < api->object->array_float_size(pitches); i++) {
-            pitchesArr[i] = (double) api->object->array_float_get_idx(pitches,i);
+            e.pitches.push_back((double) api->object->array_float_get_idx(pitches,i));
         }
-
-        fluid_synth_tune_notes(m_synth, 0, chan, api->object->array_float_size(pitches),
-                               noteNumArr, pitchesArr, false);
-
-        delete [] noteNumArr;
     }
 
     void setPitchBend(int pitchbend, int chan)
     {
-        fluid_synth_pitch_bend(m_synth, chan, pitchbend);
+        queue(SynthEvent::PITCH_BEND, chan, pitchbend);
     }
 
     int getPitchBend(int chan)
     {
+        // the latest, even if it's not rendered yet
+        for (size_t i = m_events.size(); i > 0; i--) {
+            if (m_events[i-1].type == SynthEvent::PITCH_BEND && m_events[i-1].chan == chan) {
+                return m_events[i-1].a;
+            }
+        }
+
         int pitchbend;
         fluid_synth_get_pitch_bend(m_synth, chan, &pitchbend);
         return pitchbend;
     }
 
+    int getBlockSize() { return m_blockSize; }
+
+    void setBlockSize(int frames)
+    {
+        if (frames < 1) frames = 1;
+        else if (frames > FLUIDSYNTH_MAX_BLOCK_SIZE) frames = FLUIDSYNTH_MAX_BLOCK_SIZE;
+        if (frames == m_blockSize) return;
+
+        // anything queued can't wait for a block of the new size
+        flush();
+
+        delete [] m_left;
+        delete [] m_right;
+        m_blockSize = frames;
+        m_left = new float[m_blockSize]();
+        m_right = new float[m_blockSize]();
+        // play blockSize-1 frames of silence (the new latency), then render
+        m_pos = 1;
+        m_lastRender = m_api->vm->now(m_vm);
+    }
+
+    int getCpuCores() { return m_cpuCores; }
+
+    void setCpuCores(int cores)
+    {
+        if (cores < 1) cores = 1;
+        if (cores == m_cpuCores) return;
+        m_cpuCores = cores;
+
+        // "synth.cpu-cores" is only read when a synth is created
+        delete_fluid_synth(m_synth);
+        delete_fluid_settings(m_settings);
+        createSynth();
+        for (size_t i = 0; i < m_soundfonts.size(); i++) {
+            fluid_synth_sfload(m_synth, m_soundfonts[i].c_str(), 1);
+        }
+    }
+
 private:
+    // a call on the synth, to make at a given chuck time
+    struct SynthEvent
+    {
+        enum Type { NOTE_ON, NOTE_OFF, PROG_CHANGE, BANK_SELECT, CC, PITCH_BEND,
+                    KEY_TUNING, OCTAVE_TUNING, RESET_TUNING, TUNE_NOTES };
+
+        Type type;
+        t_CKTIME when;
+        int chan;
+        int a;
+        int b;
+        std::vector<int> keys;
+        std::vector<double> pitches;
+    };
+
+    SynthEvent & queue(SynthEvent::Type type, int chan, int a = 0, int b = 0)
+    {
+        t_CKTIME now = m_api->vm->now(m_vm);
+        // not being ticked (e.g., not connected): apply what is queued now,
+        // rather than holding on to it indefinitely
+        if (now - m_lastRender > 2 * m_blockSize) {
+            flush();
+        }
+
+        m_events.push_back(SynthEvent());
+        SynthEvent & e = m_events.back();
+        e.type = type;
+        e.when = now;
+        e.chan = chan;
+        e.a = a;
+        e.b = b;
+        return e;
+    }
+
+    // render a block, the first frame of which is played at chuck time `now`;
+    // it is blockSize-1 frames behind, so it ends at `now` in synth time
+    void render(t_CKTIME now)
+    {
+        t_CKTIME start = now - (m_blockSize - 1);
+        int done = 0;
+        for (size_t i = 0; i < m_events.size(); i++) {
+            // render up to the event's frame, then apply it
+            int offset = (int)(m_events[i].when - start);
+            if (offset > m_blockSize - 1) offset = m_blockSize - 1;
+            if (offset > done) {
+                fluid_synth_write_float(m_synth, offset - done, m_left, done, 1, m_right, done, 1);
+                done = offset;
+            }
+            apply(m_events[i]);
+        }
+        m_events.clear();
+
+        if (done < m_blockSize) {
+            fluid_synth_write_float(m_synth, m_blockSize - done, m_left, done, 1, m_right, done, 1);
+        }
+        m_pos = 0;
+        m_lastRender = now;
+    }
+
+    // apply everything queued right away
+    void flush()
+    {
+        for (size_t i = 0; i < m_events.size(); i++) {
+            apply(m_events[i]);
+        }
+        m_events.clear();
+    }
+
+    void apply(const SynthEvent & e)
+    {
+        int chan = e.chan;
+
+        switch (e.type)
+        {
+        case SynthEvent::NOTE_ON:
+            fluid_synth_noteon(m_synth, chan, e.a, e.b);
+            break;
+
+        case SynthEvent::NOTE_OFF:
+            fluid_synth_noteoff(m_synth, chan, e.a);
+            break;
+
+        case SynthEvent::PROG_CHANGE:
+            fluid_synth_program_change(m_synth, chan, e.a);
+            break;
+
+        case SynthEvent::BANK_SELECT:
+            fluid_synth_bank_select(m_synth, chan, e.a);
+            break;
+
+        case SynthEvent::CC:
+            fluid_synth_cc(m_synth, chan, e.a, e.b);
+            break;
+
+        case SynthEvent::PITCH_BEND:
+            fluid_synth_pitch_bend(m_synth, chan, e.a);
+            break;
+
+        case SynthEvent::KEY_TUNING:
+        case SynthEvent::OCTAVE_TUNING:
+        {
+            bool allChans = false;
+            if (chan < 0) {
+                allChans = true;
+                chan = 0;
+            }
+
+            if (e.type == SynthEvent::KEY_TUNING) {
+                fluid_synth_activate_key_tuning(m_synth, 0, chan, "", e.pitches.data(), false);
+            } else {
+                fluid_synth_activate_octave_tuning(m_synth, 0, chan, "", e.pitches.data(), false);
+            }
+
+            if (allChans) {
+                for (chan = 0 ; chan<16 ; chan++) {
+                    fluid_synth_activate_tuning(m_synth, chan, 0, 0, false);
+                }
+            } else {
+                fluid_synth_activate_tuning(m_synth, chan, 0, chan, false);
+            }
+            break;
+        }
+
+        case SynthEvent::RESET_TUNING:
+            if (chan < 0) {
+                for (chan = 0 ; chan<16 ; chan++) {
+                    fluid_synth_deactivate_tuning(m_synth, chan, false);
+                }
+            } else {
+                fluid_synth_deactivate_tuning(m_synth, chan, false);
+            }
+            break;
+
+        case SynthEvent::TUNE_NOTES:
+            fluid_synth_tune_notes(m_synth, 0, chan, (int)e.pitches.size(),
+                                   e.keys.data(), e.pitches.data(), false);
+            break;
+        }
+    }
+
+    void createSynth()
+    {
+        m_settings = new_fluid_settings();
+        fluid_settings_setnum(m_settings, "synth.sample-rate", m_srate);
+        // FluidSynth's own parallel rendering (only read here)
+        fluid_settings_setint(m_settings, "synth.cpu-cores", m_cpuCores);
+        // every call comes from the audio thread, so skip the API's mutex
+        fluid_settings_setint(m_settings, "synth.threadsafe-api", 0);
+
+        m_synth = new_fluid_synth(m_settings);
+    }
+
     // instance data
     float m_srate;
+    Chuck_VM * m_vm;
+    CK_DL_API m_api;
     fluid_settings_t *m_settings;
     fluid_synth_t *m_synth;
+    int m_cpuCores;
+    // soundfonts opened, in order
+    std::vector<std::string> m_soundfonts;
+
+    // the block being played, and the next frame of it to play
+    int m_blockSize;
+    float * m_left;
+    float * m_right;
+    int m_pos;
+    // calls to make in the next block, in order
+    std::vector<SynthEvent> m_events;
+    // chuck time of the last render
+    t_CKTIME m_lastRender;
 };
 
 // query function: chuck calls this when loading the Chugin
@@ -322,6 +534,31 @@ CK_DLL_QUERY( fluidsynth )
     QUERY->add_mfun(QUERY, fluidsynth_getPitchBendChan, "int", "getPitchBend");
     QUERY->add_arg(QUERY, "int", "chan");
 
+    QUERY->add_mfun(QUERY, fluidsynth_cc, "void", "cc");
+    QUERY->add_arg(QUERY, "int", "ctrlNum");
+    QUERY->add_arg(QUERY, "int", "value");
+    QUERY->doc_func(QUERY, "Send a MIDI control change on channel 0.");
+
+    QUERY->add_mfun(QUERY, fluidsynth_ccChan, "void", "cc");
+    QUERY->add_arg(QUERY, "int", "ctrlNum");
+    QUERY->add_arg(QUERY, "int", "value");
+    QUERY->add_arg(QUERY, "int", "chan");
+    QUERY->doc_func(QUERY, "Send a MIDI control change.");
+
+    QUERY->add_mfun(QUERY, fluidsynth_getBlockSize, "int", "blockSize");
+    QUERY->doc_func(QUERY, "Get the number of frames rendered at a time.");
+
+    QUERY->add_mfun(QUERY, fluidsynth_setBlockSize, "int", "blockSize");
+    QUERY->add_arg(QUERY, "int", "frames");
+    QUERY->doc_func(QUERY, "Set the number of frames rendered at a time (default 64, up to 8192). Output is blockSize-1 frames behind chuck time; notes and other calls still take effect at the exact frame they are made. 1 renders a frame at a time, with no latency. Changing it while playing causes a brief gap.");
+
+    QUERY->add_mfun(QUERY, fluidsynth_getCpuCores, "int", "cpuCores");
+    QUERY->doc_func(QUERY, "Get the number of CPU cores FluidSynth renders voices on.");
+
+    QUERY->add_mfun(QUERY, fluidsynth_setCpuCores, "int", "cpuCores");
+    QUERY->add_arg(QUERY, "int", "cores");
+    QUERY->doc_func(QUERY, "Set the number of CPU cores FluidSynth renders voices on (synth.cpu-cores; default 1). Best set before open(): changing it recreates the synth, loading the soundfonts again but resetting programs, banks, controllers, tunings and pitch bends. Works best with a blockSize of 64 or more.");
+
     fluidsynth_data_offset = QUERY->add_mvar(QUERY, "int", "@f_data", false);
 
     // IMPORTANT: this MUST be called!
@@ -338,7 +575,7 @@ CK_DLL_CTOR(fluidsynth_ctor)
     OBJ_MEMBER_INT(SELF, fluidsynth_data_offset) = 0;
 
     // instantiate our internal c++ class representation
-    FluidSynth * bcdata = new FluidSynth(API->vm->srate(VM));
+    FluidSynth * bcdata = new FluidSynth(API->vm->srate(VM), VM, API);
 
     // store the pointer in the ChucK object member
     OBJ_MEMBER_INT(SELF, fluidsynth_data_offset) = (t_CKINT)bcdata;
@@ -368,7 +605,7 @@ CK_DLL_TICKF(fluidsynth_tickf)
     FluidSynth * c = (FluidSynth *) OBJ_MEMBER_INT(SELF, fluidsynth_data_offset);
 
     // invoke our tick function; store in the magical out variable
-    if(c) c->tick(in, out);
+    if(c) c->tick(in, out, nframes);
 
     // yes
     return TRUE;
@@ -646,3 +883,50 @@ CK_DLL_MFUN(fluidsynth_getPitchBendChan) {
 
     RETURN->v_int = f_data->getPitchBend(chan);
 }
+
+CK_DLL_MFUN(fluidsynth_cc)
+{
+    FluidSynth * f_data = (FluidSynth *) OBJ_MEMBER_INT(SELF, fluidsynth_data_offset);
+    t_CKINT ctrlNum = GET_NEXT_INT(ARGS);
+    t_CKINT value = GET_NEXT_INT(ARGS);
+
+    f_data->cc(0, ctrlNum, value);
+}
+
+CK_DLL_MFUN(fluidsynth_ccChan)
+{
+    FluidSynth * f_data = (FluidSynth *) OBJ_MEMBER_INT(SELF, fluidsynth_data_offset);
+    t_CKINT ctrlNum = GET_NEXT_INT(ARGS);
+    t_CKINT value = GET_NEXT_INT(ARGS);
+    t_CKINT chan = GET_NEXT_INT(ARGS);
+
+    f_data->cc(chan, ctrlNum, value);
+}
+
+CK_DLL_MFUN(fluidsynth_getBlockSize) {
+    FluidSynth * f_data = (FluidSynth *) OBJ_MEMBER_INT(SELF, fluidsynth_data_offset);
+
+    RETURN->v_int = f_data->getBlockSize();
+}
+
+CK_DLL_MFUN(fluidsynth_setBlockSize) {
+    FluidSynth * f_data = (FluidSynth *) OBJ_MEMBER_INT(SELF, fluidsynth_data_offset);
+    t_CKINT frames = GET_NEXT_INT(ARGS);
+
+    f_data->setBlockSize(frames);
+    RETURN->v_int = f_data->getBlockSize();
+}
+
+CK_DLL_MFUN(fluidsynth_getCpuCores) {
+    FluidSynth * f_data = (FluidSynth *) OBJ_MEMBER_INT(SELF, fluidsynth_data_offset);
+
+    RETURN->v_int = f_data->getCpuCores();
+}
+
+CK_DLL_MFUN(fluidsynth_setCpuCores) {
+    FluidSynth * f_data = (FluidSynth *) OBJ_MEMBER_INT(SELF, fluidsynth_data_offset);
+    t_CKINT cores = GET_NEXT_INT(ARGS);
+
+    f_data->setCpuCores(cores);
+    RETURN->v_int = f_data->getCpuCores();
+}
@@ -1,28 +1,45 @@
 #include "WarpBufChugin.h"
+#include <algorithm>
+#include <condition_variable>
 #include <filesystem>
-
-WarpBufChugin::WarpBufChugin(t_CKFLOAT srate)
+#include <mutex>
+#include <system_error>
+#include <vector>
+
+// the streams whose workers are running, so that a VM's can be stopped (and
+// waited for) when it shuts down, before the chugin is unloaded; never
+// destroyed, since a worker signals g_workersDone as its thread exits, which
+// may be after static destructors run, or after the chugin is unloaded
+static std::mutex& g_workersMutex = *new std::mutex;
+static std::condition_variable& g_workersDone = *new std::condition_variable;
+static std::vector<std::shared_ptr<WarpBufStream>>& g_workers = *new std::vector<std::shared_ptr<WarpBufStream>>;
+
+WarpBufStream::WarpBufStream(Chuck_VM* vm, t_CKFLOAT srate, SNDFILE* file, const SF_INFO& info,
+                             const AbletonClipInfo& clipInfo, int lookahead, double pitchScale)
 {
+    m_vm = vm;
     // sample rate
     m_srate = srate;
-    memset(&sfinfo, 0, sizeof(SF_INFO));
-
-    this->recreateStretcher();
-}
-
-WarpBufChugin::~WarpBufChugin()
-{
-    clearBufs();
-    m_rbstretcher.release();
-}
-
-void
-WarpBufChugin::reset() {
-    m_rbstretcher->reset();
-}
-
-void
-WarpBufChugin::recreateStretcher() {
+    sndfile = file;
+    sfinfo = info;
+    m_clipInfo = clipInfo;
+
+    m_loopStart = m_clipInfo.loop_start;
+    m_loopEnd = m_clipInfo.loop_end;
+    m_endMarker = m_clipInfo.end_marker;
+    m_loopOn = m_clipInfo.loop_on;
+    m_bpm = 120.;
+    m_pitchScale = pitchScale;
+    m_lookahead = lookahead;
+
+    m_head = 0;
+    m_tail = 0;
+    m_epoch = 1;
+    m_seekBeats = 0.;
+    m_resetRequested = false;
+    m_endedEpoch = 0;
+    m_quit = false;
+    m_asleep = false;
 
     using namespace RubberBand;
 
@@ -30,6 +47,7 @@ WarpBufChugin::recreateStretcher() {
 
     options |= RubberBandStretcher::OptionProcessRealTime;
     options |= RubberBandStretcher::OptionStretchPrecise; // This setting is always used when running in real-time mode
+    // already on our own worker thread
     options |= RubberBandStretcher::OptionThreadingNever;
     options |= RubberBandStretcher::OptionPitchHighQuality;
 
@@ -38,12 +56,33 @@ WarpBufChugin::recreateStretcher() {
         sfinfo.channels,
         options,
         1.,
-        1.);
+        pitchScale);
+
+    m_channels = sfinfo.channels;
+
+    m_nonInterleavedBuffer = new float* [m_channels];
+    for (int i = 0; i < m_channels; i++) {
+        m_nonInterleavedBuffer[i] = new float[interleaved_buffer_size];
+    }
+
+    m_interleavedBuffer = new float[m_channels * interleaved_buffer_size];
+
+    m_retrieveBuffer = new float * [m_channels];
+    // allocate buffers for each channel
+    for (int i = 0; i < m_channels; i++) {
+        m_retrieveBuffer[i] = new float[WARPBUF_BLOCK_SIZE];
+    }
+
+    // the ring, rounded up to a power of 2 so indices can wrap by masking
+    m_ringSize = 1;
+    while (m_ringSize < (size_t)lookahead) {
+        m_ringSize <<= 1;
+    }
+    m_ring = new float[m_ringSize * m_channels];
+    m_marks = new Mark[m_ringSize];
 }
 
-// clear
-void
-WarpBufChugin::clearBufs()
+WarpBufStream::~WarpBufStream()
 {
     if (m_retrieveBuffer != NULL)
     {
@@ -62,33 +101,341 @@ WarpBufChugin::clearBufs()
         }
     }
     CK_SAFE_DELETE_ARRAY(m_nonInterleavedBuffer);
+
+    CK_SAFE_DELETE_ARRAY(m_ring);
+    CK_SAFE_DELETE_ARRAY(m_marks);
+
+    if (sndfile) {
+        sf_close(sndfile);
+    }
+}
+
+bool
+WarpBufStream::start(const std::shared_ptr<WarpBufStream>& stream) {
+    std::lock_guard<std::mutex> lock(g_workersMutex);
+    WarpBufStream* s = stream.get();
+    try {
+        std::thread([s]() {
+            s->worker();
+            // let go of the stream (which goes, unless its WarpBuf still has it);
+            // quitAll() is told only once this thread has exited, holding the
+            // lock until then, so no chugin code runs here after it returns
+            std::unique_lock<std::mutex> lock(g_workersMutex);
+            g_workers.erase(std::find_if(g_workers.begin(), g_workers.end(),
+                [s](const std::shared_ptr<WarpBufStream>& w) { return w.get() == s; }));
+            std::notify_all_at_thread_exit(g_workersDone, std::move(lock));
+        }).detach();
+    }
+    catch (const std::system_error&) {
+        return false;
+    }
+    // (the worker can't finish before this, without the lock)
+    g_workers.push_back(stream);
+    return true;
+}
+
+void
+WarpBufStream::quit() {
+    m_quit = true;
+    m_wakeup.post();
+}
+
+void
+WarpBufStream::quitAll(Chuck_VM* vm) {
+    std::unique_lock<std::mutex> lock(g_workersMutex);
+    // (the workers of other VMs in the process keep going)
+    for (auto& stream : g_workers) {
+        if (stream->m_vm == vm) {
+            stream->quit();
+        }
+    }
+    g_workersDone.wait(lock, [vm]() {
+        return std::none_of(g_workers.begin(), g_workers.end(),
+            [vm](const std::shared_ptr<WarpBufStream>& w) { return w->m_vm == vm; });
+    });
+}
+
+// Audio thread: flush the ring and send the worker to `beats`.
+void
+WarpBufStream::requestSeek(double beats, bool resetStretcher) {
+
+    m_seekBeats = beats;
+    if (resetStretcher) {
+        m_resetRequested = true;
+    }
+    m_epoch.fetch_add(1, std::memory_order_release);
+
+    // drop what is buffered; the head is ours, and tick() skips any frames the
+    // worker is still finishing for the old epoch
+    m_head.store(m_tail.load(std::memory_order_acquire), std::memory_order_release);
+
+    wake();
+}
+
+void
+WarpBufStream::wake() {
+    // order what we changed before the check; the worker raises m_asleep before
+    // its last look, so either it sees the change or we see it asleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_asleep.load(std::memory_order_relaxed) && m_asleep.exchange(false)) {
+        m_wakeup.post();
+    }
+}
+
+// Worker: move the read position to `beats`.
+void
+WarpBufStream::seek(double beats) {
+    sfReadPos = m_clipInfo.beat_to_sample(beats, sfinfo.samplerate);
+    sf_seek(sndfile, std::max(0, sfReadPos), SEEK_SET);
+    // seeking doesn't change sfReadPos
 }
 
-// Allocate the buffers if the number of channels or number of samples changed.
+// Worker: keep the ring `m_lookahead` frames ahead of playback.
 void
-WarpBufChugin::allocate(int numChannels, int numSamples)
+WarpBufStream::worker()
 {
-    if (m_numAllocated == numSamples && m_channels == numChannels) {
-        return;
+    // none yet, so the first pass seeks to where the WarpBuf put the playhead
+    unsigned epoch = 0;
+    // playhead of the next frame to make
+    double beats = 0.;
+    // what the stretcher has been set to
+    double pitchScale = m_rbstretcher->getPitchScale();
+
+    // loop off, and the playhead is past the end marker
+    auto ended = [&]() {
+        return beats > m_endMarker.load(std::memory_order_relaxed) && !m_loopOn.load(std::memory_order_relaxed);
+    };
+    // free room in the ring (frames)
+    auto room = [&]() {
+        return m_lookahead.load(std::memory_order_relaxed) - (int)(m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_acquire));
+    };
+    // whether to get up: the transport moved, playback has drained half the
+    // ring and there is more to make, or markers moved and the audio thread
+    // needs to hear (again) whether the end was reached
+    auto wanted = [&]() {
+        return m_quit.load(std::memory_order_relaxed) || m_epoch.load(std::memory_order_acquire) != epoch ||
+            (room() >= m_lookahead.load(std::memory_order_relaxed) / 2 && !ended()) ||
+            (room() > 0 && ended() && m_endedEpoch.load(std::memory_order_relaxed) != epoch);
+    };
+
+    for (;;) {
+        if (m_quit) {
+            return;
+        }
+
+        unsigned current = m_epoch.load(std::memory_order_acquire);
+        if (current != epoch) {
+            // the playhead was moved (or reset): start over from there
+            epoch = current;
+            if (m_resetRequested.exchange(false)) {
+                m_rbstretcher->reset();
+            }
+            // drop what the stretcher has ready, too; it's from before the jump
+            for (int n = m_rbstretcher->available(); n > 0; n = m_rbstretcher->available()) {
+                m_rbstretcher->retrieve(m_retrieveBuffer, std::min(n, WARPBUF_BLOCK_SIZE));
+            }
+            beats = m_seekBeats;
+            seek(beats);
+        }
+
+        double scale = m_pitchScale;
+        if (scale != pitchScale) {
+            m_rbstretcher->setPitchScale(scale);
+            pitchScale = scale;
+        }
+
+        // fill up, a block at a time, until full or the transport moves
+        for (int n = room(); n > 0 && m_epoch.load(std::memory_order_acquire) == epoch; n = room()) {
+            if (ended()) {
+                // tell the audio thread to play silence, and not count underruns
+                m_endedEpoch.store(epoch, std::memory_order_release);
+                break;
+            }
+            m_endedEpoch.store(0, std::memory_order_relaxed);
+            if (!produce(beats, epoch, std::min(n, WARPBUF_BLOCK_SIZE))) {
+                break;
+            }
+        }
+
+        // sleep until wanted; the audio thread posts only if it sees m_asleep,
+        // so raise it before looking one last time
+        m_asleep.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!wanted()) {
+            m_wakeup.wait();
+        }
+        m_asleep.store(false, std::memory_order_relaxed);
     }
+}
 
-    // clear
-    clearBufs();
+// Worker: stretch up to `nframes` frames into the ring, advancing the playhead
+// `beats`; returns the number of frames made.
+int
+WarpBufStream::produce(double& beats, unsigned epoch, int nframes)
+{
+    double bpm = m_bpm;
+    double beatsPerFrame = bpm / (60. * m_srate);
+
+    // Don't make frames that start past the end marker, if we're not looping.
+    double endMarker = m_endMarker;
+    bool loopOn = m_loopOn;
+    if (!loopOn) {
+        double remaining = std::floor((endMarker - beats) / beatsPerFrame) + 1.;
+        if (remaining < nframes) {
+            nframes = std::max(0, (int)remaining);
+        }
+    }
+    if (nframes == 0) {
+        return 0;
+    }
 
-    m_channels = numChannels;
-    m_numAllocated = numSamples;
+    double _;
+    double clipBPM = -1.;
 
-    m_nonInterleavedBuffer = new float* [m_channels];
-    for (int i = 0; i < m_channels; i++) {
-        m_nonInterleavedBuffer[i] = new float[interleaved_buffer_size];
+    m_clipInfo.beat_to_seconds(beats, _, clipBPM);
+
+    int loop_start_sample = m_clipInfo.beat_to_sample(m_loopStart, sfinfo.samplerate);
+    int loop_end_sample = m_clipInfo.beat_to_sample(m_loopEnd, sfinfo.samplerate);
+
+    double ratio = (m_srate / sfinfo.samplerate);
+    if (clipBPM > 0) {
+        ratio *= clipBPM / bpm;
     }
-       
-    m_interleavedBuffer = new float[m_channels * interleaved_buffer_size];
-    
-    m_retrieveBuffer = new float * [m_channels];
-    // allocate buffers for each channel
-    for (int i = 0; i < m_channels; i++) {
-        m_retrieveBuffer[i] = new float[numSamples];
+    m_rbstretcher->setTimeRatio(ratio);
+
+    int count = 0;
+    int numAvailable = m_rbstretcher->available();
+    int allowedReadCount = 0;
+    // In a while loop, we read from the sound file into an interleaved buffer and count the number of samples we read in a "count" variable.
+    // We also track our read position integer in `sfReadPos`.
+    // If count is zero:
+    //   Then maybe we want to loop around and update our read position.
+    //   Or maybe we have some reason to write zeros into the interleaved buffer (discussed in code far below).
+    // Once we've read new samples or written zeros into tje interleaved buffer, we copy it into a non-interleaved buffer.
+    // Then we tell Rubber Band to process the non-interleaved buffer, and we wait for enough retrievable samples.
+    // When there are enough samples for every frame of the block, we retrieve them and copy them into the ring.
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    for (int made = 0; made < nframes; made++) {
+        // progress the playhead by one frame, as if the frames were made one at a time;
+        // reaching the loop end while reading for this frame moves it to the loop start.
+        beats += beatsPerFrame;
+
+        while (numAvailable < made + 1) {
+
+            // If our sample read position is in bounds given our sound file
+            if (sfReadPos > -1 && sfReadPos < sfinfo.frames) {
+
+                // We might want to artificially restrict the number of samples to try to read from the soundfile.
+                if (loopOn) {
+                    // If we're looping, we want to prevent reading samples beyond the loop end sample point.
+                    // If we're not beyond the loop end sample read point, we can greedily grab `interleaved_buffer_size` samples.
+                    allowedReadCount = std::min(interleaved_buffer_size, loop_end_sample - sfReadPos);
+                }
+                else {
+                    // Not looping, so greedily grab `interleaved_buffer_size` samples.
+                    allowedReadCount = interleaved_buffer_size;
+                }
+                if (allowedReadCount) {
+                    count = sf_readf_float(sndfile, m_interleavedBuffer, allowedReadCount);
+                    // Note that sf_readf_float can return -1 if no samples were read, so we take a max with zero.
+                    count = std::max(0, count);
+                    sfReadPos += count;
+                }
+                else {
+                    count = 0;
+                }
+            }
+            else {
+                // Our sfReadPos is out of bounds, so we didn't "read" any samples: set count to zero.
+                // We will probably want to write zeros into the buffer given to Rubber Band.
+                count = 0;
+            }
+
+            if (count < 1) {
+
+                bool do_write_zeros = false;
+                if (loopOn) {
+
+                    if ((sfReadPos >= loop_end_sample) && (loop_end_sample > loop_start_sample)) {
+                        // Our read position reached the loop_end_sample, so we should go back to the loop start.
+                        // This will change sfReadPos and hopefully put it in bounds.
+                        beats = m_loopStart;
+                        seek(beats);
+                    }
+                    else {
+                        // Our read position didn't reach the loop_end sample. Maybe the loop_end_sample is actually
+                        // to the right of the bounds of the file. We have to write zeros to kill time until we get there.
+                        // Or maybe the loop_end is less than the loop_start, and we should write zeros.
+                        do_write_zeros = true;
+                    }
+                }
+
+                // If we decided earlier to write zeros, or our read pos is out of bounds, then we should write one frame of zeros.
+                if (do_write_zeros || sfReadPos < 0 || sfReadPos >= sfinfo.frames) {
+                    count = 1;
+                    sfReadPos += count;
+                    // fill with zeros
+                    for (int c = 0; c < m_channels; c++) {
+                        for (int i = 0; i < count; i++) {
+                            m_interleavedBuffer[i * m_channels + c] = 0.;
+                        }
+                    }
+                }
+                else {
+                    // We didn't write zeros (or anything) to the interleaved buffer, so we have to "continue"
+                    // in order to not copy the invalid interleaved buffer to the nonInterleavedBuffer.
+                    // However, our read pos is in bounds, so we can expect to get samples next time.
+                    continue;
+                }
+            }
+
+            // Copy from the interleaved buffer to the non interleaved buffer.
+            for (int chan = 0; chan < m_channels; ++chan) {
+                for (int i = 0; i < count; ++i) {
+                    m_nonInterleavedBuffer[chan][i] = m_interleavedBuffer[i * m_channels + chan];
+                }
+            }
+
+            m_rbstretcher->process(m_nonInterleavedBuffer, count, false);
+            numAvailable = m_rbstretcher->available();
+        }
+
+        m_marks[(tail + made) & (m_ringSize - 1)].beats = beats;
+    }
+
+    m_rbstretcher->retrieve(m_retrieveBuffer, nframes);
+
+    // Copy from m_retrieveBuffer to the ring, interleaved, each frame marked
+    // with its epoch; then publish them to the audio thread.
+    for (int i = 0; i < nframes; i++) {
+        size_t frame = (tail + i) & (m_ringSize - 1);
+        for (int chan = 0; chan < m_channels; chan++) {
+            m_ring[frame * m_channels + chan] = m_retrieveBuffer[chan][i];
+        }
+        m_marks[frame].epoch = epoch;
+    }
+    m_tail.store(tail + nframes, std::memory_order_release);
+
+    return nframes;
+}
+
+WarpBufChugin::WarpBufChugin(Chuck_VM* vm, t_CKFLOAT srate)
+{
+    m_vm = vm;
+    // sample rate
+    m_srate = srate;
+}
+
+WarpBufChugin::~WarpBufChugin()
+{
+    stop();
+}
+
+void
+WarpBufChugin::reset() {
+    // the worker resets the stretcher, and starts again from what is playing now
+    if (m_stream) {
+        m_stream->requestSeek(m_playHeadBeats, true);
     }
 }
 
@@ -101,15 +448,15 @@ void
 WarpBufChugin::setPlayhead(double playhead) {
 
     m_playHeadBeats = playhead;
-    sfReadPos = m_clipInfo.beat_to_sample(m_playHeadBeats, sfinfo.samplerate);
-    sf_seek(sndfile, std::max(0, sfReadPos), SEEK_SET);
-    // seeking doesn't change sfReadPos
+    if (m_stream) {
+        m_stream->requestSeek(playhead, false);
+    }
 }
 
 double
 WarpBufChugin::getTranspose() {
 
-    double scale = m_rbstretcher->getPitchScale();
+    double scale = m_pitchScale;
 
     double transpose = 12. * std::log2(scale);
 
@@ -121,7 +468,11 @@ WarpBufChugin::setTranspose(double transpose) {
 
     double scale = std::pow(2., transpose/12.);
 
-    m_rbstretcher->setPitchScale(scale);
+    // the worker passes it on to the stretcher
+    m_pitchScale = scale;
+    if (m_stream) {
+        m_stream->m_pitchScale = scale;
+    }
 }
 
 double
@@ -136,162 +487,162 @@ WarpBufChugin::setBPM(double bpm) {
         return;
     }
     m_bpm = bpm;
+    if (m_stream) {
+        m_stream->m_bpm = bpm;
+    }
 }
 
 void
-WarpBufChugin::tick(SAMPLE* in, SAMPLE* out, int nframes)
-{
-    allocate(sfinfo.channels, nframes);
-
-    bool past_end_marker_and_loop_off = m_playHeadBeats > m_clipInfo.end_marker && !m_clipInfo.loop_on;
-    // If our sound file has zero channels, or for some reason the number of allocated channels (m_channels)
-    // is zero, or play is disabled, or (loop is off and our playhead measured in beats is greater than
-    // our end marker measured in beats)
-    if (sfinfo.channels == 0 || m_channels == 0 || (!m_play) || past_end_marker_and_loop_off) {
-        // Write zeros into our output buffer and return.
-        // Note that we are not feeding the zeros to the stretcher.
-        std::fill_n(out, nframes * WARPBUF_MAX_OUTPUTS, 0.f);
+WarpBufChugin::setLookahead(int frames) {
+    frames = std::max(frames, WARPBUF_BLOCK_SIZE);
+    if (frames == m_lookahead) {
         return;
     }
+    m_lookahead = frames;
 
-    double _;
-    double clipBPM = -1.;
+    // nothing to resize until a file is read
+    if (!m_stream) {
+        return;
+    }
+    if ((size_t)frames <= m_stream->m_ringSize) {
+        m_stream->m_lookahead = frames;
+        m_stream->wake();
+        return;
+    }
+    // a bigger ring: start over with a new stream of the same file, from the playhead
+    SNDFILE* file;
+    SF_INFO info;
+    if (open(m_path, file, info)) {
+        play(file, info, m_playHeadBeats);
+    }
+}
 
-    m_clipInfo.beat_to_seconds(m_playHeadBeats, _, clipBPM);
+// Audio thread: the worker may be able to play on (e.g., loop was turned back on),
+// so count silence as underruns until it says again that the end was reached.
+void
+WarpBufChugin::markersChanged() {
+    if (!m_stream) {
+        return;
+    }
+    m_stream->m_endedEpoch = 0;
+    m_stream->m_loopStart = m_clipInfo.loop_start;
+    m_stream->m_loopEnd = m_clipInfo.loop_end;
+    m_stream->m_endMarker = m_clipInfo.end_marker;
+    m_stream->m_loopOn = m_clipInfo.loop_on;
+    m_stream->wake();
+}
 
-    int loop_start_sample = m_clipInfo.beat_to_sample(m_clipInfo.loop_start, sfinfo.samplerate);
-    int loop_end_sample = m_clipInfo.beat_to_sample(m_clipInfo.loop_end, sfinfo.samplerate);
+void
+WarpBufChugin::tick(SAMPLE* in, SAMPLE* out, int nframes)
+{
+    WarpBufStream* stream = m_stream.get();
 
-    double ratio = (m_srate / sfinfo.samplerate);
-    if (clipBPM > 0) {
-        ratio *= clipBPM / m_bpm;
+    // If no file has been read, or play is disabled, write zeros into our output buffer and return.
+    // Note that the ring is left as it is, ready for when play is enabled again.
+    if (!stream || !m_play) {
+        std::fill_n(out, nframes * WARPBUF_MAX_OUTPUTS, 0.f);
+        return;
     }
-    m_rbstretcher->setTimeRatio(ratio);
 
-    // progress the playhead based on the number of frames.
-    // Note that it would be slightly better to do this more incrementally inside
-    // a loop, but that's hard to conceptualize with how a rubber band stretcher
-    // makes samples retrievable.
-    m_playHeadBeats += m_bpm * double(nframes) / (60. * m_srate);
+    unsigned epoch = stream->m_epoch.load(std::memory_order_relaxed);
+    size_t mask = stream->m_ringSize - 1;
+    size_t head = stream->m_head.load(std::memory_order_relaxed);
+    size_t tail = stream->m_tail.load(std::memory_order_acquire);
+    int channels = std::min(stream->m_channels, WARPBUF_MAX_OUTPUTS);
 
-    int count = 0;
-    int numAvailable = m_rbstretcher->available();
-    int allowedReadCount = 0;
-    // In a while loop, we read from the sound file into an interleaved buffer and count the number of samples we read in a "count" variable.
-    // We also track our read position integer in `sfReadPos`.
-    // If count is zero:
-    //   Then maybe we want to loop around and update our read position.
-    //   Or maybe we have some reason to write zeros into the interleaved buffer (discussed in code far below).
-    // Once we've read new samples or written zeros into tje interleaved buffer, we copy it into a non-interleaved buffer.
-    // Then we tell Rubber Band to process the non-interleaved buffer, and we wait for enough retrievable samples.
-    // When there are enough samples, we retrieve them and copy them into chuck's output buffer.
-    // Note that ChucK pretty much only asks for one frame at a time (`nframes` is 1).
-    while (numAvailable < nframes) {
-
-        // If our sample read position is in bounds given our sound file
-        if (sfReadPos > -1 && sfReadPos < sfinfo.frames) {
-
-            // We might want to artificially restrict the number of samples to try to read from the soundfile.
-            if (m_clipInfo.loop_on) {
-                // If we're looping, we want to prevent reading samples beyond the loop end sample point.
-                // If we're not beyond the loop end sample read point, we can greedily grab `interleaved_buffer_size` samples.
-                allowedReadCount = std::min(interleaved_buffer_size, loop_end_sample - sfReadPos);
-            }
-            else {
-                // Not looping, so greedily grab `interleaved_buffer_size` samples.
-                allowedReadCount = interleaved_buffer_size;
-            }
-            if (allowedReadCount) {
-                count = sf_readf_float(sndfile, m_interleavedBuffer, allowedReadCount);
-                // Note that sf_readf_float can return -1 if no samples were read, so we take a max with zero.
-                count = std::max(0, count);
-                sfReadPos += count;
-            }
-            else {
-                count = 0;
-            }
+    for (int i = 0; i < nframes; i++) {
+        // skip frames made before the playhead last moved
+        while (head != tail && stream->m_marks[head & mask].epoch != epoch) {
+            head++;
         }
-        else {
-            // Our sfReadPos is out of bounds, so we didn't "read" any samples: set count to zero.
-            // We will probably want to write zeros into the buffer given to Rubber Band.
-            count = 0;
-        }
-
-        if (count < 1) {
 
-            bool do_write_zeros = false;
-            if (m_clipInfo.loop_on) {
-
-                if ((sfReadPos >= loop_end_sample) && (loop_end_sample > loop_start_sample)) {
-                    // Our read position reached the loop_end_sample, so we should go back to the loop start.
-                    // This will change sfReadPos and hopefully put it in bounds.
-                    setPlayhead(m_clipInfo.loop_start);
-                }
-                else {
-                    // Our read position didn't reach the loop_end sample. Maybe the loop_end_sample is actually
-                    // to the right of the bounds of the file. We have to write zeros to kill time until we get there.
-                    // Or maybe the loop_end is less than the loop_start, and we should write zeros.
-                    do_write_zeros = true;
-                }
-            }
-
-            // If we decided earlier to write zeros, or our read pos is out of bounds, then we should write one frame of zeros.
-            if (do_write_zeros || sfReadPos < 0 || sfReadPos >= sfinfo.frames) {
-                count = 1;
-                sfReadPos += count;
-                // fill with zeros
-                for (int c = 0; c < m_channels; c++) {
-                    for (int i = 0; i < count; i++) {
-                        m_interleavedBuffer[i * m_channels + c] = 0.;
-                    }
-                }
-            }
-            else {
-                // We didn't write zeros (or anything) to the interleaved buffer, so we have to "continue"
-                // in order to not copy the invalid interleaved buffer to the nonInterleavedBuffer.
-                // However, our read pos is in bounds, so we can expect to get samples next time.
-                continue;
-            }
-        }
-        
-        // Copy from the interleaved buffer to the non interleaved buffer.
-        for (int chan = 0; chan < m_channels; ++chan) {
-            for (int i = 0; i < count; ++i) {
-                m_nonInterleavedBuffer[chan][i] = m_interleavedBuffer[i * m_channels + chan];
+        if (head == tail) {
+            // nothing ready: silence, and the playhead stays put; unless past the
+            // end marker with loop off, the worker is behind (e.g., right after a
+            // jump), so count the frames as underruns rather than wait for it
+            std::fill_n(out + i * WARPBUF_MAX_OUTPUTS, (nframes - i) * WARPBUF_MAX_OUTPUTS, 0.f);
+            if (stream->m_endedEpoch.load(std::memory_order_acquire) != epoch) {
+                m_underruns += nframes - i;
             }
+            break;
         }
 
-        m_rbstretcher->process(m_nonInterleavedBuffer, count, false);
-        numAvailable = m_rbstretcher->available();
+        // copy the frame to chuck's output, which is interleaved
+        size_t frame = head & mask;
+        for (int chan = 0; chan < channels; chan++) {
+            out[i * WARPBUF_MAX_OUTPUTS + chan] = stream->m_ring[frame * stream->m_channels + chan];
+        }
+        m_playHeadBeats = stream->m_marks[frame].beats;
+        head++;
     }
 
-    m_rbstretcher->retrieve(m_retrieveBuffer, nframes);
+    stream->m_head.store(head, std::memory_order_release);
 
-    // Copy from m_retrieveBuffer to chuck's output.
-    // out needs to receive alternating left/right channels.
-    for (int chan = 0; chan < m_channels; chan++) {
-        auto chanPtr = m_retrieveBuffer[chan];
-        for (int i = 0; i < nframes; i++) {
-            out[chan + m_channels * i] = *chanPtr++;
-        }
+    // half drained: get the worker up, if it's asleep (without blocking)
+    if ((int)(tail - head) <= stream->m_lookahead.load(std::memory_order_relaxed) / 2) {
+        stream->wake();
     }
 }
 
-// return true if the file was read
+// open a file to play; false (with a message) if it can't be
 bool
-WarpBufChugin::read(const std::string& path) {
-    
-    memset(&sfinfo, 0, sizeof(SF_INFO));
+WarpBufChugin::open(const std::string& path, SNDFILE*& file, SF_INFO& info) {
 
-    sndfile = sf_open(path.c_str(), SFM_READ, &sfinfo);
-    if (!sndfile) {
+    memset(&info, 0, sizeof(SF_INFO));
+
+    file = sf_open(path.c_str(), SFM_READ, &info);
+    if (!file) {
         std::cerr << "ERROR: Failed to open input file \"" << path << "\": "
-            << sf_strerror(sndfile) << std::endl;
+            << sf_strerror(file) << std::endl;
         return false;
     }
 
-    if (sfinfo.samplerate == 0) {
+    if (info.samplerate == 0) {
         std::cerr << "ERROR: File lacks sample rate in header" << std::endl;
+        sf_close(file);
+        file = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+// play an open file from `beats`, on a new stream; the old one's worker is
+// told to quit, not waited for
+void
+WarpBufChugin::play(SNDFILE* file, const SF_INFO& info, double beats) {
+
+    stop();
+
+    std::shared_ptr<WarpBufStream> stream = std::make_shared<WarpBufStream>(
+        m_vm, m_srate, file, info, m_clipInfo, m_lookahead, m_pitchScale);
+    stream->m_bpm = m_bpm;
+    stream->requestSeek(beats, false);
+
+    if (!WarpBufStream::start(stream)) {
+        std::cerr << "ERROR: WarpBuf could not start its worker thread" << std::endl;
+        return;
+    }
+    m_stream = stream;
+}
+
+// stop playing (silence until the next read)
+void
+WarpBufChugin::stop() {
+    if (m_stream) {
+        m_stream->quit();
+        m_stream.reset();
+    }
+}
+
+// return true if the file was read
+bool
+WarpBufChugin::read(const std::string& path) {
+
+    SNDFILE* file;
+    SF_INFO info;
+    if (!open(path, file, info)) {
+        stop();
         return false;
     }
 
@@ -301,7 +652,7 @@ WarpBufChugin::read(const std::string& path) {
     if (! (file_exists && m_clipInfo.readWarpFile(asd_path.c_str()))) {
         // We didn't find a warp file, so assume it's 120 bpm.
         const double bpm = 120.;
-        const double end_in_beats = bpm * sfinfo.frames / (sfinfo.samplerate * 60.);
+        const double end_in_beats = bpm * info.frames / (info.samplerate * 60.);
         //m_clipInfo.loop_on = true; // todo: maybe we want to do this. Let's just preserve the previous setting.
         //m_clipInfo.warp_on = true; // todo: maybe we want to do this. Let's just preserve the previous setting.
         m_clipInfo.loop_start = 0.;
@@ -319,9 +670,9 @@ WarpBufChugin::read(const std::string& path) {
         m_clipInfo.warp_markers.push_back(std::make_pair(durSeconds, beats));
     }
 
-    this->setPlayhead(m_clipInfo.start_marker);
-
-    this->recreateStretcher();
+    m_path = path;
+    m_playHeadBeats = m_clipInfo.start_marker;
+    this->play(file, info, m_playHeadBeats);
 
     return true;
 }
@@ -7,8 +7,23 @@
 #include <cmath>
 
 // STL includes
+#include <atomic>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <thread>
+
+#if defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <climits>
+#else
+#include <semaphore.h>
+#endif
 
 #include <sndfile.h>
 
@@ -16,16 +31,154 @@
 #include "AbletonClipInfo.h"
 
 #define WARPBUF_MAX_OUTPUTS 16
+// default number of stretched frames the worker keeps ready ahead of playback
+#define WARPBUF_DEFAULT_LOOKAHEAD 2048
+// the worker stretches at most this many frames at a time
+#define WARPBUF_BLOCK_SIZE 256
+
+// counting semaphore; post() never blocks or allocates, so the audio thread
+// can wake the worker with it
+class WarpBufSemaphore
+{
+private:
+#if defined(__APPLE__)
+    dispatch_semaphore_t _sem;
+#elif defined(_WIN32)
+    HANDLE _sem;
+#else
+    sem_t _sem;
+#endif
+
+public:
+#if defined(__APPLE__)
+    WarpBufSemaphore() { _sem = dispatch_semaphore_create(0); }
+    ~WarpBufSemaphore() { dispatch_release(_sem); }
+    void post() { dispatch_semaphore_signal(_sem); }
+    void wait() { dispatch_semaphore_wait(_sem, DISPATCH_TIME_FOREVER); }
+#elif defined(_WIN32)
+    WarpBufSemaphore() { _sem = CreateSemaphore(NULL, 0, LONG_MAX, NULL); }
+    ~WarpBufSemaphore() { CloseHandle(_sem); }
+    void post() { ReleaseSemaphore(_sem, 1, NULL); }
+    void wait() { WaitForSingleObject(_sem, INFINITE); }
+#else
+    WarpBufSemaphore() { sem_init(&_sem, 0, 0); }
+    ~WarpBufSemaphore() { sem_destroy(&_sem); }
+    void post() { sem_post(&_sem); }
+    void wait()
+    {
+        // retry if interrupted by a signal
+        while (sem_wait(&_sem) != 0)
+            ;
+    }
+#endif
+
+private:
+    WarpBufSemaphore(const WarpBufSemaphore&);
+    WarpBufSemaphore& operator=(const WarpBufSemaphore&);
+};
+
+//-----------------------------------------------------------------------------
+// name: struct WarpBufStream
+// desc: one open file, read and stretched by a worker thread of its own, which
+//       stays up to `lookahead` frames ahead of playback in a lock-free ring.
+//       The WarpBuf and the worker share it, so read(), lookahead(), or the
+//       WarpBuf going away only tell the worker to quit; it is never joined.
+//-----------------------------------------------------------------------------
+struct WarpBufStream
+{
+    // takes over the file; `vm` is the VM of the WarpBuf
+    WarpBufStream(Chuck_VM* vm, t_CKFLOAT srate, SNDFILE* file, const SF_INFO& info,
+                  const AbletonClipInfo& clipInfo, int lookahead, double pitchScale);
+    ~WarpBufStream();
+
+    // start the worker; false if it couldn't be
+    static bool start(const std::shared_ptr<WarpBufStream>& stream);
+    // tell the worker to quit (it lets go of the stream when it does)
+    void quit();
+    // tell the workers of a VM's streams to quit, and wait until their threads
+    // are done (on host shutdown)
+    static void quitAll(Chuck_VM* vm);
+
+    // audio thread: flush the ring and send the worker to `beats`
+    void requestSeek(double beats, bool resetStretcher);
+    // audio thread: wake the worker, if it's asleep; never blocks
+    void wake();
+
+    // the VM it plays in
+    Chuck_VM* m_vm;
+    // sample rate
+    t_CKFLOAT m_srate;
+
+    // the stretcher (worker only)
+    std::unique_ptr<RubberBand::RubberBandStretcher> m_rbstretcher;
+
+    // buffer related vars (worker only):
+    const int interleaved_buffer_size = 1024;
+    int m_channels = 0;
+    float** m_retrieveBuffer = NULL; // non interleaved: [m_channels][WARPBUF_BLOCK_SIZE]
+    float* m_interleavedBuffer = nullptr;  // interleaved: [m_channels*interleaved_buffer_size]
+    float** m_nonInterleavedBuffer = NULL;  // non interleaved: [m_channels][interleaved_buffer_size]
+
+    // soundfile vars (worker only):
+    SNDFILE* sndfile = NULL;
+    SF_INFO sfinfo;
+    int sfReadPos = 0;
+
+    // the warp markers of the clip (worker only)
+    AbletonClipInfo m_clipInfo;
+    // the markers and settings the worker follows (audio thread -> worker)
+    std::atomic<double> m_loopStart;
+    std::atomic<double> m_loopEnd;
+    std::atomic<double> m_endMarker;
+    std::atomic<bool> m_loopOn;
+    std::atomic<double> m_bpm;  // desired playback bpm (not the source bpm)
+    std::atomic<double> m_pitchScale;
+    std::atomic<int> m_lookahead;  // at most m_ringSize
+
+    // ring of stretched frames (worker -> audio thread)
+    struct Mark
+    {
+        double beats;  // playhead at this frame
+        unsigned epoch;  // the transport epoch it was made in
+    };
+    size_t m_ringSize = 0;  // in frames; a power of 2
+    float* m_ring = nullptr;  // interleaved: [m_ringSize*m_channels]
+    Mark* m_marks = nullptr;  // [m_ringSize]
+    std::atomic<size_t> m_head;  // next frame to play (audio thread)
+    std::atomic<size_t> m_tail;  // next frame to write (worker)
+
+    // transport: bumped by the audio thread to flush the ring and move the worker
+    std::atomic<unsigned> m_epoch;
+    std::atomic<double> m_seekBeats;  // where the worker goes for the new epoch
+    std::atomic<bool> m_resetRequested;
+    // the epoch in which the worker ran past the end marker (0: it hasn't)
+    std::atomic<unsigned> m_endedEpoch;
+
+    // the worker sleeps on m_wakeup, having raised m_asleep
+    std::atomic<bool> m_quit;
+    std::atomic<bool> m_asleep;
+    WarpBufSemaphore m_wakeup;
+
+private:
+    void worker();
+    int produce(double& beats, unsigned epoch, int nframes);
+    void seek(double beats);
+};
 
 //-----------------------------------------------------------------------------
 // name: class WarpBufChugin
 // desc: WarpBufChugin for time-stretching and pitch-stretching (via Rubber Band library)
+//
+// reading the file and stretching happen on the worker of a WarpBufStream;
+// tick() only copies frames out of its ring, and plays silence (counting
+// underruns) if the worker falls behind. Moving the playhead (or reset) flushes
+// the ring.
 //-----------------------------------------------------------------------------
 class WarpBufChugin
 {
 public:
     // constructor
-    WarpBufChugin(t_CKFLOAT srate);
+    WarpBufChugin(Chuck_VM* vm, t_CKFLOAT srate);
 
     ~WarpBufChugin();
 
@@ -40,6 +193,9 @@ public:
     void setTranspose(double transpose);
     double getBPM();
     void setBPM(double bpm);
+    int getLookahead() { return m_lookahead; }
+    void setLookahead(int frames);
+    t_CKINT getUnderruns() { return m_underruns; }
 
     bool read(const std::string& filename);
 
@@ -49,40 +205,37 @@ public:
     double getStartMarker() { return m_clipInfo.start_marker; }
     void setStartMarker(double startMarker) { m_clipInfo.start_marker = startMarker; }
     double getEndMarker() { return m_clipInfo.end_marker; }
-    void setEndMarker(double endMarker) { m_clipInfo.end_marker = endMarker; }
+    void setEndMarker(double endMarker) { m_clipInfo.end_marker = endMarker; markersChanged(); }
     double getLoopStart() { return m_clipInfo.loop_start; }
-    void setLoopStart(double loopStart) { m_clipInfo.loop_start = loopStart; }
+    void setLoopStart(double loopStart) { m_clipInfo.loop_start = loopStart; markersChanged(); }
     double getLoopEnd() { return m_clipInfo.loop_end; }
-    void setLoopEnd(double loopEnd) { m_clipInfo.loop_end = loopEnd; }
+    void setLoopEnd(double loopEnd) { m_clipInfo.loop_end = loopEnd; markersChanged(); }
     bool getLoopEnable() { return m_clipInfo.loop_on; }
-    void setLoopEnable(bool enable) { m_clipInfo.loop_on = enable; }
+    void setLoopEnable(bool enable) { m_clipInfo.loop_on = enable; markersChanged(); }
 
 private:
+    // the VM it plays in
+    Chuck_VM* m_vm;
     // sample rate
     t_CKFLOAT m_srate;
 
-    std::unique_ptr<RubberBand::RubberBandStretcher> m_rbstretcher;
-
-    // buffer related vars:
-    const int interleaved_buffer_size = 1024;
-    int m_numAllocated = 0;  // keep track of allocated samples
-    int m_channels = 0;  // keep track of allocated channels
-    float** m_retrieveBuffer = NULL; // non interleaved: [m_channels][nframes] where nframes is the dynamic number of frames chuck requests on tick
-    float* m_interleavedBuffer = nullptr;  // interleaved: [m_channels*interleaved_buffer_size]
-    float** m_nonInterleavedBuffer = NULL;  // non interleaved: [m_channels][interleaved_buffer_size]
-
-    // soundfile vars:
-    SNDFILE* sndfile;
-    SF_INFO sfinfo;
-    int sfReadPos = 0;
-
+    // the file last read, and its clip info
+    std::string m_path;
     AbletonClipInfo m_clipInfo;
 
-    double m_playHeadBeats = 0.; // measured in quarter notes
+    double m_playHeadBeats = 0.; // measured in quarter notes, of the frame last played
     bool m_play = true;
     double m_bpm = 120.;  // desired playback bpm (not the source bpm)
-
-    void clearBufs();
-    void allocate(int numChannels, int numSamples);
-    void recreateStretcher();
+    double m_pitchScale = 1.;
+    int m_lookahead = WARPBUF_DEFAULT_LOOKAHEAD;
+    // frames of silence played because the worker was behind
+    t_CKINT m_underruns = 0;
+
+    // what is playing (NULL until a file is read)
+    std::shared_ptr<WarpBufStream> m_stream;
+
+    bool open(const std::string& path, SNDFILE*& file, SF_INFO& info);
+    void play(SNDFILE* file, const SF_INFO& info, double beats);
+    void stop();
+    void markersChanged();
 };
@@ -26,6 +26,9 @@ CK_DLL_MFUN(warpbuf_getloopstart);
 CK_DLL_MFUN(warpbuf_setloopstart);
 CK_DLL_MFUN(warpbuf_getloopend);
 CK_DLL_MFUN(warpbuf_setloopend);
+CK_DLL_MFUN(warpbuf_getlookahead);
+CK_DLL_MFUN(warpbuf_setlookahead);
+CK_DLL_MFUN(warpbuf_getunderruns);
 
 // multi-channel audio synthesis tick function
 CK_DLL_TICKF(warpbuf_tick);
@@ -33,6 +36,12 @@ CK_DLL_TICKF(warpbuf_tick);
 // this is a special offset reserved for Chugin internal data
 t_CKINT warpbuf_data_offset = 0;
 
+// called when a VM (bindle) shuts down
+static void warpbuf_on_shutdown(void* bindle)
+{
+    WarpBufStream::quitAll((Chuck_VM*)bindle);
+}
+
 //-----------------------------------------------------------------------------
 // query function: chuck calls this when loading the Chugin
 //-----------------------------------------------------------------------------
@@ -41,6 +50,9 @@ CK_DLL_QUERY(WarpBuf)
     // hmm, don't change this...
     QUERY->setname(QUERY, "WarpBuf");
 
+    // stop this VM's workers (and wait for them) before the chugin is unloaded
+    QUERY->register_callback_on_shutdown(QUERY, warpbuf_on_shutdown, QUERY->ck_vm(QUERY));
+
     // begin the class definition
     // can change the second argument to extend a different ChucK class
     QUERY->begin_class(QUERY, "WarpBuf", "UGen");
@@ -94,6 +106,12 @@ CK_DLL_QUERY(WarpBuf)
     QUERY->add_mfun(QUERY, warpbuf_setloopend, "float", "loopEnd");
     QUERY->add_arg(QUERY, "float", "loopEnd");
 
+    QUERY->add_mfun(QUERY, warpbuf_getlookahead, "int", "lookahead");
+    QUERY->add_mfun(QUERY, warpbuf_setlookahead, "int", "lookahead");
+    QUERY->add_arg(QUERY, "int", "frames");
+
+    QUERY->add_mfun(QUERY, warpbuf_getunderruns, "int", "underruns");
+
     // this reserves a variable in the ChucK internal class to store
     // referene to the c++ class we defined above
     warpbuf_data_offset = QUERY->add_mvar(QUERY, "int", "@b_data", false);
@@ -112,7 +130,7 @@ CK_DLL_CTOR(warpbuf_ctor)
     OBJ_MEMBER_INT(SELF, warpbuf_data_offset) = 0;
 
     // instantiate our internal c++ class representation
-    WarpBufChugin* b_obj = new WarpBufChugin(API->vm->srate(VM));
+    WarpBufChugin* b_obj = new WarpBufChugin(VM, API->vm->srate(VM));
 
     // store the pointer in the ChucK object member
     OBJ_MEMBER_INT(SELF, warpbuf_data_offset) = (t_CKINT)b_obj;
@@ -306,3 +324,26 @@ CK_DLL_MFUN(warpbuf_setloopend)
     chug->setLoopEnd(loopEnd);
     RETURN->v_float = loopEnd;
 }
+
+CK_DLL_MFUN(warpbuf_getlookahead)
+{
+    WarpBufChugin* chug = (WarpBufChugin*)OBJ_MEMBER_INT(SELF, warpbuf_data_offset);
+
+    RETURN->v_int = chug->getLookahead();
+}
+
+CK_DLL_MFUN(warpbuf_setlookahead)
+{
+    t_CKINT frames = GET_NEXT_INT(ARGS);
+
+    WarpBufChugin* chug = (WarpBufChugin*)OBJ_MEMBER_INT(SELF, warpbuf_data_offset);
+    chug->setLookahead(frames);
+    RETURN->v_int = chug->getLookahead();
+}
+
+CK_DLL_MFUN(warpbuf_getunderruns)
+{
+    WarpBufChugin* chug = (WarpBufChugin*)OBJ_MEMBER_INT(SELF, warpbuf_data_offset);
+
+    RETURN->v_int = chug->getUnderruns();
+}
@@ -1192,7 +1192,7 @@ struct a_Program_ { a_Section section; a_Program next; uint32_t line; uint32_t w
 #define CK_DLL_VERSION_MAJOR (10)
 // minor API version: revisions
 // minor API version of chuck must >= API version of chugin
-#define CK_DLL_VERSION_MINOR (2)
+#define CK_DLL_VERSION_MINOR (3)
 #define CK_DLL_VERSION_MAKE(maj,min) ((t_CKUINT)(((maj) << 16) | (min)))
 #define CK_DLL_VERSION_GETMAJOR(v) (((v) >> 16) & 0xFFFF)
 #define CK_DLL_VERSION_GETMINOR(v) ((v) & 0xFFFF)
@@ -1411,6 +1411,9 @@ typedef const Chuck_DL_Api * CK_DL_API;
 // macro for defining ChucK DLL export ugen multi-channel tick functions
 // example: CK_DLL_TICKF(foo)
 #define CK_DLL_TICKF(name) CK_DLL_EXPORT(t_CKBOOL) name( Chuck_Object * SELF, SAMPLE * in, SAMPLE * out, t_CKUINT nframes, CK_DL_API API )
+// macro for defining ChucK DLL export ugen block tick functions (mono in/out, nframes each)
+// example: CK_DLL_TICKV(foo) | DL API 10.3 added
+#define CK_DLL_TICKV(name) CK_DLL_EXPORT(t_CKBOOL) name( Chuck_Object * SELF, SAMPLE * in, SAMPLE * out, t_CKUINT nframes, CK_DL_API API )
 // macro for defining ChucK DLL export ugen ctrl functions
 // example: CK_DLL_CTRL(foo)
 #define CK_DLL_CTRL(name) CK_DLL_EXPORT(void) name( Chuck_Object * SELF, void * ARGS, Chuck_DL_Return * RETURN, Chuck_VM * VM, Chuck_VM_Shred * SHRED, CK_DL_API API )
@@ -1465,6 +1468,7 @@ typedef t_CKVOID (CK_DLL_CALL * f_gfun)( void * ARGS, Chuck_DL_Return * RETURN,
 // ugen specific
 typedef t_CKBOOL (CK_DLL_CALL * f_tick)( Chuck_Object * SELF, SAMPLE in, SAMPLE * out, CK_DL_API API );
 typedef t_CKBOOL (CK_DLL_CALL * f_tickf)( Chuck_Object * SELF, SAMPLE * in, SAMPLE * out, t_CKUINT nframes, CK_DL_API API );
+typedef t_CKBOOL (CK_DLL_CALL * f_tickv)( Chuck_Object * SELF, SAMPLE * in, SAMPLE * out, t_CKUINT nframes, CK_DL_API API );
 typedef t_CKVOID (CK_DLL_CALL * f_ctrl)( Chuck_Object * SELF, void * ARGS, Chuck_DL_Return * RETURN, Chuck_VM * VM, Chuck_VM_Shred * SHRED, CK_DL_API API );
 typedef t_CKVOID (CK_DLL_CALL * f_cget)( Chuck_Object * SELF, void * ARGS, Chuck_DL_Return * RETURN, Chuck_VM * VM, Chuck_VM_Shred * SHRED, CK_DL_API API );
 typedef t_CKBOOL (CK_DLL_CALL * f_pmsg)( Chuck_Object * SELF, const char * MSG, void * ARGS, Chuck_VM * VM, Chuck_VM_Shred * SHRED, CK_DL_API API );
@@ -1545,6 +1549,8 @@ typedef void (CK_DLL_CALL * f_add_arg)( Chuck_DL_Query * query, const char * typ
 typedef void (CK_DLL_CALL * f_add_ugen_func)( Chuck_DL_Query * query, f_tick tick, f_pmsg pmsg, t_CKUINT num_in, t_CKUINT num_out );
 typedef void (CK_DLL_CALL * f_add_ugen_funcf)( Chuck_DL_Query * query, f_tickf tickf, f_pmsg pmsg, t_CKUINT num_in, t_CKUINT num_out );
 typedef void (CK_DLL_CALL * f_add_ugen_funcf_auto_num_channels)( Chuck_DL_Query * query, f_tickf tickf, f_pmsg psmg );
+// add block tick to a mono ugen, alongside its per-sample tick (which remains the fallback)
+typedef void (CK_DLL_CALL * f_add_ugen_funcv)( Chuck_DL_Query * query, f_tickv tickv );
 // ** add a ugen control (not used) | 1.4.1.0 removed
 //typedef void (CK_DLL_CALL * f_add_ugen_ctrl)( Chuck_DL_Query * query, f_ctrl ctrl, f_cget cget,
 //                                              const char * type, const char * name );
@@ -1762,6 +1768,15 @@ public:
     // -------------
     f_register_callback_on_srate_update register_callback_on_srate_update;
 
+public:
+    // -------------
+    // (ugen only) add a block tick function, computing nframes of mono
+    // output at once; must follow add_ugen_func(), whose per-sample tick
+    // is kept as the fallback | DL API 10.3 added
+    // QUERY->add_ugen_funcv( QUERY, foo_tickv );
+    // -------------
+    f_add_ugen_funcv add_ugen_funcv;
+
 
 
 